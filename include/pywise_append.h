@@ -0,0 +1,55 @@
+#ifndef PYWISE_APPEND_H
+#define PYWISE_APPEND_H
+
+#define NO_IMPORT_ARRAY
+
+#include "pywise_common.h"
+
+/*******************************************************************************
+
+    Symbol: pywise_append
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.append()
+    
+    Python Signature:
+    
+        pywise.append(results, source, threads = 0, out = None,
+                      metric = "euclidean", dtype = None)
+            -> numpy.ndarray
+            
+    Description:
+    
+        Extends results, the condensed results of pywise.distances() or
+        pywise.rmsds() across some number N of points or collections, to the
+        condensed results across every point or collection of source, which
+        must hold those N followed by any number M of new ones. Only the
+        results which involve a new point are calculated. metric is
+        "euclidean" or "rmsd", as for pywise.knn(), and the results are
+        calculated in the precision of results unless dtype says otherwise.
+        
+        If out is given, it must be a writable, one-dimensional array of the
+        results' dtype with exactly one element per pair of points of source,
+        and the results are stored in it; results may be a view of the start
+        of out, as out[:len(results)], in which case the old results are
+        moved in place, and otherwise the two must not overlap.
+        
+        On success pywise_append() returns out if given, or otherwise a new
+        one-dimensional NumPy array of the results, laid out as
+        pywise.index() describes for N + M points. On failure it raises a
+        Python exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_append
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+);
+
+#endif /* PYWISE_APPEND_H */
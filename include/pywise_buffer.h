@@ -0,0 +1,262 @@
+#ifndef PYWISE_BUFFER_H
+#define PYWISE_BUFFER_H
+
+#define NO_IMPORT_ARRAY
+
+#include "pywise_common.h"
+
+/*******************************************************************************
+
+    Symbol: pywise_borrow_input
+    
+    Type: Function returning void*
+    
+    Intent: Private
+    
+    Description:
+    
+        Attempts to borrow, without copying, the memory of a Python object
+        which supports the buffer protocol and holds a C-contiguous, aligned
+        array of native doubles (if n_type is NPY_DOUBLE) or floats (if n_type
+        is NPY_FLOAT) with n_dimensions non-empty dimensions. If o_source is a
+        NumPy array which does not meet these conditions but has n_dimensions
+        dimensions, it is first converted to one which does.
+        
+        o_source is a pointer to the input Python object, and view is a
+        pointer to the Py_buffer which will describe the borrowed memory. On
+        success stores the length of each dimension in a_shape, and returns a
+        pointer to the borrowed elements, which remain valid until view is
+        released with pywise_release_array().
+        
+        If o_source cannot be borrowed in this way returns a null pointer,
+        leaves view->buf null, and sets no Python exception; the caller should
+        then fall back on walking o_source as a generic sequence.
+        
+*******************************************************************************/
+
+void*
+pywise_borrow_input
+(
+
+    PyObject* o_source,
+    
+    int n_type,
+    int n_dimensions,
+    
+    Py_buffer* view,
+    Py_ssize_t* a_shape
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_borrow_output
+    
+    Type: Function returning void*
+    
+    Intent: Private
+    
+    Description:
+    
+        Borrows the memory of a caller-supplied Python object, o_out, in which
+        to store the l_output results of a libpairwise calculation. o_out must
+        support the buffer protocol and be a writable, C-contiguous, aligned,
+        one-dimensional array of exactly l_output native doubles (if n_type is
+        NPY_DOUBLE) or floats (if n_type is NPY_FLOAT), such as a NumPy
+        ndarray of dtype float64 or float32 respectively. a_input points to
+        the s_input bytes of the calculation's input, which o_out must not
+        overlap.
+        
+        view is a pointer to the Py_buffer which will describe the borrowed
+        memory. On success returns a pointer to it, which remains valid until
+        view is released with pywise_release_array(). On failure sets a
+        Python exception and returns a null pointer.
+        
+*******************************************************************************/
+
+void*
+pywise_borrow_output
+(
+
+    PyObject* o_out,
+    
+    int n_type,
+    
+    size_t l_output,
+    
+    const void* a_input,
+    size_t s_input,
+    
+    Py_buffer* view
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_release_array
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Releases an array returned by pywise_build_points_array(),
+        pywise_build_collections_array() or pywise_borrow_output(). a_array
+        is the returned pointer, and view is the Py_buffer passed to that call.
+        If a_array was borrowed from the caller's Python object releases view;
+        otherwise frees a_array.
+        
+        Returns nothing, and will not fail.
+        
+*******************************************************************************/
+
+void
+pywise_release_array
+(
+
+    void* a_array,
+    
+    Py_buffer* view
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_resolve_type
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Decides in which precision to carry out a calculation on the input
+        Python object o_source. o_dtype is the caller's dtype argument, or a
+        null pointer or Py_None if none was given.
+        
+        If o_dtype is given it must describe either float32 or float64.
+        Otherwise a NumPy array of float32 selects float32, so that it can be
+        borrowed without any conversion, and anything else selects float64.
+        
+        On success returns NPY_FLOAT or NPY_DOUBLE. On failure sets a Python
+        exception and returns -1.
+        
+*******************************************************************************/
+
+int
+pywise_resolve_type
+(
+
+    PyObject* o_source,
+    PyObject* o_dtype
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_narrow_array
+    
+    Type: Function returning float*
+    
+    Intent: Private
+    
+    Description:
+    
+        Copies the l_array doubles in a_doubles to a newly allocated array of
+        floats, and frees a_doubles.
+        
+        On success returns a pointer to the floats, which the caller must
+        free. On failure frees a_doubles all the same, sets a Python exception
+        and returns a null pointer.
+        
+*******************************************************************************/
+
+float*
+pywise_narrow_array
+(
+
+    double* a_doubles,
+    
+    size_t l_array
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_wrap_csr
+    
+    Type: Function returning PyObject*
+    
+    Intent: Private
+    
+    Description:
+    
+        Wraps the compressed sparse row (CSR) arrays returned by a libpairwise
+        cutoff function over n_rows collections (or points) in a tuple of
+        three one-dimensional NumPy arrays, (indptr, indices, values), each of
+        which takes ownership of the corresponding memory.
+        
+        a_indptr holds n_rows + 1 offsets, and a_indices and a_values each
+        hold a_indptr[n_rows] elements; a_values holds doubles if n_type is
+        NPY_DOUBLE, or floats if n_type is NPY_FLOAT.
+        
+        On success returns a new reference to the tuple. On failure frees all
+        three arrays, sets a Python exception and returns a null pointer.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_wrap_csr
+(
+
+    size_t n_rows,
+    
+    size_t* a_indptr,
+    size_t* a_indices,
+    
+    void* a_values,
+    
+    int n_type
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_wrap_neighbours
+    
+    Type: Function returning PyObject*
+    
+    Intent: Private
+    
+    Description:
+    
+        Wraps the arrays filled by a libpairwise k-nearest-neighbour function
+        over n_rows collections (or points) in a tuple of two two-dimensional
+        NumPy arrays of shape (n_rows, n_neighbours), (indices, values), each
+        of which takes ownership of the corresponding memory.
+        
+        a_values holds doubles if n_type is NPY_DOUBLE, or floats if n_type is
+        NPY_FLOAT.
+        
+        On success returns a new reference to the tuple. On failure frees both
+        arrays, sets a Python exception and returns a null pointer.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_wrap_neighbours
+(
+
+    size_t n_rows,
+    size_t n_neighbours,
+    
+    size_t* a_indices,
+    
+    void* a_values,
+    
+    int n_type
+
+);
+
+#endif /* PYWISE_BUFFER_H */
@@ -9,7 +9,7 @@
 
     Symbol: pywise_build_collections_array
     
-    Type: Function returning double*
+    Type: Function returning void*
     
     Intent: Private
     
@@ -21,21 +21,27 @@
         o_source is a pointer to the input Python object. On success stores the
         number of collections in o_source, the number of points per collection,
         and the number of coordinates per point in n_collections, n_points and
-        n_coordinates respectively. Also returns a pointer to a new array of
-        these collections, the responsibility to free which is passed on to the
-        caller. On failure sets a Python exception and returns a null pointer.
+        n_coordinates respectively. Also returns a pointer to an array of these
+        collections, as doubles if n_type is NPY_DOUBLE or as floats if n_type
+        is NPY_FLOAT, which the caller must release by passing it and view to
+        pywise_release_array(). On failure sets a Python exception and returns
+        a null pointer.
         
 *******************************************************************************/
 
-double*
+void*
 pywise_build_collections_array
 (
     
     PyObject* o_source,
     
+    int n_type,
+    
     size_t* n_collections,
     size_t* n_points,
-    size_t* n_coordinates
+    size_t* n_coordinates,
+    
+    Py_buffer* view
 
 );
 
@@ -9,7 +9,7 @@
 
     Symbol: pywise_build_points_array
     
-    Type: Function returning double*
+    Type: Function returning void*
     
     Intent: Private
     
@@ -19,22 +19,27 @@
         appropriate for passing to a libpairwise calculation function.
         
         o_source is a pointer to the input Python object. On success stores the
-        number of points in o_source and the number of coordinates per point in 
-        n_points and n_coordinates respectively. Also returns a pointer to a
-        new array of these points, the responsibility to free which is passed
-        on to the caller. On failure sets a Python exception and returns a null
-        pointer.
+        number of points in o_source and the number of coordinates per point in
+        n_points and n_coordinates respectively. Also returns a pointer to an
+        array of these points, as doubles if n_type is NPY_DOUBLE or as floats
+        if n_type is NPY_FLOAT, which the caller must release by passing it and
+        view to pywise_release_array(). On failure sets a Python exception and
+        returns a null pointer.
         
 *******************************************************************************/
 
-double*
+void*
 pywise_build_points_array
 (
     
     PyObject* o_source,
     
+    int n_type,
+    
     size_t* n_points,
-    size_t* n_coordinates
+    size_t* n_coordinates,
+    
+    Py_buffer* view
 
 );
 
@@ -18,17 +18,29 @@
 
 #define PYWISE_VERSION "1.0"
 
-#define PYWISE_DEFAULT_THREADS 1
+#define PYWISE_DEFAULT_THREADS 0
 
 #define PYWISE_ERROR_BUFFER_LENGTH 500
 
 #include "pywise_exception.h"
+#include "pywise_buffer.h"
 
 #include "pywise_build_points_array.h"
 #include "pywise_build_collections_array.h"
 
 #include "pywise_distances.h"
 #include "pywise_rmsds.h"
+#include "pywise_knn.h"
+#include "pywise_cross.h"
+#include "pywise_tiles.h"
+#include "pywise_future.h"
+#include "pywise_file.h"
+#include "pywise_reduce.h"
+#include "pywise_linkage.h"
+#include "pywise_append.h"
 #include "pywise_index.h"
+#include "pywise_isa.h"
+#include "pywise_pool.h"
+#include "pywise_stats.h"
 
 #endif
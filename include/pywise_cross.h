@@ -0,0 +1,118 @@
+#ifndef PYWISE_CROSS_H
+#define PYWISE_CROSS_H
+
+#define NO_IMPORT_ARRAY
+
+#include "pywise_common.h"
+
+/*******************************************************************************
+
+    Symbol: pywise_cross_distances
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.cross_distances()
+    
+    Python Signature:
+    
+        pywise.cross_distances(a, b, threads = 0, dtype = None)
+            -> numpy.ndarray
+            
+    Description:
+    
+        Calculates the Euclidean distance between every point in one set of
+        points, a, and every point in another, b, such as a batch of new
+        frames and a reference library. Binds libpairwise to distribute the
+        calculations over the requested number of threads, as
+        pywise.distances() does. threads and dtype are as for
+        pywise.distances(); calculates in single precision only if both a
+        and b would be on their own.
+        
+        On success pywise_cross_distances() returns a two-dimensional NumPy
+        array of shape (len(a), len(b)), whose element [i, j] is the distance
+        between point i of a and point j of b. On failure it raises a Python
+        exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_cross_distances
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_cross_rmsds
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.cross_rmsds()
+    
+    Python Signature:
+    
+        pywise.cross_rmsds(a, b, threads = 0, dtype = None)
+            -> numpy.ndarray
+            
+    Description:
+    
+        As pywise.cross_distances(), but calculates the RMSD between every
+        collection of points in one set of collections, a, and every
+        collection in another, b, as pywise.rmsds() does within one set.
+        
+        On success pywise_cross_rmsds() returns a two-dimensional NumPy array
+        of shape (len(a), len(b)), whose element [i, j] is the RMSD between
+        collection i of a and collection j of b. On failure it raises a Python
+        exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_cross_rmsds
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_cross
+    
+    Type: Function returning PyObject*
+    
+    Intent: Private
+    
+    Description:
+    
+        Carries out the work of pywise_cross_distances() if b_rmsd is zero,
+        or of pywise_cross_rmsds() otherwise, parsing their Python arguments,
+        values and keys, under the function name name.
+        
+        On success returns a new reference to a two-dimensional NumPy array of
+        results. On failure raises a Python exception and returns a null
+        pointer.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_cross
+(
+
+    PyObject* values,
+    PyObject* keys,
+    
+    int b_rmsd,
+    
+    char* name
+
+)
+;
+
+#endif /* PYWISE_CROSS_H */
@@ -15,14 +15,40 @@
     
     Python Signature:
     
-        pywise.distances(points, threads) -> numpy.ndarray
+        pywise.distances(points, threads = 0, out = None, dtype = None,
+                         cutoff = None, file = None)
+            -> numpy.ndarray or tuple
     
     Description:
     
         Calculates all pairwise Euclidean distances across a set of points in
         any-dimensional space. Binds libpairwise to fairly distribute the total
         number of pairwise calculations to be done over the requested number of
-        threads which are launched in parallel.
+        threads which are launched in parallel. If threads is zero, the
+        default, chooses the number of threads automatically.
+        
+        If dtype is float32, or if dtype is None and points is a NumPy array of
+        float32, carries out the calculations in single precision and returns
+        an array of float32; otherwise in double precision, returning an array
+        of float64.
+        
+        If out is given, stores the results in it rather than in a new array,
+        and returns it. out must then be a writable, C-contiguous, one-
+        dimensional array of the results' dtype with exactly one element per
+        pair.
+        
+        If cutoff is given, keeps only the results no greater than cutoff, and
+        returns them in compressed sparse row (CSR) form as a tuple of three
+        one-dimensional NumPy arrays, (indptr, indices, values). For each point
+        i, indices[indptr[i]:indptr[i + 1]] holds in increasing order every
+        point j > i whose result with i is within cutoff, and the same elements
+        of values hold those results. out may not then be given.
+        
+        If file is given, creates a libpairwise results file at that path, and
+        stores the results straight into it through a memory map rather than
+        in memory, returning them as a numpy.memmap of the file opened with
+        mode "r+", as pywise.load() would. Neither out nor cutoff may then be
+        given.
         
         On success pywise_distances() returns a one-dimensional NumPy array
         object which contains the results of all pairwise calculations. On
@@ -41,7 +41,11 @@ pywise_set_python_exception_from_pairwise_calculations_return_code
     Description:
     
         Sets an appropriate Python exception given a failure return code from
-        libpairwise's public pairwise_index().
+        libpairwise's public pairwise_index(), pairwise_index_inverse() or
+        their array forms, pairwise_indices() and pairwise_indices_inverse().
+        Codes those share with the calculations functions, such as failure to
+        allocate memory or to start a thread, are passed on to
+        pywise_set_python_exception_from_pairwise_calculations_return_code().
         
         Ignores unrecognised error codes, returns nothing, and will not fail.
         
@@ -55,4 +59,29 @@ pywise_set_python_exception_from_pairwise_index_return_code
 
 );
 
+/*******************************************************************************
+
+    Symbol: pywise_set_python_exception_from_pairwise_isa_return_code
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Sets an appropriate Python exception given a failure return code from
+        libpairwise's public pairwise_set_isa().
+        
+        Ignores unrecognised error codes, returns nothing, and will not fail.
+        
+*******************************************************************************/
+
+void
+pywise_set_python_exception_from_pairwise_isa_return_code
+(
+
+    int n_return
+
+);
+
 #endif /* PYWISE_EXCEPTION_H */
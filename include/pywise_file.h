@@ -0,0 +1,72 @@
+#ifndef PYWISE_FILE_H
+#define PYWISE_FILE_H
+
+#define NO_IMPORT_ARRAY
+
+#include "pywise_common.h"
+
+/*******************************************************************************
+
+    Symbol: pywise_load
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.load()
+    
+    Python Signature:
+    
+        pywise.load(file, mode = "r") -> numpy.memmap
+        
+    Description:
+    
+        Opens the libpairwise results file at path file, as written by
+        pywise.distances() or pywise.rmsds() when given a file, without
+        reading its results into memory.
+        
+        mode is as for numpy.memmap(), and must be "r", "r+" or "c".
+        
+        On success pywise_load() returns a one-dimensional numpy.memmap of
+        the condensed results in the file, of the dtype they were calculated
+        in. On failure it raises a Python exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_load
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_open_file
+    
+    Type: Function returning PyObject*
+    
+    Intent: Private
+    
+    Description:
+    
+        Maps the results in the libpairwise results file at path into a
+        numpy.memmap with mode mode, as described for pywise_load().
+        
+        On success returns a new reference to the numpy.memmap, or to an
+        empty array if the file holds no results. On failure sets a Python
+        exception and returns a null pointer.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_open_file
+(
+
+    const char* path,
+    const char* mode
+
+);
+
+#endif /* PYWISE_FILE_H */
@@ -0,0 +1,371 @@
+#ifndef PYWISE_FUTURE_H
+#define PYWISE_FUTURE_H
+
+#define NO_IMPORT_ARRAY
+
+#include "pywise_common.h"
+
+/*******************************************************************************
+
+    Symbol: PYWISE_FUTURE_WAIT_SLICE
+    
+    Type: Preprocessor constant
+    
+    Intent: Private
+    
+    Description:
+    
+        The longest time, in seconds, for which pywise.Future.result() waits
+        without the GIL before checking for signals, so that Ctrl-C
+        interrupts a wait promptly however long the calculation takes.
+        
+*******************************************************************************/
+
+#define PYWISE_FUTURE_WAIT_SLICE 0.05
+
+/*******************************************************************************
+
+    Symbol: pywise_future_t
+    
+    Type: Structure
+    
+    Intent: Private
+    
+    Description:
+    
+        The Python object returned by pywise.submit_distances() and
+        pywise.submit_rmsds(): a handle on a libpairwise future, future, which
+        is null once the future has been closed. a_collections and view are
+        the input array from which the future calculates, and its buffer
+        view, as returned by pywise_build_points_array() or
+        pywise_build_collections_array(), and a_results the array of
+        l_results results it fills, of NumPy type n_type; all are kept until
+        the future is closed. Once the calculation is complete, a_results is
+        handed over to the NumPy array o_result, and n_done and n_total keep
+        the final progress. b_busy is set while a thread waits, without the
+        GIL, for the result.
+        
+*******************************************************************************/
+
+typedef struct
+pywise_future
+{
+
+    PyObject_HEAD
+    
+    pairwise_future_t* future;
+    
+    void* a_collections;
+    
+    Py_buffer view;
+    
+    void* a_results;
+    size_t l_results;
+    
+    int n_type;
+    
+    PyObject* o_result;
+    
+    size_t n_done;
+    size_t n_total;
+    
+    int b_busy;
+
+} pywise_future_t;
+
+/*******************************************************************************
+
+    Symbol: pywise_future_type
+    
+    Type: PyTypeObject
+    
+    Intent: Private
+    
+    Description:
+    
+        The Python type of pywise_future_t, pywise.Future, whose members are
+        set by pywise_future_prepare_type().
+        
+*******************************************************************************/
+
+extern PyTypeObject
+pywise_future_type;
+
+/*******************************************************************************
+
+    Symbol: pywise_submit_distances
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.submit_distances()
+    
+    Python Signature:
+    
+        pywise.submit_distances(points, threads = 0, dtype = None)
+            -> pywise.Future
+            
+    Description:
+    
+        Starts calculating all pairwise Euclidean distances across a set of
+        points in any-dimensional space, as pywise.distances() does, on
+        libpairwise's worker pool, and returns at once with a pywise.Future
+        through which the calculation can be followed, cancelled and waited
+        for while the calling thread goes on with other work.
+        
+        points, threads and dtype are as for pywise.distances().
+        
+        On success pywise_submit_distances() returns a pywise.Future. On
+        failure it raises a Python exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_submit_distances
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_submit_rmsds
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.submit_rmsds()
+    
+    Python Signature:
+    
+        pywise.submit_rmsds(collections, threads = 0, dtype = None)
+            -> pywise.Future
+            
+    Description:
+    
+        Starts calculating all pairwise RMSDs across a set of collections of
+        points, as pywise.rmsds() does, on libpairwise's worker pool, and
+        returns at once with a pywise.Future through which the calculation
+        can be followed, cancelled and waited for while the calling thread
+        goes on with other work.
+        
+        collections, threads and dtype are as for pywise.rmsds().
+        
+        On success pywise_submit_rmsds() returns a pywise.Future. On failure
+        it raises a Python exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_submit_rmsds
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_future_done
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.Future.done()
+    
+    Python Signature:
+    
+        future.done() -> bool
+        
+    Description:
+    
+        Returns True if the calculation has stopped, whether because it is
+        complete or because it was cancelled, and False if it is still being
+        carried out. Never waits.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_future_done
+(
+
+    PyObject* self,
+    PyObject* unused
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_future_progress
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.Future.progress()
+    
+    Python Signature:
+    
+        future.progress() -> (int, int)
+        
+    Description:
+    
+        Returns a tuple of the number of pairwise calculations carried out so
+        far and the number there are in all. The first grows a chunk of
+        calculations at a time, and equals the second once the calculation is
+        complete.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_future_progress
+(
+
+    PyObject* self,
+    PyObject* unused
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_future_cancel
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.Future.cancel()
+    
+    Python Signature:
+    
+        future.cancel() -> None
+        
+    Description:
+    
+        Asks the threads carrying out the calculation to stop once each has
+        finished its chunk of calculations, and returns at once. A
+        calculation which is already complete is left as it is.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_future_cancel
+(
+
+    PyObject* self,
+    PyObject* unused
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_future_result
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.Future.result()
+    
+    Python Signature:
+    
+        future.result(timeout = None) -> numpy.ndarray
+        
+    Description:
+    
+        Waits for up to timeout seconds, or for as long as it takes if
+        timeout is None, for the calculation to complete, without holding the
+        GIL, and returns its results as a one-dimensional NumPy array, as
+        pywise.distances() or pywise.rmsds() would have. Every call once the
+        calculation is complete returns the same array.
+        
+        Raises RuntimeError if the calculation is still being carried out
+        once timeout has passed, or if it was cancelled. If the wait is
+        interrupted by a signal, as by Ctrl-C, cancels the calculation and
+        raises the exception of the signal handler, such as
+        KeyboardInterrupt.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_future_result
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_future_close
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Closes the libpairwise future of future, if it is not already closed,
+        without holding the GIL, cancelling it if it is still running, and
+        releases its input array. The results are kept.
+        
+        Returns the libpairwise return code of pairwise_future_close(), or
+        PAIRWISE_RETURN_SUCCESS if future was already closed.
+        
+*******************************************************************************/
+
+int
+pywise_future_close
+(
+
+    pywise_future_t* future
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_future_dealloc
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        The tp_dealloc of pywise_future_type. Closes the future of self, if
+        it is still open, which cancels a calculation still running, frees
+        any results not handed over to a NumPy array, and frees self.
+        
+        Returns nothing, and will not fail.
+        
+*******************************************************************************/
+
+void
+pywise_future_dealloc
+(
+
+    PyObject* self
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_future_prepare_type
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Sets the members of pywise_future_type and readies it for use. Called
+        once, by initpywise().
+        
+        On success returns integer zero. On failure returns integer minus one
+        and sets a Python exception.
+        
+*******************************************************************************/
+
+int
+pywise_future_prepare_type
+(void);
+
+#endif /* PYWISE_FUTURE_H */
@@ -41,4 +41,84 @@ pywise_index
 
 );
 
+/*******************************************************************************
+
+    Symbol: pywise_indices
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.indices()
+    
+    Python Signature:
+    
+        pywise.indices(n_collections, i_collections_a, i_collections_b,
+                       threads = 0)
+            -> numpy.ndarray
+            
+    Description:
+    
+        pywise.index() over arrays. i_collections_a and i_collections_b are
+        integers, or arrays of them, which are broadcast against each other
+        as NumPy broadcasts operands. For each pair of elements, the index of
+        the result of the calculation between the two collections they
+        indicate is found, exactly as pywise.index() would find it. threads
+        is as for pywise.distances().
+        
+        On success returns a NumPy array of intp of the broadcast shape, so
+        that, for instance, results[pywise.indices(N, i, others)] gathers row
+        i of the full matrix of results at once. On failure raises a Python
+        exception, which is the one pywise.index() would have raised for the
+        first pair to fail.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_indices
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_indices_inverse
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.indices_inverse()
+    
+    Python Signature:
+    
+        pywise.indices_inverse(n_collections, i_results, threads = 0)
+            -> (numpy.ndarray, numpy.ndarray)
+            
+    Description:
+    
+        The inverse of pywise.indices(). i_results is an integer, or an array
+        of them, each an index into the results of one of pywise's
+        calculation functions for n_collections collections, where negative
+        indices count back from the end of the results. For each, the two
+        collections whose calculation gave that result are found. threads is
+        as for pywise.distances().
+        
+        On success returns a tuple of two NumPy arrays of intp of the shape
+        of i_results, the first holding the lesser index of each pair and the
+        second the greater. On failure raises a Python exception, which is an
+        IndexError if any of i_results is out of bounds.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_indices_inverse
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+);
+
 #endif /* PYWISE_INDEX_H */
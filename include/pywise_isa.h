@@ -0,0 +1,70 @@
+#ifndef PYWISE_ISA_H
+#define PYWISE_ISA_H
+
+#define NO_IMPORT_ARRAY
+
+#include "pywise_common.h"
+
+/*******************************************************************************
+
+    Symbol: pywise_set_isa
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.set_isa()
+    
+    Python Signature:
+    
+        pywise.set_isa(isa) -> None
+        
+    Description:
+    
+        Selects the instruction set architecture whose kernels all subsequent
+        pywise calculations will use. isa is one of the module constants
+        pywise.ISA_AUTO, pywise.ISA_SCALAR, pywise.ISA_SSE2, pywise.ISA_AVX2
+        or pywise.ISA_AVX512. pywise.ISA_AUTO restores the widest instruction
+        set supported by the host.
+        
+        On success returns None. On failure raises a Python exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_set_isa
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_get_isa
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.get_isa()
+    
+    Python Signature:
+    
+        pywise.get_isa() -> int
+        
+    Description:
+    
+        Returns the module constant pywise.ISA_* identifying the instruction
+        set architecture whose kernels pywise calculations currently use.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_get_isa
+(
+
+    PyObject* self,
+    PyObject* values
+
+);
+
+#endif /* PYWISE_ISA_H */
@@ -0,0 +1,57 @@
+#ifndef PYWISE_KNN_H
+#define PYWISE_KNN_H
+
+#define NO_IMPORT_ARRAY
+
+#include "pywise_common.h"
+
+/*******************************************************************************
+
+    Symbol: pywise_knn
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.knn()
+    
+    Python Signature:
+    
+        pywise.knn(source, k, threads = 0, metric = "euclidean",
+                   dtype = None)
+            -> tuple
+            
+    Description:
+    
+        Finds the k nearest neighbours of every point, or of every collection
+        of points, in any-dimensional space. Binds libpairwise to carry out
+        every pairwise calculation over the requested number of threads, as
+        pywise.distances() and pywise.rmsds() do, but keeps only each row's k
+        nearest results, so that memory grows with N * k rather than with
+        N * N. If threads is zero, the default, chooses the number of threads
+        automatically.
+        
+        If metric is "euclidean", source is a two-dimensional set of points
+        and neighbours are those at the smallest Euclidean distances, as from
+        pywise.distances(). If metric is "rmsd", source is a three-
+        dimensional set of collections and neighbours are those at the
+        smallest RMSDs, as from pywise.rmsds(). k must be less than the
+        number of points or collections. dtype is as for pywise.distances().
+        
+        On success pywise_knn() returns a tuple of two NumPy arrays of shape
+        (N, k), (indices, values). Row i of indices holds the k neighbours of
+        point or collection i, nearest first, and row i of values holds their
+        results; neighbours with equal results are ordered by index. On
+        failure it raises a Python exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_knn
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+);
+
+#endif /* PYWISE_KNN_H */
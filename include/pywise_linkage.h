@@ -0,0 +1,48 @@
+#ifndef PYWISE_LINKAGE_H
+#define PYWISE_LINKAGE_H
+
+#define NO_IMPORT_ARRAY
+
+#include "pywise_common.h"
+
+/*******************************************************************************
+
+    Symbol: pywise_single_linkage
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.single_linkage()
+    
+    Python Signature:
+    
+        pywise.single_linkage(source, threads = 0, metric = "euclidean",
+                              dtype = None)
+            -> numpy.ndarray
+            
+    Description:
+    
+        Clusters a set of points, or of collections of points, by single
+        linkage, as scipy.cluster.hierarchy.linkage() would with method
+        "single" from the results of pywise.distances() or pywise.rmsds(),
+        but without ever storing those results, so that memory grows only
+        with the number of points. source, threads, metric and dtype are as
+        for pywise.knn().
+        
+        On success pywise_single_linkage() returns a two-dimensional NumPy
+        array of float64 of shape (N - 1, 4), the linkage matrix in SciPy's
+        form, or of shape (0, 4) if there are fewer than two points. On
+        failure it raises a Python exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_single_linkage
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+);
+
+#endif /* PYWISE_LINKAGE_H */
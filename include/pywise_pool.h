@@ -0,0 +1,155 @@
+#ifndef PYWISE_POOL_H
+#define PYWISE_POOL_H
+
+#define NO_IMPORT_ARRAY
+
+#include "pywise_common.h"
+
+/*******************************************************************************
+
+    Symbol: pywise_pool_resize
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.pool_resize()
+    
+    Python Signature:
+    
+        pywise.pool_resize(threads) -> None
+    
+    Description:
+    
+        Grows or shrinks libpairwise's pool of long-lived worker threads to
+        exactly the requested number of threads.
+        
+        On success returns None. On failure raises a Python exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_pool_resize
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_pool_size
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.pool_size()
+    
+    Python Signature:
+    
+        pywise.pool_size() -> int
+    
+    Description:
+    
+        Returns the number of worker threads currently in libpairwise's pool.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_pool_size
+(
+
+    PyObject* self,
+    PyObject* values
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_pool_shutdown
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.pool_shutdown()
+    
+    Python Signature:
+    
+        pywise.pool_shutdown() -> None
+    
+    Description:
+    
+        Stops and joins every worker thread in libpairwise's pool.
+        
+        On success returns None. On failure raises a Python exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_pool_shutdown
+(
+
+    PyObject* self,
+    PyObject* values
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_pool_set_affinity
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.pool_set_affinity()
+    
+    Python Signature:
+    
+        pywise.pool_set_affinity(affinity) -> None
+        
+    Description:
+    
+        Selects how the workers of libpairwise's pool are placed on the CPUs
+        of the calling thread. affinity is one of the module constants
+        pywise.AFFINITY_NONE, pywise.AFFINITY_CORES or pywise.AFFINITY_NODES.
+        
+        On success returns None. On failure raises a Python exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_pool_set_affinity
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_pool_get_affinity
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.pool_get_affinity()
+    
+    Python Signature:
+    
+        pywise.pool_get_affinity() -> int
+        
+    Description:
+    
+        Returns the pywise.AFFINITY_* constant last selected by
+        pywise.pool_set_affinity(), or pywise.AFFINITY_NONE by default.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_pool_get_affinity
+(
+
+    PyObject* self,
+    PyObject* values
+
+);
+
+#endif /* PYWISE_POOL_H */
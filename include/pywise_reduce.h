@@ -0,0 +1,124 @@
+#ifndef PYWISE_REDUCE_H
+#define PYWISE_REDUCE_H
+
+#define NO_IMPORT_ARRAY
+
+#include "pywise_common.h"
+
+/*******************************************************************************
+
+    Symbol: pywise_pair_stats
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.pair_stats()
+    
+    Python Signature:
+    
+        pywise.pair_stats(source, threads = 0, metric = "euclidean",
+                          dtype = None)
+            -> tuple
+            
+    Description:
+    
+        Finds the minimum, maximum, mean and variance of every pairwise
+        result across a set of points, or of collections of points, without
+        storing the results. source, threads, metric and dtype are as for
+        pywise.knn(). The variance is that of the results themselves, as
+        numpy.var() gives by default.
+        
+        On success pywise_pair_stats() returns a tuple of four floats,
+        (minimum, maximum, mean, variance), all NaN if there are fewer than
+        two points. On failure it raises a Python exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_pair_stats
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_histogram
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.histogram()
+    
+    Python Signature:
+    
+        pywise.histogram(source, bins = 10, range = None, threads = 0,
+                         metric = "euclidean", dtype = None)
+            -> tuple
+            
+    Description:
+    
+        Counts the pairwise results across a set of points, or of
+        collections of points, in each of bins equal bins, without storing
+        the results, as numpy.histogram() would count them. range is a pair
+        of floats (lower, upper) bounding the bins; results outside it are
+        not counted. If range is None, it is the range of the results, found
+        first by pywise.pair_stats(), at the cost of calculating every result
+        twice. source, threads, metric and dtype are as for pywise.knn().
+        
+        On success pywise_histogram() returns a tuple of two NumPy arrays,
+        (counts, edges), of bins counts and bins + 1 bin edges. On failure it
+        raises a Python exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_histogram
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_row_sums
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.row_sums()
+    
+    Python Signature:
+    
+        pywise.row_sums(source, threads = 0, metric = "euclidean",
+                        dtype = None)
+            -> numpy.ndarray
+            
+    Description:
+    
+        Sums for each point, or collection of points, its pairwise results
+        with every other, without storing the results, as the row sums of
+        the full symmetric matrix of results would give. The point with the
+        least sum is the medoid. source, threads, metric and dtype are as for
+        pywise.knn().
+        
+        On success pywise_row_sums() returns a one-dimensional NumPy array of
+        float64 with one element per point. On failure it raises a Python
+        exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_row_sums
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+);
+
+#endif /* PYWISE_REDUCE_H */
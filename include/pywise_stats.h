@@ -0,0 +1,190 @@
+#ifndef PYWISE_STATS_H
+#define PYWISE_STATS_H
+
+#define NO_IMPORT_ARRAY
+
+#include "pywise_common.h"
+
+/*******************************************************************************
+
+    Symbol: pywise_stats_t
+    
+    Type: Structure
+    
+    Intent: Private
+    
+    Description:
+    
+        The timings of one call to a pywise method, name, as it is made:
+        the seconds spent building its input array, convert_seconds,
+        allocating its output array, allocate_seconds, carrying out its
+        calculation in libpairwise, calculate_seconds, and wrapping and
+        releasing its arrays, wrap_seconds. t_mark is the time, of the
+        monotonic clock, at which the phase being timed began. Kept by the
+        method on its own stack, so that calls made at once on different
+        threads don't mix, and recorded once it succeeds by
+        pywise_stats_commit().
+        
+*******************************************************************************/
+
+typedef struct
+pywise_stats
+{
+
+    const char* name;
+    
+    double t_mark;
+    
+    double convert_seconds;
+    double allocate_seconds;
+    double calculate_seconds;
+    double wrap_seconds;
+
+} pywise_stats_t;
+
+/*******************************************************************************
+
+    Symbol: pywise_stats_begin
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Starts timing a call to the pywise method name in stats, with every
+        phase at zero and the first beginning now.
+        
+        Returns nothing, and will not fail.
+        
+*******************************************************************************/
+
+void
+pywise_stats_begin
+(
+
+    pywise_stats_t* stats,
+    
+    const char* name
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_stats_mark
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Ends the phase of stats being timed, adding the seconds it took to
+        phase_seconds, one of the members of stats, and begins the next. Needs
+        no GIL.
+        
+        Returns nothing, and will not fail.
+        
+*******************************************************************************/
+
+void
+pywise_stats_mark
+(
+
+    pywise_stats_t* stats,
+    
+    double* phase_seconds
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_stats_commit
+    
+    Type: Function returning PyObject*
+    
+    Intent: Private
+    
+    Description:
+    
+        Ends the last phase of stats, that of wrapping the result, and unless
+        o_result is a null pointer records stats, together with the
+        statistics libpairwise recorded for the calculation on this thread,
+        as those to be returned by pywise.last_stats(). Must be called on the
+        thread which carried out the calculation, holding the GIL.
+        
+        Returns o_result, so that a method may end with
+        return pywise_stats_commit(&stats, o_result).
+        
+*******************************************************************************/
+
+PyObject*
+pywise_stats_commit
+(
+
+    pywise_stats_t* stats,
+    
+    PyObject* o_result
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_last_stats
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.last_stats()
+    
+    Python Signature:
+    
+        pywise.last_stats() -> dict or None
+        
+    Description:
+    
+        Returns a dictionary describing where the time went in the last call
+        to pywise.distances() or pywise.rmsds() to succeed, on any thread, or
+        None if there has been none. Its keys are,
+        
+            "method" -> The name of the method called.
+            
+            "phases" -> A dictionary of the seconds spent in each phase of
+            the call: "convert", building the input array; "allocate",
+            allocating the output array; "prepare", cutting the calculation
+            into chunks; "spawn", handing the chunks to the worker pool until
+            the last thread had begun, including creating any workers;
+            "compute", from then until every thread had finished; and "wrap",
+            wrapping the results and releasing the input.
+            
+            "seconds" -> The seconds taken by the whole call, from building
+            the input array on.
+            
+            "threads" -> The number of threads which took part.
+            
+            "thread_seconds", "thread_pairs" -> Lists of the wall time of
+            each thread, and of the pairwise calculations it carried out.
+            
+            "pairs" -> The number of pairwise calculations carried out.
+            
+            "pairs_per_second", "gb_per_second" -> The pairwise calculations
+            carried out, and the gigabytes of input and results moved, each
+            counted once, per second of "compute".
+            
+            "imbalance" -> The longest wall time of any thread over the mean
+            of them all; 1.0 if the work was spread perfectly evenly.
+            
+        All times are of the monotonic clock. A call with nothing to
+        calculate records zero threads and pairs, and zero rates.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_last_stats
+(
+
+    PyObject* self,
+    PyObject* unused
+
+);
+
+#endif /* PYWISE_STATS_H */
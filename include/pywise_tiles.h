@@ -0,0 +1,220 @@
+#ifndef PYWISE_TILES_H
+#define PYWISE_TILES_H
+
+#define NO_IMPORT_ARRAY
+
+#include "pywise_common.h"
+
+/*******************************************************************************
+
+    Symbol: pywise_tiles_t
+    
+    Type: Structure
+    
+    Intent: Private
+    
+    Description:
+    
+        The Python object returned by pywise.tiles(): an iterator over the
+        tiles of a libpairwise stream, stream, which is null once the
+        iterator is exhausted or has failed. a_collections and view are the
+        input array from which the stream calculates, and its buffer view, as
+        returned by pywise_build_points_array() or
+        pywise_build_collections_array(); both are kept until the stream is
+        closed. n_type is the NumPy type of the results. b_busy is set while
+        a thread waits, without the GIL, for the next tile.
+        
+*******************************************************************************/
+
+typedef struct
+pywise_tiles
+{
+
+    PyObject_HEAD
+    
+    pairwise_stream_t* stream;
+    
+    void* a_collections;
+    
+    Py_buffer view;
+    
+    int n_type;
+    
+    int b_busy;
+
+} pywise_tiles_t;
+
+/*******************************************************************************
+
+    Symbol: pywise_tiles_type
+    
+    Type: PyTypeObject
+    
+    Intent: Private
+    
+    Description:
+    
+        The Python type of pywise_tiles_t, pywise.Tiles, whose members are
+        set by pywise_tiles_prepare_type().
+        
+*******************************************************************************/
+
+extern PyTypeObject
+pywise_tiles_type;
+
+/*******************************************************************************
+
+    Symbol: pywise_tiles
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.tiles()
+    
+    Python Signature:
+    
+        pywise.tiles(source, tile = 0, queue = 0, threads = 0,
+                     metric = "euclidean", dtype = None)
+            -> iterator
+            
+    Description:
+    
+        Starts calculating all pairwise results across a set of points, or of
+        collections of points, in any-dimensional space, and returns an
+        iterator which yields them tile by tile as threads finish them, so
+        that matrices of results far larger than memory can be reduced,
+        thresholded or written out as they are made.
+        
+        Each tile is a tuple, ((row_lower, row_upper), (column_lower,
+        column_upper), block), in which block is a two-dimensional NumPy
+        array holding the results between every point or collection from
+        row_lower up to but excluding row_upper and every one from
+        column_lower up to but excluding column_upper. Tiles cover the upper
+        triangle of the square matrix of results once each, in no particular
+        order; tiles on its diagonal are complete, with zeros on the
+        diagonal.
+        
+        Tiles span at most tile points or collections a side, and at most
+        queue tiles are in flight at once, calculations pausing whenever the
+        reader falls behind; zero for either chooses it automatically. source,
+        threads, metric and dtype are as for pywise.knn().
+        
+        On success pywise_tiles() returns a pywise.Tiles iterator. On failure
+        it raises a Python exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_tiles
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_tiles_next
+    
+    Type: Function returning PyObject*
+    
+    Intent: Private
+    
+    Description:
+    
+        The tp_iternext of pywise_tiles_type. Waits for the next tile of the
+        stream of self, without holding the GIL, and copies it into a new
+        NumPy array.
+        
+        On success returns the tuple described for pywise_tiles(). Once every
+        tile has been returned closes the stream and returns a null pointer
+        without setting an exception, which ends the iteration. On failure
+        closes the stream, returns a null pointer and sets a Python
+        exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_tiles_next
+(
+
+    PyObject* self
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_tiles_close
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Closes the stream of tiles, if it is not already closed, without
+        holding the GIL, and releases its input array.
+        
+        Returns the libpairwise return code of pairwise_stream_close(), or
+        PAIRWISE_RETURN_SUCCESS if tiles was already closed.
+        
+*******************************************************************************/
+
+int
+pywise_tiles_close
+(
+
+    pywise_tiles_t* tiles
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_tiles_dealloc
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        The tp_dealloc of pywise_tiles_type. Closes the stream of self, if it
+        is still open, and frees self. Tiles not yet read are discarded, and
+        the threads calculating them stopped.
+        
+        Returns nothing, and will not fail.
+        
+*******************************************************************************/
+
+void
+pywise_tiles_dealloc
+(
+
+    PyObject* self
+
+);
+
+/*******************************************************************************
+
+    Symbol: pywise_tiles_prepare_type
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Sets the members of pywise_tiles_type and readies it for use. Called
+        once, by initpywise().
+        
+        On success returns integer zero. On failure returns integer minus one
+        and sets a Python exception.
+        
+*******************************************************************************/
+
+int
+pywise_tiles_prepare_type
+(void);
+
+#endif /* PYWISE_TILES_H */
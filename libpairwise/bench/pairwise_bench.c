@@ -0,0 +1,722 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "pairwise.h"
+
+/*******************************************************************************
+
+    pairwise_bench
+    
+    A benchmark of libpairwise's calculation kernels and of the scaling of
+    its launches over threads, free of the noise of any Python wrapper.
+    
+    Usage: ./pairwise_bench [REPETITIONS [WARMUPS [THREADS]]]
+    
+    Times pairwise_distances() and pairwise_rmsds(), in double and single
+    precision, with the kernels of every instruction set architecture the
+    host supports, over every shape of input in bench_cases and for one, two,
+    four and so on up to THREADS threads. Each combination is called WARMUPS
+    times untimed, then REPETITIONS times timed, and one line of CSV is
+    written to standard output describing it; see bench_report(). The
+    defaults are ten repetitions, two warm-ups and as many threads as
+    pairwise_threads_available() finds.
+    
+    Built by "make bench" in the libpairwise directory.
+    
+*******************************************************************************/
+
+/*******************************************************************************
+
+    Symbol: bench_case_t, bench_cases
+    
+    Type: Structure and static array of structures
+    
+    Intent: Private
+    
+    Description:
+    
+        One shape of input to time: b_rmsds selects pairwise_rmsds() rather
+        than pairwise_distances(), between n_collections collections of
+        n_points points of n_coordinates coordinates. pairwise_distances()
+        takes one point per collection, so n_points is one for it.
+        
+        bench_cases covers the specialised distance row drivers for two,
+        three, four and eight coordinates and the generic one, the
+        specialised RMSD row drivers for two and four points, collections
+        both under and over _PAIRWISE_GEMM_MIN_ELEMENTS coordinates in all,
+        and for each two sizes, to tell per-call overheads from throughput.
+        
+*******************************************************************************/
+
+typedef struct
+bench_case
+{
+
+    int b_rmsds;
+    
+    size_t n_collections;
+    size_t n_points;
+    size_t n_coordinates;
+
+} bench_case_t;
+
+static const bench_case_t
+bench_cases[] = {
+    
+    {0, 1000, 1, 2},
+    {0, 1000, 1, 3},
+    {0, 1000, 1, 4},
+    {0, 1000, 1, 8},
+    {0, 1000, 1, 16},
+    {0, 1000, 1, 64},
+    {0, 3000, 1, 2},
+    {0, 3000, 1, 3},
+    {0, 3000, 1, 4},
+    {0, 3000, 1, 8},
+    {0, 3000, 1, 16},
+    {0, 3000, 1, 64},
+    {1, 300, 2, 3},
+    {1, 300, 4, 3},
+    {1, 300, 10, 3},
+    {1, 300, 100, 3},
+    {1, 1000, 2, 3},
+    {1, 1000, 4, 3},
+    {1, 1000, 10, 3},
+    {1, 1000, 100, 3}
+
+};
+
+/*******************************************************************************
+
+    Symbol: bench_isas, bench_isa_names
+    
+    Type: Static arrays
+    
+    Intent: Private
+    
+    Description:
+    
+        The instruction set architectures whose kernels are timed, where the
+        host supports them, and the names by which they are reported.
+        
+*******************************************************************************/
+
+static const int
+bench_isas[] = {
+    
+    PAIRWISE_ISA_SCALAR,
+    PAIRWISE_ISA_SSE2,
+    PAIRWISE_ISA_AVX2,
+    PAIRWISE_ISA_AVX512
+
+};
+
+static const char*
+bench_isa_names[] = {
+    
+    "scalar",
+    "sse2",
+    "avx2",
+    "avx512"
+
+};
+
+/*******************************************************************************
+
+    Symbol: bench_clock
+    
+    Type: Static function returning double
+    
+    Intent: Private
+    
+    Description:
+    
+        Returns the time, in seconds, of the monotonic clock. Only
+        differences between its values are meaningful.
+        
+*******************************************************************************/
+
+static double
+bench_clock
+(void)
+{
+
+    struct timespec now;
+    
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    
+    return now.tv_sec + (now.tv_nsec * 1e-9);
+
+}
+
+/*******************************************************************************
+
+    Symbol: bench_compare
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Orders the doubles pointed to by a and b for qsort(), ascending.
+        
+*******************************************************************************/
+
+static int
+bench_compare
+(
+
+    const void* a,
+    const void* b
+
+)
+{
+
+    double value_a;
+    double value_b;
+    
+    value_a = *(const double*)a;
+    value_b = *(const double*)b;
+    
+    return (value_a > value_b) - (value_a < value_b);
+
+}
+
+/*******************************************************************************
+
+    Symbol: bench_percentile
+    
+    Type: Static function returning double
+    
+    Intent: Private
+    
+    Description:
+    
+        Sorts the n_values doubles of a_values, at least one, and returns the
+        nearest-rank percentile of them at fraction, between zero and one: the
+        least value which at least that fraction of all values do not exceed.
+        
+*******************************************************************************/
+
+static double
+bench_percentile
+(
+
+    double* a_values,
+    size_t n_values,
+    
+    double fraction
+
+)
+{
+
+    size_t i_value;
+    
+    qsort(a_values, n_values, sizeof(double), bench_compare);
+    
+    i_value = (size_t)(fraction * n_values + 0.999999);
+    
+    if (i_value) {
+        
+        i_value --;
+    
+    }
+    
+    if (i_value >= n_values) {
+        
+        i_value = n_values - 1;
+    
+    }
+    
+    return *(a_values + i_value);
+
+}
+
+/*******************************************************************************
+
+    Symbol: bench_call
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Carries out the calculation described by bench_case once, on
+        a_input, storing its results in a_output, over n_threads threads; in
+        single precision if b_float is set, when both arrays hold floats.
+        
+        Returns whatever the libpairwise function called returns.
+        
+*******************************************************************************/
+
+static int
+bench_call
+(
+
+    const bench_case_t* bench_case,
+    
+    int b_float,
+    
+    void* a_input,
+    void* a_output,
+    
+    size_t n_threads
+
+)
+{
+
+    if (bench_case->b_rmsds && b_float) {
+        
+        return pairwise_rmsds_float(bench_case->n_collections,
+                                    bench_case->n_points,
+                                    bench_case->n_coordinates,
+                                    a_input,
+                                    a_output,
+                                    n_threads);
+    
+    }
+    
+    if (bench_case->b_rmsds) {
+        
+        return pairwise_rmsds(bench_case->n_collections,
+                              bench_case->n_points,
+                              bench_case->n_coordinates,
+                              a_input,
+                              a_output,
+                              n_threads);
+    
+    }
+    
+    if (b_float) {
+        
+        return pairwise_distances_float(bench_case->n_collections,
+                                        bench_case->n_coordinates,
+                                        a_input,
+                                        a_output,
+                                        n_threads);
+    
+    }
+    
+    return pairwise_distances(bench_case->n_collections,
+                              bench_case->n_coordinates,
+                              a_input,
+                              a_output,
+                              n_threads);
+
+}
+
+/*******************************************************************************
+
+    Symbol: bench_report
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Times the calculation described by bench_case, in single precision
+        if b_float is set, on a_input into a_output over n_threads threads,
+        n_warmups times untimed and then n_repetitions times, at least one,
+        and writes one line of CSV to standard output describing it, as
+        named by the header written by main().
+        
+        median_seconds and p95_seconds are the median and 95th percentile of
+        the wall times of the repetitions. pairs_per_second, gflop_per_second
+        and gb_per_second divide by the median the pairwise calculations
+        carried out, their floating-point operations (a subtraction, a
+        multiplication and an addition per coordinate of each collection,
+        ignoring the square root and division which end each calculation)
+        and the bytes of input and results reported by pairwise_stats_last(),
+        each counted once. imbalance is the median over repetitions of the
+        longest wall time of any thread over the mean of them all.
+        
+        a_seconds and a_imbalances are scratch space of n_repetitions
+        doubles each.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns the libpairwise error code of the
+        calculation which failed, and writes nothing.
+        
+*******************************************************************************/
+
+static int
+bench_report
+(
+
+    const bench_case_t* bench_case,
+    
+    int b_float,
+    
+    const char* isa_name,
+    
+    void* a_input,
+    void* a_output,
+    
+    size_t n_threads,
+    
+    size_t n_warmups,
+    size_t n_repetitions,
+    
+    double* a_seconds,
+    double* a_imbalances
+
+)
+{
+
+    pairwise_stats_t stats;
+    
+    int n_return;
+    
+    double t_start;
+    
+    double median;
+    double p95;
+    double longest;
+    double total;
+    
+    size_t n_pairs;
+    size_t n_bytes;
+    
+    size_t i_call;
+    size_t i_thread;
+    
+    for (i_call = 0; i_call < n_warmups; i_call ++) {
+        
+        n_return = bench_call(bench_case, b_float, a_input, a_output, n_threads);
+        
+        if (n_return) {
+            
+            return n_return;
+        
+        }
+    
+    }
+    
+    n_bytes = 0;
+    
+    for (i_call = 0; i_call < n_repetitions; i_call ++) {
+        
+        t_start = bench_clock();
+        
+        n_return = bench_call(bench_case, b_float, a_input, a_output, n_threads);
+        
+        *(a_seconds + i_call) = bench_clock() - t_start;
+        
+        if (n_return) {
+            
+            return n_return;
+        
+        }
+        
+        pairwise_stats_last(&stats);
+        
+        n_bytes = stats.n_bytes;
+        
+        longest = 0;
+        total = 0;
+        
+        for (i_thread = 0; i_thread < stats.n_threads; i_thread ++) {
+            
+            if (*(stats.a_thread_seconds + i_thread) > longest) {
+                
+                longest = *(stats.a_thread_seconds + i_thread);
+            
+            }
+            
+            total += *(stats.a_thread_seconds + i_thread);
+        
+        }
+        
+        *(a_imbalances + i_call) = total > 0 ? longest / (total / stats.n_threads) : 1.0;
+    
+    }
+    
+    n_pairs = bench_case->n_collections * (bench_case->n_collections - 1) / 2;
+    
+    median = bench_percentile(a_seconds, n_repetitions, 0.5);
+    p95 = bench_percentile(a_seconds, n_repetitions, 0.95);
+    
+    printf("%s,%s,%s,%zu,%zu,%zu,%zu,%zu,%zu,%.9f,%.9f,%.6g,%.6g,%.6g,%.4f\n",
+           bench_case->b_rmsds ? "rmsds" : "distances",
+           b_float ? "float32" : "float64",
+           isa_name,
+           n_threads,
+           bench_case->n_collections,
+           bench_case->n_points,
+           bench_case->n_coordinates,
+           n_pairs,
+           n_repetitions,
+           median,
+           p95,
+           n_pairs / median,
+           3.0 * n_pairs * bench_case->n_points * bench_case->n_coordinates / median / 1e9,
+           n_bytes / median / 1e9,
+           bench_percentile(a_imbalances, n_repetitions, 0.5));
+           
+    fflush(stdout);
+    
+    return PAIRWISE_RETURN_SUCCESS;
+
+}
+
+/*******************************************************************************
+
+    Symbol: bench_parse
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Parses text as a non-negative integer into n_value.
+        
+        Returns integer zero on success, or integer one if text is not
+        entirely a non-negative integer.
+        
+*******************************************************************************/
+
+static int
+bench_parse
+(
+
+    const char* text,
+    
+    size_t* n_value
+
+)
+{
+
+    char* end;
+    
+    long value;
+    
+    value = strtol(text, &end, 10);
+    
+    if (end == text || *end || value < 0) {
+        
+        return 1;
+    
+    }
+    
+    *n_value = value;
+    
+    return 0;
+
+}
+
+/*******************************************************************************
+
+    Symbol: main
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Parses the arguments described above, writes the CSV header, and
+        then reports every combination of case, precision, instruction set
+        architecture and thread count in turn, restoring the instruction set
+        architecture selected at load time once done.
+        
+        Returns integer zero on success. On bad arguments, or once any
+        calculation fails, writes why to standard error and returns integer
+        one.
+        
+*******************************************************************************/
+
+int
+main
+(
+
+    int n_arguments,
+    char** a_arguments
+
+)
+{
+
+    const bench_case_t* bench_case;
+    
+    void* a_input;
+    void* a_output;
+    
+    double* a_seconds;
+    double* a_imbalances;
+    
+    size_t n_repetitions;
+    size_t n_warmups;
+    size_t n_threads_max;
+    size_t n_threads;
+    
+    size_t n_elements;
+    size_t n_results;
+    
+    int n_return;
+    int b_float;
+    
+    size_t i_case;
+    size_t i_isa;
+    size_t i_element;
+    
+    n_repetitions = 10;
+    n_warmups = 2;
+    n_threads_max = pairwise_threads_available();
+    
+    if (n_arguments > 4
+    || (n_arguments > 1 && bench_parse(*(a_arguments + 1), &n_repetitions))
+    || (n_arguments > 2 && bench_parse(*(a_arguments + 2), &n_warmups))
+    || (n_arguments > 3 && bench_parse(*(a_arguments + 3), &n_threads_max))
+    ||  !n_repetitions
+    ||  !n_threads_max) {
+        
+        fprintf(stderr, "Usage: %s [REPETITIONS [WARMUPS [THREADS]]]\n"
+                        "REPETITIONS and THREADS must be greater than zero.\n",
+                        *a_arguments);
+                        
+        return 1;
+    
+    }
+    
+    a_seconds = malloc(n_repetitions * sizeof(double));
+    a_imbalances = malloc(n_repetitions * sizeof(double));
+    
+    if (!a_seconds || !a_imbalances) {
+        
+        free(a_seconds);
+        free(a_imbalances);
+        
+        fprintf(stderr, "%s: Failed to allocate memory.\n", *a_arguments);
+        
+        return 1;
+    
+    }
+    
+    printf("method,dtype,isa,threads,n_collections,n_points,n_coordinates,"
+           "pairs,repetitions,median_seconds,p95_seconds,pairs_per_second,"
+           "gflop_per_second,gb_per_second,imbalance\n");
+           
+    srand(1);
+    
+    n_return = PAIRWISE_RETURN_SUCCESS;
+    
+    for (i_case = 0;
+         i_case < sizeof(bench_cases) / sizeof(bench_case_t) && !n_return;
+         i_case ++) {
+             
+        bench_case = bench_cases + i_case;
+        
+        n_elements = bench_case->n_collections
+                   * bench_case->n_points
+                   * bench_case->n_coordinates;
+                   
+        n_results = bench_case->n_collections * (bench_case->n_collections - 1) / 2;
+        
+        /*
+        *   Allocate for doubles, which serve for floats too.
+        */
+        
+        a_input = malloc(n_elements * sizeof(double));
+        a_output = malloc(n_results * sizeof(double));
+        
+        if (!a_input || !a_output) {
+            
+            free(a_input);
+            free(a_output);
+            
+            n_return = PAIRWISE_RETURN_MALLOC_FAIL;
+            
+            break;
+        
+        }
+        
+        for (b_float = 0; b_float < 2 && !n_return; b_float ++) {
+            
+            for (i_element = 0; i_element < n_elements; i_element ++) {
+                
+                if (b_float) {
+                    
+                    *((float*)a_input + i_element) = (float)rand() / RAND_MAX;
+                
+                } else {
+                    
+                    *((double*)a_input + i_element) = (double)rand() / RAND_MAX;
+                
+                }
+            
+            }
+            
+            for (i_isa = 0;
+                 i_isa < sizeof(bench_isas) / sizeof(int) && !n_return;
+                 i_isa ++) {
+                     
+                if (!pairwise_isa_supported(*(bench_isas + i_isa))) {
+                    
+                    continue;
+                
+                }
+                
+                n_return = pairwise_set_isa(*(bench_isas + i_isa));
+                
+                /*
+                *   Double the threads each time, finishing on the most.
+                */
+                
+                for (n_threads = 1; !n_return; n_threads *= 2) {
+                    
+                    if (n_threads > n_threads_max) {
+                        
+                        n_threads = n_threads_max;
+                    
+                    }
+                    
+                    n_return = bench_report(bench_case,
+                                            b_float,
+                                            *(bench_isa_names + i_isa),
+                                            a_input,
+                                            a_output,
+                                            n_threads,
+                                            n_warmups,
+                                            n_repetitions,
+                                            a_seconds,
+                                            a_imbalances);
+                                            
+                    if (n_threads == n_threads_max) {
+                        
+                        break;
+                    
+                    }
+                
+                }
+            
+            }
+        
+        }
+        
+        free(a_input);
+        free(a_output);
+    
+    }
+    
+    pairwise_set_isa(PAIRWISE_ISA_AUTO);
+    
+    free(a_seconds);
+    free(a_imbalances);
+    
+    if (n_return) {
+        
+        fprintf(stderr, "%s: Failed with libpairwise error code %d.\n",
+                *a_arguments, n_return);
+                
+        return 1;
+    
+    }
+    
+    return 0;
+
+}
@@ -4,10 +4,13 @@
 /* Shared library definitions. */
 
 #include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
 #include <stdio.h>
 #include <pthread.h>
 #include <errno.h>
 #include <math.h>
+#include <float.h>
 
 /* libpairwise definitions. */
 
@@ -15,12 +18,51 @@
 
 #define _PAIRWISE_SQUARE(x) ((x) * (x))
 
+/* Public opaque stream of tiles, declared early for the headers using it. */
+typedef struct _pairwise_stream pairwise_stream_t;
+
+/* Public opaque future of a calculation, declared early for its users. */
+typedef struct _pairwise_future pairwise_future_t;
+
 /* Public return codes for success and failures. */
 #include "pairwise_error.h"
 
+/* Public instruction set selection and private calculation kernels. */
+#include "pairwise_simd.h"
+
+/* Public worker pool management and private task dispatch. */
+#include "pairwise_pool.h"
+
+/* Public detection of the number of threads to use. */
+#include "pairwise_threads.h"
+
+/* Public statistics of the last calculation, and private recording. */
+#include "pairwise_stats.h"
+
 /* Private dependencies for any public function carrying out calculations. */
 #include "pairwise_launch.h"
 
+/* Private dependencies for calculating wide collections by norm expansion. */
+#include "pairwise_gemm.h"
+
+/* Private dependencies for any public function keeping results in a cutoff. */
+#include "pairwise_cutoff.h"
+
+/* Private dependencies for any public function keeping nearest neighbours. */
+#include "pairwise_knn.h"
+
+/* Private dependencies for any public function reducing results. */
+#include "pairwise_reduce.h"
+
+/* Private dependencies for any public function clustering by single linkage. */
+#include "pairwise_linkage.h"
+
+/* Public reading of streams, and private dependencies for creating them. */
+#include "pairwise_stream.h"
+
+/* Public following and waiting on futures, and private submission. */
+#include "pairwise_future.h"
+
 /* Public pairwise_distances() and private dependencies. */
 #include "pairwise_distances.h"
 
@@ -30,4 +72,7 @@
 /* Public pairwise_index(). */
 #include "pairwise_index.h"
 
+/* Public creation and description of results files. */
+#include "pairwise_file.h"
+
 #endif /* PAIRWISE_H */
@@ -0,0 +1,239 @@
+#ifndef PAIRWISE_CUTOFF_H
+#define PAIRWISE_CUTOFF_H
+
+#include "pairwise.h"
+
+/*******************************************************************************
+
+    Symbol: _PAIRWISE_CUTOFF_HITS_INITIAL
+    
+    Type: Preprocessor constant
+    
+    Intent: Private
+    
+    Description:
+    
+        The number of hits for which each thread's _pairwise_hits_t first
+        allocates room. Thereafter room is doubled whenever it runs out.
+        
+*******************************************************************************/
+
+#define _PAIRWISE_CUTOFF_HITS_INITIAL 1024
+
+struct _pairwise_job;
+
+/*******************************************************************************
+
+    Symbol: _pairwise_hit_t
+    
+    Type: Structure
+    
+    Intent: Private
+    
+    Description:
+    
+        Records one hit: a pairwise calculation, between collections
+        i_collection_a and i_collection_b, whose result was no greater than
+        the cutoff. Results of calculations on floats are widened to double.
+        
+*******************************************************************************/
+
+typedef struct
+_pairwise_hit
+{
+
+    size_t i_collection_a;
+    size_t i_collection_b;
+    
+    double result;
+
+} _pairwise_hit_t;
+
+/*******************************************************************************
+
+    Symbol: _pairwise_hits_t
+    
+    Type: Structure
+    
+    Intent: Private
+    
+    Description:
+    
+        The sink of one thread taking part in _pairwise_launch_cutoff(): a
+        growable array, a_hits, of n_hits hits with room for l_hits. n_return
+        is PAIRWISE_RETURN_SUCCESS unless growing a_hits failed, after which
+        no more hits are recorded. Padded to a cache line so that threads
+        appending to neighbouring _pairwise_hits_t don't contend.
+        
+*******************************************************************************/
+
+typedef struct
+_pairwise_hits
+{
+
+    _pairwise_hit_t* a_hits;
+    
+    size_t n_hits;
+    size_t l_hits;
+    
+    int n_return;
+    
+    char padding[64 - sizeof(_pairwise_hit_t*) - (2 * sizeof(size_t)) - sizeof(int)];
+
+} _pairwise_hits_t;
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_row_cutoff, _pairwise_launch_row_cutoff_float
+    
+    Type: Functions returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Row drivers for job->f_row. Carry out the pairwise calculations
+        between collection i_collection_a of job and each of collections
+        i_collection_b_lower up to but excluding i_collection_b_upper, by
+        calling job->f_calculation on doubles or job->f_calculation_float on
+        floats respectively, and append those whose results are no greater
+        than job->cutoff to sink, a _pairwise_hits_t. a_results_row is
+        ignored.
+        
+        On success return nothing. On failure to grow sink, record
+        PAIRWISE_RETURN_MALLOC_FAIL in it.
+        
+*******************************************************************************/
+
+void
+_pairwise_launch_row_cutoff
+(
+
+    struct _pairwise_job* job,
+    
+    void* sink,
+    
+    size_t i_collection_a,
+    size_t i_collection_b_lower,
+    size_t i_collection_b_upper,
+    
+    void* a_results_row
+
+);
+
+void
+_pairwise_launch_row_cutoff_float
+(
+
+    struct _pairwise_job* job,
+    
+    void* sink,
+    
+    size_t i_collection_a,
+    size_t i_collection_b_lower,
+    size_t i_collection_b_upper,
+    
+    void* a_results_row
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_cutoff
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Applies a calculation function, f_calculation, to all pairwise
+        combinations of collections in a set of collections, a_collections,
+        as _pairwise_launch() does, but keeps only those results no greater
+        than cutoff, in compressed sparse row (CSR) form.
+        
+        n_collections, n_points, n_coordinates, a_collections and n_threads
+        are as for _pairwise_launch(). On success allocates three arrays and
+        stores pointers to them in a_indptr, a_indices and a_results; the
+        caller must free all three with free().
+        
+        *a_indptr holds n_collections + 1 offsets, and *a_indices and
+        *a_results each hold (*a_indptr)[n_collections] elements. For each
+        collection i, elements (*a_indptr)[i] up to but excluding
+        (*a_indptr)[i + 1] of *a_indices hold, in increasing order, every
+        collection j > i for which the result of f_calculation on i and j is
+        no greater than cutoff, and the same elements of *a_results hold
+        those results.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code,
+        and allocates nothing.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_cutoff
+(
+
+    double (*f_calculation)(size_t n_points,
+                            size_t n_coordinates,
+                            double* collection_a,
+                            double* collection_b),
+                            
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    
+    double cutoff,
+    
+    size_t** a_indptr,
+    size_t** a_indices,
+    double** a_results,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_cutoff_float
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch_cutoff(), but for a calculation on collections of
+        floats, f_calculation, whose kept results are stored as floats.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_cutoff_float
+(
+
+    float (*f_calculation)(size_t n_points,
+                           size_t n_coordinates,
+                           float* collection_a,
+                           float* collection_b),
+                           
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    
+    float cutoff,
+    
+    size_t** a_indptr,
+    size_t** a_indices,
+    float** a_results,
+    
+    size_t n_threads
+
+);
+
+#endif /* PAIRWISE_CUTOFF_H */
@@ -35,4 +35,22 @@
 #define PAIRWISE_RETURN_ERROR_ICOLLECTIONSAME 13
 #define PAIRWISE_RETURN_ERROR_NTHREADS 14
 
+#define PAIRWISE_RETURN_ERROR_ISA 15
+
+#define PAIRWISE_RETURN_ERROR_NNEIGHBOURS 16
+
+#define PAIRWISE_RETURN_ERROR_NCOORDINATES 17
+
+#define PAIRWISE_RETURN_ERROR_FILE 18
+#define PAIRWISE_RETURN_ERROR_FILE_FORMAT 19
+
+#define PAIRWISE_RETURN_ERROR_RANGE 20
+
+#define PAIRWISE_RETURN_ERROR_IRESULT 21
+
+#define PAIRWISE_RETURN_ERROR_AFFINITY 22
+
+#define PAIRWISE_RETURN_ERROR_TIMEOUT 23
+#define PAIRWISE_RETURN_ERROR_CANCELLED 24
+
 #endif /* PAIRWISE_ERROR_H */
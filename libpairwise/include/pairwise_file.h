@@ -0,0 +1,162 @@
+#ifndef PAIRWISE_FILE_H
+#define PAIRWISE_FILE_H
+
+#include "pairwise.h"
+
+/*******************************************************************************
+
+    Symbol: PAIRWISE_FILE_*
+    
+    Type: Family of preprocessor constants
+    
+    Intent: Public
+    
+    Description:
+    
+        The layout of a libpairwise results file. A file begins with a header
+        of PAIRWISE_FILE_HEADER bytes, laid out as follows, followed
+        immediately by the condensed results themselves.
+        
+            Bytes  0 to  7: PAIRWISE_FILE_MAGIC, without a terminating null.
+            Bytes  8 to 15: PAIRWISE_FILE_VERSION, little-endian.
+            Bytes 16 to 23: The number of collections, little-endian.
+            Bytes 24 to 31: The type of the results as a NumPy dtype string,
+                            such as "<f8" or "<f4", padded with nulls.
+            Bytes 32 to 47: The name of the metric which gave the results,
+                            such as "euclidean" or "rmsd", padded with nulls.
+            Bytes 48 to 55: The offset of the results from the start of the
+                            file, which is PAIRWISE_FILE_HEADER, little-endian.
+            Bytes 56 to 63: Reserved, and zero.
+            
+        A file can therefore be read without libpairwise, for instance with
+        numpy.memmap().
+        
+*******************************************************************************/
+
+#define PAIRWISE_FILE_MAGIC "PAIRWISE"
+
+#define PAIRWISE_FILE_VERSION 1
+
+#define PAIRWISE_FILE_HEADER 64
+
+#define PAIRWISE_FILE_METRIC_LENGTH 16
+
+/*******************************************************************************
+
+    Symbol: pairwise_file_create
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Creates a results file at path, replacing any file already there,
+        with room for the results of all pairwise calculations across
+        n_collections collections as elements of s_element bytes, which must
+        be sizeof(float) or sizeof(double). metric names the calculation, in
+        fewer than PAIRWISE_FILE_METRIC_LENGTH characters, and is recorded in
+        the header along with n_collections and s_element.
+        
+        The results part of the file is mapped into memory, and a pointer to
+        it is stored in a_results, to be passed to any libpairwise function
+        as its output array in place of one allocated with malloc(). Its
+        pages are written back to the file by the operating system as they
+        are filled, so the results need never be held in memory all at once.
+        The caller must pass a_results to pairwise_file_close() once done.
+        
+        Any file already at path is unlinked first rather than truncated, so
+        an array mapped from it, even the input of the calculation, keeps its
+        contents. The space of the whole file is reserved on disk before it
+        is mapped, where the file system allows it, so that a full disk is
+        reported here rather than as SIGBUS part way through the calculation.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code,
+        leaving errno set if the file could not be created, which is ENOSPC
+        if there was not room for it, and maps nothing.
+        
+*******************************************************************************/
+
+int
+pairwise_file_create
+(
+
+    const char* path,
+    
+    size_t n_collections,
+    size_t s_element,
+    
+    const char* metric,
+    
+    void** a_results
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_file_close
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Writes back to its file every page of a_results, as returned by
+        pairwise_file_create(), which has not already been, and unmaps it.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns PAIRWISE_RETURN_ERROR_FILE,
+        leaving errno set; a_results is unmapped nonetheless.
+        
+*******************************************************************************/
+
+int
+pairwise_file_close
+(
+
+    void* a_results
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_file_describe
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Reads the header of the results file at path, and stores the number
+        of collections whose results it holds in n_collections, the size of
+        each result in s_element, the name of the metric in metric, which
+        must have room for PAIRWISE_FILE_METRIC_LENGTH characters, and the
+        offset of the results from the start of the file in n_offset.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure to read the file returns
+        PAIRWISE_RETURN_ERROR_FILE, leaving errno set, and if it is not a
+        results file of this version, or is too short to hold its results,
+        returns PAIRWISE_RETURN_ERROR_FILE_FORMAT.
+        
+*******************************************************************************/
+
+int
+pairwise_file_describe
+(
+
+    const char* path,
+    
+    size_t* n_collections,
+    size_t* s_element,
+    
+    char* metric,
+    
+    size_t* n_offset
+
+);
+
+#endif /* PAIRWISE_FILE_H */
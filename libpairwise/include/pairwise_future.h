@@ -0,0 +1,241 @@
+#ifndef PAIRWISE_FUTURE_H
+#define PAIRWISE_FUTURE_H
+
+#include "pairwise.h"
+
+/*******************************************************************************
+
+    Symbol: pairwise_future_done
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Finds whether every thread of future has stopped, whether because its
+        calculation is complete or because it was cancelled, without waiting.
+        
+        Returns integer one if so, or integer zero if threads are still
+        carrying out pairwise calculations. Not expected to fail.
+        
+*******************************************************************************/
+
+int
+pairwise_future_done
+(
+
+    pairwise_future_t* future
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_future_progress
+    
+    Type: Function returning void
+    
+    Intent: Public
+    
+    Description:
+    
+        Stores in n_done the number of pairwise calculations of future
+        carried out so far, and in n_total the number it has in all. Either
+        may be a null pointer if not wanted. n_done is counted a chunk of
+        calculations at a time, and only reaches n_total once the
+        calculation is complete.
+        
+        Returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+void
+pairwise_future_progress
+(
+
+    pairwise_future_t* future,
+    
+    size_t* n_done,
+    size_t* n_total
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_future_cancel
+    
+    Type: Function returning void
+    
+    Intent: Public
+    
+    Description:
+    
+        Asks the threads of future to stop once they finish the chunk of
+        pairwise calculations each is carrying out, and returns at once. Any
+        thread may cancel a future, at any time, any number of times; a
+        future which is already done is left as it is. The results of a
+        cancelled future are incomplete, and must not be relied on.
+        
+        Returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+void
+pairwise_future_cancel
+(
+
+    pairwise_future_t* future
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_future_wait
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Waits for up to timeout seconds for every thread of future to stop. A
+        negative timeout waits for as long as it takes, and a timeout of zero
+        returns at once.
+        
+        Returns PAIRWISE_RETURN_SUCCESS which is always equivalent to integer
+        zero if the calculation is complete, so that every result has been
+        stored. Returns PAIRWISE_RETURN_ERROR_TIMEOUT if threads are still
+        carrying it out once timeout has passed, and
+        PAIRWISE_RETURN_ERROR_CANCELLED if they stopped early because it was
+        cancelled.
+        
+*******************************************************************************/
+
+int
+pairwise_future_wait
+(
+
+    pairwise_future_t* future,
+    
+    double timeout
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_future_close
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Cancels future if it is not yet done, waits for its threads to stop,
+        and frees it. Its input and output arrays may be freed once this
+        function returns, and not before.
+        
+        Returns PAIRWISE_RETURN_SUCCESS which is always equivalent to integer
+        zero if the calculation was complete, or
+        PAIRWISE_RETURN_ERROR_CANCELLED if it was not. future is freed either
+        way.
+        
+*******************************************************************************/
+
+int
+pairwise_future_close
+(
+
+    pairwise_future_t* future
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_submit
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Starts applying a calculation function, f_calculation, to all
+        pairwise combinations of collections in a set of collections,
+        a_collections, storing the results in a_results as _pairwise_launch()
+        does, but on the libpairwise worker pool alone, and returns at once
+        with a new future, a pointer to which is stored in future, through
+        which the caller can follow, cancel and wait for the calculation.
+        
+        n_collections, n_points, n_coordinates, a_collections, a_results and
+        n_threads are as for _pairwise_launch(). a_collections and a_results
+        must outlive the future.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero; the caller must then pass the future to
+        pairwise_future_close(). On failure returns a non-zero libpairwise
+        error code, and creates no future.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_submit
+(
+
+    double (*f_calculation)(size_t n_points,
+                            size_t n_coordinates,
+                            double* collection_a,
+                            double* collection_b),
+                            
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    double* a_results,
+    
+    size_t n_threads,
+    
+    pairwise_future_t** future
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_submit_float
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch_submit(), but for a calculation on collections of
+        floats, f_calculation, whose results are stored in an output array of
+        floats.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_submit_float
+(
+
+    float (*f_calculation)(size_t n_points,
+                           size_t n_coordinates,
+                           float* collection_a,
+                           float* collection_b),
+                           
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    float* a_results,
+    
+    size_t n_threads,
+    
+    pairwise_future_t** future
+
+);
+
+#endif /* PAIRWISE_FUTURE_H */
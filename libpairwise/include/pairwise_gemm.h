@@ -0,0 +1,173 @@
+#ifndef PAIRWISE_GEMM_H
+#define PAIRWISE_GEMM_H
+
+#include "pairwise.h"
+
+struct _pairwise_job;
+
+/*******************************************************************************
+
+    Symbol: _PAIRWISE_GEMM_MIN_ELEMENTS, _PAIRWISE_GEMM_ROWS,
+            _PAIRWISE_GEMM_COLUMNS, _PAIRWISE_GEMM_ALIGNMENT,
+            _PAIRWISE_GEMM_CANCELLATION
+            
+    Type: Preprocessor constants
+    
+    Intent: Private
+    
+    Description:
+    
+        _pairwise_launch() calculates distances and RMSDs between collections
+        of at least _PAIRWISE_GEMM_MIN_ELEMENTS coordinates in all by norm
+        expansion rather than directly; see _pairwise_gemm_prepare(). Each
+        call to the micro-kernel finds the dot products between
+        _PAIRWISE_GEMM_ROWS first collections and _PAIRWISE_GEMM_COLUMNS
+        second collections, all held in registers, from panels of coordinates
+        packed into buffers aligned to _PAIRWISE_GEMM_ALIGNMENT bytes.
+        
+        A pair whose squared distance comes out at less than
+        1 / _PAIRWISE_GEMM_CANCELLATION of the sum of the squared norms it
+        was found from has lost too many bits to cancellation, and is
+        calculated directly instead.
+        
+*******************************************************************************/
+
+#define _PAIRWISE_GEMM_MIN_ELEMENTS 64
+#define _PAIRWISE_GEMM_ROWS 4
+#define _PAIRWISE_GEMM_COLUMNS 8
+#define _PAIRWISE_GEMM_ALIGNMENT 64
+#define _PAIRWISE_GEMM_CANCELLATION 8
+
+/*******************************************************************************
+
+    Symbol: _pairwise_gemm_sink_t
+    
+    Type: Structure
+    
+    Intent: Private
+    
+    Description:
+    
+        The sink of one thread taking part in a _pairwise_job_t calculated by
+        norm expansion: the scratch space in which it packs and calculates
+        each tile before its rows are stored.
+        
+        f_kernel is the micro-kernel. a_origin holds the n_depth coordinates
+        of the collection from which every collection is measured before it
+        is packed. a_norms and a_norms_b hold the squared norm so measured of
+        every collection of job->a_collections and job->a_collections_b
+        respectively. All three are shared by every sink, and a_norms and
+        a_norms_b are the same array unless job->b_cross is set. n_depth is
+        the number of coordinates in each collection.
+        
+        a_panel_a holds the coordinates of _PAIRWISE_GEMM_ROWS first
+        collections, and a_panel_b those of every second collection of the
+        tile in panels of _PAIRWISE_GEMM_COLUMNS, interleaved coordinate by
+        coordinate and padded with zeros; a_panel_norms_a and a_panel_norms_b
+        hold their squared norms likewise. All four are of doubles, whether
+        the job is on doubles or on floats. a_dots receives the dot products
+        found by one call to the micro-kernel. a_block holds the results of
+        the tile whose first and second collections begin at
+        i_collection_a_lower and i_collection_b_lower, row by row, each row
+        n_block_columns results long, of the job's own element type.
+        
+        Followed by a cache line of padding so that threads updating
+        neighbouring _pairwise_gemm_sink_t don't contend.
+        
+*******************************************************************************/
+
+typedef struct
+_pairwise_gemm_sink
+{
+
+    void (*f_kernel)(size_t n_depth,
+                     const double* a_panel_a,
+                     const double* a_panel_b,
+                     double* a_dots);
+                     
+    double* a_origin;
+    double* a_norms;
+    double* a_norms_b;
+    
+    size_t n_depth;
+    
+    double* a_panel_a;
+    double* a_panel_b;
+    double* a_panel_norms_a;
+    double* a_panel_norms_b;
+    double* a_dots;
+    void* a_block;
+    
+    size_t i_collection_a_lower;
+    size_t i_collection_b_lower;
+    size_t n_block_columns;
+    
+    char padding[64];
+
+} _pairwise_gemm_sink_t;
+
+/*******************************************************************************
+
+    Symbol: _pairwise_gemm_prepare
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        If job, whose tiles must already have been cut by
+        _pairwise_populate_chunks(), calculates Euclidean distances or RMSDs
+        with one of the generic row drivers, between collections of at least
+        _PAIRWISE_GEMM_MIN_ELEMENTS coordinates in all, switches it over to
+        norm expansion: finds the squared norm of every collection, measured
+        from the first collection of job->a_collections, gives each of
+        n_threads threads a _pairwise_gemm_sink_t, and replaces the tile and
+        row drivers of job with those of this module. Leaves every other job
+        as it is.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns PAIRWISE_RETURN_MALLOC_FAIL, and
+        leaves job as it is.
+        
+*******************************************************************************/
+
+int
+_pairwise_gemm_prepare
+(
+
+    struct _pairwise_job* job,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_gemm_release
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Frees everything allocated by a successful call to
+        _pairwise_gemm_prepare() for job and n_threads threads, if it switched
+        job over to norm expansion. Does nothing otherwise.
+        
+        Returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+void
+_pairwise_gemm_release
+(
+
+    struct _pairwise_job* job,
+    
+    size_t n_threads
+
+);
+
+#endif /* PAIRWISE_GEMM_H */
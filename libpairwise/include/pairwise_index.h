@@ -3,6 +3,69 @@
 
 #include "pairwise.h"
 
+/*******************************************************************************
+
+    Symbol: _PAIRWISE_INDEX_GRAIN
+    
+    Type: Preprocessor constant
+    
+    Intent: Private
+    
+    Description:
+    
+        The least number of indices worth handing to a thread of its own in
+        pairwise_indices() or pairwise_indices_inverse(). Each index costs
+        only a handful of integer operations, so arrays shorter than this per
+        thread use fewer threads, since waking a thread would cost more than
+        it saves.
+        
+*******************************************************************************/
+
+#define _PAIRWISE_INDEX_GRAIN 65536
+
+/*******************************************************************************
+
+    Symbol: _pairwise_index_task_t
+    
+    Type: Structure
+    
+    Intent: Private
+    
+    Description:
+    
+        One thread's share of pairwise_indices() or
+        pairwise_indices_inverse(): elements i_lower up to but excluding
+        i_upper of a_collections_a, a_collections_b and a_results, over
+        n_collections collections. Whichever of those arrays are inputs hold
+        ssize_t, and whichever are outputs size_t.
+        
+        Once done, n_return is PAIRWISE_RETURN_SUCCESS, or the error code of
+        the first element which failed.
+        
+        Followed by a cache line of padding so that threads updating
+        neighbouring _pairwise_index_task_t don't contend.
+        
+*******************************************************************************/
+
+typedef struct
+_pairwise_index_task
+{
+
+    size_t n_collections;
+    
+    void* a_collections_a;
+    void* a_collections_b;
+    void* a_results;
+    
+    size_t i_lower;
+    size_t i_upper;
+    
+    int n_return;
+    
+    char padding[64];
+
+} _pairwise_index_task_t;
+
 /*******************************************************************************
 
     Symbol: pairwise_index
@@ -51,4 +114,123 @@ pairwise_index
 
 );
 
+/*******************************************************************************
+
+    Symbol: pairwise_index_inverse
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        The inverse of pairwise_index(). Finds the two collections whose
+        pairwise calculation gave the result at index i_result of an array of
+        results for n_collections collections, and stores the lesser of their
+        indices in i_collection_a and the greater in i_collection_b.
+        
+        A negative i_result is permitted, and indexes backwards from the end
+        of the results, so that -1 indicates the last of them.
+        
+        Fails if n_collections is less than two, or if i_result is out of
+        bounds for the results of n_collections collections.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+*******************************************************************************/
+
+int
+pairwise_index_inverse
+(
+
+    size_t n_collections,
+    
+    ssize_t i_result,
+    
+    size_t* i_collection_a,
+    size_t* i_collection_b
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_indices
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        pairwise_index() over arrays. For each of n_indices elements, stores
+        in a_results the index of the result of the pairwise calculation
+        between the collections indexed by the same element of
+        a_collections_a and a_collections_b, exactly as pairwise_index()
+        would. The work is split over up to n_threads threads.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns the error code pairwise_index()
+        gives for the first element which fails, or another non-zero
+        libpairwise error code, and makes no guarantee about the state of
+        a_results.
+        
+*******************************************************************************/
+
+int
+pairwise_indices
+(
+
+    size_t n_collections,
+    size_t n_indices,
+    
+    ssize_t* a_collections_a,
+    ssize_t* a_collections_b,
+    
+    size_t* a_results,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_indices_inverse
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        pairwise_index_inverse() over arrays. For each of n_indices elements
+        of a_results, stores in the same element of a_collections_a and
+        a_collections_b the indices of the two collections whose pairwise
+        calculation gave that result, exactly as pairwise_index_inverse()
+        would. The work is split over up to n_threads threads.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns the error code
+        pairwise_index_inverse() gives for the first element which fails, or
+        another non-zero libpairwise error code, and makes no guarantee about
+        the state of a_collections_a or a_collections_b.
+        
+*******************************************************************************/
+
+int
+pairwise_indices_inverse
+(
+
+    size_t n_collections,
+    size_t n_indices,
+    
+    ssize_t* a_results,
+    
+    size_t* a_collections_a,
+    size_t* a_collections_b,
+    
+    size_t n_threads
+
+);
+
 #endif /* PAIRWISE_INDEX_H */
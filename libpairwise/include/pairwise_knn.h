@@ -0,0 +1,225 @@
+#ifndef PAIRWISE_KNN_H
+#define PAIRWISE_KNN_H
+
+#include "pairwise.h"
+
+struct _pairwise_job;
+
+/*******************************************************************************
+
+    Symbol: _pairwise_neighbour_t
+    
+    Type: Structure
+    
+    Intent: Private
+    
+    Description:
+    
+        Records one neighbour of a collection: another collection,
+        i_collection, and the result of the pairwise calculation between the
+        two. Results of calculations on floats are widened to double.
+        
+*******************************************************************************/
+
+typedef struct
+_pairwise_neighbour
+{
+
+    size_t i_collection;
+    
+    double result;
+
+} _pairwise_neighbour_t;
+
+/*******************************************************************************
+
+    Symbol: _pairwise_heaps_t
+    
+    Type: Structure
+    
+    Intent: Private
+    
+    Description:
+    
+        The sink of one thread taking part in _pairwise_launch_knn(): one
+        bounded max-heap of up to n_neighbours neighbours for each of
+        n_collections collections. The heap of collection i is elements
+        i * n_neighbours onwards of a_neighbours, and holds a_fills[i]
+        neighbours, the farthest of them first.
+        
+        a_neighbours and a_fills are allocated by the thread the first time
+        it carries out a calculation, and stay null if it never does.
+        n_return is PAIRWISE_RETURN_SUCCESS unless that allocation failed.
+        Padded to a cache line so that threads updating neighbouring
+        _pairwise_heaps_t don't contend.
+        
+*******************************************************************************/
+
+typedef struct
+_pairwise_heaps
+{
+
+    _pairwise_neighbour_t* a_neighbours;
+    
+    size_t* a_fills;
+    
+    size_t n_collections;
+    size_t n_neighbours;
+    
+    int n_return;
+    
+    char padding[64 - sizeof(_pairwise_neighbour_t*) - sizeof(size_t*) - (2 * sizeof(size_t)) - sizeof(int)];
+
+} _pairwise_heaps_t;
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_row_knn, _pairwise_launch_row_knn_float
+    
+    Type: Functions returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Row drivers for job->f_row. Carry out the pairwise calculations
+        between collection i_collection_a of job and each of collections
+        i_collection_b_lower up to but excluding i_collection_b_upper, by
+        calling job->f_calculation on doubles or job->f_calculation_float on
+        floats respectively, and offer each result to the heaps of both of
+        its collections in sink, a _pairwise_heaps_t. a_results_row is
+        ignored.
+        
+        On success return nothing. On failure to allocate the heaps of sink,
+        record PAIRWISE_RETURN_MALLOC_FAIL in it.
+        
+*******************************************************************************/
+
+void
+_pairwise_launch_row_knn
+(
+
+    struct _pairwise_job* job,
+    
+    void* sink,
+    
+    size_t i_collection_a,
+    size_t i_collection_b_lower,
+    size_t i_collection_b_upper,
+    
+    void* a_results_row
+
+);
+
+void
+_pairwise_launch_row_knn_float
+(
+
+    struct _pairwise_job* job,
+    
+    void* sink,
+    
+    size_t i_collection_a,
+    size_t i_collection_b_lower,
+    size_t i_collection_b_upper,
+    
+    void* a_results_row
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_knn
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Applies a calculation function, f_calculation, to all pairwise
+        combinations of collections in a set of collections, a_collections,
+        as _pairwise_launch() does, but keeps for each collection only the
+        n_neighbours other collections with the smallest results.
+        
+        n_collections, n_points, n_coordinates, a_collections and n_threads
+        are as for _pairwise_launch(). n_neighbours must be less than
+        n_collections, unless it is zero. a_indices and a_results must each
+        have room for n_collections * n_neighbours elements.
+        
+        For each collection i, elements i * n_neighbours up to but excluding
+        (i + 1) * n_neighbours of a_indices hold its nearest n_neighbours
+        collections, nearest first, and the same elements of a_results hold
+        the results of f_calculation on i and each of them. Equal results are
+        ordered by collection, so the output does not depend on n_threads.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code,
+        and makes no guarantee about the state of a_indices or a_results.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_knn
+(
+
+    double (*f_calculation)(size_t n_points,
+                            size_t n_coordinates,
+                            double* collection_a,
+                            double* collection_b),
+                            
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    
+    size_t n_neighbours,
+    
+    size_t* a_indices,
+    double* a_results,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_knn_float
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch_knn(), but for a calculation on collections of
+        floats, f_calculation, whose kept results are stored as floats.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_knn_float
+(
+
+    float (*f_calculation)(size_t n_points,
+                           size_t n_coordinates,
+                           float* collection_a,
+                           float* collection_b),
+                           
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    
+    size_t n_neighbours,
+    
+    size_t* a_indices,
+    float* a_results,
+    
+    size_t n_threads
+
+);
+
+#endif /* PAIRWISE_KNN_H */
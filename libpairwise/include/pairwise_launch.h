@@ -5,7 +5,35 @@
 
 /*******************************************************************************
 
-    Symbol: _pairwise_as_t
+    Symbol: _PAIRWISE_CHUNKS_PER_THREAD, _PAIRWISE_TILE_MIN_COLLECTIONS,
+            _PAIRWISE_TILE_CACHE_BYTES
+    
+    Type: Preprocessor constants
+    
+    Intent: Private
+    
+    Description:
+    
+        _pairwise_launch() cuts the pairwise calculations to be done into
+        square tiles, which threads claim one at a time as chunks and steal
+        from one another. Tiles are made small enough that the two blocks of
+        collections they read fit together in the host's level 2 cache (or in
+        _PAIRWISE_TILE_CACHE_BYTES, if its size cannot be found), and that
+        there are about _PAIRWISE_CHUNKS_PER_THREAD tiles per thread. The
+        latter never makes a tile side shorter than
+        _PAIRWISE_TILE_MIN_COLLECTIONS collections.
+        
+*******************************************************************************/
+
+#define _PAIRWISE_CHUNKS_PER_THREAD 16
+#define _PAIRWISE_TILE_MIN_COLLECTIONS 8
+#define _PAIRWISE_TILE_CACHE_BYTES 262144
+
+struct _pairwise_argument_set;
+
+/*******************************************************************************
+
+    Symbol: _pairwise_job_t
     
     Type: Structure
     
@@ -13,32 +41,202 @@
     
     Description:
     
-        Parameterises a call to _pairwise_launch_bounded(). Initialised by
-        _pairwise_populate_argument_sets().
+        Describes one call to _pairwise_launch() or _pairwise_launch_float():
+        the calculation to be done, its input and output arrays, and the tiles
+        into which its pairwise calculations are cut.
+        
+        Unless b_cross is set, the calculations are those between every pair
+        of the n_collections collections in a_collections, and a_collections_b
+        and n_collections_b are set by _pairwise_launch_job() to a_collections
+        and n_collections. If b_cross is set, as by _pairwise_launch_cross(),
+        they are instead those between every collection in a_collections and
+        every one of the n_collections_b collections in a_collections_b, and
+        the results form a row-major n_collections by n_collections_b matrix.
+        If b_append is also set, as by _pairwise_launch_append(), the
+        collections of a_collections_b are instead the last n_collections_b
+        of a_collections, only pairs whose second collection comes after
+        their first are calculated, and their results are stored where
+        pairwise_index() places them among those of all n_collections.
+        
+        Coordinates and results are both elements of s_element bytes - doubles
+        or floats. f_row carries out the pairwise calculations between
+        collection i_collection_a and each of collections i_collection_b_lower
+        up to but excluding i_collection_b_upper, and stores their results
+        consecutively from a_results_row; it calls f_calculation (for doubles)
+        or f_calculation_float (for floats) for each pair.
+        
+        If f_tile is not null, it is called with the bounds of each tile
+        before f_row is called for any of its rows, so that a row driver can
+        store results which f_tile has calculated for the whole tile at once,
+        as those of _pairwise_gemm_prepare() do. f_tile is set to null by
+        _pairwise_launch_prepare() and _pairwise_launch_stream_job().
+        
+        b_cancel is cleared by _pairwise_launch_prepare() and
+        _pairwise_launch_stream_job(), and may be set by any thread, as by
+        pairwise_future_cancel(), to stop threads claiming further chunks; it
+        is read and written atomically.
+        
+        Row drivers which keep only some results, such as those of
+        _pairwise_launch_cutoff() which keep results no greater than cutoff
+        and of _pairwise_launch_knn() which keep nearest neighbours, pass
+        them instead to sink: the calling thread's own element of
+        a_sinks, an array of one s_sink-byte sink per thread, so that threads
+        need never synchronise to store results. a_results is then null, and
+        so is a_results_row. Row drivers which store every result ignore sink,
+        and a_sinks is null.
+        
+        The collections are split into n_tile_blocks blocks of
+        n_tile_collections consecutive collections (bar the last), and the
+        tile in row of tiles i_block_a and column of tiles i_block_b, with
+        i_block_b >= i_block_a, covers every pairwise calculation whose first
+        collection lies in block i_block_a and whose second lies in block
+        i_block_b. Tiles are numbered row by row, and a_tile_offsets[i_block_a]
+        is the number of the first tile in row i_block_a. Each tile is one of
+        n_chunks chunks. If b_cross is set, the collections of a_collections_b
+        are likewise split into n_tile_blocks_b blocks, and every row of tiles
+        holds a tile for every one of them, not only for i_block_b >=
+        i_block_a.
+        
+        Shared, read-only, by all n_argument_sets _pairwise_as_t in
+        a_argument_sets. Initialised by _pairwise_launch_job() and
+        _pairwise_populate_chunks().
         
 *******************************************************************************/
 
 typedef struct
-_pairwise_argument_set
+_pairwise_job
 {
-    
+
     double (*f_calculation)(size_t n_points,
                             size_t n_coordinates,
                             double* collection_a,
                             double* collection_b);
     
-    double* a_collections;
-    double* a_results;
+    float (*f_calculation_float)(size_t n_points,
+                                 size_t n_coordinates,
+                                 float* collection_a,
+                                 float* collection_b);
+                                 
+    void (*f_row)(struct _pairwise_job* job,
+                  void* sink,
+                  size_t i_collection_a,
+                  size_t i_collection_b_lower,
+                  size_t i_collection_b_upper,
+                  void* a_results_row);
+                  
+    void (*f_tile)(struct _pairwise_job* job,
+                   void* sink,
+                   size_t i_collection_a_lower,
+                   size_t i_collection_a_upper,
+                   size_t i_collection_b_lower,
+                   size_t i_collection_b_upper);
+                   
+    void* a_collections;
+    void* a_collections_b;
+    void* a_results;
+    
+    size_t s_element;
+    
+    void* a_sinks;
+    size_t s_sink;
+    
+    double cutoff;
+    
+    int b_cross;
+    int b_append;
+    int b_cancel;
     
     size_t n_collections;
+    size_t n_collections_b;
     size_t n_points;
     size_t n_coordinates;
     
-    size_t i_collection_lower;
-    size_t i_collection_upper;
+    size_t n_tile_collections;
+    size_t n_tile_blocks;
+    size_t n_tile_blocks_b;
     
+    size_t* a_tile_offsets;
+    
+    size_t n_chunks;
+    
+    size_t n_argument_sets;
+    struct _pairwise_argument_set* a_argument_sets;
+
+} _pairwise_job_t;
+
+/*******************************************************************************
+
+    Symbol: _pairwise_as_t
+    
+    Type: Structure
+    
+    Intent: Private
+    
+    Description:
+    
+        Parameterises a call to _pairwise_launch_bounded() by one of the
+        threads taking part in a _pairwise_job_t, job. chunks packs the range
+        of chunk indices [lower, upper) not yet claimed from this thread's
+        share, as lower in its low 32 bits and upper in its high 32 bits, so
+        that both ends can be claimed with a single atomic compare-and-swap.
+        n_pairs counts the pairwise calculations this thread has carried out
+        so far, whether in its own chunks or in stolen ones; only this thread
+        adds to it, atomically, so that others may read it meanwhile. t_start
+        and t_end are the times, of _pairwise_stats_clock(), at which this
+        thread began and finished its call, for _pairwise_stats_record().
+        Padded to a cache line so that threads claiming from neighbouring
+        _pairwise_as_t don't contend. Initialised by
+        _pairwise_populate_argument_sets().
+        
+*******************************************************************************/
+
+typedef struct
+_pairwise_argument_set
+{
+
+    _pairwise_job_t* job;
+    
+    uint64_t chunks;
+    uint64_t n_pairs;
+    
+    double t_start;
+    double t_end;
+    
+    char padding[64 - sizeof(_pairwise_job_t*) - (2 * sizeof(uint64_t)) - (2 * sizeof(double))];
+
 } _pairwise_as_t;
 
+/*******************************************************************************
+
+    Symbol: _pairwise_populate_chunks
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Cuts the pairwise calculations to be done by job into square tiles,
+        aiming for about n_chunks_target tiles, but making them smaller if
+        needed for the collections each reads to stay in cache. Stores the
+        tile layout in job, allocating job->a_tile_offsets, the
+        responsibility to free which is passed on to the caller.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+*******************************************************************************/
+
+int
+_pairwise_populate_chunks
+(
+
+    _pairwise_job_t* job,
+    
+    size_t n_chunks_target
+
+);
+
 /*******************************************************************************
 
     Symbol: _pairwise_populate_argument_sets
@@ -50,28 +248,18 @@ _pairwise_argument_set
     Description:
     
         Initialises an array of _pairwise_as_t, a_argument_sets, according to
-        parameters specified by the caller. Each initialised _pairwise_as_t
-        can then be passed to _pairwise_launch_bounded() to carry out a
-        specific subset of all pairwise calculations to be done. Multiple such
-        calls to _pairwise_launch_bounded(), each parameterised by a different
-        _pairwise_as_t in an initialised a_argument_sets, can be made by
-        multiple threads running in parallel; this is the libpairwise
-        parallelisation strategy.
-        
-        f_calculation is a pointer to a function representing a single round of
-        the pairwise calculations to be done. n_collections is the number of
-        collections in a_collections, n_points is the number of points per
-        collection, and n_coordinates is the number of coordinates per point.
-        a_collections is a pointer to an input array containing a set of
-        collections, a_results is a pointer to an output array of sufficient
-        size to store the results of all pairwise calculations. n_argument_sets
-        is the number of _pairwise_as_t in a_argument_sets, and a_argument_sets
-        is a pointer to the array of _pairwise_as_t to be initialised.
+        the chunks of an initialised _pairwise_job_t, job. Each initialised
+        _pairwise_as_t can then be passed to _pairwise_launch_bounded() to
+        carry out pairwise calculations chunk by chunk, starting with its own
+        share of the chunks and then stealing chunks from the other
+        _pairwise_as_t. Multiple such calls to _pairwise_launch_bounded(), each
+        parameterised by a different _pairwise_as_t in an initialised
+        a_argument_sets, can be made by multiple threads running in parallel;
+        this is the libpairwise parallelisation strategy.
         
-        Changes only a_argument_sets. The caller is responsible for ensuring
-        that a_collections has the expected form (see the prologue comment for
-        pairwise_rmsds()), and that a_results is large enough to store
-        0.5 * n_collections * (n_collections - 1) doubles.
+        n_argument_sets is the number of _pairwise_as_t in a_argument_sets,
+        and a_argument_sets is a pointer to the array of _pairwise_as_t to be
+        initialised. Also records both in job.
         
         On success returns nothing. Not expected to fail.
         
@@ -81,23 +269,114 @@ void
 _pairwise_populate_argument_sets
 (
 
-    double (*f_calculation)(size_t n_points,
-                            size_t n_coordinates,
-                            double* collection_a,
-                            double* collection_b),
-    
-    size_t n_collections,
-    size_t n_points,
-    size_t n_coordinates,
-    
-    double* a_collections,
-    double* a_results,
+    _pairwise_job_t* job,
     
     size_t n_argument_sets,
     _pairwise_as_t* a_argument_sets
     
 );
 
+/*******************************************************************************
+
+    Symbol: _pairwise_claim_chunk
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Atomically claims one unclaimed chunk from the share of argument_set:
+        the first if steal is zero, as the owning thread does, or the last
+        otherwise, as any other thread does. Stores the index of the claimed
+        chunk in i_chunk.
+        
+        Returns integer one if a chunk was claimed, or integer zero if none
+        remained in the share of argument_set. Not expected to fail.
+        
+*******************************************************************************/
+
+int
+_pairwise_claim_chunk
+(
+
+    _pairwise_as_t* argument_set,
+    
+    int steal,
+    
+    size_t* i_chunk
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_locate_chunk
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Finds the collections covered by chunk - that is, tile - i_chunk of
+        job: every pairwise calculation whose first collection is one of
+        i_collection_a_lower up to but excluding i_collection_a_upper, and
+        whose second is one of i_collection_b_lower up to but excluding
+        i_collection_b_upper, stored in the four size_t pointed to. On the
+        diagonal of a triangle, only those pairs whose second collection
+        comes after their first belong to the tile.
+        
+        On success returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+void
+_pairwise_locate_chunk
+(
+
+    _pairwise_job_t* job,
+    
+    size_t i_chunk,
+    
+    size_t* i_collection_a_lower,
+    size_t* i_collection_a_upper,
+    size_t* i_collection_b_lower,
+    size_t* i_collection_b_upper
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_chunk
+    
+    Type: Function returning size_t
+    
+    Intent: Private
+    
+    Description:
+    
+        Carries out the pairwise calculations in chunk - that is, tile -
+        i_chunk of job, and stores their results at the appropriate offsets
+        in job->a_results. sink is the calling thread's sink in
+        job->a_sinks, or a null pointer if job has none.
+        
+        On success returns the number of pairwise calculations carried out.
+        Not expected to fail.
+        
+*******************************************************************************/
+
+size_t
+_pairwise_launch_chunk
+(
+
+    _pairwise_job_t* job,
+    
+    void* sink,
+    
+    size_t i_chunk
+
+);
+
 /*******************************************************************************
 
     Symbol: _pairwise_launch_bounded
@@ -108,8 +387,11 @@ _pairwise_populate_argument_sets
     
     Description:
     
-        Carries out a subset of all the pairwise calculations to be done which
-        is parameterised by an initialised _pairwise_as_t, argument_set.
+        Carries out chunks of the pairwise calculations to be done by a
+        _pairwise_job_t for as long as any remain unclaimed, starting with the
+        share of an initialised _pairwise_as_t, argument_set, and counting
+        them in argument_set->n_pairs. Stops early, before claiming another
+        chunk, once job->b_cancel is set.
         
         On success returns nothing. Not expected to fail.
         
@@ -123,6 +405,157 @@ _pairwise_launch_bounded
 
 );
 
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_row, _pairwise_launch_row_float
+    
+    Type: Functions returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Row drivers for job->f_row. Carry out the pairwise calculations
+        between collection i_collection_a of job and each of collections
+        i_collection_b_lower up to but excluding i_collection_b_upper, by
+        calling job->f_calculation on doubles or job->f_calculation_float on
+        floats respectively, and store their results consecutively from
+        a_results_row. sink is ignored.
+        
+        On success return nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+void
+_pairwise_launch_row
+(
+
+    _pairwise_job_t* job,
+    
+    void* sink,
+    
+    size_t i_collection_a,
+    size_t i_collection_b_lower,
+    size_t i_collection_b_upper,
+    
+    void* a_results_row
+
+);
+
+void
+_pairwise_launch_row_float
+(
+
+    _pairwise_job_t* job,
+    
+    void* sink,
+    
+    size_t i_collection_a,
+    size_t i_collection_b_lower,
+    size_t i_collection_b_upper,
+    
+    void* a_results_row
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_prepare
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Readies job, whose calculation, row driver, input and output arrays,
+        element size, sinks and dimensions must already be set, to be carried
+        out over n_threads threads, as described for _pairwise_launch_job():
+        cuts its tiles, and allocates and initialises job->a_argument_sets,
+        one for each thread which can be kept busy, so that each can be passed
+        to _pairwise_launch_bounded(). If job->a_sinks is not null it must
+        hold n_threads sinks.
+        
+        A job with no pairwise calculations to carry out is left with no
+        argument sets, job->n_argument_sets being zero.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero, and the caller must pass job to
+        _pairwise_launch_release() once done with it. On failure returns a
+        non-zero libpairwise error code, having freed anything allocated.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_prepare
+(
+
+    _pairwise_job_t* job,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_release
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Frees everything allocated for job by a successful call to
+        _pairwise_launch_prepare(). No thread may still be carrying out
+        chunks of job.
+        
+        Returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+void
+_pairwise_launch_release
+(
+
+    _pairwise_job_t* job
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_job
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Carries out every pairwise calculation described by job, whose
+        calculation, row driver, input and output arrays, element size, sinks
+        and dimensions must already be set, distributed over n_threads
+        threads. If job->a_sinks is not null it must hold n_threads sinks.
+        Called by _pairwise_launch(), _pairwise_launch_float(),
+        _pairwise_launch_cutoff() and _pairwise_launch_knn().
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code,
+        and makes no guarantee about the state of job->a_results, which may
+        or may not have been changed.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_job
+(
+
+    _pairwise_job_t* job,
+    
+    size_t n_threads
+
+);
+
 /*******************************************************************************
 
     Symbol: _pairwise_launch
@@ -142,9 +575,9 @@ _pairwise_launch_bounded
         collection, and n_coordinates is the number of coordinates per point.
         a_collections is a pointer to an input array containing a set of
         collections, a_results is a pointer to an output array of sufficient
-        size to store the results of all pairwise calculations. n_argument_sets
-        is the number of _pairwise_as_t in a_argument_sets, and a_argument_sets
-        is a pointer to the array of _pairwise_as_t to be initialised.
+        size to store the results of all pairwise calculations. n_threads is
+        the number of threads across which to distribute the pairwise
+        calculations to be done.
         
         The caller is responsible for ensuring that a_collections has the
         expected form (see the prologue comment for pairwise_rmsds()), and that
@@ -178,4 +611,219 @@ _pairwise_launch
 
 );
 
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_float
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch(), but for a calculation on collections of floats,
+        f_calculation, whose results are stored in an output array of floats.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_float
+(
+
+    float (*f_calculation)(size_t n_points,
+                           size_t n_coordinates,
+                           float* collection_a,
+                           float* collection_b),
+                           
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    float* a_results,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_cross
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch(), but applies f_calculation to every pair of one
+        collection from a_collections and one from a_collections_b, rather than
+        to every pair of collections from one set.
+        
+        n_collections and n_collections_b are the numbers of collections in
+        a_collections and a_collections_b, whose collections must each have
+        n_points points of n_coordinates coordinates. a_results must be large
+        enough to store n_collections * n_collections_b doubles. The result
+        for collection i of a_collections and collection j of a_collections_b
+        is stored in element i * n_collections_b + j.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code,
+        and makes no guarantee about the state a_results, which may or may not
+        have been changed.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_cross
+(
+
+    double (*f_calculation)(size_t n_points,
+                            size_t n_coordinates,
+                            double* collection_a,
+                            double* collection_b),
+                            
+    size_t n_collections,
+    size_t n_collections_b,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    double* a_collections_b,
+    double* a_results,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_cross_float
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch_cross(), but for a calculation on collections of
+        floats, f_calculation, whose results are stored in an output array of
+        floats.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_cross_float
+(
+
+    float (*f_calculation)(size_t n_points,
+                           size_t n_coordinates,
+                           float* collection_a,
+                           float* collection_b),
+                           
+    size_t n_collections,
+    size_t n_collections_b,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    float* a_collections_b,
+    float* a_results,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_append
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch(), but extends the results of every pairwise
+        calculation across n_collections_old collections to those across
+        n_collections_old + n_collections_new, calculating only the results
+        which involve at least one of the n_collections_new new collections.
+        
+        a_collections holds all n_collections_old + n_collections_new
+        collections, old first, each of n_points points of n_coordinates
+        coordinates. a_results_old holds the condensed results across the old
+        collections, as _pairwise_launch() stores them, and a_results must be
+        large enough to store the results across all collections. The old
+        results are moved to their places among those, as pairwise_index()
+        gives them, and the new results are calculated into the rest.
+        a_results may be a_results_old itself, once enlarged, in which case
+        the old results are moved in place; otherwise the two must not
+        overlap.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code,
+        and makes no guarantee about the state a_results, which may or may not
+        have been changed.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_append
+(
+
+    double (*f_calculation)(size_t n_points,
+                            size_t n_coordinates,
+                            double* collection_a,
+                            double* collection_b),
+                            
+    size_t n_collections_old,
+    size_t n_collections_new,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    double* a_results_old,
+    double* a_results,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_append_float
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch_append(), but for a calculation on collections of
+        floats, f_calculation, whose results are stored in arrays of floats.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_append_float
+(
+
+    float (*f_calculation)(size_t n_points,
+                           size_t n_coordinates,
+                           float* collection_a,
+                           float* collection_b),
+                           
+    size_t n_collections_old,
+    size_t n_collections_new,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    float* a_results_old,
+    float* a_results,
+    
+    size_t n_threads
+
+);
+
 #endif /* PAIRWISE_LAUNCH_H */
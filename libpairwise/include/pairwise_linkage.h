@@ -0,0 +1,205 @@
+#ifndef PAIRWISE_LINKAGE_H
+#define PAIRWISE_LINKAGE_H
+
+#include "pairwise.h"
+
+/*******************************************************************************
+
+    Symbol: _PAIRWISE_LINKAGE_GRAIN
+    
+    Type: Preprocessor constant
+    
+    Intent: Private
+    
+    Description:
+    
+        The least number of collections worth handing to a thread of its own
+        in one step of _pairwise_launch_linkage(). Steps with fewer remaining
+        collections than this per thread use fewer threads, since waking a
+        thread would cost more than it saves.
+        
+*******************************************************************************/
+
+#define _PAIRWISE_LINKAGE_GRAIN 256
+
+/*******************************************************************************
+
+    Symbol: _pairwise_linkage_t
+    
+    Type: Structure
+    
+    Intent: Private
+    
+    Description:
+    
+        The state shared by every thread taking part in one step of Prim's
+        algorithm in _pairwise_launch_linkage().
+        
+        f_calculation or f_calculation_float, whichever is not null, is the
+        calculation between a pair of the n_collections collections of
+        n_points points of n_coordinates coordinates in a_collections.
+        
+        The first n_remaining elements of a_order are the collections not yet
+        in the tree, in no particular order. For the collection at position i
+        of a_order, element i of a_nearest is the least result between it and
+        any collection in the tree, and element i of a_from is that
+        collection. i_added is the collection added to the tree last, whose
+        results with every remaining collection are yet to be offered.
+        
+*******************************************************************************/
+
+typedef struct
+_pairwise_linkage
+{
+
+    double (*f_calculation)(size_t n_points,
+                            size_t n_coordinates,
+                            double* collection_a,
+                            double* collection_b);
+                            
+    float (*f_calculation_float)(size_t n_points,
+                                 size_t n_coordinates,
+                                 float* collection_a,
+                                 float* collection_b);
+                                 
+    void* a_collections;
+    
+    size_t n_collections;
+    size_t n_points;
+    size_t n_coordinates;
+    
+    size_t* a_order;
+    double* a_nearest;
+    size_t* a_from;
+    
+    size_t n_remaining;
+    
+    size_t i_added;
+
+} _pairwise_linkage_t;
+
+/*******************************************************************************
+
+    Symbol: _pairwise_linkage_task_t
+    
+    Type: Structure
+    
+    Intent: Private
+    
+    Description:
+    
+        One thread's share of a step of _pairwise_launch_linkage(): positions
+        i_lower up to but excluding i_upper of linkage->a_order. Once done,
+        i_nearest is the position among them whose collection is nearest the
+        tree, and nearest is its result.
+        
+        Followed by a cache line of padding so that threads updating
+        neighbouring _pairwise_linkage_task_t don't contend.
+        
+*******************************************************************************/
+
+typedef struct
+_pairwise_linkage_task
+{
+
+    _pairwise_linkage_t* linkage;
+    
+    size_t i_lower;
+    size_t i_upper;
+    
+    size_t i_nearest;
+    double nearest;
+    
+    char padding[64];
+
+} _pairwise_linkage_task_t;
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_linkage
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Clusters a set of collections, a_collections, by single linkage under
+        a calculation function, f_calculation, without storing the results of
+        all pairwise calculations between them, and stores the clustering in
+        a_linkage in the form of scipy.cluster.hierarchy.linkage().
+        
+        n_collections, n_points, n_coordinates, a_collections and n_threads
+        are as for _pairwise_launch(). a_linkage must have room for
+        (n_collections - 1) * 4 doubles, and holds a row-major matrix of
+        n_collections - 1 merges in order of increasing result. Row i merges
+        the clusters whose labels are in columns 0 and 1, the lesser first,
+        at the result in column 2, into a cluster of as many collections as
+        column 3 holds, which is labelled n_collections + i. Each collection
+        is a cluster of its own to begin with, labelled by its index.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code,
+        and makes no guarantee about the state of a_linkage.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_linkage
+(
+
+    double (*f_calculation)(size_t n_points,
+                            size_t n_coordinates,
+                            double* collection_a,
+                            double* collection_b),
+                            
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    
+    double* a_linkage,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_linkage_float
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch_linkage(), but for a calculation on collections of
+        floats, f_calculation. The linkage is stored in double precision
+        nonetheless, as SciPy expects.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_linkage_float
+(
+
+    float (*f_calculation)(size_t n_points,
+                           size_t n_coordinates,
+                           float* collection_a,
+                           float* collection_b),
+                           
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    
+    double* a_linkage,
+    
+    size_t n_threads
+
+);
+
+#endif /* PAIRWISE_LINKAGE_H */
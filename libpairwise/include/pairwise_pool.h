@@ -0,0 +1,326 @@
+#ifndef PAIRWISE_POOL_H
+#define PAIRWISE_POOL_H
+
+#include "pairwise.h"
+
+/*******************************************************************************
+
+    Symbol: _pairwise_pool_job_t
+    
+    Type: Structure
+    
+    Intent: Private
+    
+    Description:
+    
+        Describes a batch of n_tasks independent tasks to be run by the
+        libpairwise worker pool. Task i_task is a call to f_task with the
+        pointer a_tasks + (i_task * s_task). Initialised and submitted by
+        _pairwise_pool_run() or _pairwise_pool_submit(); the remaining members
+        are bookkeeping shared with the workers under the pool mutex.
+        
+*******************************************************************************/
+
+typedef struct
+_pairwise_pool_job
+{
+
+    void (*f_task)(void* task);
+    
+    char* a_tasks;
+    
+    size_t s_task;
+    size_t n_tasks;
+    
+    size_t i_task_next;
+    size_t n_tasks_done;
+    
+    pthread_cond_t done;
+    
+    struct _pairwise_pool_job* next;
+
+} _pairwise_pool_job_t;
+
+/*******************************************************************************
+
+    Symbol: pairwise_pool_resize
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Grows or shrinks the libpairwise worker pool to exactly n_workers
+        long-lived threads. Workers removed by shrinking first finish any task
+        they are running, and help to run any task already queued. Passing
+        zero is equivalent to calling pairwise_pool_shutdown().
+        
+        Calling this function is never required: the pool grows on demand to
+        n_threads - 1 workers whenever a calculation asks for n_threads
+        threads, since the calling thread always takes part itself.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code;
+        the pool then keeps whichever workers were successfully created or
+        not yet joined.
+        
+*******************************************************************************/
+
+int
+pairwise_pool_resize
+(
+
+    size_t n_workers
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_pool_size
+    
+    Type: Function returning size_t
+    
+    Intent: Public
+    
+    Description:
+    
+        Returns the number of worker threads currently in the libpairwise
+        worker pool. Not expected to fail.
+        
+*******************************************************************************/
+
+size_t
+pairwise_pool_size
+(void);
+
+/*******************************************************************************
+
+    Symbol: pairwise_pool_shutdown
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Stops and joins every worker thread in the libpairwise worker pool,
+        releasing their resources. Subsequent calculations recreate workers
+        on demand.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+*******************************************************************************/
+
+int
+pairwise_pool_shutdown
+(void);
+
+/*******************************************************************************
+
+    Symbol: PAIRWISE_AFFINITY_*
+    
+    Type: Family of preprocessor constants
+    
+    Intent: Public
+    
+    Description:
+    
+        Identifiers for the ways pairwise_pool_set_affinity() can place the
+        workers of the libpairwise worker pool. PAIRWISE_AFFINITY_NONE leaves
+        placement to the operating system. PAIRWISE_AFFINITY_CORES pins each
+        worker to a CPU of its own, and PAIRWISE_AFFINITY_NODES pins each to
+        the CPUs of one NUMA node, spreading workers over the nodes in turn.
+        
+*******************************************************************************/
+
+#define PAIRWISE_AFFINITY_NONE 0
+#define PAIRWISE_AFFINITY_CORES 1
+#define PAIRWISE_AFFINITY_NODES 2
+
+/*******************************************************************************
+
+    Symbol: pairwise_pool_set_affinity
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Selects how the workers of the libpairwise worker pool are placed on
+        the CPUs which the calling thread may run on. n_affinity is one of
+        PAIRWISE_AFFINITY_*. Applies at once to every existing worker, and to
+        every worker created later.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. If n_affinity is not a recognised identifier, or the
+        host does not support pinning threads, returns
+        PAIRWISE_RETURN_ERROR_AFFINITY, and on failure to allocate memory
+        returns PAIRWISE_RETURN_MALLOC_FAIL, leaving the current selection
+        unchanged in either case. If some worker could not be pinned, returns
+        PAIRWISE_RETURN_ERROR_AFFINITY having made the selection nonetheless.
+        
+*******************************************************************************/
+
+int
+pairwise_pool_set_affinity
+(
+
+    int n_affinity
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_pool_get_affinity
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Returns the PAIRWISE_AFFINITY_* identifier last selected by
+        pairwise_pool_set_affinity(), or PAIRWISE_AFFINITY_NONE if it has
+        never been called. Not expected to fail.
+        
+*******************************************************************************/
+
+int
+pairwise_pool_get_affinity
+(void);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_pool_run
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Runs n_tasks tasks, each a call to f_task with the pointer
+        a_tasks + (i_task * s_task), on the libpairwise worker pool and on the
+        calling thread, and returns once all have finished. Grows the pool to
+        n_tasks - 1 workers first if it is smaller.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure to grow the pool returns a non-zero
+        libpairwise error code without having run any task.
+        
+*******************************************************************************/
+
+int
+_pairwise_pool_run
+(
+
+    void (*f_task)(void* task),
+    
+    void* a_tasks,
+    
+    size_t s_task,
+    size_t n_tasks
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_pool_submit
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Queues n_tasks tasks, each a call to f_task with the pointer
+        a_tasks + (i_task * s_task), to be run on the libpairwise worker pool
+        alone, describing them in job, and returns at once. Grows the pool to
+        n_tasks workers first if it is smaller, since the calling thread
+        takes no part.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero; job and the tasks must then stay valid until
+        _pairwise_pool_wait() has found every task finished, and the caller
+        must then pass job to _pairwise_pool_forget(). On failure to grow the
+        pool returns a non-zero libpairwise error code, having queued
+        nothing.
+        
+*******************************************************************************/
+
+int
+_pairwise_pool_submit
+(
+
+    _pairwise_pool_job_t* job,
+    
+    void (*f_task)(void* task),
+    
+    void* a_tasks,
+    
+    size_t s_task,
+    size_t n_tasks
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_pool_wait
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Waits for every task of job, as submitted by _pairwise_pool_submit(),
+        to finish, or until the absolute time deadline, of the realtime
+        clock, has passed. A null deadline waits for as long as it takes, and
+        any deadline already passed returns at once. Any number of threads
+        may wait for the same job at once.
+        
+        Returns integer one if every task has finished, or integer zero if
+        the deadline passed first. Not expected to fail.
+        
+*******************************************************************************/
+
+int
+_pairwise_pool_wait
+(
+
+    _pairwise_pool_job_t* job,
+    
+    const struct timespec* deadline
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_pool_forget
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Releases the resources of job, as submitted by
+        _pairwise_pool_submit(), once _pairwise_pool_wait() has found every
+        task of job finished and no thread waits for it any longer.
+        
+        Returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+void
+_pairwise_pool_forget
+(
+
+    _pairwise_pool_job_t* job
+
+);
+
+#endif /* PAIRWISE_POOL_H */
@@ -0,0 +1,242 @@
+#ifndef PAIRWISE_REDUCE_H
+#define PAIRWISE_REDUCE_H
+
+#include "pairwise.h"
+
+struct _pairwise_job;
+
+/*******************************************************************************
+
+    Symbol: _pairwise_reduction_t
+    
+    Type: Structure
+    
+    Intent: Private
+    
+    Description:
+    
+        The sink of one thread taking part in _pairwise_launch_reduce(): its
+        share of every reduction asked for, over the n_results results it
+        has been offered so far.
+        
+        minimum and maximum are the least and greatest of those results, and
+        sum and sum_squares are the sums of their differences from shift, the
+        first of them, and of the squares of those differences. Shifting
+        keeps the variance found from them accurate even when it is small
+        beside the square of the mean.
+        
+        If b_counts is set, a_counts holds the number of results in each of
+        n_bins equal bins from lower to upper, scale of which span a unit. If
+        b_sums is set, a_sums holds for each of n_collections collections the
+        sum of the results of every pairwise calculation it took part in.
+        Both are allocated by the thread the first time it carries out a
+        calculation, and stay null if it never does. n_return is
+        PAIRWISE_RETURN_SUCCESS unless that allocation failed.
+        
+        Followed by a cache line of padding so that threads updating
+        neighbouring _pairwise_reduction_t don't contend.
+        
+*******************************************************************************/
+
+typedef struct
+_pairwise_reduction
+{
+
+    size_t* a_counts;
+    double* a_sums;
+    
+    size_t n_collections;
+    size_t n_bins;
+    
+    double lower;
+    double upper;
+    double scale;
+    
+    size_t n_results;
+    
+    double shift;
+    double sum;
+    double sum_squares;
+    
+    double minimum;
+    double maximum;
+    
+    int b_counts;
+    int b_sums;
+    
+    int n_return;
+    
+    char padding[64];
+
+} _pairwise_reduction_t;
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_row_reduce, _pairwise_launch_row_reduce_float
+    
+    Type: Functions returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Row drivers for job->f_row. Carry out the pairwise calculations
+        between collection i_collection_a of job and each of collections
+        i_collection_b_lower up to but excluding i_collection_b_upper, by
+        calling job->f_calculation on doubles or job->f_calculation_float on
+        floats respectively, and offer each result to the reductions of sink,
+        a _pairwise_reduction_t. a_results_row is ignored.
+        
+        On success return nothing. On failure to allocate the counts or sums
+        of sink, record PAIRWISE_RETURN_MALLOC_FAIL in it.
+        
+*******************************************************************************/
+
+void
+_pairwise_launch_row_reduce
+(
+
+    struct _pairwise_job* job,
+    
+    void* sink,
+    
+    size_t i_collection_a,
+    size_t i_collection_b_lower,
+    size_t i_collection_b_upper,
+    
+    void* a_results_row
+
+);
+
+void
+_pairwise_launch_row_reduce_float
+(
+
+    struct _pairwise_job* job,
+    
+    void* sink,
+    
+    size_t i_collection_a,
+    size_t i_collection_b_lower,
+    size_t i_collection_b_upper,
+    
+    void* a_results_row
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_reduce
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Applies a calculation function, f_calculation, to all pairwise
+        combinations of collections in a set of collections, a_collections,
+        as _pairwise_launch() does, but stores no result, and instead reduces
+        them all at once to whichever of three summaries are asked for.
+        
+        n_collections, n_points, n_coordinates, a_collections and n_threads
+        are as for _pairwise_launch().
+        
+        If a_statistics is not a null pointer, it must have room for four
+        elements, which are set to the minimum, maximum, mean and variance
+        of all results, in that order. The variance is that of the results
+        themselves, dividing by their number rather than by one less. If
+        there are no results, all four are set to NaN.
+        
+        If a_counts is not a null pointer, it must have room for n_bins
+        elements, which must be at least one, and lower must be less than
+        upper. The range from lower to upper is split into n_bins equal bins,
+        each including its lower edge but not its upper edge, except for the
+        last, which includes both; element i of a_counts is set to the number
+        of results within bin i. Results outside the range are not counted.
+        
+        If a_sums is not a null pointer, it must have room for n_collections
+        elements, and element i is set to the sum of the results of every
+        pairwise calculation between collection i and any other.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. If a_counts is given with no bins or an empty range,
+        returns PAIRWISE_RETURN_ERROR_RANGE. On any other failure returns a
+        non-zero libpairwise error code, and makes no guarantee about the
+        state of a_statistics, a_counts or a_sums.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_reduce
+(
+
+    double (*f_calculation)(size_t n_points,
+                            size_t n_coordinates,
+                            double* collection_a,
+                            double* collection_b),
+                            
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    
+    double* a_statistics,
+    
+    double lower,
+    double upper,
+    size_t n_bins,
+    size_t* a_counts,
+    
+    double* a_sums,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_reduce_float
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch_reduce(), but for a calculation on collections of
+        floats, f_calculation. Results are reduced in double precision
+        nonetheless.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_reduce_float
+(
+
+    float (*f_calculation)(size_t n_points,
+                           size_t n_coordinates,
+                           float* collection_a,
+                           float* collection_b),
+                           
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    
+    double* a_statistics,
+    
+    double lower,
+    double upper,
+    size_t n_bins,
+    size_t* a_counts,
+    
+    double* a_sums,
+    
+    size_t n_threads
+
+);
+
+#endif /* PAIRWISE_REDUCE_H */
@@ -3,6 +3,29 @@
 
 #include "pairwise.h"
 
+/*******************************************************************************
+
+    Symbol: _PAIRWISE_QCP_ITERATIONS, _PAIRWISE_QCP_PRECISION,
+            _PAIRWISE_QCP_NOISE
+    
+    Type: Preprocessor constants
+    
+    Intent: Private
+    
+    Description:
+    
+        The most Newton-Raphson iterations _pairwise_qcp_rmsd() takes to find
+        the largest root of the QCP characteristic polynomial, the relative
+        change in the root below which it stops early, and the multiple of
+        DBL_EPSILON times the magnitude of the polynomial's terms below which
+        its value is taken to be lost in rounding, which also stops it.
+        
+*******************************************************************************/
+
+#define _PAIRWISE_QCP_ITERATIONS 50
+#define _PAIRWISE_QCP_PRECISION 1e-11
+#define _PAIRWISE_QCP_NOISE 4
+
 /*******************************************************************************
 
     Symbol: pairwise_rmsds
@@ -71,34 +94,930 @@ pairwise_rmsds
 
 /*******************************************************************************
 
-    Symbol: _pairwise_single_rmsd
+    Symbol: pairwise_rmsds_float
     
-    Type: Inline function returning double
+    Type: Function returning int
     
-    Intent: Private
+    Intent: Public
     
     Description:
     
-        Calculates the single RMSD between two collections of points.
+        As pairwise_rmsds(), but for collections of points whose coordinates are
+        floats rather than doubles, with the RMSDs stored as floats. Arithmetic
+        is carried out in single precision throughout, which roughly halves the
+        memory traffic and doubles the number of coordinates handled per SIMD
+        instruction, at the cost of precision.
         
-        n_points is the number of points per collection, and n_coordinates is
-        the number of coordinates per point. collection_a and collection_b are
-        pointers to arrays containing the coordinates of the two collections
-        involved in this calculation.
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
         
-        On success returns the calculated RMSD. Not expected to fail.
+*******************************************************************************/
+
+int
+pairwise_rmsds_float
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    float* a_rmsds,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_cutoff
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Calculates, as pairwise_rmsds() does, all pairwise RMSDs across a set
+        of collections of points, but keeps only those no greater than
+        cutoff, in compressed sparse row (CSR) form. Memory is needed only for
+        the RMSDs kept, however many collections there are.
+        
+        n_collections, n_points, n_coordinates, a_collections and n_threads
+        are as for pairwise_rmsds(). On success allocates three arrays and
+        stores pointers to them in a_indptr, a_indices and a_rmsds; the caller
+        must free all three with free().
+        
+        *a_indptr holds n_collections + 1 offsets, and *a_indices and *a_rmsds
+        each hold (*a_indptr)[n_collections] elements. For each collection i,
+        elements (*a_indptr)[i] up to but excluding (*a_indptr)[i + 1] of
+        *a_indices hold, in increasing order, every collection j > i whose
+        RMSD from collection i is no greater than cutoff, and the same
+        elements of *a_rmsds hold those RMSDs.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code,
+        and allocates nothing.
         
 *******************************************************************************/
 
-inline double
-_pairwise_single_rmsd
+int
+pairwise_rmsds_cutoff
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    
+    double cutoff,
+    
+    size_t** a_indptr,
+    size_t** a_indices,
+    double** a_rmsds,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_cutoff_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_rmsds_cutoff(), but for collections of points whose
+        coordinates are floats, with the RMSDs kept stored as floats.
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_cutoff_float
 (
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    
+    float cutoff,
+    
+    size_t** a_indptr,
+    size_t** a_indices,
+    float** a_rmsds,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_knn
+    
+    Type: Function returning int
     
+    Intent: Public
+    
+    Description:
+    
+        Calculates, as pairwise_rmsds() does, all pairwise RMSDs across a set
+        of collections, but keeps for each collection only the n_neighbours
+        other collections nearest to it. Memory is needed only for the RMSDs
+        kept, however many collections there are.
+        
+        n_collections, n_points, n_coordinates, a_collections and n_threads
+        are as for pairwise_rmsds(). n_neighbours must be less than
+        n_collections, unless it is zero. a_indices and a_rmsds must each
+        have room for n_collections * n_neighbours elements.
+        
+        For each collection i, elements i * n_neighbours up to but excluding
+        (i + 1) * n_neighbours of a_indices hold the n_neighbours collections
+        nearest to collection i, nearest first, and the same elements of
+        a_rmsds hold their RMSDs from it. Collections at equal RMSDs are
+        ordered by index.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_knn
+(
+
+    size_t n_collections,
     size_t n_points,
     size_t n_coordinates,
     
-    double* collection_a,
-    double* collection_b
+    double* a_collections,
+    
+    size_t n_neighbours,
+    
+    size_t* a_indices,
+    double* a_rmsds,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_knn_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_rmsds_knn(), but for collections whose coordinates are
+        floats, with the RMSDs kept stored as floats.
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_knn_float
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    
+    size_t n_neighbours,
+    
+    size_t* a_indices,
+    float* a_rmsds,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_reduce
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Calculates, as pairwise_rmsds() does, all pairwise RMSDs across a set
+        of collections, but keeps none of them, reducing them instead as they
+        are calculated, as pairwise_distances_reduce() does with distances.
+        
+        n_collections, n_points, n_coordinates, a_collections and n_threads
+        are as for pairwise_rmsds(), and a_statistics, lower, upper, n_bins,
+        a_counts and a_sums as for pairwise_distances_reduce(), with a_sums
+        having room for n_collections elements.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_reduce
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    
+    double* a_statistics,
+    
+    double lower,
+    double upper,
+    size_t n_bins,
+    size_t* a_counts,
+    
+    double* a_sums,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_reduce_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_rmsds_reduce(), but for collections whose coordinates are
+        floats. The RMSDs are reduced in double precision nonetheless.
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_reduce_float
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    
+    double* a_statistics,
+    
+    double lower,
+    double upper,
+    size_t n_bins,
+    size_t* a_counts,
+    
+    double* a_sums,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_linkage
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Clusters a set of collections by single linkage under the RMSD, as
+        pairwise_distances_linkage() does points under the Euclidean distance.
+        
+        n_collections, n_points, n_coordinates, a_collections and n_threads
+        are as for pairwise_rmsds(). a_linkage must have room for
+        (n_collections - 1) * 4 doubles.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_linkage
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    
+    double* a_linkage,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_linkage_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_rmsds_linkage(), but for collections whose coordinates
+        are floats. The linkage is stored in double precision nonetheless.
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_linkage_float
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    
+    double* a_linkage,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_append
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Extends the RMSDs between every pair of n_collections_old collections,
+        as calculated by pairwise_rmsds(), to those between every pair of
+        n_collections_old + n_collections_new collections, as
+        pairwise_distances_append() does distances.
+        
+        a_collections holds all n_collections_old + n_collections_new
+        collections, old first, each of n_points points of n_coordinates
+        coordinates. a_rmsds_old and a_rmsds are as a_distances_old and
+        a_distances are for pairwise_distances_append().
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_append
+(
+
+    size_t n_collections_old,
+    size_t n_collections_new,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    double* a_rmsds_old,
+    double* a_rmsds,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_append_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_rmsds_append(), but for collections whose coordinates are
+        floats, and RMSDs which are stored as floats.
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_append_float
+(
+
+    size_t n_collections_old,
+    size_t n_collections_new,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    float* a_rmsds_old,
+    float* a_rmsds,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_stream
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Calculates, as pairwise_rmsds() does, all pairwise RMSDs across a set
+        of collections, but hands them to the caller tile by tile, through a
+        stream, as threads finish them, so that however many collections
+        there are memory is needed only for a fixed number of tiles.
+        
+        n_collections, n_points, n_coordinates, a_collections and n_threads
+        are as for pairwise_rmsds(). Tiles span no more than
+        n_tile_collections collections a side, and no more than n_queue tiles
+        are in flight at once, threads waiting whenever the caller falls
+        behind; zero for either chooses it automatically. a_collections must
+        outlive the stream.
+        
+        On success stores a pointer to the new stream in stream, from which
+        tiles are read with pairwise_stream_next() and which must be passed
+        to pairwise_stream_close() once done with, and returns
+        PAIRWISE_RETURN_SUCCESS which is always equivalent to integer zero.
+        On failure returns a non-zero libpairwise error code.
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_stream
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    
+    size_t n_tile_collections,
+    size_t n_queue,
+    
+    size_t n_threads,
+    
+    pairwise_stream_t** stream
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_stream_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_rmsds_stream(), but for collections whose coordinates are
+        floats, with the RMSDs handed over as floats.
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_stream_float
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    
+    size_t n_tile_collections,
+    size_t n_queue,
+    
+    size_t n_threads,
+    
+    pairwise_stream_t** stream
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_submit
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Calculates, as pairwise_rmsds() does, all pairwise RMSDs across a set
+        of collections, but on the libpairwise worker pool alone, returning
+        at once with a future through which the calculation can be followed,
+        cancelled and waited for while the calling thread goes on with other
+        work.
+        
+        n_collections, n_points, n_coordinates, a_collections, a_rmsds and
+        n_threads are as for pairwise_rmsds(). a_collections and a_rmsds must
+        outlive the future, and a_rmsds must not be read until
+        pairwise_future_wait() has found the calculation complete.
+        
+        On success stores a pointer to the new future in future, which must
+        be passed to pairwise_future_close() once done with, and returns
+        PAIRWISE_RETURN_SUCCESS which is always equivalent to integer zero.
+        On failure returns a non-zero libpairwise error code.
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_submit
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    double* a_rmsds,
+    
+    size_t n_threads,
+    
+    pairwise_future_t** future
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_submit_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_rmsds_submit(), but for collections whose coordinates are
+        floats, with the RMSDs stored as floats.
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_submit_float
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    float* a_rmsds,
+    
+    size_t n_threads,
+    
+    pairwise_future_t** future
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_cross_rmsds
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Calculates the RMSD between every collection in one set,
+        a_collections_a, and every collection in another, a_collections_b,
+        rather than between every pair of collections in one set.
+        
+        n_collections_a and n_collections_b are the numbers of collections in
+        a_collections_a and a_collections_b, n_points is the number of points
+        per collection and n_coordinates the number of coordinates per point
+        in both. n_threads is as for pairwise_rmsds(). a_rmsds must be large
+        enough to store n_collections_a * n_collections_b doubles; the RMSD
+        between collection i of a_collections_a and collection j of
+        a_collections_b is stored in element i * n_collections_b + j, so
+        a_rmsds is a row-major n_collections_a by n_collections_b matrix.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+*******************************************************************************/
+
+int
+pairwise_cross_rmsds
+(
+
+    size_t n_collections_a,
+    size_t n_collections_b,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections_a,
+    double* a_collections_b,
+    double* a_rmsds,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_cross_rmsds_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_cross_rmsds(), but for collections whose coordinates are
+        floats, with the RMSDs stored as floats.
+        
+*******************************************************************************/
+
+int
+pairwise_cross_rmsds_float
+(
+
+    size_t n_collections_a,
+    size_t n_collections_b,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections_a,
+    float* a_collections_b,
+    float* a_rmsds,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_superposed
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Calculates all pairwise RMSDs across a set of collections of points in
+        three-dimensional space, as pairwise_rmsds() does, but after optimally
+        superposing each pair: that is, the smallest RMSD between the two
+        collections over every translation and rotation of one onto the
+        other.
+        
+        n_collections, n_points, a_collections, a_rmsds and n_threads are as
+        for pairwise_rmsds(). n_coordinates must be three.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_superposed
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    double* a_rmsds,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_superposed_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_rmsds_superposed(), but for collections whose coordinates
+        are floats, with the RMSDs stored as floats.
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_superposed_float
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    float* a_rmsds,
+    
+    size_t n_threads
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_single_rmsd
+    
+    Type: Function returning double
+    
+    Intent: Private
+    
+    Description:
+    
+        Calculates the single RMSD between two collections of points.
+        
+        n_points is the number of points per collection, and n_coordinates is
+        the number of coordinates per point. collection_a and collection_b are
+        pointers to arrays containing the coordinates of the two collections
+        involved in this calculation.
+        
+        On success returns the calculated RMSD. Not expected to fail.
+        
+*******************************************************************************/
+
+double
+_pairwise_single_rmsd
+(
+    
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* collection_a,
+    double* collection_b
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_single_rmsd_float
+    
+    Type: Function returning float
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_single_rmsd(), but for collections of floats. Compatible
+        with _pairwise_launch_float().
+        
+*******************************************************************************/
+
+float
+_pairwise_single_rmsd_float
+(
+
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* collection_a,
+    float* collection_b
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_superpose_collections
+    
+    Type: Function returning double*
+    
+    Intent: Private
+    
+    Description:
+    
+        Prepares a set of n_collections collections of n_points points in
+        three-dimensional space, a_collections, for
+        _pairwise_single_rmsd_superposed(). Copies every collection, centred
+        on its centroid, to a new array, and follows it with one more point
+        whose first coordinate is G, the sum of the squared norms of the
+        centred points, and whose other coordinates are zero.
+        
+        On success returns a pointer to the new array of
+        n_collections * (n_points + 1) points, which the caller must free. On
+        failure returns a null pointer.
+        
+*******************************************************************************/
+
+double*
+_pairwise_superpose_collections
+(
+
+    size_t n_collections,
+    size_t n_points,
+    
+    double* a_collections
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_superpose_collections_float
+    
+    Type: Function returning float*
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_superpose_collections(), but for collections of floats.
+        Centroids and G are accumulated in double precision, and G is stored
+        as the sum of the first two coordinates of the extra point, a float
+        and the float nearest to its rounding error.
+        
+*******************************************************************************/
+
+float*
+_pairwise_superpose_collections_float
+(
+
+    size_t n_collections,
+    size_t n_points,
+    
+    float* a_collections
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_single_rmsd_superposed
+    
+    Type: Function returning double
+    
+    Intent: Private
+    
+    Description:
+    
+        Calculates the single RMSD between two collections of points in
+        three-dimensional space after optimal superposition, given each as
+        prepared by _pairwise_superpose_collections(): centred, and followed
+        by one more point holding its G.
+        
+        n_points is the number of points per prepared collection, one more
+        than in the collection itself, and n_coordinates must be three.
+        collection_a and collection_b are pointers to the two prepared
+        collections involved in this calculation.
+        
+        On success returns the superposed RMSD. Not expected to fail.
+        
+*******************************************************************************/
+
+double
+_pairwise_single_rmsd_superposed
+(
+
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* collection_a,
+    double* collection_b
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_single_rmsd_superposed_float
+    
+    Type: Function returning float
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_single_rmsd_superposed(), but for collections of floats
+        prepared by _pairwise_superpose_collections_float(). Compatible with
+        _pairwise_launch_float(). The inner products are accumulated, and the
+        QCP root found, in double precision.
+        
+*******************************************************************************/
+
+float
+_pairwise_single_rmsd_superposed_float
+(
+
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* collection_a,
+    float* collection_b
 
 );
 
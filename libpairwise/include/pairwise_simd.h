@@ -0,0 +1,356 @@
+#ifndef PAIRWISE_SIMD_H
+#define PAIRWISE_SIMD_H
+
+#include "pairwise.h"
+
+/*******************************************************************************
+
+    Symbol: PAIRWISE_ISA_*
+    
+    Type: Family of preprocessor constants
+    
+    Intent: Public
+    
+    Description:
+    
+        Identifiers for the instruction set architectures for which
+        libpairwise provides calculation kernels. PAIRWISE_ISA_AUTO requests
+        the widest instruction set supported by the host, as detected with
+        cpuid when libpairwise is loaded.
+        
+*******************************************************************************/
+
+#define PAIRWISE_ISA_AUTO 0
+#define PAIRWISE_ISA_SCALAR 1
+#define PAIRWISE_ISA_SSE2 2
+#define PAIRWISE_ISA_AVX2 3
+#define PAIRWISE_ISA_AVX512 4
+
+/*
+*   Kernels for instruction sets other than the scalar fallback are only built
+*   by compilers which can target individual functions at extended x86
+*   instruction sets, so that one libpairwise.a runs on any x86-64 host.
+*/
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define _PAIRWISE_SIMD_X86 1
+#endif
+
+/*******************************************************************************
+
+    Symbol: pairwise_set_isa
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Selects the instruction set architecture whose kernels all subsequent
+        libpairwise calculations will use. n_isa is one of PAIRWISE_ISA_*.
+        Passing PAIRWISE_ISA_AUTO restores the selection made when libpairwise
+        was loaded.
+        
+        Fails if n_isa is not a recognised identifier, or if the host does not
+        support the requested instruction set.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code,
+        and leaves the current selection unchanged.
+        
+*******************************************************************************/
+
+int
+pairwise_set_isa
+(
+
+    int n_isa
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_get_isa
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Returns the PAIRWISE_ISA_* identifier of the instruction set
+        architecture whose kernels libpairwise calculations currently use.
+        Never returns PAIRWISE_ISA_AUTO. Not expected to fail.
+        
+*******************************************************************************/
+
+int
+pairwise_get_isa
+(void);
+
+/*******************************************************************************
+
+    Symbol: pairwise_isa_supported
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Returns integer one if the host supports the instruction set
+        architecture identified by n_isa, one of PAIRWISE_ISA_*, and if
+        libpairwise was built with kernels for it. Otherwise returns integer
+        zero. Not expected to fail.
+        
+*******************************************************************************/
+
+int
+pairwise_isa_supported
+(
+
+    int n_isa
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_sum_squared_differences,
+            _pairwise_sum_squared_differences_float
+    
+    Type: Pointers to functions returning double and float
+    
+    Intent: Private
+    
+    Description:
+    
+        Point to the kernels for the instruction set architecture currently
+        selected by pairwise_set_isa(), or at load time. The kernels return
+        the sum of the squared differences between the n_elements doubles (or
+        floats) starting at a and the n_elements doubles (or floats) starting
+        at b.
+        
+*******************************************************************************/
+
+extern double
+(*_pairwise_sum_squared_differences)
+(
+
+    size_t n_elements,
+    
+    const double* a,
+    const double* b
+
+);
+
+extern float
+(*_pairwise_sum_squared_differences_float)
+(
+
+    size_t n_elements,
+    
+    const float* a,
+    const float* b
+
+);
+
+/*******************************************************************************
+
+    Symbol: _PAIRWISE_SUM_SQUARED_DIFFERENCES_2,
+            _PAIRWISE_SUM_SQUARED_DIFFERENCES_3,
+            _PAIRWISE_SUM_SQUARED_DIFFERENCES_4,
+            _PAIRWISE_SUM_SQUARED_DIFFERENCES_8,
+            _PAIRWISE_SUM_SQUARED_DIFFERENCES_6,
+            _PAIRWISE_SUM_SQUARED_DIFFERENCES_12
+            
+    Type: Family of preprocessor macros
+    
+    Intent: Private
+    
+    Description:
+    
+        Expand to the sum of the squared differences between the first 2, 3,
+        4 or 8 elements at a and those at b, as does a call to a kernel with
+        that n_elements, but written out in full so that the compiler can
+        inline and schedule it with no loop at all. The additions always form
+        the same tree, whatever the element type.
+        
+        _PAIRWISE_SUM_SQUARED_DIFFERENCES_6 and _12 do the same for the 6 or
+        12 coordinates of collections of 2 or 4 points in three dimensions,
+        summing each point with _PAIRWISE_SUM_SQUARED_DIFFERENCES_3 and then
+        the two halves.
+        
+        Points and collections of these common shapes are summed with these
+        macros rather than with the kernels, whichever instruction set is
+        selected, by every calculation on them, so that a result is the same
+        to the bit however it is reached.
+        
+*******************************************************************************/
+
+#define _PAIRWISE_SUM_SQUARED_DIFFERENCES_2(a, b) \
+    (_PAIRWISE_SQUARE(*(a) - *(b)) + _PAIRWISE_SQUARE(*((a) + 1) - *((b) + 1)))
+    
+#define _PAIRWISE_SUM_SQUARED_DIFFERENCES_3(a, b) \
+    (_PAIRWISE_SUM_SQUARED_DIFFERENCES_2(a, b) \
+   + _PAIRWISE_SQUARE(*((a) + 2) - *((b) + 2)))
+   
+#define _PAIRWISE_SUM_SQUARED_DIFFERENCES_4(a, b) \
+    (_PAIRWISE_SUM_SQUARED_DIFFERENCES_2(a, b) \
+   + _PAIRWISE_SUM_SQUARED_DIFFERENCES_2((a) + 2, (b) + 2))
+   
+#define _PAIRWISE_SUM_SQUARED_DIFFERENCES_8(a, b) \
+    (_PAIRWISE_SUM_SQUARED_DIFFERENCES_4(a, b) \
+   + _PAIRWISE_SUM_SQUARED_DIFFERENCES_4((a) + 4, (b) + 4))
+   
+#define _PAIRWISE_SUM_SQUARED_DIFFERENCES_6(a, b) \
+    (_PAIRWISE_SUM_SQUARED_DIFFERENCES_3(a, b) \
+   + _PAIRWISE_SUM_SQUARED_DIFFERENCES_3((a) + 3, (b) + 3))
+   
+#define _PAIRWISE_SUM_SQUARED_DIFFERENCES_12(a, b) \
+    (_PAIRWISE_SUM_SQUARED_DIFFERENCES_6(a, b) \
+   + _PAIRWISE_SUM_SQUARED_DIFFERENCES_6((a) + 6, (b) + 6))
+   
+/*******************************************************************************
+
+    Symbol: _PAIRWISE_UNVECTORISED
+    
+    Type: Preprocessor macro
+    
+    Intent: Private
+    
+    Description:
+    
+        Marks a function which the compiler must not vectorise, neither its
+        loops nor the straight-line code within them. Every function which
+        expands _PAIRWISE_SUM_SQUARED_DIFFERENCES_2 or its kin is so marked.
+        
+    Further Information:
+    
+        libpairwise is built with -Ofast, which lets the compiler add terms
+        in whatever order it likes. Vectorised, the same sum may be added up
+        one way in one function, another way in another, and a third way in
+        the scalar remainder of a loop, so that a distance would depend on
+        how it was reached and even on the number of threads. Kept scalar,
+        every expansion adds its terms alike. Spelled for GCC, which
+        libpairwise is built with; elsewhere this expands to nothing.
+        
+*******************************************************************************/
+
+#if defined(__GNUC__) && !defined(__clang__)
+#define _PAIRWISE_UNVECTORISED __attribute__((optimize("no-tree-vectorize")))
+#else
+#define _PAIRWISE_UNVECTORISED
+#endif
+
+/*******************************************************************************
+
+    Symbol: _pairwise_sum_squared_differences_*
+    
+    Type: Family of functions returning double or float
+    
+    Intent: Private
+    
+    Description:
+    
+        Kernels for each instruction set architecture to which
+        _pairwise_sum_squared_differences (or, for the _float_ kernels,
+        _pairwise_sum_squared_differences_float) may point. Each returns the
+        sum of the squared differences between the n_elements doubles (or
+        floats) starting at a and the n_elements doubles (or floats) starting
+        at b. Neither a nor b need be aligned. Not expected to fail.
+        
+*******************************************************************************/
+
+double
+_pairwise_sum_squared_differences_scalar
+(
+
+    size_t n_elements,
+    
+    const double* a,
+    const double* b
+
+);
+
+float
+_pairwise_sum_squared_differences_float_scalar
+(
+
+    size_t n_elements,
+    
+    const float* a,
+    const float* b
+
+);
+
+#if defined(_PAIRWISE_SIMD_X86)
+
+double
+_pairwise_sum_squared_differences_sse2
+(
+
+    size_t n_elements,
+    
+    const double* a,
+    const double* b
+
+);
+
+double
+_pairwise_sum_squared_differences_avx2
+(
+
+    size_t n_elements,
+    
+    const double* a,
+    const double* b
+
+);
+
+double
+_pairwise_sum_squared_differences_avx512
+(
+
+    size_t n_elements,
+    
+    const double* a,
+    const double* b
+
+);
+
+float
+_pairwise_sum_squared_differences_float_sse2
+(
+
+    size_t n_elements,
+    
+    const float* a,
+    const float* b
+
+);
+
+float
+_pairwise_sum_squared_differences_float_avx2
+(
+
+    size_t n_elements,
+    
+    const float* a,
+    const float* b
+
+);
+
+float
+_pairwise_sum_squared_differences_float_avx512
+(
+
+    size_t n_elements,
+    
+    const float* a,
+    const float* b
+
+);
+
+#endif /* _PAIRWISE_SIMD_X86 */
+
+#endif /* PAIRWISE_SIMD_H */
@@ -0,0 +1,141 @@
+#ifndef PAIRWISE_STATS_H
+#define PAIRWISE_STATS_H
+
+#include "pairwise.h"
+
+struct _pairwise_job;
+
+/*******************************************************************************
+
+    Symbol: pairwise_stats_t
+    
+    Type: Structure
+    
+    Intent: Public
+    
+    Description:
+    
+        Statistics of the last calculation carried out by the calling thread,
+        as filled in by pairwise_stats_last(). All times are in seconds of
+        the monotonic clock.
+        
+        prepare_seconds is the time taken to cut the calculation into chunks
+        and allocate what the threads need; spawn_seconds the time from
+        handing the chunks to the worker pool until the last thread had begun
+        carrying them out, which includes creating any workers the pool
+        lacked; and compute_seconds the time from then until every thread
+        had finished.
+        
+        n_threads is the number of threads which took part, and n_pairs the
+        number of pairwise calculations they carried out. n_bytes is the
+        size of the input array, plus that of the results if they were all
+        stored, each counted once; it is a lower bound on the memory traffic
+        of the calculation. a_thread_seconds and a_thread_pairs point to
+        n_threads elements each, the wall time of each thread from beginning
+        to finishing its part and the pairwise calculations it carried out,
+        stolen chunks included; they stay valid until the calling thread's
+        next calculation, and must not be freed.
+        
+*******************************************************************************/
+
+typedef struct
+pairwise_stats
+{
+
+    double prepare_seconds;
+    double spawn_seconds;
+    double compute_seconds;
+    
+    size_t n_threads;
+    size_t n_pairs;
+    size_t n_bytes;
+    
+    const double* a_thread_seconds;
+    const size_t* a_thread_pairs;
+
+} pairwise_stats_t;
+
+/*******************************************************************************
+
+    Symbol: pairwise_stats_last
+    
+    Type: Function returning void
+    
+    Intent: Public
+    
+    Description:
+    
+        Stores in stats the statistics of the last calculation carried out
+        by the calling thread, by any libpairwise function whose calculation
+        the calling thread waits for, such as pairwise_distances() or
+        pairwise_rmsds_knn(). Calculations through streams and futures are
+        not recorded. If the calling thread has carried out no calculation,
+        or its statistics could not be recorded, every member of stats is
+        zero, or null.
+        
+        Returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+void
+pairwise_stats_last
+(
+
+    pairwise_stats_t* stats
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_stats_clock
+    
+    Type: Function returning double
+    
+    Intent: Private
+    
+    Description:
+    
+        Returns the time, in seconds, of the monotonic clock, which is
+        unaffected by changes to the time of day. Only differences between
+        its values are meaningful.
+        
+*******************************************************************************/
+
+double
+_pairwise_stats_clock
+(void);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_stats_record
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Records, as the statistics of the calling thread's last calculation,
+        those of job, whose every thread has finished but whose argument sets
+        have not yet been released. t_prepare, t_submit and t_done are the
+        times, of _pairwise_stats_clock(), at which job began to be prepared,
+        was handed to the worker pool, and was found finished.
+        
+        Returns nothing. If memory for the statistics cannot be allocated,
+        records none, so that pairwise_stats_last() finds zeros.
+        
+*******************************************************************************/
+
+void
+_pairwise_stats_record
+(
+
+    struct _pairwise_job* job,
+    
+    double t_prepare,
+    double t_submit,
+    double t_done
+
+);
+
+#endif /* PAIRWISE_STATS_H */
@@ -0,0 +1,288 @@
+#ifndef PAIRWISE_STREAM_H
+#define PAIRWISE_STREAM_H
+
+#include "pairwise.h"
+
+struct _pairwise_job;
+
+/*******************************************************************************
+
+    Symbol: _PAIRWISE_STREAM_TILE_COLLECTIONS, _PAIRWISE_STREAM_TILES_PER_THREAD
+    
+    Type: Preprocessor constants
+    
+    Intent: Private
+    
+    Description:
+    
+        The longest side of the tiles of a stream, in collections, and the
+        number of tiles per thread which may be in flight at once, when the
+        caller of _pairwise_launch_stream() asks for either to be chosen
+        automatically. A tile of doubles of the default side takes 8 MiB.
+        
+*******************************************************************************/
+
+#define _PAIRWISE_STREAM_TILE_COLLECTIONS 1024
+#define _PAIRWISE_STREAM_TILES_PER_THREAD 2
+
+/*******************************************************************************
+
+    Symbol: _pairwise_tile_t
+    
+    Type: Structure
+    
+    Intent: Private
+    
+    Description:
+    
+        One of the fixed number of tiles of a stream, each of which is at any
+        time either free, being filled by a thread, ready to be read, or held
+        by the reader. a_block has room for the results of the largest tile
+        of the stream's job; while filled it holds the results of every
+        pairwise calculation between collections i_row_lower up to but
+        excluding i_row_upper and collections i_column_lower up to but
+        excluding i_column_upper, as a row-major matrix. next links the tile
+        into the list of free tiles or the queue of ready tiles.
+        
+*******************************************************************************/
+
+typedef struct
+_pairwise_tile
+{
+
+    void* a_block;
+    
+    size_t i_row_lower;
+    size_t i_row_upper;
+    size_t i_column_lower;
+    size_t i_column_upper;
+    
+    struct _pairwise_tile* next;
+
+} _pairwise_tile_t;
+
+/*******************************************************************************
+
+    Symbol: pairwise_stream_next
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Waits for the next tile of stream to be finished, and stores in
+        a_block a pointer to its results and in i_row_lower, i_row_upper,
+        i_column_lower and i_column_upper the collections - or points - it
+        covers. The results are those between every collection from
+        i_row_lower up to but excluding i_row_upper and every collection from
+        i_column_lower up to but excluding i_column_upper, as a row-major
+        matrix of doubles or floats, as the stream was created for.
+        
+        Tiles cover the upper triangle of the matrix of all pairwise results
+        once each, in whatever order threads finish them. A tile on the
+        diagonal, whose rows and columns are the same collections, is
+        completed by symmetry, with zero on its diagonal.
+        
+        The results stay valid until the next call to pairwise_stream_next()
+        or pairwise_stream_close() for stream, after which the tile is reused.
+        Once every tile has been handed over, stores a null pointer in
+        a_block. Only one thread at a time may read from a stream.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure of the calculation returns a non-zero
+        libpairwise error code, in place of the end of the stream.
+        
+*******************************************************************************/
+
+int
+pairwise_stream_next
+(
+
+    pairwise_stream_t* stream,
+    
+    size_t* i_row_lower,
+    size_t* i_row_upper,
+    size_t* i_column_lower,
+    size_t* i_column_upper,
+    
+    void** a_block
+
+);
+
+/*******************************************************************************
+
+    Symbol: pairwise_stream_close
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Stops stream, whether or not every tile has been read, waits for its
+        threads to finish the tiles they are filling, and frees it.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code;
+        stream is freed nonetheless.
+        
+*******************************************************************************/
+
+int
+pairwise_stream_close
+(
+
+    pairwise_stream_t* stream
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_row_stream, _pairwise_launch_row_stream_float
+    
+    Type: Functions returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Row drivers for job->f_row. Carry out the pairwise calculations
+        between collection i_collection_a of job and each of collections
+        i_collection_b_lower up to but excluding i_collection_b_upper, by
+        calling job->f_calculation on doubles or job->f_calculation_float on
+        floats respectively, and store their results in the row of the block
+        of sink, the _pairwise_tile_t being filled. a_results_row is ignored.
+        
+        On success return nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+void
+_pairwise_launch_row_stream
+(
+
+    struct _pairwise_job* job,
+    
+    void* sink,
+    
+    size_t i_collection_a,
+    size_t i_collection_b_lower,
+    size_t i_collection_b_upper,
+    
+    void* a_results_row
+
+);
+
+void
+_pairwise_launch_row_stream_float
+(
+
+    struct _pairwise_job* job,
+    
+    void* sink,
+    
+    size_t i_collection_a,
+    size_t i_collection_b_lower,
+    size_t i_collection_b_upper,
+    
+    void* a_results_row
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_stream
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Starts applying a calculation function, f_calculation, to all
+        pairwise combinations of collections in a set of collections,
+        a_collections, as _pairwise_launch() does, but hands the results to
+        the caller tile by tile through a new stream, a pointer to which is
+        stored in stream.
+        
+        n_collections, n_points, n_coordinates, a_collections and n_threads
+        are as for _pairwise_launch(). Tiles are no more than
+        n_tile_collections collections a side, and smaller if the
+        collections would not otherwise fit in cache. No more than n_queue
+        tiles are in flight at once - being filled, waiting to be read or
+        being read - so threads wait whenever the reader falls behind, and
+        memory is fixed at n_queue tiles. Zero for either chooses it
+        automatically. a_collections must outlive the stream.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero; the caller must then pass the stream to
+        pairwise_stream_close(). On failure returns a non-zero libpairwise
+        error code, and creates no stream.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_stream
+(
+
+    double (*f_calculation)(size_t n_points,
+                            size_t n_coordinates,
+                            double* collection_a,
+                            double* collection_b),
+                            
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    
+    size_t n_tile_collections,
+    size_t n_queue,
+    
+    size_t n_threads,
+    
+    pairwise_stream_t** stream
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_stream_float
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch_stream(), but for a calculation on collections of
+        floats, f_calculation, whose results are handed over as floats.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_stream_float
+(
+
+    float (*f_calculation)(size_t n_points,
+                           size_t n_coordinates,
+                           float* collection_a,
+                           float* collection_b),
+                           
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    
+    size_t n_tile_collections,
+    size_t n_queue,
+    
+    size_t n_threads,
+    
+    pairwise_stream_t** stream
+
+);
+
+#endif /* PAIRWISE_STREAM_H */
@@ -0,0 +1,93 @@
+#ifndef PAIRWISE_THREADS_H
+#define PAIRWISE_THREADS_H
+
+#include "pairwise.h"
+
+/*******************************************************************************
+
+    Symbol: _PAIRWISE_THREADS_MIN_ELEMENTS
+    
+    Type: Preprocessor constant
+    
+    Intent: Private
+    
+    Description:
+    
+        The number of coordinate differences that pairwise_threads_suggested()
+        expects each thread to work through before the cost of waking it is
+        repaid.
+        
+*******************************************************************************/
+
+#define _PAIRWISE_THREADS_MIN_ELEMENTS 262144
+
+/*******************************************************************************
+
+    Symbol: pairwise_threads_available
+    
+    Type: Function returning size_t
+    
+    Intent: Public
+    
+    Description:
+    
+        Returns the number of threads which the calling thread can usefully
+        run in parallel: the number of processors in its CPU affinity mask,
+        further limited by any CPU quota set on its control group. Always
+        returns at least one. Not expected to fail.
+        
+*******************************************************************************/
+
+size_t
+pairwise_threads_available
+(void);
+
+/*******************************************************************************
+
+    Symbol: pairwise_threads_suggested
+    
+    Type: Function returning size_t
+    
+    Intent: Public
+    
+    Description:
+    
+        Returns the number of threads with which to carry out all pairwise
+        calculations across n_collections collections of n_points points of
+        n_coordinates coordinates each. This is pairwise_threads_available(),
+        reduced for small inputs so that every thread has enough work to
+        repay waking it. Always returns at least one. Not expected to fail.
+        
+*******************************************************************************/
+
+size_t
+pairwise_threads_suggested
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates
+
+);
+
+/*******************************************************************************
+
+    Symbol: _pairwise_threads_quota
+    
+    Type: Function returning size_t
+    
+    Intent: Private
+    
+    Description:
+    
+        Returns the CPU quota of the control group of the calling process,
+        rounded up to whole processors, or zero if there is no quota or it
+        cannot be read. Looked up once, on first call. Not expected to fail.
+        
+*******************************************************************************/
+
+size_t
+_pairwise_threads_quota
+(void);
+
+#endif /* PAIRWISE_THREADS_H */
@@ -0,0 +1,702 @@
+#include "pairwise_cutoff.h"
+
+/*******************************************************************************
+
+    Symbol: _pairwise_hits_grow
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Doubles the room for hits in hits, or makes room for
+        _PAIRWISE_CUTOFF_HITS_INITIAL hits if it has none yet.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure records and returns
+        PAIRWISE_RETURN_MALLOC_FAIL, leaving the hits already recorded intact.
+        
+*******************************************************************************/
+
+static int
+_pairwise_hits_grow
+(
+
+    _pairwise_hits_t* hits
+
+)
+{
+
+    _pairwise_hit_t* a_hits;
+    
+    size_t l_hits;
+    
+    l_hits = hits->l_hits ? 2 * hits->l_hits : _PAIRWISE_CUTOFF_HITS_INITIAL;
+    
+    a_hits = realloc(hits->a_hits, l_hits * sizeof(_pairwise_hit_t));
+    
+    if (!a_hits) {
+        
+        hits->n_return = PAIRWISE_RETURN_MALLOC_FAIL;
+        
+        return hits->n_return;
+    
+    }
+    
+    hits->a_hits = a_hits;
+    hits->l_hits = l_hits;
+    
+    return PAIRWISE_RETURN_SUCCESS;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_row_cutoff
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Row driver for job->f_row. Carries out the pairwise calculations
+        between collection i_collection_a of job and each of collections
+        i_collection_b_lower up to but excluding i_collection_b_upper, by
+        calling job->f_calculation on doubles, and appends those whose results
+        are no greater than job->cutoff to sink, a _pairwise_hits_t.
+        a_results_row is ignored.
+        
+        On success returns nothing. On failure to grow sink, records
+        PAIRWISE_RETURN_MALLOC_FAIL in it.
+        
+*******************************************************************************/
+
+void
+_pairwise_launch_row_cutoff
+(
+
+    _pairwise_job_t* job,
+    
+    void* sink,
+    
+    size_t i_collection_a,
+    size_t i_collection_b_lower,
+    size_t i_collection_b_upper,
+    
+    void* a_results_row
+
+)
+{
+
+    double (*f_calculation)(size_t n_points,
+                            size_t n_coordinates,
+                            double* collection_a,
+                            double* collection_b);
+                            
+    _pairwise_hits_t* hits;
+    _pairwise_hit_t* hit;
+    
+    double* a_collections;
+    double* a_collections_b;
+    
+    double* collection_a;
+    double* collection_b;
+    
+    double cutoff;
+    double result;
+    
+    size_t n_points;
+    size_t n_coordinates;
+    
+    size_t i_collection_b;
+    
+    hits = sink;
+    
+    if (hits->n_return) {
+        
+        return;
+    
+    }
+    
+    f_calculation = job->f_calculation;
+    
+    a_collections = job->a_collections;
+    a_collections_b = job->a_collections_b;
+    
+    cutoff = job->cutoff;
+    
+    n_points = job->n_points;
+    n_coordinates = job->n_coordinates;
+    
+    collection_a = a_collections + (i_collection_a * n_points * n_coordinates);
+    
+    for (i_collection_b = i_collection_b_lower;
+         i_collection_b < i_collection_b_upper;
+         i_collection_b ++) {
+             
+        collection_b = a_collections_b + (i_collection_b * n_points * n_coordinates);
+        
+        result = f_calculation(n_points, n_coordinates, collection_a, collection_b);
+        
+        if (!(result <= cutoff)) {
+            
+            continue;
+        
+        }
+        
+        if (hits->n_hits == hits->l_hits && _pairwise_hits_grow(hits)) {
+            
+            return;
+        
+        }
+        
+        hit = hits->a_hits + (hits->n_hits ++);
+        
+        hit->i_collection_a = i_collection_a;
+        hit->i_collection_b = i_collection_b;
+        
+        hit->result = result;
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_row_cutoff_float
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch_row_cutoff(), but calling job->f_calculation_float
+        on floats.
+        
+*******************************************************************************/
+
+void
+_pairwise_launch_row_cutoff_float
+(
+
+    _pairwise_job_t* job,
+    
+    void* sink,
+    
+    size_t i_collection_a,
+    size_t i_collection_b_lower,
+    size_t i_collection_b_upper,
+    
+    void* a_results_row
+
+)
+{
+
+    float (*f_calculation)(size_t n_points,
+                           size_t n_coordinates,
+                           float* collection_a,
+                           float* collection_b);
+                           
+    _pairwise_hits_t* hits;
+    _pairwise_hit_t* hit;
+    
+    float* a_collections;
+    float* a_collections_b;
+    
+    float* collection_a;
+    float* collection_b;
+    
+    float cutoff;
+    float result;
+    
+    size_t n_points;
+    size_t n_coordinates;
+    
+    size_t i_collection_b;
+    
+    hits = sink;
+    
+    if (hits->n_return) {
+        
+        return;
+    
+    }
+    
+    f_calculation = job->f_calculation_float;
+    
+    a_collections = job->a_collections;
+    a_collections_b = job->a_collections_b;
+    
+    cutoff = job->cutoff;
+    
+    n_points = job->n_points;
+    n_coordinates = job->n_coordinates;
+    
+    collection_a = a_collections + (i_collection_a * n_points * n_coordinates);
+    
+    for (i_collection_b = i_collection_b_lower;
+         i_collection_b < i_collection_b_upper;
+         i_collection_b ++) {
+             
+        collection_b = a_collections_b + (i_collection_b * n_points * n_coordinates);
+        
+        result = f_calculation(n_points, n_coordinates, collection_a, collection_b);
+        
+        if (!(result <= cutoff)) {
+            
+            continue;
+        
+        }
+        
+        if (hits->n_hits == hits->l_hits && _pairwise_hits_grow(hits)) {
+            
+            return;
+        
+        }
+        
+        hit = hits->a_hits + (hits->n_hits ++);
+        
+        hit->i_collection_a = i_collection_a;
+        hit->i_collection_b = i_collection_b;
+        
+        hit->result = result;
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_hit_compare
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Orders two hits of the same row, a and b, by their second collection,
+        for qsort().
+        
+        Returns a negative integer, zero or a positive integer as a comes
+        before, with or after b. Not expected to fail.
+        
+*******************************************************************************/
+
+static int
+_pairwise_hit_compare
+(
+
+    const void* a,
+    const void* b
+
+)
+{
+
+    size_t i_collection_b_a;
+    size_t i_collection_b_b;
+    
+    i_collection_b_a = ((const _pairwise_hit_t*)a)->i_collection_b;
+    i_collection_b_b = ((const _pairwise_hit_t*)b)->i_collection_b;
+    
+    return (i_collection_b_a > i_collection_b_b) - (i_collection_b_a < i_collection_b_b);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_cutoff_job
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Carries out every pairwise calculation described by job, whose
+        calculation, cutoff row driver, input array, element size, cutoff and
+        dimensions must already be set, over n_threads threads, and gathers
+        the hits into CSR arrays as described for _pairwise_launch_cutoff().
+        Results are stored in *a_results as elements of job->s_element bytes.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code,
+        and allocates nothing.
+        
+    Further Information:
+    
+        Each thread appends its hits to its own _pairwise_hits_t in whatever
+        order it happens to carry out its chunks, so threads never wait on
+        one another, and memory grows with the number of hits rather than
+        with the number of pairwise calculations.
+        
+        Once every chunk is done, the hits of all threads are counted by row
+        to give the row offsets, and then moved row by row into one array,
+        freeing each thread's hits as soon as they are moved. A row's hits
+        may come from several tiles, carried out by several threads, so each
+        row is then sorted by second collection before being split into
+        indices and results.
+        
+*******************************************************************************/
+
+static int
+_pairwise_launch_cutoff_job
+(
+
+    _pairwise_job_t* job,
+    
+    size_t** a_indptr,
+    size_t** a_indices,
+    void** a_results,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    _pairwise_hits_t* a_sinks;
+    _pairwise_hits_t* hits;
+    
+    _pairwise_hit_t* a_hits;
+    _pairwise_hit_t* hit;
+    
+    size_t* a_row_offsets;
+    size_t* a_row_fills;
+    size_t* a_row_indices;
+    
+    void* a_row_results;
+    
+    size_t n_collections;
+    size_t n_hits;
+    
+    size_t i_sink;
+    size_t i_hit;
+    size_t i_collection;
+    
+    n_collections = job->n_collections;
+    
+    /*
+    *   Give every thread a sink of its own. (A request for zero threads is
+    *   refused by _pairwise_launch_job(), but still needs a sink here.)
+    */
+    
+    a_sinks = calloc(n_threads ? n_threads : 1, sizeof(_pairwise_hits_t));
+    
+    if (!a_sinks) {
+        
+        return PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    job->a_results = NULL;
+    
+    job->a_sinks = a_sinks;
+    job->s_sink = sizeof(_pairwise_hits_t);
+    
+    job->b_cross = 0;
+    job->b_append = 0;
+    
+    n_return = _pairwise_launch_job(job, n_threads);
+    
+    /*
+    *   Count the hits of every thread by row, and check that every thread
+    *   managed to record all of its hits.
+    */
+    
+    a_row_offsets = calloc(n_collections + 1, sizeof(size_t));
+    a_row_fills = malloc((n_collections + 1) * sizeof(size_t));
+    
+    if (!n_return && (!a_row_offsets || !a_row_fills)) {
+        
+        n_return = PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    n_hits = 0;
+    
+    for (i_sink = 0; i_sink < n_threads && !n_return; i_sink ++) {
+        
+        hits = a_sinks + i_sink;
+        
+        n_return = hits->n_return;
+        
+        for (i_hit = 0; i_hit < hits->n_hits; i_hit ++) {
+            
+            (*(a_row_offsets + (hits->a_hits + i_hit)->i_collection_a + 1)) ++;
+        
+        }
+        
+        n_hits += hits->n_hits;
+    
+    }
+    
+    a_hits = NULL;
+    
+    if (!n_return) {
+        
+        a_hits = malloc((n_hits ? n_hits : 1) * sizeof(_pairwise_hit_t));
+        
+        if (!a_hits) {
+            
+            n_return = PAIRWISE_RETURN_MALLOC_FAIL;
+        
+        }
+    
+    }
+    
+    if (n_return) {
+        
+        for (i_sink = 0; i_sink < n_threads; i_sink ++) {
+            
+            free((a_sinks + i_sink)->a_hits);
+        
+        }
+        
+        free(a_sinks);
+        free(a_row_offsets);
+        free(a_row_fills);
+        
+        return n_return;
+    
+    }
+    
+    for (i_collection = 0; i_collection < n_collections; i_collection ++) {
+        
+        *(a_row_offsets + i_collection + 1) += *(a_row_offsets + i_collection);
+        
+        *(a_row_fills + i_collection) = *(a_row_offsets + i_collection);
+    
+    }
+    
+    /*
+    *   Move every hit into its row of a_hits, freeing each thread's hits as
+    *   soon as they have been moved.
+    */
+    
+    for (i_sink = 0; i_sink < n_threads; i_sink ++) {
+        
+        hits = a_sinks + i_sink;
+        
+        for (i_hit = 0; i_hit < hits->n_hits; i_hit ++) {
+            
+            hit = hits->a_hits + i_hit;
+            
+            *(a_hits + ((*(a_row_fills + hit->i_collection_a)) ++)) = *hit;
+        
+        }
+        
+        free(hits->a_hits);
+    
+    }
+    
+    free(a_sinks);
+    free(a_row_fills);
+    
+    a_row_indices = malloc((n_hits ? n_hits : 1) * sizeof(size_t));
+    a_row_results = malloc((n_hits ? n_hits : 1) * job->s_element);
+    
+    if (!a_row_indices || !a_row_results) {
+        
+        free(a_hits);
+        free(a_row_offsets);
+        free(a_row_indices);
+        free(a_row_results);
+        
+        return PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    for (i_collection = 0; i_collection < n_collections; i_collection ++) {
+        
+        qsort(a_hits + *(a_row_offsets + i_collection),
+              *(a_row_offsets + i_collection + 1) - *(a_row_offsets + i_collection),
+              sizeof(_pairwise_hit_t),
+              _pairwise_hit_compare);
+    
+    }
+    
+    for (i_hit = 0; i_hit < n_hits; i_hit ++) {
+        
+        *(a_row_indices + i_hit) = (a_hits + i_hit)->i_collection_b;
+        
+        if (job->s_element == sizeof(float)) {
+            
+            *((float*)a_row_results + i_hit) = (a_hits + i_hit)->result;
+        
+        } else {
+            
+            *((double*)a_row_results + i_hit) = (a_hits + i_hit)->result;
+        
+        }
+    
+    }
+    
+    free(a_hits);
+    
+    *a_indptr = a_row_offsets;
+    *a_indices = a_row_indices;
+    *a_results = a_row_results;
+    
+    return PAIRWISE_RETURN_SUCCESS;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_cutoff
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Applies a calculation function, f_calculation, to all pairwise
+        combinations of collections in a set of collections, a_collections,
+        as _pairwise_launch() does, but keeps only those results no greater
+        than cutoff, in compressed sparse row (CSR) form.
+        
+        n_collections, n_points, n_coordinates, a_collections and n_threads
+        are as for _pairwise_launch(). On success allocates three arrays and
+        stores pointers to them in a_indptr, a_indices and a_results; the
+        caller must free all three with free().
+        
+        *a_indptr holds n_collections + 1 offsets, and *a_indices and
+        *a_results each hold (*a_indptr)[n_collections] elements. For each
+        collection i, elements (*a_indptr)[i] up to but excluding
+        (*a_indptr)[i + 1] of *a_indices hold, in increasing order, every
+        collection j > i for which the result of f_calculation on i and j is
+        no greater than cutoff, and the same elements of *a_results hold
+        those results.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code,
+        and allocates nothing.
+        
+    Further Information:
+    
+        This function describes the calculation in a _pairwise_job_t with
+        the row driver _pairwise_launch_row_cutoff(), and passes it to
+        _pairwise_launch_cutoff_job().
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_cutoff
+(
+
+    double (*f_calculation)(size_t n_points,
+                            size_t n_coordinates,
+                            double* collection_a,
+                            double* collection_b),
+                            
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    
+    double cutoff,
+    
+    size_t** a_indptr,
+    size_t** a_indices,
+    double** a_results,
+    
+    size_t n_threads
+
+)
+{
+
+    _pairwise_job_t job;
+    
+    job.f_calculation = f_calculation;
+    job.f_calculation_float = NULL;
+    job.f_row = _pairwise_launch_row_cutoff;
+    
+    job.a_collections = a_collections;
+    
+    job.s_element = sizeof(double);
+    
+    job.cutoff = cutoff;
+    
+    job.n_collections = n_collections;
+    job.n_points = n_points;
+    job.n_coordinates = n_coordinates;
+    
+    return _pairwise_launch_cutoff_job(&job,
+                                       a_indptr,
+                                       a_indices,
+                                       (void**)a_results,
+                                       n_threads);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_cutoff_float
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch_cutoff(), but for a calculation on collections of
+        floats, f_calculation, whose kept results are stored as floats.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_cutoff_float
+(
+
+    float (*f_calculation)(size_t n_points,
+                           size_t n_coordinates,
+                           float* collection_a,
+                           float* collection_b),
+                           
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    
+    float cutoff,
+    
+    size_t** a_indptr,
+    size_t** a_indices,
+    float** a_results,
+    
+    size_t n_threads
+
+)
+{
+
+    _pairwise_job_t job;
+    
+    job.f_calculation = NULL;
+    job.f_calculation_float = f_calculation;
+    job.f_row = _pairwise_launch_row_cutoff_float;
+    
+    job.a_collections = a_collections;
+    
+    job.s_element = sizeof(float);
+    
+    job.cutoff = cutoff;
+    
+    job.n_collections = n_collections;
+    job.n_points = n_points;
+    job.n_coordinates = n_coordinates;
+    
+    return _pairwise_launch_cutoff_job(&job,
+                                       a_indptr,
+                                       a_indices,
+                                       (void**)a_results,
+                                       n_threads);
+
+}
@@ -89,11 +89,1061 @@ pairwise_distances
 
 }
 
+/*******************************************************************************
+
+    Symbol: pairwise_distances_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_distances(), but for points whose coordinates are floats
+        rather than doubles, with the distances stored as floats. Arithmetic is
+        carried out in single precision throughout, which roughly halves the
+        memory traffic and doubles the number of coordinates handled per SIMD
+        instruction, at the cost of precision.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_distance_float() with
+        _pairwise_launch_float().
+        
+*******************************************************************************/
+
+int
+pairwise_distances_float
+(
+
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_points,
+    float* a_distances,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_float(_pairwise_single_distance_float,
+                                      n_points,
+                                      1,
+                                      n_coordinates,
+                                      a_points,
+                                      a_distances,
+                                      n_threads);
+                                      
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_distances_cutoff
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Calculates, as pairwise_distances() does, all pairwise Euclidean
+        distances across a set of points, but keeps only those no greater than
+        cutoff, in compressed sparse row (CSR) form. Memory is needed only for
+        the distances kept, however many points there are.
+        
+        n_points, n_coordinates, a_points and n_threads are as for
+        pairwise_distances(). On success allocates three arrays and stores
+        pointers to them in a_indptr, a_indices and a_distances; the caller
+        must free all three with free().
+        
+        *a_indptr holds n_points + 1 offsets, and *a_indices and *a_distances
+        each hold (*a_indptr)[n_points] elements. For each point i, elements
+        (*a_indptr)[i] up to but excluding (*a_indptr)[i + 1] of *a_indices
+        hold, in increasing order, every point j > i whose distance from
+        point i is no greater than cutoff, and the same elements of
+        *a_distances hold those distances.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code,
+        and allocates nothing.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_distance() with
+        _pairwise_launch_cutoff(), passing n_points as the number of
+        collections as pairwise_distances() does.
+        
+*******************************************************************************/
+
+int
+pairwise_distances_cutoff
+(
+
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_points,
+    
+    double cutoff,
+    
+    size_t** a_indptr,
+    size_t** a_indices,
+    double** a_distances,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_cutoff(_pairwise_single_distance,
+                                       n_points,
+                                       1,
+                                       n_coordinates,
+                                       a_points,
+                                       cutoff,
+                                       a_indptr,
+                                       a_indices,
+                                       a_distances,
+                                       n_threads);
+                                       
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_distances_cutoff_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_distances_cutoff(), but for points whose coordinates are
+        floats, with the distances kept stored as floats.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_distance_float() with
+        _pairwise_launch_cutoff_float().
+        
+*******************************************************************************/
+
+int
+pairwise_distances_cutoff_float
+(
+
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_points,
+    
+    float cutoff,
+    
+    size_t** a_indptr,
+    size_t** a_indices,
+    float** a_distances,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_cutoff_float(_pairwise_single_distance_float,
+                                             n_points,
+                                             1,
+                                             n_coordinates,
+                                             a_points,
+                                             cutoff,
+                                             a_indptr,
+                                             a_indices,
+                                             a_distances,
+                                             n_threads);
+                                             
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_distances_knn
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Calculates, as pairwise_distances() does, all pairwise Euclidean
+        distances across a set of points, but keeps for each point only the
+        n_neighbours other points nearest to it. Memory is needed only for
+        the distances kept, however many points there are.
+        
+        n_points, n_coordinates, a_points and n_threads are as for
+        pairwise_distances(). n_neighbours must be less than n_points, unless
+        it is zero. a_indices and a_distances must each have room for
+        n_points * n_neighbours elements.
+        
+        For each point i, elements i * n_neighbours up to but excluding
+        (i + 1) * n_neighbours of a_indices hold the n_neighbours points
+        nearest to point i, nearest first, and the same elements of
+        a_distances hold their distances from it. Equally distant points are
+        ordered by index.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_distance() with
+        _pairwise_launch_knn(), passing n_points as the number of collections
+        as pairwise_distances() does.
+        
+*******************************************************************************/
+
+int
+pairwise_distances_knn
+(
+
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_points,
+    
+    size_t n_neighbours,
+    
+    size_t* a_indices,
+    double* a_distances,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_knn(_pairwise_single_distance,
+                                    n_points,
+                                    1,
+                                    n_coordinates,
+                                    a_points,
+                                    n_neighbours,
+                                    a_indices,
+                                    a_distances,
+                                    n_threads);
+                                    
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_distances_knn_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_distances_knn(), but for points whose coordinates are
+        floats, with the distances kept stored as floats.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_distance_float() with
+        _pairwise_launch_knn_float().
+        
+*******************************************************************************/
+
+int
+pairwise_distances_knn_float
+(
+
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_points,
+    
+    size_t n_neighbours,
+    
+    size_t* a_indices,
+    float* a_distances,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_knn_float(_pairwise_single_distance_float,
+                                          n_points,
+                                          1,
+                                          n_coordinates,
+                                          a_points,
+                                          n_neighbours,
+                                          a_indices,
+                                          a_distances,
+                                          n_threads);
+                                          
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_distances_reduce
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Calculates, as pairwise_distances() does, all pairwise Euclidean
+        distances across a set of points, but keeps none of them, reducing
+        them instead as they are calculated to their statistics, a histogram
+        and the sum of each point's distances, or whichever of those three
+        are asked for. Memory is needed only for the reductions, however many
+        points there are.
+        
+        n_points, n_coordinates, a_points and n_threads are as for
+        pairwise_distances(). If a_statistics is not a null pointer, the
+        minimum, maximum, mean and variance of all distances are stored in
+        its four elements, in that order. If a_counts is not a null pointer,
+        the number of distances in each of n_bins equal bins from lower to
+        upper is stored in its n_bins elements. If a_sums is not a null
+        pointer, the sum of the distances from point i to every other is
+        stored in its element i, for each of its n_points elements. See
+        _pairwise_launch_reduce() for the details of each.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_distance() with
+        _pairwise_launch_reduce(), passing n_points as the number of
+        collections as pairwise_distances() does.
+        
+*******************************************************************************/
+
+int
+pairwise_distances_reduce
+(
+
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_points,
+    
+    double* a_statistics,
+    
+    double lower,
+    double upper,
+    size_t n_bins,
+    size_t* a_counts,
+    
+    double* a_sums,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_reduce(_pairwise_single_distance,
+                                       n_points,
+                                       1,
+                                       n_coordinates,
+                                       a_points,
+                                       a_statistics,
+                                       lower,
+                                       upper,
+                                       n_bins,
+                                       a_counts,
+                                       a_sums,
+                                       n_threads);
+                                       
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_distances_reduce_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_distances_reduce(), but for points whose coordinates are
+        floats. The distances are reduced in double precision nonetheless.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_distance_float() with
+        _pairwise_launch_reduce_float().
+        
+*******************************************************************************/
+
+int
+pairwise_distances_reduce_float
+(
+
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_points,
+    
+    double* a_statistics,
+    
+    double lower,
+    double upper,
+    size_t n_bins,
+    size_t* a_counts,
+    
+    double* a_sums,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_reduce_float(_pairwise_single_distance_float,
+                                             n_points,
+                                             1,
+                                             n_coordinates,
+                                             a_points,
+                                             a_statistics,
+                                             lower,
+                                             upper,
+                                             n_bins,
+                                             a_counts,
+                                             a_sums,
+                                             n_threads);
+                                             
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_distances_linkage
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Clusters a set of points by single linkage under the Euclidean
+        distance, as scipy.cluster.hierarchy.linkage() would from the results of
+        pairwise_distances(), but without ever holding more than n_points of
+        those results at once.
+        
+        n_points, n_coordinates, a_points and n_threads are as for
+        pairwise_distances(). a_linkage must have room for (n_points - 1) * 4
+        doubles, and is set to the linkage as described for
+        _pairwise_launch_linkage().
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_distance() with
+        _pairwise_launch_linkage(), passing n_points as the number of
+        collections as pairwise_distances() does.
+        
+*******************************************************************************/
+
+int
+pairwise_distances_linkage
+(
+
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_points,
+    
+    double* a_linkage,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_linkage(_pairwise_single_distance,
+                                        n_points,
+                                        1,
+                                        n_coordinates,
+                                        a_points,
+                                        a_linkage,
+                                        n_threads);
+                                        
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_distances_linkage_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_distances_linkage(), but for points whose coordinates are
+        floats. The linkage is stored in double precision nonetheless.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_distance_float() with
+        _pairwise_launch_linkage_float().
+        
+*******************************************************************************/
+
+int
+pairwise_distances_linkage_float
+(
+
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_points,
+    
+    double* a_linkage,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_linkage_float(_pairwise_single_distance_float,
+                                              n_points,
+                                              1,
+                                              n_coordinates,
+                                              a_points,
+                                              a_linkage,
+                                              n_threads);
+                                              
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_distances_append
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Extends the Euclidean distances between every pair of n_points_old
+        points, as calculated by pairwise_distances(), to those between every
+        pair of n_points_old + n_points_new points, calculating only the
+        distances which involve at least one of the n_points_new new points.
+        
+        a_points holds all n_points_old + n_points_new points, old first, each
+        of n_coordinates coordinates. a_distances_old holds the distances
+        between the old points, and a_distances must be large enough to store
+        the distances between all points, which are stored as
+        pairwise_distances() would store them. a_distances may be
+        a_distances_old itself, once enlarged, in which case the old distances
+        are moved in place; otherwise the two must not overlap.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_distance() with
+        _pairwise_launch_append(), passing n_points_old and n_points_new as the
+        numbers of collections as pairwise_distances() does.
+        
+*******************************************************************************/
+
+int
+pairwise_distances_append
+(
+
+    size_t n_points_old,
+    size_t n_points_new,
+    size_t n_coordinates,
+    
+    double* a_points,
+    double* a_distances_old,
+    double* a_distances,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_append(_pairwise_single_distance,
+                                       n_points_old,
+                                       n_points_new,
+                                       1,
+                                       n_coordinates,
+                                       a_points,
+                                       a_distances_old,
+                                       a_distances,
+                                       n_threads);
+                                       
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_distances_append_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_distances_append(), but for points whose coordinates are
+        floats, and distances which are stored as floats.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_distance_float() with
+        _pairwise_launch_append_float().
+        
+*******************************************************************************/
+
+int
+pairwise_distances_append_float
+(
+
+    size_t n_points_old,
+    size_t n_points_new,
+    size_t n_coordinates,
+    
+    float* a_points,
+    float* a_distances_old,
+    float* a_distances,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_append_float(_pairwise_single_distance_float,
+                                             n_points_old,
+                                             n_points_new,
+                                             1,
+                                             n_coordinates,
+                                             a_points,
+                                             a_distances_old,
+                                             a_distances,
+                                             n_threads);
+                                             
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_distances_stream
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Calculates, as pairwise_distances() does, all pairwise Euclidean
+        distances across a set of points, but hands them to the caller tile by
+        tile, through a stream, as threads finish them, so that however many
+        points there are memory is needed only for a fixed number of tiles.
+        
+        n_points, n_coordinates, a_points and n_threads are as for
+        pairwise_distances(). Tiles span no more than n_tile_points points a
+        side, and no more than n_queue tiles are in flight at once, threads
+        waiting whenever the caller falls behind; zero for either chooses it
+        automatically. a_points must outlive the stream.
+        
+        On success stores a pointer to the new stream in stream, from which
+        tiles are read with pairwise_stream_next() and which must be passed
+        to pairwise_stream_close() once done with, and returns
+        PAIRWISE_RETURN_SUCCESS which is always equivalent to integer zero.
+        On failure returns a non-zero libpairwise error code.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_distance() with
+        _pairwise_launch_stream(), passing n_points as the number of
+        collections as pairwise_distances() does.
+        
+*******************************************************************************/
+
+int
+pairwise_distances_stream
+(
+
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_points,
+    
+    size_t n_tile_points,
+    size_t n_queue,
+    
+    size_t n_threads,
+    
+    pairwise_stream_t** stream
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_stream(_pairwise_single_distance,
+                                       n_points,
+                                       1,
+                                       n_coordinates,
+                                       a_points,
+                                       n_tile_points,
+                                       n_queue,
+                                       n_threads,
+                                       stream);
+                                       
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_distances_stream_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_distances_stream(), but for points whose coordinates are
+        floats, with the distances handed over as floats.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_distance_float() with
+        _pairwise_launch_stream_float().
+        
+*******************************************************************************/
+
+int
+pairwise_distances_stream_float
+(
+
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_points,
+    
+    size_t n_tile_points,
+    size_t n_queue,
+    
+    size_t n_threads,
+    
+    pairwise_stream_t** stream
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_stream_float(_pairwise_single_distance_float,
+                                             n_points,
+                                             1,
+                                             n_coordinates,
+                                             a_points,
+                                             n_tile_points,
+                                             n_queue,
+                                             n_threads,
+                                             stream);
+                                             
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_distances_submit
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Calculates, as pairwise_distances() does, all pairwise Euclidean
+        distances across a set of points, but on the libpairwise worker pool
+        alone, returning at once with a future through which the calculation
+        can be followed, cancelled and waited for while the calling thread
+        goes on with other work.
+        
+        n_points, n_coordinates, a_points, a_distances and n_threads are as
+        for pairwise_distances(). a_points and a_distances must outlive the
+        future, and a_distances must not be read until pairwise_future_wait()
+        has found the calculation complete.
+        
+        On success stores a pointer to the new future in future, which must
+        be passed to pairwise_future_close() once done with, and returns
+        PAIRWISE_RETURN_SUCCESS which is always equivalent to integer zero.
+        On failure returns a non-zero libpairwise error code.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_distance() with
+        _pairwise_launch_submit(), passing n_points as the number of
+        collections as pairwise_distances() does.
+        
+*******************************************************************************/
+
+int
+pairwise_distances_submit
+(
+
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_points,
+    double* a_distances,
+    
+    size_t n_threads,
+    
+    pairwise_future_t** future
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_submit(_pairwise_single_distance,
+                                       n_points,
+                                       1,
+                                       n_coordinates,
+                                       a_points,
+                                       a_distances,
+                                       n_threads,
+                                       future);
+                                       
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_distances_submit_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_distances_submit(), but for points whose coordinates are
+        floats, with the distances stored as floats.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_distance_float() with
+        _pairwise_launch_submit_float().
+        
+*******************************************************************************/
+
+int
+pairwise_distances_submit_float
+(
+
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_points,
+    float* a_distances,
+    
+    size_t n_threads,
+    
+    pairwise_future_t** future
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_submit_float(_pairwise_single_distance_float,
+                                             n_points,
+                                             1,
+                                             n_coordinates,
+                                             a_points,
+                                             a_distances,
+                                             n_threads,
+                                             future);
+                                             
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_cross_distances
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Calculates the Euclidean distance between every point in one set,
+        a_points_a, and every point in another, a_points_b, rather than
+        between every pair of points in one set.
+        
+        n_points_a and n_points_b are the numbers of points in a_points_a and
+        a_points_b, and n_coordinates is the number of coordinates per point
+        in both. n_threads is as for pairwise_distances(). a_distances must
+        be large enough to store n_points_a * n_points_b doubles; the
+        distance between point i of a_points_a and point j of a_points_b is
+        stored in element i * n_points_b + j, so a_distances is a row-major
+        n_points_a by n_points_b matrix.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_distance() with
+        _pairwise_launch_cross(), passing n_points_a and n_points_b as the
+        numbers of collections as pairwise_distances() does.
+        
+*******************************************************************************/
+
+int
+pairwise_cross_distances
+(
+
+    size_t n_points_a,
+    size_t n_points_b,
+    size_t n_coordinates,
+    
+    double* a_points_a,
+    double* a_points_b,
+    double* a_distances,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_cross(_pairwise_single_distance,
+                                      n_points_a,
+                                      n_points_b,
+                                      1,
+                                      n_coordinates,
+                                      a_points_a,
+                                      a_points_b,
+                                      a_distances,
+                                      n_threads);
+                                      
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_cross_distances_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_cross_distances(), but for points whose coordinates are
+        floats, with the distances stored as floats.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_distance_float() with
+        _pairwise_launch_cross_float().
+        
+*******************************************************************************/
+
+int
+pairwise_cross_distances_float
+(
+
+    size_t n_points_a,
+    size_t n_points_b,
+    size_t n_coordinates,
+    
+    float* a_points_a,
+    float* a_points_b,
+    float* a_distances,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_cross_float(_pairwise_single_distance_float,
+                                            n_points_a,
+                                            n_points_b,
+                                            1,
+                                            n_coordinates,
+                                            a_points_a,
+                                            a_points_b,
+                                            a_distances,
+                                            n_threads);
+                                            
+    return n_return;
+
+}
+
 /*******************************************************************************
 
     Symbol: _pairwise_single_distance
     
-    Type: Inline function returning double
+    Type: Function returning double
     
     Intent: Private
     
@@ -113,9 +1163,19 @@ pairwise_distances
         
         On success returns the calculated distance. Not expected to fail.
         
+    Further Information:
+    
+        The sum of squared coordinate differences is delegated to the kernel
+        for the instruction set selected by pairwise_set_isa(), or at load
+        time, through _pairwise_sum_squared_differences, except for points of
+        2, 3, 4 or 8 coordinates, which are summed inline by
+        _PAIRWISE_SUM_SQUARED_DIFFERENCES_2 and its kin, just as the row
+        drivers specialised for those shapes sum them.
+        
 *******************************************************************************/
 
-inline double
+_PAIRWISE_UNVECTORISED
+double
 _pairwise_single_distance
 (
     
@@ -128,26 +1188,133 @@ _pairwise_single_distance
 )
 {
 
-    size_t i_coordinate;
-    
     double point_distance_squared;
     double point_distance;
     
-    double coordinate_a;
-    double coordinate_b;
+    switch (n_coordinates) {
+        
+        case 2:
+        
+            point_distance_squared =
+                _PAIRWISE_SUM_SQUARED_DIFFERENCES_2(collection_a, collection_b);
+                
+            break;
+            
+        case 3:
+        
+            point_distance_squared =
+                _PAIRWISE_SUM_SQUARED_DIFFERENCES_3(collection_a, collection_b);
+                
+            break;
+            
+        case 4:
+        
+            point_distance_squared =
+                _PAIRWISE_SUM_SQUARED_DIFFERENCES_4(collection_a, collection_b);
+                
+            break;
+            
+        case 8:
+        
+            point_distance_squared =
+                _PAIRWISE_SUM_SQUARED_DIFFERENCES_8(collection_a, collection_b);
+                
+            break;
+            
+        default:
+        
+            point_distance_squared =
+                _pairwise_sum_squared_differences(n_coordinates,
+                                                  collection_a,
+                                                  collection_b);
+    
+    }
+    
+    point_distance = sqrt(point_distance_squared);
+    
+    return point_distance;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_single_distance_float
+    
+    Type: Function returning float
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_single_distance(), but for collections of floats.
+        Compatible with _pairwise_launch_float().
+        
+    Further Information:
+    
+        The sum of squared coordinate differences is delegated to the kernel
+        selected by pairwise_set_isa(), or at load time, through
+        _pairwise_sum_squared_differences_float, except for points of 2, 3, 4
+        or 8 coordinates, as for _pairwise_single_distance().
+        
+*******************************************************************************/
+
+_PAIRWISE_UNVECTORISED
+float
+_pairwise_single_distance_float
+(
+
+    size_t n_points,
+    size_t n_coordinates,
     
-    point_distance_squared = 0;
+    float* collection_a,
+    float* collection_b
+
+)
+{
+
+    float point_distance_squared;
+    float point_distance;
     
-    for (i_coordinate = 0; i_coordinate < n_coordinates; i_coordinate ++) {
+    switch (n_coordinates) {
+        
+        case 2:
+        
+            point_distance_squared =
+                _PAIRWISE_SUM_SQUARED_DIFFERENCES_2(collection_a, collection_b);
+                
+            break;
+            
+        case 3:
+        
+            point_distance_squared =
+                _PAIRWISE_SUM_SQUARED_DIFFERENCES_3(collection_a, collection_b);
+                
+            break;
+            
+        case 4:
+        
+            point_distance_squared =
+                _PAIRWISE_SUM_SQUARED_DIFFERENCES_4(collection_a, collection_b);
+                
+            break;
+            
+        case 8:
+        
+            point_distance_squared =
+                _PAIRWISE_SUM_SQUARED_DIFFERENCES_8(collection_a, collection_b);
+                
+            break;
             
-        coordinate_a = *(collection_a + i_coordinate);
-        coordinate_b = *(collection_b + i_coordinate);
+        default:
         
-        point_distance_squared += _PAIRWISE_SQUARE(coordinate_a - coordinate_b);
+            point_distance_squared =
+                _pairwise_sum_squared_differences_float(n_coordinates,
+                                                        collection_a,
+                                                        collection_b);
     
     }
     
-    point_distance = sqrt(point_distance_squared);
+    point_distance = sqrtf(point_distance_squared);
     
     return point_distance;
 
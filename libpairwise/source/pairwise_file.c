@@ -0,0 +1,571 @@
+/*
+*   fallocate() is a GNU extension, and must be asked for before any system
+*   header is included.
+*/
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "pairwise_file.h"
+
+/*******************************************************************************
+
+    Symbol: _pairwise_file_put, _pairwise_file_get
+    
+    Type: Static functions returning void and uint64_t
+    
+    Intent: Private
+    
+    Description:
+    
+        Store value in, or load a value from, the eight bytes at a_bytes,
+        little-endian whatever the byte order of the machine, as the fields
+        of a results file header are.
+        
+        Not expected to fail.
+        
+*******************************************************************************/
+
+static void
+_pairwise_file_put
+(
+
+    unsigned char* a_bytes,
+    
+    uint64_t value
+
+)
+{
+
+    size_t i_byte;
+    
+    for (i_byte = 0; i_byte < 8; i_byte ++) {
+        
+        *(a_bytes + i_byte) = (unsigned char)(value >> (8 * i_byte));
+    
+    }
+
+}
+
+static uint64_t
+_pairwise_file_get
+(
+
+    const unsigned char* a_bytes
+
+)
+{
+
+    uint64_t value;
+    
+    size_t i_byte;
+    
+    value = 0;
+    
+    for (i_byte = 0; i_byte < 8; i_byte ++) {
+        
+        value |= (uint64_t)*(a_bytes + i_byte) << (8 * i_byte);
+    
+    }
+    
+    return value;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_file_dtype
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Writes into dtype, which must have room for eight characters, the
+        NumPy dtype string for results of s_element bytes in the byte order of
+        the machine, padded with nulls.
+        
+        Returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+static void
+_pairwise_file_dtype
+(
+
+    size_t s_element,
+    
+    char* dtype
+
+)
+{
+
+    unsigned int one;
+    
+    one = 1;
+    
+    memset(dtype, 0, 8);
+    
+    *(dtype + 0) = *(unsigned char*)&one ? '<' : '>';
+    *(dtype + 1) = 'f';
+    *(dtype + 2) = s_element == sizeof(float) ? '4' : '8';
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_file_length
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Stores in l_file the length in bytes of a results file holding the
+        results of all pairwise calculations across n_collections collections
+        as elements of s_element bytes, header included.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. If the length would overflow a size_t, sets errno to
+        EFBIG and returns PAIRWISE_RETURN_ERROR_FILE.
+        
+*******************************************************************************/
+
+static int
+_pairwise_file_length
+(
+
+    size_t n_collections,
+    size_t s_element,
+    
+    size_t* l_file
+
+)
+{
+
+    size_t n_results;
+    
+    n_results = 0;
+    
+    if (n_collections > 1) {
+        
+        if (n_collections - 1 > SIZE_MAX / n_collections) {
+            
+            errno = EFBIG;
+            
+            return PAIRWISE_RETURN_ERROR_FILE;
+        
+        }
+        
+        n_results = (n_collections * (n_collections - 1)) / 2;
+    
+    }
+    
+    if (n_results > (SIZE_MAX - PAIRWISE_FILE_HEADER) / s_element) {
+        
+        errno = EFBIG;
+        
+        return PAIRWISE_RETURN_ERROR_FILE;
+    
+    }
+    
+    *l_file = PAIRWISE_FILE_HEADER + (n_results * s_element);
+    
+    return PAIRWISE_RETURN_SUCCESS;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_file_create
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Creates a results file at path, replacing any file already there,
+        with room for the results of all pairwise calculations across
+        n_collections collections as elements of s_element bytes, which must
+        be sizeof(float) or sizeof(double). metric names the calculation, in
+        fewer than PAIRWISE_FILE_METRIC_LENGTH characters, and is recorded in
+        the header along with n_collections and s_element.
+        
+        The results part of the file is mapped into memory, and a pointer to
+        it is stored in a_results, to be passed to any libpairwise function
+        as its output array in place of one allocated with malloc(). Its
+        pages are written back to the file by the operating system as they
+        are filled, so the results need never be held in memory all at once.
+        The caller must pass a_results to pairwise_file_close() once done.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code,
+        leaving errno set if the file could not be created, and maps nothing.
+        
+    Further Information:
+    
+        Any file already at path is unlinked rather than truncated, and a new
+        one created in its place. An array still mapped from the old file,
+        such as the very input of the calculation about to fill the new one,
+        therefore keeps its contents rather than being cut short under it.
+        
+        The space of the whole file is reserved on disk with fallocate() on
+        Linux, and posix_fallocate() elsewhere, so that a disk too full to
+        hold the results fails here with ENOSPC rather than with SIGBUS in
+        whichever thread first writes to a page with no space behind it.
+        Where the file system cannot reserve space, the file is sized with
+        ftruncate() instead, and takes space only as its pages are written.
+        Either way its results start out as zeros without being written.
+        
+        posix_fallocate() is avoided on Linux because glibc emulates it on
+        file systems without fallocate(), such as NFS before version 4.2, by
+        writing a byte to every block of the file: far slower than the
+        calculation itself for a large file, and never reaching ftruncate().
+        Elsewhere, a posix_fallocate() that emulates allocation in the same
+        way writes every block before the calculation starts.
+        
+        The whole file, header included, is mapped shared, and the descriptor
+        closed at once, since the mapping keeps the file open;
+        pairwise_file_close() finds the length of the mapping again from the
+        header, just before a_results.
+        
+*******************************************************************************/
+
+int
+pairwise_file_create
+(
+
+    const char* path,
+    
+    size_t n_collections,
+    size_t s_element,
+    
+    const char* metric,
+    
+    void** a_results
+
+)
+{
+
+    int n_return;
+    int n_errno;
+    
+    int fd;
+    
+    unsigned char* a_file;
+    
+    size_t l_file;
+    
+    if ((s_element != sizeof(float) && s_element != sizeof(double))
+    ||  strlen(metric) >= PAIRWISE_FILE_METRIC_LENGTH) {
+        
+        return PAIRWISE_RETURN_ERROR_FILE_FORMAT;
+    
+    }
+    
+    n_return = _pairwise_file_length(n_collections, s_element, &l_file);
+    
+    if (n_return) {
+        
+        return n_return;
+    
+    }
+    
+    if (unlink(path) && errno != ENOENT) {
+        
+        return PAIRWISE_RETURN_ERROR_FILE;
+    
+    }
+    
+    fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0666);
+    
+    if (fd < 0) {
+        
+        return PAIRWISE_RETURN_ERROR_FILE;
+    
+    }
+    
+    a_file = MAP_FAILED;
+    
+    /*
+    *   posix_fallocate() returns its error rather than setting errno, where
+    *   fallocate() sets errno. Fall back to ftruncate() only if the file
+    *   system cannot reserve space at all; running out of it is a failure.
+    */
+    
+#if defined(__linux__)
+    n_errno = fallocate(fd, 0, 0, (off_t)l_file) ? errno : 0;
+#else
+    n_errno = posix_fallocate(fd, 0, (off_t)l_file);
+#endif
+    
+    if (n_errno == EINVAL || n_errno == EOPNOTSUPP || n_errno == ENOSYS) {
+        
+        n_errno = ftruncate(fd, (off_t)l_file) ? errno : 0;
+    
+    }
+    
+    if (!n_errno) {
+        
+        a_file = mmap(NULL, l_file, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        
+        if (a_file == MAP_FAILED) {
+            
+            n_errno = errno;
+        
+        }
+    
+    }
+    
+    /*
+    *   Keep the errno of whichever call failed, rather than any from close()
+    *   or unlink(), and leave no half-made file behind.
+    */
+    
+    close(fd);
+    
+    if (a_file == MAP_FAILED) {
+        
+        unlink(path);
+        
+        errno = n_errno;
+        
+        return PAIRWISE_RETURN_ERROR_FILE;
+    
+    }
+    
+    memset(a_file, 0, PAIRWISE_FILE_HEADER);
+    
+    memcpy(a_file, PAIRWISE_FILE_MAGIC, 8);
+    
+    _pairwise_file_put(a_file + 8, PAIRWISE_FILE_VERSION);
+    _pairwise_file_put(a_file + 16, n_collections);
+    
+    _pairwise_file_dtype(s_element, (char*)a_file + 24);
+    
+    memcpy(a_file + 32, metric, strlen(metric));
+    
+    _pairwise_file_put(a_file + 48, PAIRWISE_FILE_HEADER);
+    
+    *a_results = a_file + PAIRWISE_FILE_HEADER;
+    
+    return PAIRWISE_RETURN_SUCCESS;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_file_close
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Writes back to its file every page of a_results, as returned by
+        pairwise_file_create(), which has not already been, and unmaps it.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns PAIRWISE_RETURN_ERROR_FILE,
+        leaving errno set; a_results is unmapped nonetheless.
+        
+*******************************************************************************/
+
+int
+pairwise_file_close
+(
+
+    void* a_results
+
+)
+{
+
+    int n_return;
+    int n_errno;
+    
+    unsigned char* a_file;
+    
+    size_t l_file;
+    
+    a_file = (unsigned char*)a_results - PAIRWISE_FILE_HEADER;
+    
+    /*
+    *   The header was checked when the file was created, so its length is
+    *   known not to overflow.
+    */
+    
+    l_file = PAIRWISE_FILE_HEADER;
+    
+    _pairwise_file_length(_pairwise_file_get(a_file + 16),
+                          *(a_file + 26) == '4' ? sizeof(float) : sizeof(double),
+                          &l_file);
+                          
+    n_return = PAIRWISE_RETURN_SUCCESS;
+    
+    if (msync(a_file, l_file, MS_SYNC)) {
+        
+        n_return = PAIRWISE_RETURN_ERROR_FILE;
+    
+    }
+    
+    n_errno = errno;
+    
+    if (munmap(a_file, l_file)) {
+        
+        n_return = PAIRWISE_RETURN_ERROR_FILE;
+    
+    } else {
+        
+        errno = n_errno;
+    
+    }
+    
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_file_describe
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Reads the header of the results file at path, and stores the number
+        of collections whose results it holds in n_collections, the size of
+        each result in s_element, the name of the metric in metric, which
+        must have room for PAIRWISE_FILE_METRIC_LENGTH characters, and the
+        offset of the results from the start of the file in n_offset.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure to read the file returns
+        PAIRWISE_RETURN_ERROR_FILE, leaving errno set, and if it is not a
+        results file of this version, or is too short to hold its results,
+        returns PAIRWISE_RETURN_ERROR_FILE_FORMAT.
+        
+    Further Information:
+    
+        Results are stored in the byte order of the machine which calculated
+        them, so a file from a machine of the other byte order is refused as
+        being of the wrong format.
+        
+*******************************************************************************/
+
+int
+pairwise_file_describe
+(
+
+    const char* path,
+    
+    size_t* n_collections,
+    size_t* s_element,
+    
+    char* metric,
+    
+    size_t* n_offset
+
+)
+{
+
+    int n_errno;
+    
+    int fd;
+    
+    unsigned char a_header[PAIRWISE_FILE_HEADER];
+    
+    char dtype[8];
+    
+    struct stat status;
+    
+    ssize_t l_read;
+    
+    size_t l_file;
+    
+    uint64_t n_file_collections;
+    uint64_t n_file_offset;
+    
+    fd = open(path, O_RDONLY);
+    
+    if (fd < 0) {
+        
+        return PAIRWISE_RETURN_ERROR_FILE;
+    
+    }
+    
+    l_read = -1;
+    
+    if (!fstat(fd, &status)) {
+        
+        l_read = read(fd, a_header, PAIRWISE_FILE_HEADER);
+    
+    }
+    
+    n_errno = errno;
+    
+    close(fd);
+    
+    if (l_read < 0) {
+        
+        errno = n_errno;
+        
+        return PAIRWISE_RETURN_ERROR_FILE;
+    
+    }
+    
+    /*
+    *   Check the magic, the version and the dtype, and that the file is long
+    *   enough to hold every result its header promises.
+    */
+    
+    if (l_read != PAIRWISE_FILE_HEADER
+    ||  memcmp(a_header, PAIRWISE_FILE_MAGIC, 8)
+    ||  _pairwise_file_get(a_header + 8) != PAIRWISE_FILE_VERSION
+    ||  *(a_header + 47)) {
+        
+        return PAIRWISE_RETURN_ERROR_FILE_FORMAT;
+    
+    }
+    
+    *s_element = *(a_header + 26) == '4' ? sizeof(float) : sizeof(double);
+    
+    _pairwise_file_dtype(*s_element, dtype);
+    
+    if (memcmp(a_header + 24, dtype, 8)) {
+        
+        return PAIRWISE_RETURN_ERROR_FILE_FORMAT;
+    
+    }
+    
+    n_file_collections = _pairwise_file_get(a_header + 16);
+    n_file_offset = _pairwise_file_get(a_header + 48);
+    
+    if (n_file_collections > SIZE_MAX
+    ||  n_file_offset != PAIRWISE_FILE_HEADER
+    ||  _pairwise_file_length(n_file_collections, *s_element, &l_file)
+    ||  (uint64_t)status.st_size < l_file) {
+        
+        return PAIRWISE_RETURN_ERROR_FILE_FORMAT;
+    
+    }
+    
+    *n_collections = n_file_collections;
+    *n_offset = n_file_offset;
+    
+    memcpy(metric, a_header + 32, PAIRWISE_FILE_METRIC_LENGTH);
+    
+    return PAIRWISE_RETURN_SUCCESS;
+
+}
@@ -0,0 +1,600 @@
+#include <time.h>
+
+#include "pairwise_future.h"
+
+/*******************************************************************************
+
+    Symbol: struct _pairwise_future
+    
+    Type: Structure
+    
+    Intent: Private
+    
+    Description:
+    
+        The members of pairwise_future_t, a calculation carried out on the
+        libpairwise worker pool while the thread which started it goes on
+        with other work. Created by pairwise_distances_submit(),
+        pairwise_rmsds_submit() or their float counterparts, and destroyed by
+        pairwise_future_close(). Declared in pairwise.h, and opaque outside
+        this file.
+        
+        job describes the calculation, and pool_job the tasks carrying it out
+        on the pool, one call to _pairwise_launch_bounded() per argument set
+        of job. n_total is the number of pairwise calculations of job. b_queued
+        is set if pool_job was submitted, and clear if job had nothing to do,
+        in which case the future is done from the start.
+        
+*******************************************************************************/
+
+struct
+_pairwise_future
+{
+
+    _pairwise_job_t job;
+    
+    _pairwise_pool_job_t pool_job;
+    
+    size_t n_total;
+    
+    int b_queued;
+
+};
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_submit_job
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Submits job, whose calculation, row driver, input and output arrays,
+        element size and dimensions must already be set, to the libpairwise
+        worker pool over n_threads threads, and stores a pointer to a new
+        future carrying it out in future.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code,
+        and creates no future.
+        
+    Further Information:
+    
+        job is copied into the future, and readied there with
+        _pairwise_launch_prepare(), since its argument sets point back at it.
+        The tasks are then queued with _pairwise_pool_submit(), which grows
+        the pool to n_threads workers if need be, and never runs a task on
+        the calling thread.
+        
+*******************************************************************************/
+
+static int
+_pairwise_launch_submit_job
+(
+
+    _pairwise_job_t* job,
+    
+    size_t n_threads,
+    
+    pairwise_future_t** future
+
+)
+{
+
+    int n_return;
+    
+    pairwise_future_t* self;
+    
+    self = calloc(1, sizeof(pairwise_future_t));
+    
+    if (!self) {
+        
+        return PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    self->job = *job;
+    
+    self->job.a_sinks = NULL;
+    self->job.s_sink = 0;
+    
+    self->job.cutoff = 0;
+    
+    self->job.b_cross = 0;
+    self->job.b_append = 0;
+    
+    n_return = _pairwise_launch_prepare(&self->job, n_threads);
+    
+    if (n_return) {
+        
+        free(self);
+        
+        return n_return;
+    
+    }
+    
+    if (self->job.n_argument_sets) {
+        
+        self->n_total = (self->job.n_collections * (self->job.n_collections - 1)) / 2;
+        
+        n_return = _pairwise_pool_submit(&self->pool_job,
+                                         (void (*)(void*))_pairwise_launch_bounded,
+                                         self->job.a_argument_sets,
+                                         sizeof(_pairwise_as_t),
+                                         self->job.n_argument_sets);
+                                         
+        if (n_return) {
+            
+            _pairwise_launch_release(&self->job);
+            
+            free(self);
+            
+            return n_return;
+        
+        }
+        
+        self->b_queued = 1;
+    
+    }
+    
+    *future = self;
+    
+    return PAIRWISE_RETURN_SUCCESS;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_future_stopped
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Waits for every thread of future to stop, or until the absolute time
+        deadline of the realtime clock has passed, as for
+        _pairwise_pool_wait(); a null deadline waits for as long as it takes.
+        
+        Returns integer one if every thread has stopped, or integer zero if
+        the deadline passed first. Not expected to fail.
+        
+*******************************************************************************/
+
+static int
+_pairwise_future_stopped
+(
+
+    pairwise_future_t* future,
+    
+    const struct timespec* deadline
+
+)
+{
+
+    if (!future->b_queued) {
+        
+        return 1;
+    
+    }
+    
+    return _pairwise_pool_wait(&future->pool_job, deadline);
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_future_done
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Finds whether every thread of future has stopped, whether because its
+        calculation is complete or because it was cancelled, without waiting.
+        
+        Returns integer one if so, or integer zero if threads are still
+        carrying out pairwise calculations. Not expected to fail.
+        
+*******************************************************************************/
+
+int
+pairwise_future_done
+(
+
+    pairwise_future_t* future
+
+)
+{
+
+    struct timespec deadline;
+    
+    /*
+    *   Any deadline already passed returns at once, and none is earlier than
+    *   the epoch.
+    */
+    
+    deadline.tv_sec = 0;
+    deadline.tv_nsec = 0;
+    
+    return _pairwise_future_stopped(future, &deadline);
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_future_progress
+    
+    Type: Function returning void
+    
+    Intent: Public
+    
+    Description:
+    
+        Stores in n_done the number of pairwise calculations of future
+        carried out so far, and in n_total the number it has in all. Either
+        may be a null pointer if not wanted. n_done is counted a chunk of
+        calculations at a time, and only reaches n_total once the
+        calculation is complete.
+        
+        Returns nothing. Not expected to fail.
+        
+    Further Information:
+    
+        Every thread adds the calculations of each chunk it finishes, its own
+        or stolen, to the counter of its own argument set, so counting costs
+        one atomic addition per chunk. n_done is the sum of every counter,
+        each read atomically; it lags the threads by the chunks they are
+        carrying out, but never counts any calculation twice.
+        
+*******************************************************************************/
+
+void
+pairwise_future_progress
+(
+
+    pairwise_future_t* future,
+    
+    size_t* n_done,
+    size_t* n_total
+
+)
+{
+
+    size_t n_pairs;
+    
+    size_t i_argument_set;
+    
+    n_pairs = 0;
+    
+    for (i_argument_set = 0;
+         i_argument_set < future->job.n_argument_sets;
+         i_argument_set ++) {
+             
+        n_pairs += __atomic_load_n(&(future->job.a_argument_sets + i_argument_set)->n_pairs,
+                                   __ATOMIC_RELAXED);
+    
+    }
+    
+    if (n_done) {
+        
+        *n_done = n_pairs;
+    
+    }
+    
+    if (n_total) {
+        
+        *n_total = future->n_total;
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_future_cancel
+    
+    Type: Function returning void
+    
+    Intent: Public
+    
+    Description:
+    
+        Asks the threads of future to stop once they finish the chunk of
+        pairwise calculations each is carrying out, and returns at once. Any
+        thread may cancel a future, at any time, any number of times; a
+        future which is already done is left as it is. The results of a
+        cancelled future are incomplete, and must not be relied on.
+        
+        Returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+void
+pairwise_future_cancel
+(
+
+    pairwise_future_t* future
+
+)
+{
+
+    __atomic_store_n(&future->job.b_cancel, 1, __ATOMIC_RELAXED);
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_future_wait
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Waits for up to timeout seconds for every thread of future to stop. A
+        negative timeout waits for as long as it takes, and a timeout of zero
+        returns at once.
+        
+        Returns PAIRWISE_RETURN_SUCCESS which is always equivalent to integer
+        zero if the calculation is complete, so that every result has been
+        stored. Returns PAIRWISE_RETURN_ERROR_TIMEOUT if threads are still
+        carrying it out once timeout has passed, and
+        PAIRWISE_RETURN_ERROR_CANCELLED if they stopped early because it was
+        cancelled.
+        
+    Further Information:
+    
+        A future cancelled only after its last chunk was claimed still
+        completes, and is reported as complete: what matters is whether every
+        calculation was carried out, which the counters of
+        pairwise_future_progress() tell once every thread has stopped.
+        
+*******************************************************************************/
+
+int
+pairwise_future_wait
+(
+
+    pairwise_future_t* future,
+    
+    double timeout
+
+)
+{
+
+    struct timespec deadline;
+    
+    size_t n_done;
+    size_t n_total;
+    
+    int b_stopped;
+    
+    if (timeout < 0) {
+        
+        b_stopped = _pairwise_future_stopped(future, NULL);
+    
+    } else {
+        
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        
+        deadline.tv_sec += (time_t)timeout;
+        deadline.tv_nsec += (long)((timeout - (time_t)timeout) * 1e9);
+        
+        if (deadline.tv_nsec >= 1000000000L) {
+            
+            deadline.tv_sec ++;
+            deadline.tv_nsec -= 1000000000L;
+        
+        }
+        
+        b_stopped = _pairwise_future_stopped(future, &deadline);
+    
+    }
+    
+    if (!b_stopped) {
+        
+        return PAIRWISE_RETURN_ERROR_TIMEOUT;
+    
+    }
+    
+    pairwise_future_progress(future, &n_done, &n_total);
+    
+    if (n_done < n_total) {
+        
+        return PAIRWISE_RETURN_ERROR_CANCELLED;
+    
+    }
+    
+    return PAIRWISE_RETURN_SUCCESS;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_future_close
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Cancels future if it is not yet done, waits for its threads to stop,
+        and frees it. Its input and output arrays may be freed once this
+        function returns, and not before.
+        
+        Returns PAIRWISE_RETURN_SUCCESS which is always equivalent to integer
+        zero if the calculation was complete, or
+        PAIRWISE_RETURN_ERROR_CANCELLED if it was not. future is freed either
+        way.
+        
+*******************************************************************************/
+
+int
+pairwise_future_close
+(
+
+    pairwise_future_t* future
+
+)
+{
+
+    int n_return;
+    
+    pairwise_future_cancel(future);
+    
+    n_return = pairwise_future_wait(future, -1);
+    
+    if (future->b_queued) {
+        
+        _pairwise_pool_forget(&future->pool_job);
+    
+    }
+    
+    _pairwise_launch_release(&future->job);
+    
+    free(future);
+    
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_submit
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Starts applying a calculation function, f_calculation, to all
+        pairwise combinations of collections in a set of collections,
+        a_collections, storing the results in a_results as _pairwise_launch()
+        does, but on the libpairwise worker pool alone, and returns at once
+        with a new future, a pointer to which is stored in future, through
+        which the caller can follow, cancel and wait for the calculation.
+        
+        n_collections, n_points, n_coordinates, a_collections, a_results and
+        n_threads are as for _pairwise_launch(). a_collections and a_results
+        must outlive the future.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero; the caller must then pass the future to
+        pairwise_future_close(). On failure returns a non-zero libpairwise
+        error code, and creates no future.
+        
+    Further Information:
+    
+        This function describes the calculation in a _pairwise_job_t, and
+        passes it to _pairwise_launch_submit_job().
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_submit
+(
+
+    double (*f_calculation)(size_t n_points,
+                            size_t n_coordinates,
+                            double* collection_a,
+                            double* collection_b),
+                            
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    double* a_results,
+    
+    size_t n_threads,
+    
+    pairwise_future_t** future
+
+)
+{
+
+    _pairwise_job_t job;
+    
+    job.f_calculation = f_calculation;
+    job.f_calculation_float = NULL;
+    job.f_row = _pairwise_launch_row;
+    
+    job.a_collections = a_collections;
+    job.a_results = a_results;
+    
+    job.s_element = sizeof(double);
+    
+    job.n_collections = n_collections;
+    job.n_points = n_points;
+    job.n_coordinates = n_coordinates;
+    
+    return _pairwise_launch_submit_job(&job, n_threads, future);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_submit_float
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch_submit(), but for a calculation on collections of
+        floats, f_calculation, whose results are stored in an output array of
+        floats.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_submit_float
+(
+
+    float (*f_calculation)(size_t n_points,
+                           size_t n_coordinates,
+                           float* collection_a,
+                           float* collection_b),
+                           
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    float* a_results,
+    
+    size_t n_threads,
+    
+    pairwise_future_t** future
+
+)
+{
+
+    _pairwise_job_t job;
+    
+    job.f_calculation = NULL;
+    job.f_calculation_float = f_calculation;
+    job.f_row = _pairwise_launch_row_float;
+    
+    job.a_collections = a_collections;
+    job.a_results = a_results;
+    
+    job.s_element = sizeof(float);
+    
+    job.n_collections = n_collections;
+    job.n_points = n_points;
+    job.n_coordinates = n_coordinates;
+    
+    return _pairwise_launch_submit_job(&job, n_threads, future);
+
+}
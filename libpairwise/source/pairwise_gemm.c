@@ -0,0 +1,1189 @@
+#include <string.h>
+
+#include "pairwise_gemm.h"
+
+#if defined(_PAIRWISE_SIMD_X86)
+#include <immintrin.h>
+#endif
+
+/*******************************************************************************
+
+    Symbol: _pairwise_gemm_kernel
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        The portable micro-kernel. Finds the dot product of every one of the
+        _PAIRWISE_GEMM_ROWS collections packed in a_panel_a with every one of
+        the _PAIRWISE_GEMM_COLUMNS collections packed in a_panel_b, each of
+        n_depth coordinates, and stores them row by row in a_dots. Not
+        expected to fail.
+        
+    Further Information:
+    
+        The dot products are accumulated in a block of registers, one
+        coordinate at a time, so that each coordinate loaded is used
+        _PAIRWISE_GEMM_ROWS or _PAIRWISE_GEMM_COLUMNS times rather than once,
+        and the compiler vectorises across the columns. Every dot product is
+        therefore summed in coordinate order whichever row and column of the
+        block it falls in, and every tile is carried out by whole blocks, so
+        the result of a pair depends neither on the tile it falls in nor on
+        the number of threads.
+        
+        There is no version for floats. Collections of floats are packed as
+        doubles and their dot products accumulated in double precision, since
+        single precision leaves too few bits to survive the subtraction of
+        the expansion.
+        
+*******************************************************************************/
+
+static void
+_pairwise_gemm_kernel
+(
+
+    size_t n_depth,
+    
+    const double* a_panel_a,
+    const double* a_panel_b,
+    
+    double* a_dots
+
+)
+{
+
+    double dots[_PAIRWISE_GEMM_ROWS][_PAIRWISE_GEMM_COLUMNS];
+    
+    size_t i_depth;
+    size_t i_row;
+    size_t i_column;
+    
+    for (i_row = 0; i_row < _PAIRWISE_GEMM_ROWS; i_row ++) {
+        
+        for (i_column = 0; i_column < _PAIRWISE_GEMM_COLUMNS; i_column ++) {
+            
+            dots[i_row][i_column] = 0;
+        
+        }
+    
+    }
+    
+    for (i_depth = 0; i_depth < n_depth; i_depth ++) {
+        
+        for (i_row = 0; i_row < _PAIRWISE_GEMM_ROWS; i_row ++) {
+            
+            for (i_column = 0; i_column < _PAIRWISE_GEMM_COLUMNS; i_column ++) {
+                
+                dots[i_row][i_column] += *(a_panel_a + i_row) * *(a_panel_b + i_column);
+            
+            }
+        
+        }
+        
+        a_panel_a += _PAIRWISE_GEMM_ROWS;
+        a_panel_b += _PAIRWISE_GEMM_COLUMNS;
+    
+    }
+    
+    for (i_row = 0; i_row < _PAIRWISE_GEMM_ROWS; i_row ++) {
+        
+        for (i_column = 0; i_column < _PAIRWISE_GEMM_COLUMNS; i_column ++) {
+            
+            *(a_dots ++) = dots[i_row][i_column];
+        
+        }
+    
+    }
+
+}
+
+#if defined(_PAIRWISE_SIMD_X86)
+
+/*******************************************************************************
+
+    Symbol: _pairwise_gemm_kernel_avx2
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_gemm_kernel(), but using AVX2 and FMA, for a block of
+        four rows by eight columns. Not expected to fail.
+        
+    Further Information:
+    
+        Each row of the block is held in two registers of four columns, so
+        the block takes eight, as many independent fused multiply-adds as
+        are needed to hide their latency. Every coordinate of the first
+        collections is broadcast straight from memory, so that only the
+        loads, and not the shuffle unit, are shared with the arithmetic.
+        
+*******************************************************************************/
+
+__attribute__((target("avx2,fma")))
+static void
+_pairwise_gemm_kernel_avx2
+(
+
+    size_t n_depth,
+    
+    const double* a_panel_a,
+    const double* a_panel_b,
+    
+    double* a_dots
+
+)
+{
+
+    __m256d dots_00;
+    __m256d dots_01;
+    __m256d dots_10;
+    __m256d dots_11;
+    __m256d dots_20;
+    __m256d dots_21;
+    __m256d dots_30;
+    __m256d dots_31;
+    
+    __m256d column_0;
+    __m256d column_1;
+    __m256d row;
+    
+    size_t i_depth;
+    
+    dots_00 = _mm256_setzero_pd();
+    dots_01 = _mm256_setzero_pd();
+    dots_10 = _mm256_setzero_pd();
+    dots_11 = _mm256_setzero_pd();
+    dots_20 = _mm256_setzero_pd();
+    dots_21 = _mm256_setzero_pd();
+    dots_30 = _mm256_setzero_pd();
+    dots_31 = _mm256_setzero_pd();
+    
+    for (i_depth = 0; i_depth < n_depth; i_depth ++) {
+        
+        column_0 = _mm256_load_pd(a_panel_b);
+        column_1 = _mm256_load_pd(a_panel_b + 4);
+        
+        row = _mm256_broadcast_sd(a_panel_a);
+        dots_00 = _mm256_fmadd_pd(row, column_0, dots_00);
+        dots_01 = _mm256_fmadd_pd(row, column_1, dots_01);
+        
+        row = _mm256_broadcast_sd(a_panel_a + 1);
+        dots_10 = _mm256_fmadd_pd(row, column_0, dots_10);
+        dots_11 = _mm256_fmadd_pd(row, column_1, dots_11);
+        
+        row = _mm256_broadcast_sd(a_panel_a + 2);
+        dots_20 = _mm256_fmadd_pd(row, column_0, dots_20);
+        dots_21 = _mm256_fmadd_pd(row, column_1, dots_21);
+        
+        row = _mm256_broadcast_sd(a_panel_a + 3);
+        dots_30 = _mm256_fmadd_pd(row, column_0, dots_30);
+        dots_31 = _mm256_fmadd_pd(row, column_1, dots_31);
+        
+        a_panel_a += _PAIRWISE_GEMM_ROWS;
+        a_panel_b += _PAIRWISE_GEMM_COLUMNS;
+    
+    }
+    
+    _mm256_storeu_pd(a_dots, dots_00);
+    _mm256_storeu_pd(a_dots + 4, dots_01);
+    _mm256_storeu_pd(a_dots + 8, dots_10);
+    _mm256_storeu_pd(a_dots + 12, dots_11);
+    _mm256_storeu_pd(a_dots + 16, dots_20);
+    _mm256_storeu_pd(a_dots + 20, dots_21);
+    _mm256_storeu_pd(a_dots + 24, dots_30);
+    _mm256_storeu_pd(a_dots + 28, dots_31);
+
+}
+
+#endif /* _PAIRWISE_SIMD_X86 */
+
+/*******************************************************************************
+
+    Symbol: _pairwise_gemm_pack, _pairwise_gemm_pack_float
+    
+    Type: Static functions returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Pack the collections i_collection_lower up to but excluding
+        i_collection_upper of a_collections, of n_depth coordinates each,
+        less the coordinates of a_origin, into a_panel as one panel n_width
+        collections wide: coordinate i of the collection in lane j of the
+        panel is element i * n_width + j. Their squared norms, taken from
+        a_norms, are likewise stored in a_panel_norms, or zeros if a_norms is
+        a null pointer. Lanes beyond i_collection_upper are filled with
+        zeros. Panels are of doubles whether a_collections is of doubles or,
+        for _pairwise_gemm_pack_float(), of floats.
+        
+        Return nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+static void
+_pairwise_gemm_pack
+(
+
+    size_t n_width,
+    size_t n_depth,
+    
+    const double* a_collections,
+    const double* a_origin,
+    const double* a_norms,
+    
+    size_t i_collection_lower,
+    size_t i_collection_upper,
+    
+    double* a_panel,
+    double* a_panel_norms
+
+)
+{
+
+    const double* collection;
+    
+    size_t i_lane;
+    size_t i_depth;
+    
+    for (i_lane = 0; i_lane < n_width; i_lane ++) {
+        
+        *(a_panel_norms + i_lane) = 0;
+        
+        if (i_collection_lower + i_lane >= i_collection_upper) {
+            
+            for (i_depth = 0; i_depth < n_depth; i_depth ++) {
+                
+                *(a_panel + (i_depth * n_width) + i_lane) = 0;
+            
+            }
+            
+            continue;
+        
+        }
+        
+        collection = a_collections + ((i_collection_lower + i_lane) * n_depth);
+        
+        for (i_depth = 0; i_depth < n_depth; i_depth ++) {
+            
+            *(a_panel + (i_depth * n_width) + i_lane) = *(collection + i_depth) - *(a_origin + i_depth);
+        
+        }
+        
+        if (a_norms) {
+            
+            *(a_panel_norms + i_lane) = *(a_norms + i_collection_lower + i_lane);
+        
+        }
+    
+    }
+
+}
+
+static void
+_pairwise_gemm_pack_float
+(
+
+    size_t n_width,
+    size_t n_depth,
+    
+    const float* a_collections,
+    const double* a_origin,
+    const double* a_norms,
+    
+    size_t i_collection_lower,
+    size_t i_collection_upper,
+    
+    double* a_panel,
+    double* a_panel_norms
+
+)
+{
+
+    const float* collection;
+    
+    size_t i_lane;
+    size_t i_depth;
+    
+    for (i_lane = 0; i_lane < n_width; i_lane ++) {
+        
+        *(a_panel_norms + i_lane) = 0;
+        
+        if (i_collection_lower + i_lane >= i_collection_upper) {
+            
+            for (i_depth = 0; i_depth < n_depth; i_depth ++) {
+                
+                *(a_panel + (i_depth * n_width) + i_lane) = 0;
+            
+            }
+            
+            continue;
+        
+        }
+        
+        collection = a_collections + ((i_collection_lower + i_lane) * n_depth);
+        
+        for (i_depth = 0; i_depth < n_depth; i_depth ++) {
+            
+            *(a_panel + (i_depth * n_width) + i_lane) = (double)*(collection + i_depth) - *(a_origin + i_depth);
+        
+        }
+        
+        if (a_norms) {
+            
+            *(a_panel_norms + i_lane) = *(a_norms + i_collection_lower + i_lane);
+        
+        }
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_gemm_norms
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Store in a_norms the squared norm of each of the n_collections
+        collections of a_collections, of gemm->n_depth coordinates each,
+        measured from gemm->a_origin, using the panels of gemm for scratch
+        space. a_collections is of floats if b_float is set, and of doubles
+        otherwise.
+        
+        Returns nothing. Not expected to fail.
+        
+    Further Information:
+    
+        Each squared norm is the dot product of a collection with itself,
+        found by the very micro-kernel which will find its dot products with
+        every other collection, from the same lane of both panels, so that
+        the expansion of a collection with itself comes out as exactly zero.
+        
+*******************************************************************************/
+
+static void
+_pairwise_gemm_norms
+(
+
+    _pairwise_gemm_sink_t* gemm,
+    
+    int b_float,
+    
+    size_t n_collections,
+    
+    const void* a_collections,
+    double* a_norms
+
+)
+{
+
+    size_t i_collection;
+    size_t i_collection_upper;
+    size_t i_lane;
+    
+    for (i_collection = 0; i_collection < n_collections; i_collection += _PAIRWISE_GEMM_ROWS) {
+        
+        i_collection_upper = i_collection + _PAIRWISE_GEMM_ROWS;
+        
+        if (i_collection_upper > n_collections) {
+            
+            i_collection_upper = n_collections;
+        
+        }
+        
+        if (b_float) {
+            
+            _pairwise_gemm_pack_float(_PAIRWISE_GEMM_ROWS, gemm->n_depth, a_collections, gemm->a_origin, NULL,
+                                      i_collection, i_collection_upper, gemm->a_panel_a, gemm->a_panel_norms_a);
+                                      
+            _pairwise_gemm_pack_float(_PAIRWISE_GEMM_COLUMNS, gemm->n_depth, a_collections, gemm->a_origin, NULL,
+                                      i_collection, i_collection_upper, gemm->a_panel_b, gemm->a_panel_norms_b);
+        
+        } else {
+            
+            _pairwise_gemm_pack(_PAIRWISE_GEMM_ROWS, gemm->n_depth, a_collections, gemm->a_origin, NULL,
+                                i_collection, i_collection_upper, gemm->a_panel_a, gemm->a_panel_norms_a);
+                                
+            _pairwise_gemm_pack(_PAIRWISE_GEMM_COLUMNS, gemm->n_depth, a_collections, gemm->a_origin, NULL,
+                                i_collection, i_collection_upper, gemm->a_panel_b, gemm->a_panel_norms_b);
+        
+        }
+        
+        gemm->f_kernel(gemm->n_depth, gemm->a_panel_a, gemm->a_panel_b, gemm->a_dots);
+        
+        for (i_lane = 0; i_collection + i_lane < i_collection_upper; i_lane ++) {
+            
+            *(a_norms + i_collection + i_lane) = *(gemm->a_dots + (i_lane * _PAIRWISE_GEMM_COLUMNS) + i_lane);
+        
+        }
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_gemm_tile
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Tile driver for job->f_tile. Calculates by norm expansion the results
+        of every pairwise calculation between collections
+        i_collection_a_lower up to but excluding i_collection_a_upper of job
+        and collections i_collection_b_lower up to but excluding
+        i_collection_b_upper, on doubles, and stores them in the block of
+        sink, a _pairwise_gemm_sink_t, from which _pairwise_gemm_row() then
+        copies them row by row.
+        
+        On success returns nothing. Not expected to fail.
+        
+    Further Information:
+    
+        The squared distance between collections a and b is
+        ||a||^2 + ||b||^2 - 2 a.b, of which only the dot product need be found
+        for each pair; the squared norms were found once for every collection
+        by _pairwise_gemm_prepare(). The RMSD is then the square root of the
+        squared distance over job->n_points, which is one for a Euclidean
+        distance.
+        
+        Round-off in the expansion grows with the norms rather than with the
+        distance, so every collection is measured from a common origin, the
+        first collection of job->a_collections, which keeps the norms of
+        ordinary data, such as frames of one molecule or features far from
+        zero, on the scale of the distances between them. Where a pair is
+        nonetheless near enough for its squared distance to come out at less
+        than 1 / _PAIRWISE_GEMM_CANCELLATION of the sum of its squared norms,
+        the pair is calculated again directly by job->f_calculation, so that
+        no result loses more than a few bits to cancellation, and identical
+        collections give exactly zero.
+        
+        The second collections of the tile are packed once, and each group of
+        _PAIRWISE_GEMM_ROWS first collections is packed in turn and passed
+        to the micro-kernel with every panel of second collections. On the
+        diagonal of a triangle, blocks with no pair above it are skipped.
+        
+*******************************************************************************/
+
+static void
+_pairwise_gemm_tile
+(
+
+    _pairwise_job_t* job,
+    
+    void* sink,
+    
+    size_t i_collection_a_lower,
+    size_t i_collection_a_upper,
+    size_t i_collection_b_lower,
+    size_t i_collection_b_upper
+
+)
+{
+
+    _pairwise_gemm_sink_t* gemm;
+    
+    double* a_panel_b;
+    double* a_panel_norms_a;
+    double* a_panel_norms_b;
+    double* a_dots;
+    double* a_results;
+    
+    double norms;
+    double squared;
+    
+    int b_triangle;
+    
+    size_t n_depth;
+    size_t n_panels;
+    size_t n_block_columns;
+    size_t n_collections_old;
+    
+    size_t i_collection_a;
+    size_t i_collection_b;
+    size_t i_panel;
+    size_t i_row;
+    size_t i_column;
+    
+    gemm = sink;
+    
+    n_depth = gemm->n_depth;
+    
+    a_panel_norms_a = gemm->a_panel_norms_a;
+    a_dots = gemm->a_dots;
+    
+    n_panels = (i_collection_b_upper - i_collection_b_lower + _PAIRWISE_GEMM_COLUMNS - 1) / _PAIRWISE_GEMM_COLUMNS;
+    n_block_columns = n_panels * _PAIRWISE_GEMM_COLUMNS;
+    
+    b_triangle = !job->b_cross || job->b_append;
+    n_collections_old = job->b_append ? job->n_collections - job->n_collections_b : 0;
+    
+    gemm->i_collection_a_lower = i_collection_a_lower;
+    gemm->i_collection_b_lower = i_collection_b_lower;
+    gemm->n_block_columns = n_block_columns;
+    
+    for (i_panel = 0; i_panel < n_panels; i_panel ++) {
+        
+        _pairwise_gemm_pack(_PAIRWISE_GEMM_COLUMNS,
+                            n_depth,
+                            job->a_collections_b,
+                            gemm->a_origin,
+                            gemm->a_norms_b,
+                            i_collection_b_lower + (i_panel * _PAIRWISE_GEMM_COLUMNS),
+                            i_collection_b_upper,
+                            gemm->a_panel_b + (i_panel * _PAIRWISE_GEMM_COLUMNS * n_depth),
+                            gemm->a_panel_norms_b + (i_panel * _PAIRWISE_GEMM_COLUMNS));
+    
+    }
+    
+    for (i_collection_a = i_collection_a_lower;
+         i_collection_a < i_collection_a_upper;
+         i_collection_a += _PAIRWISE_GEMM_ROWS) {
+             
+        _pairwise_gemm_pack(_PAIRWISE_GEMM_ROWS,
+                            n_depth,
+                            job->a_collections,
+                            gemm->a_origin,
+                            gemm->a_norms,
+                            i_collection_a,
+                            i_collection_a_upper,
+                            gemm->a_panel_a,
+                            a_panel_norms_a);
+                            
+        for (i_panel = 0; i_panel < n_panels; i_panel ++) {
+            
+            i_collection_b = i_collection_b_lower + (i_panel * _PAIRWISE_GEMM_COLUMNS);
+            
+            /*
+            *   Unless calculating a rectangle, skip a block whose last
+            *   second collection comes no later than its first first
+            *   collection, since none of its pairs belong to the tile.
+            */
+            
+            if (b_triangle && n_collections_old + i_collection_b + _PAIRWISE_GEMM_COLUMNS <= i_collection_a + 1) {
+                
+                continue;
+            
+            }
+            
+            a_panel_b = gemm->a_panel_b + (i_panel * _PAIRWISE_GEMM_COLUMNS * n_depth);
+            a_panel_norms_b = gemm->a_panel_norms_b + (i_panel * _PAIRWISE_GEMM_COLUMNS);
+            
+            gemm->f_kernel(n_depth, gemm->a_panel_a, a_panel_b, a_dots);
+            
+            a_results = (double*)gemm->a_block
+                      + ((i_collection_a - i_collection_a_lower) * n_block_columns)
+                      + (i_panel * _PAIRWISE_GEMM_COLUMNS);
+                      
+            for (i_row = 0; i_row < _PAIRWISE_GEMM_ROWS; i_row ++) {
+                
+                for (i_column = 0; i_column < _PAIRWISE_GEMM_COLUMNS; i_column ++) {
+                    
+                    norms = *(a_panel_norms_a + i_row) + *(a_panel_norms_b + i_column);
+                    squared = norms - (2 * *(a_dots + (i_row * _PAIRWISE_GEMM_COLUMNS) + i_column));
+                    
+                    /*
+                    *   Recalculate a pair too near for the expansion directly,
+                    *   so long as it lies within the tile and is one whose
+                    *   result will be stored.
+                    */
+                    
+                    if (squared * _PAIRWISE_GEMM_CANCELLATION < norms
+                    &&  i_collection_a + i_row < i_collection_a_upper
+                    &&  i_collection_b + i_column < i_collection_b_upper
+                    &&  (!b_triangle || n_collections_old + i_collection_b + i_column > i_collection_a + i_row)) {
+                        
+                        *(a_results + (i_row * n_block_columns) + i_column)
+                            = job->f_calculation(job->n_points,
+                                                 job->n_coordinates,
+                                                 (double*)job->a_collections + ((i_collection_a + i_row) * n_depth),
+                                                 (double*)job->a_collections_b + ((i_collection_b + i_column) * n_depth));
+                                                 
+                        continue;
+                    
+                    }
+                    
+                    if (squared < 0) {
+                        
+                        squared = 0;
+                    
+                    }
+                    
+                    *(a_results + (i_row * n_block_columns) + i_column) = sqrt(squared / job->n_points);
+                
+                }
+            
+            }
+        
+        }
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_gemm_tile_float
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_gemm_tile(), but on floats, whose dot products and
+        squared distances are nonetheless found in double precision and
+        rounded to single precision only once calculated. Pairs too near for
+        the expansion are recalculated directly by job->f_calculation_float.
+        
+*******************************************************************************/
+
+static void
+_pairwise_gemm_tile_float
+(
+
+    _pairwise_job_t* job,
+    
+    void* sink,
+    
+    size_t i_collection_a_lower,
+    size_t i_collection_a_upper,
+    size_t i_collection_b_lower,
+    size_t i_collection_b_upper
+
+)
+{
+
+    _pairwise_gemm_sink_t* gemm;
+    
+    double* a_panel_b;
+    double* a_panel_norms_a;
+    double* a_panel_norms_b;
+    double* a_dots;
+    float* a_results;
+    
+    double norms;
+    double squared;
+    
+    int b_triangle;
+    
+    size_t n_depth;
+    size_t n_panels;
+    size_t n_block_columns;
+    size_t n_collections_old;
+    
+    size_t i_collection_a;
+    size_t i_collection_b;
+    size_t i_panel;
+    size_t i_row;
+    size_t i_column;
+    
+    gemm = sink;
+    
+    n_depth = gemm->n_depth;
+    
+    a_panel_norms_a = gemm->a_panel_norms_a;
+    a_dots = gemm->a_dots;
+    
+    n_panels = (i_collection_b_upper - i_collection_b_lower + _PAIRWISE_GEMM_COLUMNS - 1) / _PAIRWISE_GEMM_COLUMNS;
+    n_block_columns = n_panels * _PAIRWISE_GEMM_COLUMNS;
+    
+    b_triangle = !job->b_cross || job->b_append;
+    n_collections_old = job->b_append ? job->n_collections - job->n_collections_b : 0;
+    
+    gemm->i_collection_a_lower = i_collection_a_lower;
+    gemm->i_collection_b_lower = i_collection_b_lower;
+    gemm->n_block_columns = n_block_columns;
+    
+    for (i_panel = 0; i_panel < n_panels; i_panel ++) {
+        
+        _pairwise_gemm_pack_float(_PAIRWISE_GEMM_COLUMNS,
+                                  n_depth,
+                                  job->a_collections_b,
+                                  gemm->a_origin,
+                                  gemm->a_norms_b,
+                                  i_collection_b_lower + (i_panel * _PAIRWISE_GEMM_COLUMNS),
+                                  i_collection_b_upper,
+                                  gemm->a_panel_b + (i_panel * _PAIRWISE_GEMM_COLUMNS * n_depth),
+                                  gemm->a_panel_norms_b + (i_panel * _PAIRWISE_GEMM_COLUMNS));
+    
+    }
+    
+    for (i_collection_a = i_collection_a_lower;
+         i_collection_a < i_collection_a_upper;
+         i_collection_a += _PAIRWISE_GEMM_ROWS) {
+             
+        _pairwise_gemm_pack_float(_PAIRWISE_GEMM_ROWS,
+                                  n_depth,
+                                  job->a_collections,
+                                  gemm->a_origin,
+                                  gemm->a_norms,
+                                  i_collection_a,
+                                  i_collection_a_upper,
+                                  gemm->a_panel_a,
+                                  a_panel_norms_a);
+                                  
+        for (i_panel = 0; i_panel < n_panels; i_panel ++) {
+            
+            i_collection_b = i_collection_b_lower + (i_panel * _PAIRWISE_GEMM_COLUMNS);
+            
+            if (b_triangle && n_collections_old + i_collection_b + _PAIRWISE_GEMM_COLUMNS <= i_collection_a + 1) {
+                
+                continue;
+            
+            }
+            
+            a_panel_b = gemm->a_panel_b + (i_panel * _PAIRWISE_GEMM_COLUMNS * n_depth);
+            a_panel_norms_b = gemm->a_panel_norms_b + (i_panel * _PAIRWISE_GEMM_COLUMNS);
+            
+            gemm->f_kernel(n_depth, gemm->a_panel_a, a_panel_b, a_dots);
+            
+            a_results = (float*)gemm->a_block
+                      + ((i_collection_a - i_collection_a_lower) * n_block_columns)
+                      + (i_panel * _PAIRWISE_GEMM_COLUMNS);
+                      
+            for (i_row = 0; i_row < _PAIRWISE_GEMM_ROWS; i_row ++) {
+                
+                for (i_column = 0; i_column < _PAIRWISE_GEMM_COLUMNS; i_column ++) {
+                    
+                    norms = *(a_panel_norms_a + i_row) + *(a_panel_norms_b + i_column);
+                    squared = norms - (2 * *(a_dots + (i_row * _PAIRWISE_GEMM_COLUMNS) + i_column));
+                    
+                    if (squared * _PAIRWISE_GEMM_CANCELLATION < norms
+                    &&  i_collection_a + i_row < i_collection_a_upper
+                    &&  i_collection_b + i_column < i_collection_b_upper
+                    &&  (!b_triangle || n_collections_old + i_collection_b + i_column > i_collection_a + i_row)) {
+                        
+                        *(a_results + (i_row * n_block_columns) + i_column)
+                            = job->f_calculation_float(job->n_points,
+                                                       job->n_coordinates,
+                                                       (float*)job->a_collections + ((i_collection_a + i_row) * n_depth),
+                                                       (float*)job->a_collections_b + ((i_collection_b + i_column) * n_depth));
+                                                       
+                        continue;
+                    
+                    }
+                    
+                    if (squared < 0) {
+                        
+                        squared = 0;
+                    
+                    }
+                    
+                    *(a_results + (i_row * n_block_columns) + i_column) = (float)sqrt(squared / job->n_points);
+                
+                }
+            
+            }
+        
+        }
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_gemm_row
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Row driver for job->f_row. Copies the results between collection
+        i_collection_a of job and each of collections i_collection_b_lower up
+        to but excluding i_collection_b_upper, already calculated by the tile
+        driver into the block of sink, a _pairwise_gemm_sink_t, consecutively
+        from a_results_row. Serves doubles and floats alike.
+        
+        On success returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+static void
+_pairwise_gemm_row
+(
+
+    _pairwise_job_t* job,
+    
+    void* sink,
+    
+    size_t i_collection_a,
+    size_t i_collection_b_lower,
+    size_t i_collection_b_upper,
+    
+    void* a_results_row
+
+)
+{
+
+    _pairwise_gemm_sink_t* gemm;
+    
+    size_t i_block;
+    
+    gemm = sink;
+    
+    i_block = ((i_collection_a - gemm->i_collection_a_lower) * gemm->n_block_columns)
+            + (i_collection_b_lower - gemm->i_collection_b_lower);
+            
+    memcpy(a_results_row,
+           (char*)gemm->a_block + (i_block * job->s_element),
+           (i_collection_b_upper - i_collection_b_lower) * job->s_element);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_gemm_free
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Frees the n_sinks _pairwise_gemm_sink_t of a_sinks, everything they
+        point to, and the origin and squared norms which the first of them
+        points to.
+        
+        Returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+static void
+_pairwise_gemm_free
+(
+
+    _pairwise_gemm_sink_t* a_sinks,
+    
+    size_t n_sinks
+
+)
+{
+
+    _pairwise_gemm_sink_t* gemm;
+    
+    size_t i_sink;
+    
+    for (i_sink = 0; i_sink < n_sinks; i_sink ++) {
+        
+        gemm = a_sinks + i_sink;
+        
+        free(gemm->a_panel_a);
+        free(gemm->a_panel_b);
+        free(gemm->a_panel_norms_a);
+        free(gemm->a_panel_norms_b);
+        free(gemm->a_dots);
+        free(gemm->a_block);
+    
+    }
+    
+    if (a_sinks->a_norms_b != a_sinks->a_norms) {
+        
+        free(a_sinks->a_norms_b);
+    
+    }
+    
+    free(a_sinks->a_norms);
+    free(a_sinks->a_origin);
+    
+    free(a_sinks);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_gemm_allocate
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Allocates s_buffer bytes aligned to _PAIRWISE_GEMM_ALIGNMENT bytes,
+        and stores a pointer to them in a_buffer, or a null pointer on
+        failure.
+        
+        Returns integer zero on success, or integer one on failure.
+        
+*******************************************************************************/
+
+static int
+_pairwise_gemm_allocate
+(
+
+    void** a_buffer,
+    
+    size_t s_buffer
+
+)
+{
+
+    if (posix_memalign(a_buffer, _PAIRWISE_GEMM_ALIGNMENT, s_buffer)) {
+        
+        *a_buffer = NULL;
+        
+        return 1;
+    
+    }
+    
+    return 0;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_gemm_prepare
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        If job, whose tiles must already have been cut by
+        _pairwise_populate_chunks(), calculates Euclidean distances or RMSDs
+        with one of the generic row drivers, between collections of at least
+        _PAIRWISE_GEMM_MIN_ELEMENTS coordinates in all, switches it over to
+        norm expansion: finds the squared norm of every collection, measured
+        from the first collection of job->a_collections, gives each of
+        n_threads threads a _pairwise_gemm_sink_t, and replaces the tile and
+        row drivers of job with those of this module. Leaves every other job
+        as it is.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns PAIRWISE_RETURN_MALLOC_FAIL, and
+        leaves job as it is.
+        
+    Further Information:
+    
+        Calculated directly, each pair costs a subtraction, a multiplication
+        and an addition per coordinate, and reads two coordinates for them,
+        so wide collections are bound by loads rather than by arithmetic.
+        Expanded, each pair costs a single multiply-add per coordinate, and
+        the micro-kernel reuses every coordinate it loads across a whole row
+        or column of its block, as in a matrix multiplication. Collections
+        narrower than _PAIRWISE_GEMM_MIN_ELEMENTS gain too little from this
+        to pay for packing, and keep the direct calculation.
+        
+        The origin is a collection of the set rather than, say, its mean, so
+        that it stays the same when collections are appended, and appended
+        results agree to the bit with those calculated for the whole set at
+        once. Measured from it, and with near pairs recalculated directly,
+        results agree with the direct calculation to within a few units in
+        the last place; see _pairwise_gemm_tile(). The expansion is confined
+        to calculations which store every result, through _pairwise_launch()
+        and its cross and append variants. Those which filter, reduce,
+        cluster or stream results keep the direct calculation, and so may
+        differ from them by that much for such wide collections.
+        
+        The micro-kernel is also written for AVX2 with FMA, and that version
+        is used whenever the instruction set selected by pairwise_set_isa()
+        is AVX2 or wider. Either way, one calculation uses one micro-kernel
+        throughout, norms included, and always in double precision.
+        
+*******************************************************************************/
+
+int
+_pairwise_gemm_prepare
+(
+
+    _pairwise_job_t* job,
+    
+    size_t n_threads
+
+)
+{
+
+    _pairwise_gemm_sink_t* a_sinks;
+    _pairwise_gemm_sink_t* gemm;
+    
+    double* a_origin;
+    double* a_norms;
+    double* a_norms_b;
+    
+    int b_double;
+    int b_float;
+    int b_failed;
+    
+    size_t n_depth;
+    size_t n_rows;
+    size_t n_columns;
+    
+    size_t i_sink;
+    size_t i_depth;
+    
+    n_depth = job->n_points * job->n_coordinates;
+    
+    b_double = job->f_row == _pairwise_launch_row
+            && (job->f_calculation == _pairwise_single_rmsd
+            ||  (job->f_calculation == _pairwise_single_distance && job->n_points == 1));
+            
+    b_float = job->f_row == _pairwise_launch_row_float
+           && (job->f_calculation_float == _pairwise_single_rmsd_float
+           ||  (job->f_calculation_float == _pairwise_single_distance_float && job->n_points == 1));
+           
+    if ((!b_double && !b_float) || n_depth < _PAIRWISE_GEMM_MIN_ELEMENTS) {
+        
+        return PAIRWISE_RETURN_SUCCESS;
+    
+    }
+    
+    /*
+    *   The block of a tile has room for whole blocks of the micro-kernel,
+    *   even where the tile ends part way through one.
+    */
+    
+    n_rows = ((job->n_tile_collections + _PAIRWISE_GEMM_ROWS - 1) / _PAIRWISE_GEMM_ROWS)
+           * _PAIRWISE_GEMM_ROWS;
+           
+    n_columns = ((job->n_tile_collections + _PAIRWISE_GEMM_COLUMNS - 1) / _PAIRWISE_GEMM_COLUMNS)
+              * _PAIRWISE_GEMM_COLUMNS;
+              
+    a_sinks = calloc(n_threads, sizeof(_pairwise_gemm_sink_t));
+    
+    if (!a_sinks) {
+        
+        return PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    b_failed = 0;
+    
+    for (i_sink = 0; i_sink < n_threads; i_sink ++) {
+        
+        gemm = a_sinks + i_sink;
+        
+        gemm->f_kernel = _pairwise_gemm_kernel;
+        
+        #if defined(_PAIRWISE_SIMD_X86)
+        if (pairwise_get_isa() >= PAIRWISE_ISA_AVX2
+        &&  pairwise_isa_supported(PAIRWISE_ISA_AVX2)) {
+            
+            gemm->f_kernel = _pairwise_gemm_kernel_avx2;
+        
+        }
+        #endif
+        
+        gemm->n_depth = n_depth;
+        
+        b_failed |= _pairwise_gemm_allocate((void**)&gemm->a_panel_a, _PAIRWISE_GEMM_ROWS * n_depth * sizeof(double));
+        b_failed |= _pairwise_gemm_allocate((void**)&gemm->a_panel_b, n_columns * n_depth * sizeof(double));
+        b_failed |= _pairwise_gemm_allocate((void**)&gemm->a_panel_norms_a, _PAIRWISE_GEMM_ROWS * sizeof(double));
+        b_failed |= _pairwise_gemm_allocate((void**)&gemm->a_panel_norms_b, n_columns * sizeof(double));
+        b_failed |= _pairwise_gemm_allocate((void**)&gemm->a_dots, _PAIRWISE_GEMM_ROWS * _PAIRWISE_GEMM_COLUMNS * sizeof(double));
+        b_failed |= _pairwise_gemm_allocate(&gemm->a_block, n_rows * n_columns * job->s_element);
+    
+    }
+    
+    a_origin = malloc(n_depth * sizeof(double));
+    a_norms = malloc(job->n_collections * sizeof(double));
+    a_norms_b = job->b_cross ? malloc(job->n_collections_b * sizeof(double)) : a_norms;
+    
+    a_sinks->a_origin = a_origin;
+    a_sinks->a_norms = a_norms;
+    a_sinks->a_norms_b = a_norms_b;
+    
+    if (b_failed || !a_origin || !a_norms || !a_norms_b) {
+        
+        _pairwise_gemm_free(a_sinks, n_threads);
+        
+        return PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    /*
+    *   Take the first collection as the origin, then find the squared norms
+    *   once, using the scratch space of the first sink, and share them
+    *   between every sink.
+    */
+    
+    for (i_depth = 0; i_depth < n_depth; i_depth ++) {
+        
+        *(a_origin + i_depth) = b_float ? *((float*)job->a_collections + i_depth)
+                                        : *((double*)job->a_collections + i_depth);
+    
+    }
+    
+    _pairwise_gemm_norms(a_sinks, b_float, job->n_collections, job->a_collections, a_norms);
+    
+    if (job->b_cross) {
+        
+        _pairwise_gemm_norms(a_sinks, b_float, job->n_collections_b, job->a_collections_b, a_norms_b);
+    
+    }
+    
+    for (i_sink = 1; i_sink < n_threads; i_sink ++) {
+        
+        (a_sinks + i_sink)->a_origin = a_origin;
+        (a_sinks + i_sink)->a_norms = a_norms;
+        (a_sinks + i_sink)->a_norms_b = a_norms_b;
+    
+    }
+    
+    job->a_sinks = a_sinks;
+    job->s_sink = sizeof(_pairwise_gemm_sink_t);
+    
+    job->f_tile = b_float ? _pairwise_gemm_tile_float : _pairwise_gemm_tile;
+    job->f_row = _pairwise_gemm_row;
+    
+    return PAIRWISE_RETURN_SUCCESS;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_gemm_release
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Frees everything allocated by a successful call to
+        _pairwise_gemm_prepare() for job and n_threads threads, if it switched
+        job over to norm expansion. Does nothing otherwise.
+        
+        Returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+void
+_pairwise_gemm_release
+(
+
+    _pairwise_job_t* job,
+    
+    size_t n_threads
+
+)
+{
+
+    if (job->f_row != _pairwise_gemm_row) {
+        
+        return;
+    
+    }
+    
+    _pairwise_gemm_free(job->a_sinks, n_threads);
+    
+    job->a_sinks = NULL;
+
+}
@@ -1,5 +1,266 @@
 #include "pairwise_index.h"
 
+/*******************************************************************************
+
+    Symbol: _pairwise_index_triangle
+    
+    Type: Static function returning size_t
+    
+    Intent: Private
+    
+    Description:
+    
+        Returns the n_rows-th triangular number, n_rows * (n_rows + 1) / 2,
+        the number of results in the last n_rows rows of the condensed upper
+        triangle. One of the two factors is always even, and is halved before
+        multiplying, so the product cannot overflow unless the result itself
+        would.
+        
+        Not expected to fail.
+        
+*******************************************************************************/
+
+static size_t
+_pairwise_index_triangle
+(
+
+    size_t n_rows
+
+)
+{
+
+    if (n_rows & 1) {
+        
+        return n_rows * ((n_rows + 1) >> 1);
+    
+    }
+    
+    return (n_rows >> 1) * (n_rows + 1);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_index_span, _pairwise_index_inverse_span
+    
+    Type: Static functions returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Carry out one thread's share, task, a _pairwise_index_task_t, of
+        pairwise_indices() or pairwise_indices_inverse() respectively, by
+        calling pairwise_index() or pairwise_index_inverse() on each of its
+        elements in turn, and stopping at the first which fails.
+        
+        Return nothing. Record their outcome in task.
+        
+*******************************************************************************/
+
+static void
+_pairwise_index_span
+(
+
+    void* task
+
+)
+{
+
+    _pairwise_index_task_t* share;
+    
+    ssize_t* a_collections_a;
+    ssize_t* a_collections_b;
+    size_t* a_results;
+    
+    size_t i_index;
+    
+    share = task;
+    
+    a_collections_a = share->a_collections_a;
+    a_collections_b = share->a_collections_b;
+    a_results = share->a_results;
+    
+    share->n_return = PAIRWISE_RETURN_SUCCESS;
+    
+    for (i_index = share->i_lower; i_index < share->i_upper; i_index ++) {
+        
+        share->n_return = pairwise_index(share->n_collections,
+                                         *(a_collections_a + i_index),
+                                         *(a_collections_b + i_index),
+                                         a_results + i_index);
+                                         
+        if (share->n_return) {
+            
+            return;
+        
+        }
+    
+    }
+
+}
+
+static void
+_pairwise_index_inverse_span
+(
+
+    void* task
+
+)
+{
+
+    _pairwise_index_task_t* share;
+    
+    size_t* a_collections_a;
+    size_t* a_collections_b;
+    ssize_t* a_results;
+    
+    size_t i_index;
+    
+    share = task;
+    
+    a_collections_a = share->a_collections_a;
+    a_collections_b = share->a_collections_b;
+    a_results = share->a_results;
+    
+    share->n_return = PAIRWISE_RETURN_SUCCESS;
+    
+    for (i_index = share->i_lower; i_index < share->i_upper; i_index ++) {
+        
+        share->n_return = pairwise_index_inverse(share->n_collections,
+                                                 *(a_results + i_index),
+                                                 a_collections_a + i_index,
+                                                 a_collections_b + i_index);
+                                                 
+        if (share->n_return) {
+            
+            return;
+        
+        }
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_index_run
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Splits n_indices elements of a_collections_a, a_collections_b and
+        a_results into contiguous shares of at least _PAIRWISE_INDEX_GRAIN
+        elements, for no more than n_threads threads, and runs f_span, one of
+        _pairwise_index_span() or _pairwise_index_inverse_span(), on each
+        share with the worker pool.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns the error code of the first
+        element which failed, whichever thread found it, so the outcome never
+        depends on the number of threads, or another non-zero libpairwise
+        error code.
+        
+*******************************************************************************/
+
+static int
+_pairwise_index_run
+(
+
+    void (*f_span)(void* task),
+    
+    size_t n_collections,
+    size_t n_indices,
+    
+    void* a_collections_a,
+    void* a_collections_b,
+    void* a_results,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    _pairwise_index_task_t* a_tasks;
+    
+    size_t n_tasks;
+    
+    size_t i_task;
+    
+    if (n_collections < 2) {
+        
+        return PAIRWISE_RETURN_ERROR_NCOLLECTIONS;
+    
+    }
+    
+    if (!n_threads) {
+        
+        return PAIRWISE_RETURN_ERROR_NTHREADS;
+    
+    }
+    
+    if (!n_indices) {
+        
+        return PAIRWISE_RETURN_SUCCESS;
+    
+    }
+    
+    n_tasks = (n_indices + _PAIRWISE_INDEX_GRAIN - 1) / _PAIRWISE_INDEX_GRAIN;
+    
+    if (n_tasks > n_threads) {
+        
+        n_tasks = n_threads;
+    
+    }
+    
+    a_tasks = malloc(n_tasks * sizeof(_pairwise_index_task_t));
+    
+    if (!a_tasks) {
+        
+        return PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    for (i_task = 0; i_task < n_tasks; i_task ++) {
+        
+        (a_tasks + i_task)->n_collections = n_collections;
+        
+        (a_tasks + i_task)->a_collections_a = a_collections_a;
+        (a_tasks + i_task)->a_collections_b = a_collections_b;
+        (a_tasks + i_task)->a_results = a_results;
+        
+        (a_tasks + i_task)->i_lower = (n_indices * i_task) / n_tasks;
+        (a_tasks + i_task)->i_upper = (n_indices * (i_task + 1)) / n_tasks;
+    
+    }
+    
+    n_return = _pairwise_pool_run(f_span,
+                                  a_tasks,
+                                  sizeof(_pairwise_index_task_t),
+                                  n_tasks);
+                                  
+    /*
+    *   Shares are in order, so the first share to fail holds the first
+    *   element to fail.
+    */
+    
+    for (i_task = 0; i_task < n_tasks && !n_return; i_task ++) {
+        
+        n_return = (a_tasks + i_task)->n_return;
+    
+    }
+    
+    free(a_tasks);
+    
+    return n_return;
+
+}
+
 /*******************************************************************************
 
     Symbol: pairwise_index
@@ -113,3 +374,226 @@ pairwise_index
     return PAIRWISE_RETURN_SUCCESS;
 
 }
+
+/*******************************************************************************
+
+    Symbol: pairwise_index_inverse
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        The inverse of pairwise_index(). Finds the two collections whose
+        pairwise calculation gave the result at index i_result of an array of
+        results for n_collections collections, and stores the lesser of their
+        indices in i_collection_a and the greater in i_collection_b.
+        
+        A negative i_result is permitted, and indexes backwards from the end
+        of the results, so that -1 indicates the last of them.
+        
+        Fails if n_collections is less than two, or if i_result is out of
+        bounds for the results of n_collections collections.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+    Further Information:
+    
+        Counting from the end of the results, the last n_rows rows of the
+        condensed upper triangle hold _pairwise_index_triangle(n_rows)
+        results, so the row holding i_result is found by inverting that
+        triangular number. A square root in double precision gives n_rows to
+        within one or so even when the number of results exceeds the 53 bits
+        of a double's mantissa; it is then corrected exactly in integer
+        arithmetic, so that every index a size_t can hold maps back to the
+        right pair.
+        
+*******************************************************************************/
+
+int
+pairwise_index_inverse
+(
+
+    size_t n_collections,
+    
+    ssize_t i_result,
+    
+    size_t* i_collection_a,
+    size_t* i_collection_b
+
+)
+{
+
+    size_t n_results;
+    size_t n_after;
+    size_t n_rows;
+    
+    if (n_collections < 2) {
+        
+        return PAIRWISE_RETURN_ERROR_NCOLLECTIONS;
+    
+    }
+    
+    n_results = _pairwise_index_triangle(n_collections - 1);
+    
+    if (i_result < 0) {
+        
+        i_result += n_results;
+    
+    }
+    
+    if (i_result < 0 || i_result >= n_results) {
+        
+        return PAIRWISE_RETURN_ERROR_IRESULT;
+    
+    }
+    
+    /*
+    *   n_after results follow i_result. The last n_rows rows are the fewest
+    *   which hold all of them and i_result itself.
+    */
+    
+    n_after = n_results - 1 - i_result;
+    
+    n_rows = (sqrt(8.0 * (double)n_after + 1.0) - 1.0) / 2.0;
+    
+    while (n_rows && _pairwise_index_triangle(n_rows) > n_after) {
+        
+        n_rows --;
+    
+    }
+    
+    while (_pairwise_index_triangle(n_rows + 1) <= n_after) {
+        
+        n_rows ++;
+    
+    }
+    
+    *i_collection_a = n_collections - 2 - n_rows;
+    *i_collection_b = n_collections - 1 - (n_after - _pairwise_index_triangle(n_rows));
+    
+    return PAIRWISE_RETURN_SUCCESS;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_indices
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        pairwise_index() over arrays. For each of n_indices elements, stores
+        in a_results the index of the result of the pairwise calculation
+        between the collections indexed by the same element of
+        a_collections_a and a_collections_b, exactly as pairwise_index()
+        would. The work is split over up to n_threads threads.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns the error code pairwise_index()
+        gives for the first element which fails, or another non-zero
+        libpairwise error code, and makes no guarantee about the state of
+        a_results.
+        
+    Further Information:
+    
+        The elements are split into contiguous shares run on the worker pool
+        by _pairwise_index_run(), which uses a single thread for arrays of
+        fewer than _PAIRWISE_INDEX_GRAIN elements.
+        
+*******************************************************************************/
+
+int
+pairwise_indices
+(
+
+    size_t n_collections,
+    size_t n_indices,
+    
+    ssize_t* a_collections_a,
+    ssize_t* a_collections_b,
+    
+    size_t* a_results,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_index_run(_pairwise_index_span,
+                                   n_collections,
+                                   n_indices,
+                                   a_collections_a,
+                                   a_collections_b,
+                                   a_results,
+                                   n_threads);
+                                   
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_indices_inverse
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        pairwise_index_inverse() over arrays. For each of n_indices elements
+        of a_results, stores in the same element of a_collections_a and
+        a_collections_b the indices of the two collections whose pairwise
+        calculation gave that result, exactly as pairwise_index_inverse()
+        would. The work is split over up to n_threads threads.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns the error code
+        pairwise_index_inverse() gives for the first element which fails, or
+        another non-zero libpairwise error code, and makes no guarantee about
+        the state of a_collections_a or a_collections_b.
+        
+    Further Information:
+    
+        As for pairwise_indices().
+        
+*******************************************************************************/
+
+int
+pairwise_indices_inverse
+(
+
+    size_t n_collections,
+    size_t n_indices,
+    
+    ssize_t* a_results,
+    
+    size_t* a_collections_a,
+    size_t* a_collections_b,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_index_run(_pairwise_index_inverse_span,
+                                   n_collections,
+                                   n_indices,
+                                   a_collections_a,
+                                   a_collections_b,
+                                   a_results,
+                                   n_threads);
+                                   
+    return n_return;
+
+}
@@ -0,0 +1,758 @@
+#include "pairwise_knn.h"
+
+/*******************************************************************************
+
+    Symbol: _pairwise_neighbour_compare
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Orders two neighbours, a and b, of the same collection by result, and
+        then by collection, for qsort() and for the heaps of
+        _pairwise_heaps_t.
+        
+        Returns a negative integer, zero or a positive integer as a is nearer
+        than, as near as, or farther than b. Not expected to fail.
+        
+*******************************************************************************/
+
+static int
+_pairwise_neighbour_compare
+(
+
+    const void* a,
+    const void* b
+
+)
+{
+
+    const _pairwise_neighbour_t* neighbour_a;
+    const _pairwise_neighbour_t* neighbour_b;
+    
+    neighbour_a = a;
+    neighbour_b = b;
+    
+    if (neighbour_a->result != neighbour_b->result) {
+        
+        return (neighbour_a->result > neighbour_b->result) - (neighbour_a->result < neighbour_b->result);
+    
+    }
+    
+    return (neighbour_a->i_collection > neighbour_b->i_collection) - (neighbour_a->i_collection < neighbour_b->i_collection);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_heaps_offer
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Offers collection i_collection, whose result with collection i_row is
+        result, to the heap of i_row in heaps. Keeps it if the heap is not yet
+        full, or if it is nearer than the farthest neighbour in the heap,
+        which it then replaces.
+        
+        Returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+static void
+_pairwise_heaps_offer
+(
+
+    _pairwise_heaps_t* heaps,
+    
+    size_t i_row,
+    size_t i_collection,
+    
+    double result
+
+)
+{
+
+    _pairwise_neighbour_t* a_heap;
+    
+    _pairwise_neighbour_t neighbour;
+    
+    size_t n_neighbours;
+    size_t n_fill;
+    
+    size_t i_node;
+    size_t i_next;
+    
+    n_neighbours = heaps->n_neighbours;
+    
+    a_heap = heaps->a_neighbours + (i_row * n_neighbours);
+    
+    n_fill = *(heaps->a_fills + i_row);
+    
+    neighbour.i_collection = i_collection;
+    neighbour.result = result;
+    
+    if (n_fill < n_neighbours) {
+        
+        /*
+        *   The heap is not yet full, so add the neighbour as a new leaf and
+        *   sift it up past every parent nearer than it.
+        */
+        
+        *(heaps->a_fills + i_row) = n_fill + 1;
+        
+        for (i_node = n_fill; i_node; i_node = i_next) {
+            
+            i_next = (i_node - 1) / 2;
+            
+            if (_pairwise_neighbour_compare(a_heap + i_next, &neighbour) >= 0) {
+                
+                break;
+            
+            }
+            
+            *(a_heap + i_node) = *(a_heap + i_next);
+        
+        }
+        
+        *(a_heap + i_node) = neighbour;
+        
+        return;
+    
+    }
+    
+    if (_pairwise_neighbour_compare(&neighbour, a_heap) >= 0) {
+        
+        return;
+    
+    }
+    
+    /*
+    *   The neighbour is nearer than the farthest in the full heap, so
+    *   replace the root with it and sift it down past every child farther
+    *   than it.
+    */
+    
+    for (i_node = 0; ; i_node = i_next) {
+        
+        i_next = (2 * i_node) + 1;
+        
+        if (i_next >= n_neighbours) {
+            
+            break;
+        
+        }
+        
+        if (i_next + 1 < n_neighbours
+        &&  _pairwise_neighbour_compare(a_heap + i_next + 1, a_heap + i_next) > 0) {
+            
+            i_next ++;
+        
+        }
+        
+        if (_pairwise_neighbour_compare(a_heap + i_next, &neighbour) <= 0) {
+            
+            break;
+        
+        }
+        
+        *(a_heap + i_node) = *(a_heap + i_next);
+    
+    }
+    
+    *(a_heap + i_node) = neighbour;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_heaps_allocate
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Allocates the heaps of heaps, all empty.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure records and returns
+        PAIRWISE_RETURN_MALLOC_FAIL.
+        
+*******************************************************************************/
+
+static int
+_pairwise_heaps_allocate
+(
+
+    _pairwise_heaps_t* heaps
+
+)
+{
+
+    heaps->a_neighbours = malloc(heaps->n_collections * heaps->n_neighbours * sizeof(_pairwise_neighbour_t));
+    heaps->a_fills = calloc(heaps->n_collections, sizeof(size_t));
+    
+    if (!heaps->a_neighbours || !heaps->a_fills) {
+        
+        free(heaps->a_neighbours);
+        free(heaps->a_fills);
+        
+        heaps->a_neighbours = NULL;
+        heaps->a_fills = NULL;
+        
+        heaps->n_return = PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    return heaps->n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_row_knn
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Row driver for job->f_row. Carries out the pairwise calculations
+        between collection i_collection_a of job and each of collections
+        i_collection_b_lower up to but excluding i_collection_b_upper, by
+        calling job->f_calculation on doubles, and offers each result to the
+        heaps of both of its collections in sink, a _pairwise_heaps_t.
+        a_results_row is ignored.
+        
+        On success returns nothing. On failure to allocate the heaps of sink,
+        records PAIRWISE_RETURN_MALLOC_FAIL in it.
+        
+    Further Information:
+    
+        Each pairwise calculation is carried out only once, for the upper
+        triangle, but its result is a candidate neighbour of both of its
+        collections, so it is offered to both heaps.
+        
+*******************************************************************************/
+
+void
+_pairwise_launch_row_knn
+(
+
+    _pairwise_job_t* job,
+    
+    void* sink,
+    
+    size_t i_collection_a,
+    size_t i_collection_b_lower,
+    size_t i_collection_b_upper,
+    
+    void* a_results_row
+
+)
+{
+
+    double (*f_calculation)(size_t n_points,
+                            size_t n_coordinates,
+                            double* collection_a,
+                            double* collection_b);
+                            
+    _pairwise_heaps_t* heaps;
+    
+    double* a_collections;
+    double* a_collections_b;
+    
+    double* collection_a;
+    double* collection_b;
+    
+    double result;
+    
+    size_t n_points;
+    size_t n_coordinates;
+    
+    size_t i_collection_b;
+    
+    heaps = sink;
+    
+    if (heaps->n_return || !heaps->n_neighbours) {
+        
+        return;
+    
+    }
+    
+    if (!heaps->a_neighbours && _pairwise_heaps_allocate(heaps)) {
+        
+        return;
+    
+    }
+    
+    f_calculation = job->f_calculation;
+    
+    a_collections = job->a_collections;
+    a_collections_b = job->a_collections_b;
+    
+    n_points = job->n_points;
+    n_coordinates = job->n_coordinates;
+    
+    collection_a = a_collections + (i_collection_a * n_points * n_coordinates);
+    
+    for (i_collection_b = i_collection_b_lower;
+         i_collection_b < i_collection_b_upper;
+         i_collection_b ++) {
+             
+        collection_b = a_collections_b + (i_collection_b * n_points * n_coordinates);
+        
+        result = f_calculation(n_points, n_coordinates, collection_a, collection_b);
+        
+        _pairwise_heaps_offer(heaps, i_collection_a, i_collection_b, result);
+        _pairwise_heaps_offer(heaps, i_collection_b, i_collection_a, result);
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_row_knn_float
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch_row_knn(), but calling job->f_calculation_float
+        on floats.
+        
+*******************************************************************************/
+
+void
+_pairwise_launch_row_knn_float
+(
+
+    _pairwise_job_t* job,
+    
+    void* sink,
+    
+    size_t i_collection_a,
+    size_t i_collection_b_lower,
+    size_t i_collection_b_upper,
+    
+    void* a_results_row
+
+)
+{
+
+    float (*f_calculation)(size_t n_points,
+                           size_t n_coordinates,
+                           float* collection_a,
+                           float* collection_b);
+                           
+    _pairwise_heaps_t* heaps;
+    
+    float* a_collections;
+    float* a_collections_b;
+    
+    float* collection_a;
+    float* collection_b;
+    
+    float result;
+    
+    size_t n_points;
+    size_t n_coordinates;
+    
+    size_t i_collection_b;
+    
+    heaps = sink;
+    
+    if (heaps->n_return || !heaps->n_neighbours) {
+        
+        return;
+    
+    }
+    
+    if (!heaps->a_neighbours && _pairwise_heaps_allocate(heaps)) {
+        
+        return;
+    
+    }
+    
+    f_calculation = job->f_calculation_float;
+    
+    a_collections = job->a_collections;
+    a_collections_b = job->a_collections_b;
+    
+    n_points = job->n_points;
+    n_coordinates = job->n_coordinates;
+    
+    collection_a = a_collections + (i_collection_a * n_points * n_coordinates);
+    
+    for (i_collection_b = i_collection_b_lower;
+         i_collection_b < i_collection_b_upper;
+         i_collection_b ++) {
+             
+        collection_b = a_collections_b + (i_collection_b * n_points * n_coordinates);
+        
+        result = f_calculation(n_points, n_coordinates, collection_a, collection_b);
+        
+        _pairwise_heaps_offer(heaps, i_collection_a, i_collection_b, result);
+        _pairwise_heaps_offer(heaps, i_collection_b, i_collection_a, result);
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_knn_job
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Carries out every pairwise calculation described by job, whose
+        calculation, k-nearest-neighbour row driver, input array, element
+        size and dimensions must already be set, over n_threads threads, and
+        gathers the nearest n_neighbours neighbours of every collection into
+        a_indices and a_results as described for _pairwise_launch_knn().
+        Results are stored in a_results as elements of job->s_element bytes.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+    Further Information:
+    
+        Every thread keeps heaps of its own for every collection, so threads
+        never wait on one another, and memory grows with n_threads *
+        n_collections * n_neighbours rather than with the number of pairwise
+        calculations. A collection's nearest neighbours overall are each
+        among the nearest of some thread, so once every chunk is done, the
+        heaps of all threads are merged collection by collection and sorted,
+        and the nearest n_neighbours kept.
+        
+*******************************************************************************/
+
+static int
+_pairwise_launch_knn_job
+(
+
+    _pairwise_job_t* job,
+    
+    size_t n_neighbours,
+    
+    size_t* a_indices,
+    void* a_results,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    _pairwise_heaps_t* a_sinks;
+    _pairwise_heaps_t* heaps;
+    
+    _pairwise_neighbour_t* a_candidates;
+    _pairwise_neighbour_t* neighbour;
+    
+    size_t n_collections;
+    size_t n_sinks;
+    size_t n_candidates;
+    size_t n_fill;
+    
+    size_t i_sink;
+    size_t i_collection;
+    size_t i_neighbour;
+    size_t i_result;
+    
+    n_collections = job->n_collections;
+    
+    if (n_neighbours && n_neighbours >= n_collections) {
+        
+        return PAIRWISE_RETURN_ERROR_NNEIGHBOURS;
+    
+    }
+    
+    /*
+    *   Give every thread a sink of its own. (A request for zero threads is
+    *   refused by _pairwise_launch_job(), but still needs a sink here.)
+    */
+    
+    n_sinks = n_threads ? n_threads : 1;
+    
+    a_sinks = calloc(n_sinks, sizeof(_pairwise_heaps_t));
+    
+    if (!a_sinks) {
+        
+        return PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    for (i_sink = 0; i_sink < n_sinks; i_sink ++) {
+        
+        (a_sinks + i_sink)->n_collections = n_collections;
+        (a_sinks + i_sink)->n_neighbours = n_neighbours;
+    
+    }
+    
+    job->a_results = NULL;
+    
+    job->a_sinks = a_sinks;
+    job->s_sink = sizeof(_pairwise_heaps_t);
+    
+    job->cutoff = 0;
+    
+    job->b_cross = 0;
+    job->b_append = 0;
+    
+    n_return = _pairwise_launch_job(job, n_threads);
+    
+    for (i_sink = 0; i_sink < n_sinks && !n_return; i_sink ++) {
+        
+        n_return = (a_sinks + i_sink)->n_return;
+    
+    }
+    
+    a_candidates = NULL;
+    
+    if (!n_return && n_neighbours) {
+        
+        a_candidates = malloc(n_sinks * n_neighbours * sizeof(_pairwise_neighbour_t));
+        
+        if (!a_candidates) {
+            
+            n_return = PAIRWISE_RETURN_MALLOC_FAIL;
+        
+        }
+    
+    }
+    
+    /*
+    *   Merge the heaps of every thread collection by collection, sort the
+    *   candidates from nearest to farthest, and keep the nearest.
+    */
+    
+    for (i_collection = 0;
+         i_collection < n_collections && n_neighbours && !n_return;
+         i_collection ++) {
+             
+        n_candidates = 0;
+        
+        for (i_sink = 0; i_sink < n_sinks; i_sink ++) {
+            
+            heaps = a_sinks + i_sink;
+            
+            if (!heaps->a_neighbours) {
+                
+                continue;
+            
+            }
+            
+            n_fill = *(heaps->a_fills + i_collection);
+            
+            for (i_neighbour = 0; i_neighbour < n_fill; i_neighbour ++) {
+                
+                *(a_candidates + (n_candidates ++)) = *(heaps->a_neighbours + (i_collection * n_neighbours) + i_neighbour);
+            
+            }
+        
+        }
+        
+        qsort(a_candidates,
+              n_candidates,
+              sizeof(_pairwise_neighbour_t),
+              _pairwise_neighbour_compare);
+              
+        for (i_neighbour = 0; i_neighbour < n_neighbours; i_neighbour ++) {
+            
+            neighbour = a_candidates + i_neighbour;
+            
+            i_result = (i_collection * n_neighbours) + i_neighbour;
+            
+            *(a_indices + i_result) = neighbour->i_collection;
+            
+            if (job->s_element == sizeof(float)) {
+                
+                *((float*)a_results + i_result) = neighbour->result;
+            
+            } else {
+                
+                *((double*)a_results + i_result) = neighbour->result;
+            
+            }
+        
+        }
+    
+    }
+    
+    for (i_sink = 0; i_sink < n_sinks; i_sink ++) {
+        
+        free((a_sinks + i_sink)->a_neighbours);
+        free((a_sinks + i_sink)->a_fills);
+    
+    }
+    
+    free(a_sinks);
+    free(a_candidates);
+    
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_knn
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Applies a calculation function, f_calculation, to all pairwise
+        combinations of collections in a set of collections, a_collections,
+        as _pairwise_launch() does, but keeps for each collection only the
+        n_neighbours other collections with the smallest results.
+        
+        n_collections, n_points, n_coordinates, a_collections and n_threads
+        are as for _pairwise_launch(). n_neighbours must be less than
+        n_collections, unless it is zero. a_indices and a_results must each
+        have room for n_collections * n_neighbours elements.
+        
+        For each collection i, elements i * n_neighbours up to but excluding
+        (i + 1) * n_neighbours of a_indices hold its nearest n_neighbours
+        collections, nearest first, and the same elements of a_results hold
+        the results of f_calculation on i and each of them. Equal results are
+        ordered by collection, so the output does not depend on n_threads.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code,
+        and makes no guarantee about the state of a_indices or a_results.
+        
+    Further Information:
+    
+        This function describes the calculation in a _pairwise_job_t with
+        the row driver _pairwise_launch_row_knn(), and passes it to
+        _pairwise_launch_knn_job().
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_knn
+(
+
+    double (*f_calculation)(size_t n_points,
+                            size_t n_coordinates,
+                            double* collection_a,
+                            double* collection_b),
+                            
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    
+    size_t n_neighbours,
+    
+    size_t* a_indices,
+    double* a_results,
+    
+    size_t n_threads
+
+)
+{
+
+    _pairwise_job_t job;
+    
+    job.f_calculation = f_calculation;
+    job.f_calculation_float = NULL;
+    job.f_row = _pairwise_launch_row_knn;
+    
+    job.a_collections = a_collections;
+    
+    job.s_element = sizeof(double);
+    
+    job.n_collections = n_collections;
+    job.n_points = n_points;
+    job.n_coordinates = n_coordinates;
+    
+    return _pairwise_launch_knn_job(&job,
+                                    n_neighbours,
+                                    a_indices,
+                                    a_results,
+                                    n_threads);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_knn_float
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch_knn(), but for a calculation on collections of
+        floats, f_calculation, whose kept results are stored as floats.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_knn_float
+(
+
+    float (*f_calculation)(size_t n_points,
+                           size_t n_coordinates,
+                           float* collection_a,
+                           float* collection_b),
+                           
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    
+    size_t n_neighbours,
+    
+    size_t* a_indices,
+    float* a_results,
+    
+    size_t n_threads
+
+)
+{
+
+    _pairwise_job_t job;
+    
+    job.f_calculation = NULL;
+    job.f_calculation_float = f_calculation;
+    job.f_row = _pairwise_launch_row_knn_float;
+    
+    job.a_collections = a_collections;
+    
+    job.s_element = sizeof(float);
+    
+    job.n_collections = n_collections;
+    job.n_points = n_points;
+    job.n_coordinates = n_coordinates;
+    
+    return _pairwise_launch_knn_job(&job,
+                                    n_neighbours,
+                                    a_indices,
+                                    a_results,
+                                    n_threads);
+
+}
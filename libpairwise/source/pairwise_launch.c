@@ -1,265 +1,239 @@
+#include <string.h>
+#include <sys/mman.h>
+
 #include "pairwise_launch.h"
 
 /*******************************************************************************
 
-    Symbol: _pairwise_populate_argument_sets
+    Symbol: _pairwise_populate_chunks
     
-    Type: Function returning void
+    Type: Function returning int
     
     Intent: Private
     
     Description:
     
-        Initialises an array of _pairwise_as_t, a_argument_sets, according to
-        parameters specified by the caller. Each initialised _pairwise_as_t
-        can then be passed to _pairwise_launch_bounded() to carry out a
-        specific subset of all pairwise calculations to be done. Multiple such
-        calls to _pairwise_launch_bounded(), each parameterised by a different
-        _pairwise_as_t in an initialised a_argument_sets, can be made by
-        multiple threads running in parallel; this is the libpairwise
-        parallelisation strategy.
-        
-        f_calculation is a pointer to a function representing a single round of
-        the pairwise calculations to be done. n_collections is the number of
-        collections in a_collections, n_points is the number of points per
-        collection, and n_coordinates is the number of coordinates per point.
-        a_collections is a pointer to an input array containing a set of
-        collections, a_results is a pointer to an output array of sufficient
-        size to store the results of all pairwise calculations. n_argument_sets
-        is the number of _pairwise_as_t in a_argument_sets, and a_argument_sets
-        is a pointer to the array of _pairwise_as_t to be initialised.
-        
-        Changes only a_argument_sets. The caller is responsible for ensuring
-        that a_collections has the expected form (see the prologue comment for
-        pairwise_rmsds()), and that a_results is large enough to store
-        0.5 * n_collections * (n_collections - 1) doubles.
+        Cuts the pairwise calculations to be done by job into square tiles,
+        aiming for about n_chunks_target tiles, but making them smaller if
+        needed for the collections each reads to stay in cache. Stores the
+        tile layout in job, allocating job->a_tile_offsets, the
+        responsibility to free which is passed on to the caller. If
+        job->b_cross is set, cuts the rectangle of calculations between
+        job->a_collections and job->a_collections_b instead of the triangle.
         
-        On success returns nothing. Not expected to fail.
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
         
     Further Information:
     
-        This function determines the fairest division of the pairwise
-        calculations to be done across the requested number of threads to be
-        run in parallel, n_threads. For each such subset of these calculations,
-        this function determines i_collection_lower and i_collection_upper,
-        the lower- and upper-bound indices, respectively, into a_collections,
-        an input array containing a set of collections over which to do these
-        calculations. It also determines i_results_offset, the corresponding
-        lower-bound index into a_results, the output array in which the results
-        of these calculations will be stored.
-    
-        In this way, each instance of _pairwise_launch_bounded() parameterised
-        by a different _pairwise_as_t in an initialised a_argument_sets
-        works on a different subset of pairs of collections in a_collections,
-        and then populates with the results of the corresponding subset of the
-        pairwise calculations to be done the appropriate section of a_results.
-        Sections of a_results are chosen such that they are contiguous and non-
-        overlapping. Thus, in making all calls to _pairwise_launch_bounded() as
-        determined by a_argument_sets after initialisation by this function, it
-        is guaranteed that a_results will be fully and correctly populated with
-        the results of all the pairwise calculations to be done.
+        Pairwise calculations are carried out in the order,
+        
+            1_to_2, 1_to_3, ..., 1_to_N,
+                    2_to_3, ..., 2_to_N,
+                            ..., ...,
+                            ..., (N - 1)_to_N
+                            
+        where i_to_j represents the calculation done on the pair of
+        collections i and j. Throughout libpairwise, sets of pairwise
+        calculations are indexed according to the index of the first
+        collection - that is, collection i in i_to_j notation.
+        
+        Walking a whole row i against every j > i reads every later
+        collection once per row. Once the input set no longer fits in cache,
+        each of those reads comes from main memory. A tile instead pairs one
+        block of rows with one block of columns, so that while it is carried
+        out only the two blocks need be in cache, and each collection is read
+        from main memory about once per tile rather than once per row. This
+        matters most for pairwise_rmsds() over large collections.
+        
+        The tile side is the smallest of: the number of collections of which
+        two blocks fit in the level 2 cache; the side which gives about
+        n_chunks_target tiles (but no shorter than
+        _PAIRWISE_TILE_MIN_COLLECTIONS); and the number of collections. Tiles
+        on the diagonal hold only the pairwise calculations above it, and
+        tiles in the last row and column of tiles may be narrower than the
+        rest, so tiles are not all of equal cost; stealing evens this out.
+        
+        A rectangle has no diagonal, so all of its tiles but those in the
+        last row and column are full, and its tile side is chosen from its
+        area rather than from the side of a triangle.
         
 *******************************************************************************/
 
-void
-_pairwise_populate_argument_sets
+int
+_pairwise_populate_chunks
 (
 
-    /*
-    *   A pointer to the function representing the calculation to be carried
-    *   out across all pairs of collections in a_collections. n_points is the
-    *   number of points per collection, n_coordinates is the number of
-    *   coordinates per point, and collection_a and collection_b are pointers
-    *   to the pair of collections involved in this calculation.
-    */
-    
-    double (*f_calculation)(size_t n_points,
-                            size_t n_coordinates,
-                            double* collection_a,
-                            double* collection_b),
+    _pairwise_job_t* job,
     
-    size_t n_collections,
-    size_t n_points,
-    size_t n_coordinates,
+    size_t n_chunks_target
 
-    double* a_collections,
-    double* a_results,
-    
-    size_t n_argument_sets,
-    _pairwise_as_t* a_argument_sets
-    
 )
 {
+
+    static long s_cache = 0;
     
-    size_t i_argument_set;
-    
-    size_t i_collection_lower;
-    size_t i_collection_upper;
-    size_t i_collection_delta;
+    size_t n_collections;
+    size_t n_collections_b;
+    size_t n_collections_max;
     
-    size_t i_results_offset;
+    size_t n_tile_collections;
+    size_t n_tile_collections_cache;
+    size_t n_tile_blocks;
+    size_t n_tile_blocks_b;
+    size_t n_tile_blocks_target;
     
-    double n_calculations_per_argument_set;
-    double n_collections_remaining;
-    double n_collections_used;
+    size_t s_collection;
     
-    /*
-    *   Calculate the ideal number of calculations to be carried out by each
-    *   call to _pairwise_launch_bounded().
-    */
+    size_t i_block;
     
-    n_calculations_per_argument_set = (0.5 * n_collections * (n_collections - 1)) / n_argument_sets;
+    n_collections = job->n_collections;
+    n_collections_b = job->n_collections_b;
     
-    i_collection_upper = 0;
+    n_collections_max = n_collections > n_collections_b ? n_collections : n_collections_b;
     
-    n_collections_remaining = n_collections;
+    s_collection = job->n_points * job->n_coordinates * sizeof(double);
     
     /*
-    *   Populate each _pairwise_as_t in a_argument_sets appropriately.
+    *   Look up the size of the level 2 cache once. (Concurrent first calls
+    *   may each look it up, but will all find the same value.)
     */
     
-    for (i_argument_set = 0; i_argument_set < n_argument_sets; i_argument_set ++) {
+    if (!__atomic_load_n(&s_cache, __ATOMIC_RELAXED)) {
     
-        if (!i_argument_set) {
-        
-            /*
-            *   For the first _pairwise_as_t read from the beginning of the
-            *   input data array and correspondingly write to the beginning of
-            *   the output data array.
-            */
-        
-            i_results_offset = 0;
-            
-            i_collection_lower = 0;
-        
-        } else {
+        #if defined(_SC_LEVEL2_CACHE_SIZE)
+        long s_cache_found = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        #else
+        long s_cache_found = 0;
+        #endif
         
-            /*
-            *   For subsequent _pairwise_as_t read from where in the input data
-            *   array the last _pairwise_as_t left off. Write to the output
-            *   data array at the corresponding offset, given the expression
-            *   appropriate to a set of pairwise calculations carried out in
-            *   the order,
-            *   
-            *       1_to_2, 1_to_3, ..., 1_to_N,
-            *               2_to_3, ..., 2_to_N,
-            *                       ..., ...,
-            *                       ..., (N - 1)_to_N
-            *   
-            *   where i_to_j represents the calculation done on the pair of
-            *   collections i and j.
-            *   
-            *   Throughout libpairwise, sets of pairwise calculations are
-            *   indexed according to the index of the first collection - that
-            *   is, collection i in i_to_j notation, considered by any one
-            *   given pairwise calculation. Thus, for example, lower- and
-            *   upper-bounds of i = 5 and i = 7 correspond to the set of
-            *   pairwise calculations,
-            *   
-            *       5_to_6, 5_to_7, 5_to_8, ..., 5_to_N,
-            *               6_to_7, 6_to_8, ..., 6_to_N,
-            *                       7_to_8, ..., 7_to_N
-            *  
-            *   such that any given pairwise calculation i_to_j, assumed to
-            *   yield an equivalent result to that j_to_i, is carried out
-            *   exactly once.
-            *   
-            *   In this way, for fair distribution of pairwise calculations
-            *   across calls to _pairwise_launch_bounded(), the difference
-            *   between the upper- and lower-indices into the input data array,
-            *   i_collection_delta, grows quadratically with i_argument_set,
-            *   the index into the array of _pairwise_as_t.
-            */
-        
-            i_collection_delta = i_collection_upper - i_collection_lower;
-        
-            i_results_offset += 0.5 * i_collection_delta * ((2 * (n_collections - i_collection_lower)) - i_collection_delta - 1);
+        if (s_cache_found <= 0) {
             
-            i_collection_lower = i_collection_upper;
+            s_cache_found = _PAIRWISE_TILE_CACHE_BYTES;
         
         }
         
-        /*
-        *   Calculate the number of first collections - that is, collections i
-        *   in i_to_j notation as follows the pairwise calculation series
-        *   defined above - that have already been assigned to _pairwise_as_t,
-        *   n_collections_used, and thus those that remain to be assigned,
-        *   n_collections_remaining.
-        *   
-        *   Note that the result of n_collections_used is not likely to be an
-        *   integer; given that this result is found in terms of first
-        *   collection index - that is, in terms of i in i_to_j notation -, it
-        *   is not guaranteed that there exists an integer solution for an
-        *   arbitrary number of divisions of pairwise calculations - that is,
-        *   for arbitrary n_argument_sets. Yet we require integer solutions so
-        *   that they may be used to form indices into the input data array.
-        *   
-        *   The strategy here is to round down n_collections_used to an integer
-        *   for all _pairwise_as_t except the last. (Rounding down is implicit
-        *   in the assignment of a double to a size_t.) For the last
-        *   _pairwise_as_t we instead round up to n_collections, the number of
-        *   input collections across which to carry out pairwise calculations.
-        *   This ensures that all pairwise calculations are assigned to one of
-        *   the available _pairwise_as_t.
-        *   
-        *   The practical consequence of this strategy is that the call to
-        *   _pairwise_launch_bounded() parameterised by the last _pairwise_as_t
-        *   in a_argument_sets will usually have to carry out a slightly larger
-        *   number of pairwise calculations than the other calls. However, this
-        *   excess will be very small compared with the number of pairwise
-        *   calculations to the carried out by the other calls for any total
-        *   number of pairwise calculations for which this parallelisation
-        *   strategy provides a speed-up, and only becomes comparatively
-        *   smaller with increasing total number of pairwise calculations.
-        *   
-        *   We can go some way to compensating for this small imbalance by
-        *   launching threads which call _pairwise_launch_bounded() in an order
-        *   reversed compared to that of _pairwise_as_t in a_argument_sets.
-        *   (Note that, while libpairwise threads can indeed run in parallel,
-        *   they must be launched sequentially by the parent thread.)
-        */
+        __atomic_store_n(&s_cache, s_cache_found, __ATOMIC_RELAXED);
+    
+    }
+    
+    n_tile_collections_cache = (__atomic_load_n(&s_cache, __ATOMIC_RELAXED) / 2) / s_collection;
+    
+    /*
+    *   A triangle of tiles n_tile_blocks to a side holds
+    *   0.5 * n_tile_blocks * (n_tile_blocks + 1) tiles, so about
+    *   sqrt(2 * n_chunks_target) blocks give n_chunks_target tiles.
+    */
+    
+    n_tile_blocks_target = sqrt(2.0 * n_chunks_target);
+    
+    if (!n_tile_blocks_target) {
         
-        n_collections_used = 0.5 * (-sqrt((-8 * n_calculations_per_argument_set) + (4 * _PAIRWISE_SQUARE(n_collections_remaining))
-                             - (4 * n_collections_remaining) +  1) + (2 * n_collections_remaining) - 1);
+        n_tile_blocks_target = 1;
+    
+    }
+    
+    n_tile_collections = (n_collections + n_tile_blocks_target - 1) / n_tile_blocks_target;
+    
+    /*
+    *   A rectangle of tiles n_tile_collections to a side instead holds about
+    *   n_collections * n_collections_b / (n_tile_collections ^ 2) tiles.
+    */
+    
+    if (job->b_cross) {
         
-        n_collections_remaining -= n_collections_used;
+        n_tile_collections = ceil(sqrt(((double)n_collections * n_collections_b) / n_chunks_target));
+    
+    }
+    
+    if (n_tile_collections < _PAIRWISE_TILE_MIN_COLLECTIONS) {
         
-        if (i_argument_set == (n_argument_sets - 1)) {
+        n_tile_collections = _PAIRWISE_TILE_MIN_COLLECTIONS;
+    
+    }
+    
+    if (n_tile_collections > n_tile_collections_cache) {
         
-            i_collection_upper = n_collections;
+        n_tile_collections = n_tile_collections_cache;
+    
+    }
+    
+    if (n_tile_collections > n_collections_max) {
         
-        } else {
+        n_tile_collections = n_collections_max;
+    
+    }
+    
+    if (!n_tile_collections) {
         
-            i_collection_upper += n_collections_used;
+        n_tile_collections = 1;
+    
+    }
+    
+    n_tile_blocks = (n_collections + n_tile_collections - 1) / n_tile_collections;
+    n_tile_blocks_b = (n_collections_b + n_tile_collections - 1) / n_tile_collections;
+    
+    /*
+    *   Chunk indices must fit in half of the 64-bit word in which
+    *   _pairwise_as_t packs each share, which allows up to 92681 blocks a
+    *   side of a triangle, or 65535 a side of a rectangle. Widen tiles beyond
+    *   what fits in cache if need be.
+    */
+    
+    if (!job->b_cross && n_tile_blocks > 92681) {
         
-        }
+        n_tile_collections = (n_collections + 92680) / 92681;
         
-        /*
-        *   Populate this _pairwise_as_t with the calculated parameters. Note
-        *   that a number of parameters are constant across all _pairwise_as_t
-        *   belonging to the same a_argument_sets; these are f_calculation,
-        *   a_collections, n_collections, n_points and n_coordinates.
-        */
+        n_tile_blocks = (n_collections + n_tile_collections - 1) / n_tile_collections;
+        n_tile_blocks_b = n_tile_blocks;
+    
+    }
+    
+    if (job->b_cross && (n_tile_blocks > 65535 || n_tile_blocks_b > 65535)) {
         
-        (a_argument_sets + i_argument_set)->f_calculation = f_calculation;
+        n_tile_collections = (n_collections_max + 65534) / 65535;
         
-        (a_argument_sets + i_argument_set)->a_collections = a_collections;
-        (a_argument_sets + i_argument_set)->a_results = a_results + i_results_offset;
+        n_tile_blocks = (n_collections + n_tile_collections - 1) / n_tile_collections;
+        n_tile_blocks_b = (n_collections_b + n_tile_collections - 1) / n_tile_collections;
+    
+    }
+    
+    job->a_tile_offsets = malloc((n_tile_blocks + 1) * sizeof(size_t));
+    
+    if (!job->a_tile_offsets) {
         
-        (a_argument_sets + i_argument_set)->n_collections = n_collections;
-        (a_argument_sets + i_argument_set)->n_points = n_points;
-        (a_argument_sets + i_argument_set)->n_coordinates = n_coordinates;
+        return PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    /*
+    *   Row of tiles i_block holds n_tile_blocks - i_block tiles, from the
+    *   diagonal to the last column of tiles; or, for a rectangle, a tile for
+    *   every one of the n_tile_blocks_b columns of tiles.
+    */
+    
+    *(job->a_tile_offsets) = 0;
+    
+    for (i_block = 0; i_block < n_tile_blocks; i_block ++) {
         
-        (a_argument_sets + i_argument_set)->i_collection_lower = i_collection_lower;
-        (a_argument_sets + i_argument_set)->i_collection_upper = i_collection_upper;
+        *(job->a_tile_offsets + i_block + 1) = *(job->a_tile_offsets + i_block)
+                                             + (job->b_cross ? n_tile_blocks_b : n_tile_blocks - i_block);
     
     }
+    
+    job->n_tile_collections = n_tile_collections;
+    job->n_tile_blocks = n_tile_blocks;
+    job->n_tile_blocks_b = n_tile_blocks_b;
+    
+    job->n_chunks = *(job->a_tile_offsets + n_tile_blocks);
+    
+    return PAIRWISE_RETURN_SUCCESS;
 
 }
 
 /*******************************************************************************
 
-    Symbol: _pairwise_launch_bounded
+    Symbol: _pairwise_populate_argument_sets
     
     Type: Function returning void
     
@@ -267,385 +241,2030 @@ _pairwise_populate_argument_sets
     
     Description:
     
-        Carries out a subset of all the pairwise calculations to be done which
-        is parameterised by an initialised _pairwise_as_t, argument_set.
+        Initialises an array of _pairwise_as_t, a_argument_sets, according to
+        the chunks of an initialised _pairwise_job_t, job. Each initialised
+        _pairwise_as_t can then be passed to _pairwise_launch_bounded() to
+        carry out pairwise calculations chunk by chunk, starting with its own
+        share of the chunks and then stealing chunks from the other
+        _pairwise_as_t. Multiple such calls to _pairwise_launch_bounded(), each
+        parameterised by a different _pairwise_as_t in an initialised
+        a_argument_sets, can be made by multiple threads running in parallel;
+        this is the libpairwise parallelisation strategy.
+        
+        n_argument_sets is the number of _pairwise_as_t in a_argument_sets,
+        and a_argument_sets is a pointer to the array of _pairwise_as_t to be
+        initialised. Also records both in job.
         
         On success returns nothing. Not expected to fail.
         
     Further Information:
     
-        It is expected that multiple calls to this function will be made by
-        multiple threads running is parallel, as per the libpairwise
-        parallelisation strategy.
+        Each _pairwise_as_t starts with an equal, contiguous share of the
+        chunk indices of job. Since chunks hold roughly equal numbers of
+        pairwise calculations, on an idle host with equally fast cores every
+        thread finishes its own share at about the same time, and no chunk
+        changes hands. Otherwise threads which finish early steal chunks from
+        the back of the shares of slower threads, so that the calculation as
+        a whole finishes at most about one chunk after its last thread runs
+        out of work.
+        
+        Since tiles are numbered row by row, contiguous shares also keep each
+        thread writing to nearby sections of a_results, and reading the same
+        blocks of collections, for as long as it isn't stealing.
         
 *******************************************************************************/
 
 void
-_pairwise_launch_bounded
+_pairwise_populate_argument_sets
 (
+
+    _pairwise_job_t* job,
     
-    _pairwise_as_t* argument_set
+    size_t n_argument_sets,
+    _pairwise_as_t* a_argument_sets
 
 )
 {
 
-    register double (*f_calculation)(size_t n_points,
-                                     size_t n_coordinates,
-                                     double* collection_a,
-                                     double* collection_b);
+    size_t i_argument_set;
     
-    register double* a_collections;
-    register double* a_results;
+    uint64_t i_chunk_lower;
+    uint64_t i_chunk_upper;
+    
+    job->n_argument_sets = n_argument_sets;
+    job->a_argument_sets = a_argument_sets;
+    
+    for (i_argument_set = 0; i_argument_set < n_argument_sets; i_argument_set ++) {
+        
+        i_chunk_lower = (i_argument_set * job->n_chunks) / n_argument_sets;
+        i_chunk_upper = ((i_argument_set + 1) * job->n_chunks) / n_argument_sets;
+        
+        (a_argument_sets + i_argument_set)->job = job;
+        
+        (a_argument_sets + i_argument_set)->chunks = i_chunk_lower | (i_chunk_upper << 32);
+        (a_argument_sets + i_argument_set)->n_pairs = 0;
+        
+        (a_argument_sets + i_argument_set)->t_start = 0;
+        (a_argument_sets + i_argument_set)->t_end = 0;
+    
+    }
 
-    register size_t n_collections;
-    register size_t n_points;
-    register size_t n_coordinates;
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_claim_chunk
     
-    register size_t i_collection_lower;
-    register size_t i_collection_upper;
+    Type: Function returning int
     
-    register size_t i_collection_a;
-    register size_t i_collection_b;
+    Intent: Private
     
-    register double* collection_a;
-    register double* collection_b;
+    Description:
     
-    /*
-    *   Extract parameters from argument_set on the heap and place them on the
-    *   stack for faster access.
-    */
+        Atomically claims one unclaimed chunk from the share of argument_set:
+        the first if steal is zero, as the owning thread does, or the last
+        otherwise, as any other thread does. Stores the index of the claimed
+        chunk in i_chunk.
+        
+        Returns integer one if a chunk was claimed, or integer zero if none
+        remained in the share of argument_set. Not expected to fail.
+        
+    Further Information:
     
-    f_calculation = argument_set->f_calculation;
+        Both ends of the unclaimed range are packed into the single 64-bit
+        word argument_set->chunks, and every claim is a compare-and-swap on
+        that word, so the owner and any number of thieves can never claim the
+        same chunk, even when only one remains. Since chunks are only ever
+        removed from a share, and never added, a share found empty stays
+        empty.
+        
+*******************************************************************************/
+
+int
+_pairwise_claim_chunk
+(
+
+    _pairwise_as_t* argument_set,
     
-    a_collections = argument_set->a_collections;
-    a_results = argument_set->a_results;
+    int steal,
     
-    n_collections = argument_set->n_collections;
-    n_points = argument_set->n_points;
-    n_coordinates = argument_set->n_coordinates;
+    size_t* i_chunk
+
+)
+{
+
+    uint64_t chunks;
+    uint64_t chunks_claimed;
     
-    i_collection_lower = argument_set->i_collection_lower;
-    i_collection_upper = argument_set->i_collection_upper;
+    uint64_t i_chunk_lower;
+    uint64_t i_chunk_upper;
     
-    /*
-    *   Iterate over a subset of pairs of collections, stored in a_collections
-    *   and delimited by i_collection_lower and i_collection_upper. Indices for
-    *   any given collection pair are i_collection_a and i_collection_b.
-    */
+    chunks = __atomic_load_n(&argument_set->chunks, __ATOMIC_RELAXED);
     
-    for (i_collection_a = i_collection_lower;
-         i_collection_a < i_collection_upper;
-         i_collection_a ++) {
+    do {
         
-        for (i_collection_b = i_collection_a + 1;
-             i_collection_b < n_collections;
-             i_collection_b ++) {
-            
-            /*
-            *   Calculate pointers, collection_a and collection_b, to the
-            *   elements in a_collections at which the present pair of
-            *   collections begin. Note that a_collections has form,
-            *   
-            *   a_collections = [COLLECTION_1], ..., [COLLECTION_P]
-            *   
-            *   [COLLECTION_P] = [POINT_1], ..., [POINT_Q]
-            *   
-            *   [POINT_Q] = [COORDINATE_1], ..., [COORDINATE_R]
-            *   
-            *   where Q and R, given by n_points and n_coordinates
-            *   respectively, are constant across all P collections in
-            *   a_collections.
-            */
-            
-            collection_a = a_collections + (i_collection_a * n_points * n_coordinates);
-            collection_b = a_collections + (i_collection_b * n_points * n_coordinates);
-            
-            /*
-            *   Pass n_points, n_coordinates, collection_a and collection_b to
-            *   the function pointed to by f_calculation and store the result
-            *   in the element to which a_results points. Then advance the
-            *   a_results pointer by one element in preparation for the next
-            *   pairwise calculation.
-            */
-            
-            *(a_results ++) = f_calculation(n_points,
-                                            n_coordinates,
-                                            collection_a,
-                                            collection_b);
+        i_chunk_lower = chunks & 0xFFFFFFFF;
+        i_chunk_upper = chunks >> 32;
+        
+        if (i_chunk_lower >= i_chunk_upper) {
+        
+            return 0;
         
         }
-    
-    }
+        
+        if (steal) {
+        
+            *i_chunk = -- i_chunk_upper;
+        
+        } else {
+        
+            *i_chunk = i_chunk_lower ++;
+        
+        }
+        
+        chunks_claimed = i_chunk_lower | (i_chunk_upper << 32);
+    
+    } while (!__atomic_compare_exchange_n(&argument_set->chunks,
+                                          &chunks,
+                                          chunks_claimed,
+                                          0,
+                                          __ATOMIC_RELAXED,
+                                          __ATOMIC_RELAXED));
+                                          
+    return 1;
 
 }
 
 /*******************************************************************************
 
-    Symbol: _pairwise_launch
+    Symbol: _pairwise_locate_chunk
     
-    Type: Function returning int
+    Type: Function returning void
     
     Intent: Private
     
     Description:
     
-        Coordinates the parallel execution of pairwise calculations to be done
-        distributed fairly across multiple threads.
-        
-        f_calculation is a pointer to a function representing a single round of
-        the pairwise calculations to be done. n_collections is the number of
-        collections in a_collections, n_points is the number of points per
-        collection, and n_coordinates is the number of coordinates per point.
-        a_collections is a pointer to an input array containing a set of
-        collections, a_results is a pointer to an output array of sufficient
-        size to store the results of all pairwise calculations. n_argument_sets
-        is the number of _pairwise_as_t in a_argument_sets, and a_argument_sets
-        is a pointer to the array of _pairwise_as_t to be initialised.
-        
-        The caller is responsible for ensuring that a_collections has the
-        expected form (see the prologue comment for pairwise_rmsds()), and that
-        a_results is large enough to store
-        0.5 * n_collections * (n_collections - 1) doubles.
+        Finds the collections covered by chunk - that is, tile - i_chunk of
+        job: every pairwise calculation whose first collection is one of
+        i_collection_a_lower up to but excluding i_collection_a_upper, and
+        whose second is one of i_collection_b_lower up to but excluding
+        i_collection_b_upper, stored in the four size_t pointed to. On the
+        diagonal of a triangle, only those pairs whose second collection
+        comes after their first belong to the tile.
         
-        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
-        to integer zero. On failure returns a non-zero libpairwise error code,
-        and makes no guarantee about the state a_results, which may or may not
-        have been changed.
+        On success returns nothing. Not expected to fail.
         
     Further Information:
     
-        It is expected that this function will be indirectly called by a public
-        wrapper function that binds it to a specific calculation function.
-        
-        This function allocates memory for an array of pthread_t, a_threads,
-        and for an array of _pairwise_as_t, a_argument_sets. It then calls
-        _pairwise_populate_argument_sets() to initialise a_argument_sets
-        according to its arguments. Thereafter it launches n_threads threads by
-        making sequential calls to pthread_create(), each such thread
-        instructed to call _pairwise_launch_bounded() with parameters stored in
-        one of the initialised _pairwise_as_t in a_argument_sets. This function
-        then waits for all child threads to join by making sequential calls to
-        pthread_join(), by which time all pairwise calculations have been done.
-    
-        This function checks the return codes of all functions it calls for
-        which it makes sense to do so, and will itself return early with an
-        appropriate libpairwise non-zero error code if it detects an error.
-        Before any such early return, all allocated memory is first freed.
+        The row of tiles holding tile i_chunk is found by binary search of
+        the tile offsets of each row, and from that its column of tiles.
         
 *******************************************************************************/
 
-int
-_pairwise_launch
+void
+_pairwise_locate_chunk
 (
 
-    double (*f_calculation)(size_t n_points,
-                            size_t n_coordinates,
-                            double* collection_a,
-                            double* collection_b),
-    
-    size_t n_collections,
-    size_t n_points,
-    size_t n_coordinates,
+    _pairwise_job_t* job,
     
-    double* a_collections,
-    double* a_results,
+    size_t i_chunk,
     
-    size_t n_threads
+    size_t* i_collection_a_lower,
+    size_t* i_collection_a_upper,
+    size_t* i_collection_b_lower,
+    size_t* i_collection_b_upper
 
 )
 {
 
-    int n_return;
+    size_t i_block_a;
+    size_t i_block_b;
     
-    size_t i_thread;
+    size_t i_block_lower;
+    size_t i_block_upper;
+    size_t i_block_middle;
     
-    pthread_t* a_threads;
+    i_block_lower = 0;
+    i_block_upper = job->n_tile_blocks;
     
-    _pairwise_as_t* a_argument_sets;
+    while (i_block_upper - i_block_lower > 1) {
+        
+        i_block_middle = (i_block_lower + i_block_upper) / 2;
+        
+        if (*(job->a_tile_offsets + i_block_middle) <= i_chunk) {
+            
+            i_block_lower = i_block_middle;
+        
+        } else {
+            
+            i_block_upper = i_block_middle;
+        
+        }
     
-    /*
-    *   If the caller specifies fewer than two collections over which to carry
-    *   out pairwise calculations, or that each collection contains no points,
-    *   or that each point contains no coordinates, then the total number of
-    *   pairwise calculations to be carried out is zero, and we can return
-    *   with success without doing anything else.
-    */
+    }
     
-    if (n_collections < 2 || !n_points || !n_coordinates) {
+    i_block_a = i_block_lower;
+    i_block_b = i_chunk - *(job->a_tile_offsets + i_block_a);
     
-        return PAIRWISE_RETURN_SUCCESS;
+    if (!job->b_cross) {
+        
+        i_block_b += i_block_a;
     
     }
     
-    /*
-    *   If the caller specifies that zero threads should be used (and there are
-    *   pairwise calculations to be carried out) then return with an error.
-    */
+    *i_collection_a_lower = i_block_a * job->n_tile_collections;
+    *i_collection_a_upper = *i_collection_a_lower + job->n_tile_collections;
     
-    if (!n_threads) {
+    *i_collection_b_lower = i_block_b * job->n_tile_collections;
+    *i_collection_b_upper = *i_collection_b_lower + job->n_tile_collections;
     
-        return PAIRWISE_RETURN_ERROR_NTHREADS;
+    if (*i_collection_a_upper > job->n_collections) {
+        
+        *i_collection_a_upper = job->n_collections;
     
     }
     
-    a_argument_sets = malloc(n_threads * sizeof(_pairwise_as_t));
-    
-    if (!a_argument_sets) {
+    if (*i_collection_b_upper > job->n_collections_b) {
         
-        return PAIRWISE_RETURN_MALLOC_FAIL;
+        *i_collection_b_upper = job->n_collections_b;
     
     }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_chunk
     
-    /*
-    *   For the special case in which only one thread is requested, forego all
-    *   parallelisation overhead. Manually initialise the single _pairwise_as_t
-    *   in a_argument_sets to parameterise a call to _pairwise_launch_bounded(
-    *   which will carry out all of the pairwise calculationsto be done, and
-    *   then make that call.
-    */
+    Type: Function returning size_t
     
-    if (n_threads == 1) {
+    Intent: Private
     
-        a_argument_sets->f_calculation = f_calculation;
-        
-        a_argument_sets->a_collections = a_collections;
-        a_argument_sets->a_results = a_results;
-        
-        a_argument_sets->n_collections = n_collections;
-        a_argument_sets->n_points = n_points;
-        a_argument_sets->n_coordinates = n_coordinates;
-        
-        a_argument_sets->i_collection_lower = 0;
-        a_argument_sets->i_collection_upper = n_collections;
+    Description:
+    
+        Carries out the pairwise calculations in chunk - that is, tile -
+        i_chunk of job, and stores their results at the appropriate offsets
+        in job->a_results. sink is the calling thread's sink in
+        job->a_sinks, or a null pointer if job has none.
         
-        _pairwise_launch_bounded(a_argument_sets);
+        On success returns the number of pairwise calculations carried out.
+        Not expected to fail.
         
-        free(a_argument_sets);
+    Further Information:
+    
+        The tile is walked row by row, so that the block of second
+        collections is read once per row from cache, while each row's
+        results are written by job->f_row to a contiguous run of a_results.
+        If job->f_tile is set, it is first given the whole tile.
+        The run for row i and second collection j begins at the offset of row
+        i in a_results, that is, the number of pairwise calculations in all i
+        preceding rows, plus j - i - 1.
         
-        return PAIRWISE_RETURN_SUCCESS;
+*******************************************************************************/
+
+size_t
+_pairwise_launch_chunk
+(
+
+    _pairwise_job_t* job,
     
-    }
+    void* sink,
+    
+    size_t i_chunk
+
+)
+{
+
+    size_t n_collections;
+    size_t n_collections_b;
+    size_t n_collections_old;
     
-    _pairwise_populate_argument_sets(f_calculation,
-                                     n_collections,
-                                     n_points,
-                                     n_coordinates,
-                                     a_collections,
-                                     a_results,
-                                     n_threads,
-                                     a_argument_sets);
+    size_t i_collection_a;
+    size_t i_collection_a_lower;
+    size_t i_collection_a_upper;
+    size_t i_collection_b_lower;
+    size_t i_collection_b_upper;
+    size_t i_collection_b_first;
     
-    a_threads = malloc(n_threads * sizeof(pthread_t));
+    size_t i_result;
     
-    if (!a_threads) {
+    size_t n_pairs;
     
-        free(a_argument_sets);
-        
-        return PAIRWISE_RETURN_MALLOC_FAIL;
+    void* a_results_row;
+    
+    n_collections = job->n_collections;
+    n_collections_b = job->n_collections_b;
+    
+    n_pairs = 0;
+    
+    n_collections_old = job->b_append ? n_collections - n_collections_b : 0;
+    
+    _pairwise_locate_chunk(job,
+                           i_chunk,
+                           &i_collection_a_lower,
+                           &i_collection_a_upper,
+                           &i_collection_b_lower,
+                           &i_collection_b_upper);
+    
+    if (job->f_tile) {
         
+        job->f_tile(job,
+                    sink,
+                    i_collection_a_lower,
+                    i_collection_a_upper,
+                    i_collection_b_lower,
+                    i_collection_b_upper);
+    
     }
     
     /*
-    *   Launch a thread for each _pairwise_as_t in a_argument_sets. These
-    *   threads are deliberately launched in reverse order (that is, the thread
-    *   whose call to _pairwise_launch_bounded is parameterised by the last
-    *   element of a_argument_sets is launched first), because distribution of
-    *   pairwise calculations across threads is not usually perfectly fair, and
-    *   the thread parameterised by the last element of a_argument_sets has to
-    *   do a slightly larger number of calculations than the rest.
+    *   Iterate over the rows of this tile, that is, over its first
+    *   collections, i_collection_a.
     */
     
-    for (i_thread = n_threads; i_thread; i_thread --) {
-        
-        n_return = pthread_create(a_threads + i_thread - 1,
-                                  NULL,
-                                  (void*)_pairwise_launch_bounded,
-                                  a_argument_sets + i_thread - 1);
-        
-        if (n_return) {
-        
-            /*
-            *   If any pthread_create() call fails, return early with an
-            *   appropriate error code. Before returning, send cancellation
-            *   requests to all other child threads that may already have been
-            *   launched successfully. We don't want to return leaving behind
-            *   orphaned threads whose references we've freed. Note that
-            *   pthread_cancel() only fails if the requested thread ID is
-            *   invalid. Since we've necessarily already checked that any
-            *   threads whose IDs we're passing to pthread_cancel() were indeed
-            *   successfully launched, there's no need to test the return code
-            *   here.
-            */
-        
-            for (; i_thread < n_threads; i_thread ++) {
+    for (i_collection_a = i_collection_a_lower;
+         i_collection_a < i_collection_a_upper;
+         i_collection_a ++) {
+        
+        /*
+        *   On the diagonal only pairs with i_collection_b > i_collection_a
+        *   belong to this tile.
+        */
+        
+        i_collection_b_first = i_collection_b_lower;
+        
+        if (!job->b_cross && i_collection_b_first <= i_collection_a) {
+            
+            i_collection_b_first = i_collection_a + 1;
+        
+        }
+        
+        /*
+        *   When appending, collection i_collection_b of a_collections_b is
+        *   collection n_collections_old + i_collection_b of a_collections, and
+        *   likewise only pairs beyond the diagonal belong to this tile.
+        */
+        
+        if (job->b_append && n_collections_old + i_collection_b_first <= i_collection_a) {
             
-                pthread_cancel(*(a_threads + i_thread));
+            i_collection_b_first = i_collection_a + 1 - n_collections_old;
+        
+        }
+        
+        if (i_collection_b_first >= i_collection_b_upper) {
             
-            }
+            continue;
+        
+        }
+        
+        /*
+        *   Find the element of a_results in which to store the result of the
+        *   first pair in this row of the tile. (Either i_collection_a or
+        *   2 * n_collections - i_collection_a - 1 is even, so the division is
+        *   exact.) A rectangle of results is simply row-major, and appended
+        *   results lie in the triangle of all n_collections collections.
+        */
         
-            free(a_argument_sets);
-            free(a_threads);
+        if (job->b_append) {
             
-            switch (n_return) {
+            i_result = ((i_collection_a * ((2 * n_collections) - i_collection_a - 1)) / 2)
+                     + (n_collections_old + i_collection_b_first - i_collection_a - 1);
+        
+        } else if (job->b_cross) {
             
-                case EAGAIN: return PAIRWISE_RETURN_PTHREAD_CREATE_EAGAIN;
-                
-                case EINVAL: return PAIRWISE_RETURN_PTHREAD_CREATE_EINVAL;
-                
-                case EPERM: return PAIRWISE_RETURN_PTHREAD_CREATE_EPERM;
-                
-                default: return PAIRWISE_RETURN_PTHREAD_CREATE_UNKNOWN;
+            i_result = (i_collection_a * n_collections_b) + i_collection_b_first;
+        
+        } else {
             
-            }
+            i_result = ((i_collection_a * ((2 * n_collections) - i_collection_a - 1)) / 2)
+                     + (i_collection_b_first - i_collection_a - 1);
+        
+        }
+        
+        a_results_row = NULL;
+        
+        if (job->a_results) {
             
+            a_results_row = (char*)job->a_results + (i_result * job->s_element);
+        
         }
+        
+        job->f_row(job,
+                   sink,
+                   i_collection_a,
+                   i_collection_b_first,
+                   i_collection_b_upper,
+                   a_results_row);
+                   
+        n_pairs += i_collection_b_upper - i_collection_b_first;
+    
+    }
+    
+    return n_pairs;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_row
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Row driver for job->f_row. Carries out the pairwise calculations
+        between collection i_collection_a of job and each of collections
+        i_collection_b_lower up to but excluding i_collection_b_upper, by
+        calling job->f_calculation on doubles, and stores their results
+        consecutively from a_results_row. sink is ignored.
+        
+        On success returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+void
+_pairwise_launch_row
+(
+
+    _pairwise_job_t* job,
+    
+    void* sink,
+    
+    size_t i_collection_a,
+    size_t i_collection_b_lower,
+    size_t i_collection_b_upper,
+    
+    void* a_results_row
+
+)
+{
+
+    register double (*f_calculation)(size_t n_points,
+                                     size_t n_coordinates,
+                                     double* collection_a,
+                                     double* collection_b);
+                                     
+    register double* a_collections;
+    register double* a_collections_b;
+    register double* a_results;
+    
+    register size_t n_points;
+    register size_t n_coordinates;
+    
+    register size_t i_collection_b;
+    
+    register double* collection_a;
+    register double* collection_b;
+    
+    /*
+    *   Extract parameters from job on the heap and place them on the stack
+    *   for faster access.
+    */
+    
+    f_calculation = job->f_calculation;
+    
+    a_collections = job->a_collections;
+    a_collections_b = job->a_collections_b;
+    a_results = a_results_row;
+    
+    n_points = job->n_points;
+    n_coordinates = job->n_coordinates;
+    
+    collection_a = a_collections + (i_collection_a * n_points * n_coordinates);
+    
+    for (i_collection_b = i_collection_b_lower;
+         i_collection_b < i_collection_b_upper;
+         i_collection_b ++) {
+             
+        /*
+        *   Calculate a pointer, collection_b, to the element in
+        *   a_collections_b (a_collections itself, unless job->b_cross is set)
+        *   at which the second collection of the present pair begins. Note
+        *   that a_collections has form,
+        *   
+        *   a_collections = [COLLECTION_1], ..., [COLLECTION_P]
+        *   
+        *   [COLLECTION_P] = [POINT_1], ..., [POINT_Q]
+        *   
+        *   [POINT_Q] = [COORDINATE_1], ..., [COORDINATE_R]
+        *   
+        *   where Q and R, given by n_points and n_coordinates respectively,
+        *   are constant across all P collections in a_collections.
+        */
+        
+        collection_b = a_collections_b + (i_collection_b * n_points * n_coordinates);
+        
+        /*
+        *   Pass n_points, n_coordinates, collection_a and collection_b to the
+        *   function pointed to by f_calculation and store the result in the
+        *   element to which a_results points. Then advance the a_results
+        *   pointer by one element in preparation for the next pairwise
+        *   calculation.
+        */
+        
+        *(a_results ++) = f_calculation(n_points,
+                                        n_coordinates,
+                                        collection_a,
+                                        collection_b);
     
     }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_row_float
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Row driver for job->f_row. Carries out the pairwise calculations
+        between collection i_collection_a of job and each of collections
+        i_collection_b_lower up to but excluding i_collection_b_upper, by
+        calling job->f_calculation_float on floats, and stores their
+        results consecutively from a_results_row. sink is ignored.
+        
+        On success returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+void
+_pairwise_launch_row_float
+(
+
+    _pairwise_job_t* job,
+    
+    void* sink,
+    
+    size_t i_collection_a,
+    size_t i_collection_b_lower,
+    size_t i_collection_b_upper,
+    
+    void* a_results_row
+
+)
+{
+
+    register float (*f_calculation)(size_t n_points,
+                                    size_t n_coordinates,
+                                    float* collection_a,
+                                    float* collection_b);
+                                    
+    register float* a_collections;
+    register float* a_collections_b;
+    register float* a_results;
+    
+    register size_t n_points;
+    register size_t n_coordinates;
+    
+    register size_t i_collection_b;
+    
+    register float* collection_a;
+    register float* collection_b;
     
     /*
-    *   Wait for each launched thread to finish, also in reverse order to
-    *   complement the order in which they were launched.
+    *   Extract parameters from job on the heap and place them on the stack
+    *   for faster access.
     */
     
-    for (i_thread = n_threads; i_thread; i_thread --) {
+    f_calculation = job->f_calculation_float;
+    
+    a_collections = job->a_collections;
+    a_collections_b = job->a_collections_b;
+    a_results = a_results_row;
     
-        n_return = pthread_join(*(a_threads + i_thread - 1), NULL);
+    n_points = job->n_points;
+    n_coordinates = job->n_coordinates;
+    
+    collection_a = a_collections + (i_collection_a * n_points * n_coordinates);
+    
+    for (i_collection_b = i_collection_b_lower;
+         i_collection_b < i_collection_b_upper;
+         i_collection_b ++) {
+             
+        /*
+        *   Calculate a pointer, collection_b, to the element in
+        *   a_collections_b (a_collections itself, unless job->b_cross is set)
+        *   at which the second collection of the present pair begins. Note
+        *   that a_collections has form,
+        *   
+        *   a_collections = [COLLECTION_1], ..., [COLLECTION_P]
+        *   
+        *   [COLLECTION_P] = [POINT_1], ..., [POINT_Q]
+        *   
+        *   [POINT_Q] = [COORDINATE_1], ..., [COORDINATE_R]
+        *   
+        *   where Q and R, given by n_points and n_coordinates respectively,
+        *   are constant across all P collections in a_collections.
+        */
+        
+        collection_b = a_collections_b + (i_collection_b * n_points * n_coordinates);
         
         /*
-        *   If any pthread_join() call fails, apply the same clean up procedure
-        *   as for failed pthread_create() calls above.
+        *   Pass n_points, n_coordinates, collection_a and collection_b to the
+        *   function pointed to by f_calculation and store the result in the
+        *   element to which a_results points. Then advance the a_results
+        *   pointer by one element in preparation for the next pairwise
+        *   calculation.
         */
         
-        if (n_return) {
+        *(a_results ++) = f_calculation(n_points,
+                                        n_coordinates,
+                                        collection_a,
+                                        collection_b);
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _PAIRWISE_LAUNCH_ROW_DISTANCE
+    
+    Type: Preprocessor macro
+    
+    Intent: Private
+    
+    Description:
+    
+        Defines f_row, a static row driver for job->f_row which does what
+        _pairwise_launch_row() does when job->f_calculation is
+        _pairwise_single_distance(), or _pairwise_launch_row_float() when
+        job->f_calculation_float is _pairwise_single_distance_float(), for
+        points of exactly n_coordinates coordinates of type real. f_sum is
+        the _PAIRWISE_SUM_SQUARED_DIFFERENCES_* macro for n_coordinates, and
+        f_sqrt takes the square root of its sum.
         
-            for (; i_thread < n_threads; i_thread ++) {
-            
-                pthread_cancel(*(a_threads + i_thread));
-            
-            }
+    Further Information:
+    
+        The generic row drivers make two indirect calls per pair, through
+        job->f_calculation and then through the kernel pointer, and the
+        kernel loops over a coordinate count known only at run time. Here the
+        sum is written out in the driver itself, with no loop, and point_a
+        stays in registers for the whole row. Since f_sum is also what
+        _pairwise_single_distance() uses for these shapes, the results are
+        the same to the bit as those of every other distance calculation,
+        so long as neither is vectorised; see _PAIRWISE_UNVECTORISED.
         
-            free(a_argument_sets);
-            free(a_threads);
-            
-            switch (n_return) {
-            
-                case EDEADLK: return PAIRWISE_RETURN_PTHREAD_JOIN_EDEADLK;
-                
-                case EINVAL: return PAIRWISE_RETURN_PTHREAD_JOIN_EINVAL;
-                
-                case ESRCH: return PAIRWISE_RETURN_PTHREAD_JOIN_ESRCH;
-                
-                default: return PAIRWISE_RETURN_PTHREAD_JOIN_UNKNOWN;
+*******************************************************************************/
+
+#define _PAIRWISE_LAUNCH_ROW_DISTANCE(f_row, real, f_sqrt, f_sum, n_coordinates) \
+_PAIRWISE_UNVECTORISED                                                        \
+static void                                                                   \
+f_row                                                                         \
+(                                                                             \
+    _pairwise_job_t* job,                                                     \
+    void* sink,                                                               \
+    size_t i_collection_a,                                                    \
+    size_t i_collection_b_lower,                                              \
+    size_t i_collection_b_upper,                                              \
+    void* a_results_row                                                       \
+)                                                                             \
+{                                                                             \
+    real* a_points_b;                                                         \
+    real* a_results;                                                          \
+    real* point_a;                                                            \
+    real* point_b;                                                            \
+    size_t i_collection_b;                                                    \
+                                                                              \
+    a_points_b = job->a_collections_b;                                        \
+    a_results = a_results_row;                                                \
+                                                                              \
+    point_a = (real*)job->a_collections + (i_collection_a * (n_coordinates)); \
+                                                                              \
+    for (i_collection_b = i_collection_b_lower;                               \
+         i_collection_b < i_collection_b_upper;                               \
+         i_collection_b ++) {                                                 \
+                                                                              \
+        point_b = a_points_b + (i_collection_b * (n_coordinates));            \
+                                                                              \
+        *(a_results ++) = f_sqrt(f_sum(point_a, point_b));                    \
+    }                                                                         \
+}
+
+_PAIRWISE_LAUNCH_ROW_DISTANCE(_pairwise_launch_row_distance_2, double, sqrt,
+                              _PAIRWISE_SUM_SQUARED_DIFFERENCES_2, 2)
+_PAIRWISE_LAUNCH_ROW_DISTANCE(_pairwise_launch_row_distance_3, double, sqrt,
+                              _PAIRWISE_SUM_SQUARED_DIFFERENCES_3, 3)
+_PAIRWISE_LAUNCH_ROW_DISTANCE(_pairwise_launch_row_distance_4, double, sqrt,
+                              _PAIRWISE_SUM_SQUARED_DIFFERENCES_4, 4)
+_PAIRWISE_LAUNCH_ROW_DISTANCE(_pairwise_launch_row_distance_8, double, sqrt,
+                              _PAIRWISE_SUM_SQUARED_DIFFERENCES_8, 8)
+                              
+_PAIRWISE_LAUNCH_ROW_DISTANCE(_pairwise_launch_row_distance_float_2, float, sqrtf,
+                              _PAIRWISE_SUM_SQUARED_DIFFERENCES_2, 2)
+_PAIRWISE_LAUNCH_ROW_DISTANCE(_pairwise_launch_row_distance_float_3, float, sqrtf,
+                              _PAIRWISE_SUM_SQUARED_DIFFERENCES_3, 3)
+_PAIRWISE_LAUNCH_ROW_DISTANCE(_pairwise_launch_row_distance_float_4, float, sqrtf,
+                              _PAIRWISE_SUM_SQUARED_DIFFERENCES_4, 4)
+_PAIRWISE_LAUNCH_ROW_DISTANCE(_pairwise_launch_row_distance_float_8, float, sqrtf,
+                              _PAIRWISE_SUM_SQUARED_DIFFERENCES_8, 8)
+                              
+/*******************************************************************************
+
+    Symbol: _PAIRWISE_LAUNCH_ROW_RMSD
+    
+    Type: Preprocessor macro
+    
+    Intent: Private
+    
+    Description:
+    
+        Defines f_row, a static row driver for job->f_row which does what
+        _pairwise_launch_row() does when job->f_calculation is
+        _pairwise_single_rmsd(), or _pairwise_launch_row_float() when
+        job->f_calculation_float is _pairwise_single_rmsd_float(), for
+        collections of exactly n_points points of 3 coordinates of type real.
+        f_sum is the _PAIRWISE_SUM_SQUARED_DIFFERENCES_* macro for
+        3 * n_points elements, and f_sqrt takes the square root of its mean
+        over the points.
+        
+    Further Information:
+    
+        As for _PAIRWISE_LAUNCH_ROW_DISTANCE, the two indirect calls per pair
+        and the kernel's loop over a run-time length are replaced by a sum
+        written out in the driver. That pays only while the calls cost as
+        much as the sum: from 8 points up, the scalar sum is slower than the
+        vectorised kernel, so such collections keep the generic drivers.
+        
+*******************************************************************************/
+
+#define _PAIRWISE_LAUNCH_ROW_RMSD(f_row, real, f_sqrt, f_sum, n_points)       \
+_PAIRWISE_UNVECTORISED                                                        \
+static void                                                                   \
+f_row                                                                         \
+(                                                                             \
+    _pairwise_job_t* job,                                                     \
+    void* sink,                                                               \
+    size_t i_collection_a,                                                    \
+    size_t i_collection_b_lower,                                              \
+    size_t i_collection_b_upper,                                              \
+    void* a_results_row                                                       \
+)                                                                             \
+{                                                                             \
+    real* a_collections_b;                                                    \
+    real* a_results;                                                          \
+    real* collection_a;                                                       \
+    real* collection_b;                                                       \
+    size_t i_collection_b;                                                    \
+                                                                              \
+    a_collections_b = job->a_collections_b;                                   \
+    a_results = a_results_row;                                                \
+                                                                              \
+    collection_a = (real*)job->a_collections                                  \
+                 + (i_collection_a * (n_points) * 3);                         \
+                                                                              \
+    for (i_collection_b = i_collection_b_lower;                               \
+         i_collection_b < i_collection_b_upper;                               \
+         i_collection_b ++) {                                                 \
+                                                                              \
+        collection_b = a_collections_b + (i_collection_b * (n_points) * 3);   \
+                                                                              \
+        *(a_results ++) = f_sqrt(f_sum(collection_a, collection_b)            \
+                                 / (real)(n_points));                         \
+    }                                                                         \
+}
+
+_PAIRWISE_LAUNCH_ROW_RMSD(_pairwise_launch_row_rmsd_2, double, sqrt,
+                          _PAIRWISE_SUM_SQUARED_DIFFERENCES_6, 2)
+_PAIRWISE_LAUNCH_ROW_RMSD(_pairwise_launch_row_rmsd_4, double, sqrt,
+                          _PAIRWISE_SUM_SQUARED_DIFFERENCES_12, 4)
+                          
+_PAIRWISE_LAUNCH_ROW_RMSD(_pairwise_launch_row_rmsd_float_2, float, sqrtf,
+                          _PAIRWISE_SUM_SQUARED_DIFFERENCES_6, 2)
+_PAIRWISE_LAUNCH_ROW_RMSD(_pairwise_launch_row_rmsd_float_4, float, sqrtf,
+                          _PAIRWISE_SUM_SQUARED_DIFFERENCES_12, 4)
+                          
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_specialise
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        If job calculates Euclidean distances between points of 2, 3, 4 or 8
+        coordinates, or RMSDs between collections of 2 or 4 points of 3
+        coordinates, with one of the generic row drivers, replaces its f_row
+        with the matching driver defined by _PAIRWISE_LAUNCH_ROW_DISTANCE or
+        _PAIRWISE_LAUNCH_ROW_RMSD, which gives the same results. Leaves every
+        other job as it is.
+        
+        Returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+static void
+_pairwise_launch_specialise
+(
+
+    _pairwise_job_t* job
+
+)
+{
+
+    if (job->f_row == _pairwise_launch_row
+    &&  job->f_calculation == _pairwise_single_distance
+    &&  job->n_points == 1) {
+        
+        switch (job->n_coordinates) {
             
-            }
+            case 2: job->f_row = _pairwise_launch_row_distance_2; return;
+            case 3: job->f_row = _pairwise_launch_row_distance_3; return;
+            case 4: job->f_row = _pairwise_launch_row_distance_4; return;
+            case 8: job->f_row = _pairwise_launch_row_distance_8; return;
+        
+        }
+    
+    }
+    
+    if (job->f_row == _pairwise_launch_row_float
+    &&  job->f_calculation_float == _pairwise_single_distance_float
+    &&  job->n_points == 1) {
+        
+        switch (job->n_coordinates) {
             
+            case 2: job->f_row = _pairwise_launch_row_distance_float_2; return;
+            case 3: job->f_row = _pairwise_launch_row_distance_float_3; return;
+            case 4: job->f_row = _pairwise_launch_row_distance_float_4; return;
+            case 8: job->f_row = _pairwise_launch_row_distance_float_8; return;
+        
         }
     
     }
     
-    free(a_argument_sets);
-    free(a_threads);
+    if (job->f_row == _pairwise_launch_row
+    &&  job->f_calculation == _pairwise_single_rmsd
+    &&  job->n_coordinates == 3) {
+        
+        switch (job->n_points) {
+            
+            case 2: job->f_row = _pairwise_launch_row_rmsd_2; return;
+            case 4: job->f_row = _pairwise_launch_row_rmsd_4; return;
+        
+        }
     
-    return PAIRWISE_RETURN_SUCCESS;
+    }
     
+    if (job->f_row == _pairwise_launch_row_float
+    &&  job->f_calculation_float == _pairwise_single_rmsd_float
+    &&  job->n_coordinates == 3) {
+        
+        switch (job->n_points) {
+            
+            case 2: job->f_row = _pairwise_launch_row_rmsd_float_2; return;
+            case 4: job->f_row = _pairwise_launch_row_rmsd_float_4; return;
+        
+        }
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_row_offset
+    
+    Type: Static function returning size_t
+    
+    Intent: Private
+    
+    Description:
+    
+        Returns the offset in job->a_results of the first result of row
+        i_collection_a, that is, the number of results in all preceding rows.
+        Passing job->n_collections returns the number of results in all.
+        Not expected to fail.
+        
+*******************************************************************************/
+
+static size_t
+_pairwise_launch_row_offset
+(
+
+    _pairwise_job_t* job,
+    
+    size_t i_collection_a
+
+)
+{
+
+    if (job->b_cross && !job->b_append) {
+        
+        return i_collection_a * job->n_collections_b;
+    
+    }
+    
+    return (i_collection_a * ((2 * job->n_collections) - i_collection_a - 1)) / 2;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_touch
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Faults in, from the calling thread, every page of job->a_results
+        holding the results of the rows of tiles in which the share first
+        given to argument set i_argument_set lies, so that each page is
+        placed on the NUMA node of the thread about to fill it rather than on
+        that of whichever thread happens to write it first. Pages already
+        faulted in are left where they are, and no result is changed.
+        
+        Returns nothing. Does nothing if the host cannot fault in pages
+        without writing them. Not expected to fail.
+        
+    Further Information:
+    
+        Each argument set starts with a contiguous run of tiles, and tiles are
+        numbered row by row, so the rows of tiles of consecutive argument
+        sets are in turn contiguous, and cut a_results into slices. A row of
+        tiles split between two argument sets is counted in full to the later
+        of them; either way every page is faulted in by a thread which will
+        write to it.
+        
+        The pages are faulted in by madvise() with MADV_POPULATE_WRITE, which
+        allocates them exactly as writing them would, but without writing, so
+        it is safe while other threads fill pages of the same slice, as
+        thieves may. Older kernels refuse it, leaving placement to the first
+        write as before.
+        
+*******************************************************************************/
+
+static void
+_pairwise_launch_touch
+(
+
+    _pairwise_job_t* job,
+    
+    size_t i_argument_set
+
+)
+{
+
+#if defined(MADV_POPULATE_WRITE)
+
+    size_t i_chunk_lower;
+    size_t i_chunk_upper;
+    
+    size_t i_collection_a_lower;
+    size_t i_collection_a_upper;
+    size_t i_collection_b_lower;
+    size_t i_collection_b_upper;
+    
+    size_t i_result_lower;
+    size_t i_result_upper;
+    
+    uintptr_t i_page_lower;
+    uintptr_t i_page_upper;
+    uintptr_t s_page;
+    
+    i_chunk_lower = (i_argument_set * job->n_chunks) / job->n_argument_sets;
+    i_chunk_upper = ((i_argument_set + 1) * job->n_chunks) / job->n_argument_sets;
+    
+    if (i_chunk_lower >= i_chunk_upper) {
+        
+        return;
+    
+    }
+    
+    _pairwise_locate_chunk(job,
+                           i_chunk_lower,
+                           &i_collection_a_lower,
+                           &i_collection_a_upper,
+                           &i_collection_b_lower,
+                           &i_collection_b_upper);
+                           
+    i_result_lower = _pairwise_launch_row_offset(job, i_collection_a_lower);
+    i_result_upper = _pairwise_launch_row_offset(job, job->n_collections);
+    
+    if (i_chunk_upper < job->n_chunks) {
+        
+        _pairwise_locate_chunk(job,
+                               i_chunk_upper,
+                               &i_collection_a_lower,
+                               &i_collection_a_upper,
+                               &i_collection_b_lower,
+                               &i_collection_b_upper);
+                               
+        i_result_upper = _pairwise_launch_row_offset(job, i_collection_a_lower);
+    
+    }
+    
+    if (i_result_lower >= i_result_upper) {
+        
+        return;
+    
+    }
+    
+    /*
+    *   Round the slice out to whole pages. Neighbouring slices may then share
+    *   a page, which whichever thread gets there first faults in.
+    */
+    
+    s_page = sysconf(_SC_PAGESIZE);
+    
+    i_page_lower = (uintptr_t)job->a_results + (i_result_lower * job->s_element);
+    i_page_upper = (uintptr_t)job->a_results + (i_result_upper * job->s_element);
+    
+    i_page_lower -= i_page_lower % s_page;
+    i_page_upper += (s_page - (i_page_upper % s_page)) % s_page;
+    
+    madvise((void*)i_page_lower, i_page_upper - i_page_lower, MADV_POPULATE_WRITE);
+    
+#else
+
+    (void)job;
+    (void)i_argument_set;
+    
+#endif
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_bounded
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Carries out chunks of the pairwise calculations to be done by a
+        _pairwise_job_t for as long as any remain unclaimed, starting with the
+        share of an initialised _pairwise_as_t, argument_set.
+        
+        On success returns nothing. Not expected to fail.
+        
+    Further Information:
+    
+        It is expected that multiple calls to this function will be made by
+        multiple threads running is parallel, as per the libpairwise
+        parallelisation strategy.
+        
+        This function first claims chunks one by one from the front of its own
+        share. Once that is empty it visits the share of every other
+        _pairwise_as_t in turn, starting with the next, and steals chunks one
+        by one from its back until it too is empty. Since shares never grow, a
+        single pass over the other shares leaves no chunk unclaimed. After
+        each chunk it adds the number of pairwise calculations carried out to
+        argument_set->n_pairs, from which pairwise_future_progress() reports.
+        
+        Before any of that, if job stores its results in job->a_results, this
+        function faults in its own slice of them with
+        _pairwise_launch_touch(), so that with workers pinned by
+        pairwise_pool_set_affinity() each thread mostly writes to memory on
+        its own NUMA node.
+        
+*******************************************************************************/
+
+void
+_pairwise_launch_bounded
+(
+
+    _pairwise_as_t* argument_set
+
+)
+{
+
+    _pairwise_job_t* job;
+    
+    _pairwise_as_t* victim;
+    
+    size_t i_argument_set;
+    size_t i_victim;
+    
+    size_t i_chunk;
+    
+    size_t n_pairs;
+    
+    void* sink;
+    
+    argument_set->t_start = _pairwise_stats_clock();
+    
+    job = argument_set->job;
+    
+    i_argument_set = argument_set - job->a_argument_sets;
+    
+    /*
+    *   Each thread passes its own sink, if job has any, to every chunk it
+    *   carries out, whether that chunk is its own or stolen.
+    */
+    
+    sink = NULL;
+    
+    if (job->a_sinks) {
+        
+        sink = (char*)job->a_sinks + (i_argument_set * job->s_sink);
+    
+    }
+    
+    if (job->a_results && job->n_argument_sets > 1) {
+        
+        _pairwise_launch_touch(job, i_argument_set);
+    
+    }
+    
+    /*
+    *   The first share visited is this thread's own, claimed from the front;
+    *   every other share is stolen from, from the back. A cancelled job is
+    *   abandoned between chunks.
+    */
+    
+    for (i_victim = 0; i_victim < job->n_argument_sets; i_victim ++) {
+        
+        victim = job->a_argument_sets + ((i_argument_set + i_victim) % job->n_argument_sets);
+        
+        while (!__atomic_load_n(&job->b_cancel, __ATOMIC_RELAXED)
+        &&     _pairwise_claim_chunk(victim, i_victim != 0, &i_chunk)) {
+            
+            n_pairs = _pairwise_launch_chunk(job, sink, i_chunk);
+            
+            __atomic_add_fetch(&argument_set->n_pairs, n_pairs, __ATOMIC_RELAXED);
+        
+        }
+    
+    }
+    
+    argument_set->t_end = _pairwise_stats_clock();
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_prepare
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Readies job, whose calculation, row driver, input and output arrays,
+        element size, sinks and dimensions must already be set, to be carried
+        out over n_threads threads, as described for _pairwise_launch_job():
+        cuts its tiles, and allocates and initialises job->a_argument_sets,
+        one for each thread which can be kept busy, so that each can be passed
+        to _pairwise_launch_bounded(). If job->a_sinks is not null it must
+        hold n_threads sinks.
+        
+        A job with no pairwise calculations to carry out is left with no
+        argument sets, job->n_argument_sets being zero.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero, and the caller must pass job to
+        _pairwise_launch_release() once done with it. On failure returns a
+        non-zero libpairwise error code, having freed anything allocated.
+        
+    Further Information:
+    
+        This function checks the return codes of all functions it calls for
+        which it makes sense to do so, and will itself return early with an
+        appropriate libpairwise non-zero error code if it detects an error.
+        Before any such early return, all allocated memory is first freed.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_prepare
+(
+
+    _pairwise_job_t* job,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    _pairwise_as_t* a_argument_sets;
+    
+    size_t n_collections;
+    
+    size_t n_chunks_target;
+    
+    n_collections = job->n_collections;
+    
+    /*
+    *   Unless asked for the calculations between two sets, carry out those
+    *   between every pair of collections of the one set.
+    */
+    
+    if (!job->b_cross) {
+        
+        job->a_collections_b = job->a_collections;
+        job->n_collections_b = n_collections;
+    
+    }
+    
+    job->f_tile = NULL;
+    
+    job->b_cancel = 0;
+    
+    job->a_tile_offsets = NULL;
+    
+    job->n_argument_sets = 0;
+    job->a_argument_sets = NULL;
+    
+    /*
+    *   If the caller specifies fewer than two collections over which to carry
+    *   out pairwise calculations (or, between two sets, an empty set), or that
+    *   each collection contains no points, or that each point contains no
+    *   coordinates, then the total number of pairwise calculations to be
+    *   carried out is zero, and we can return with success without doing
+    *   anything else.
+    */
+    
+    if (job->b_cross ? (!n_collections || !job->n_collections_b) : n_collections < 2) {
+        
+        return PAIRWISE_RETURN_SUCCESS;
+    
+    }
+    
+    if (!job->n_points || !job->n_coordinates) {
+    
+        return PAIRWISE_RETURN_SUCCESS;
+    
+    }
+    
+    /*
+    *   If the caller specifies that zero threads should be used (and there are
+    *   pairwise calculations to be carried out) then return with an error.
+    */
+    
+    if (!n_threads) {
+    
+        return PAIRWISE_RETURN_ERROR_NTHREADS;
+    
+    }
+    
+    /*
+    *   Swap in a row driver specialised for the shape of the points, if there
+    *   is one.
+    */
+    
+    _pairwise_launch_specialise(job);
+    
+    /*
+    *   For the special case in which only one thread is requested, forego all
+    *   parallelisation overhead: that thread carries out every tile in turn.
+    */
+    
+    n_chunks_target = n_threads * _PAIRWISE_CHUNKS_PER_THREAD;
+    
+    if (n_threads == 1) {
+    
+        n_chunks_target = 1;
+    
+    }
+    
+    n_return = _pairwise_populate_chunks(job, n_chunks_target);
+    
+    if (n_return) {
+    
+        return n_return;
+    
+    }
+    
+    /*
+    *   There is no use for more threads than chunks.
+    */
+    
+    if (n_threads > job->n_chunks) {
+        
+        n_threads = job->n_chunks;
+    
+    }
+    
+    /*
+    *   Calculate wide collections by norm expansion, if job is one which can
+    *   be. Now that the tiles are cut, each thread's scratch space can be
+    *   sized to hold one.
+    */
+    
+    n_return = _pairwise_gemm_prepare(job, n_threads);
+    
+    if (n_return) {
+        
+        free(job->a_tile_offsets);
+        
+        job->a_tile_offsets = NULL;
+        
+        return n_return;
+    
+    }
+    
+    a_argument_sets = malloc(n_threads * sizeof(_pairwise_as_t));
+    
+    if (!a_argument_sets) {
+        
+        _pairwise_gemm_release(job, n_threads);
+        
+        free(job->a_tile_offsets);
+        
+        job->a_tile_offsets = NULL;
+        
+        return PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    _pairwise_populate_argument_sets(job, n_threads, a_argument_sets);
+    
+    return PAIRWISE_RETURN_SUCCESS;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_release
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Frees everything allocated for job by a successful call to
+        _pairwise_launch_prepare(). No thread may still be carrying out
+        chunks of job.
+        
+        Returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+void
+_pairwise_launch_release
+(
+
+    _pairwise_job_t* job
+
+)
+{
+
+    if (job->n_argument_sets) {
+        
+        _pairwise_gemm_release(job, job->n_argument_sets);
+    
+    }
+    
+    free(job->a_argument_sets);
+    free(job->a_tile_offsets);
+    
+    job->n_argument_sets = 0;
+    job->a_argument_sets = NULL;
+    
+    job->a_tile_offsets = NULL;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_job
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Carries out every pairwise calculation described by job, whose
+        calculation, row driver, input and output arrays, element size, sinks
+        and dimensions must already be set, distributed over n_threads
+        threads. If job->a_sinks is not null it must hold n_threads sinks.
+        Called by _pairwise_launch(), _pairwise_launch_float(),
+        _pairwise_launch_cutoff() and _pairwise_launch_knn().
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code,
+        and makes no guarantee about the state of job->a_results, which may
+        or may not have been changed.
+        
+    Further Information:
+    
+        This function cuts the pairwise calculations to be done into cache-
+        sized tiles, about _PAIRWISE_CHUNKS_PER_THREAD or more per thread,
+        with _pairwise_populate_chunks(), and gives each of n_threads
+        _pairwise_as_t an equal share of them with
+        _pairwise_populate_argument_sets(), both by way of
+        _pairwise_launch_prepare(). Thereafter it passes one call to
+        _pairwise_launch_bounded() per initialised _pairwise_as_t to
+        _pairwise_pool_run(), which distributes those calls over the calling
+        thread and n_threads - 1 long-lived workers of the libpairwise worker
+        pool (creating workers only if the pool is smaller than that), and
+        returns once all pairwise calculations have been done. Threads which
+        run out of chunks of their own steal them from the others, so a slow
+        or preempted thread delays the calculation by at most about one chunk.
+        A single thread runs its one task directly, without the pool. The
+        timings of each phase, and of each thread, are recorded with
+        _pairwise_stats_record() for pairwise_stats_last().
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_job
+(
+
+    _pairwise_job_t* job,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    double t_prepare;
+    double t_submit;
+    double t_done;
+    
+    t_prepare = _pairwise_stats_clock();
+    
+    n_return = _pairwise_launch_prepare(job, n_threads);
+    
+    if (n_return) {
+        
+        return n_return;
+    
+    }
+    
+    t_submit = _pairwise_stats_clock();
+    
+    /*
+    *   Hand one task per _pairwise_as_t to the libpairwise worker pool, on
+    *   which this thread also works until every task has finished. The
+    *   pool's long-lived workers make this far cheaper than creating and
+    *   joining n_threads threads for every call.
+    */
+    
+    n_return = _pairwise_pool_run((void (*)(void*))_pairwise_launch_bounded,
+                                  job->a_argument_sets,
+                                  sizeof(_pairwise_as_t),
+                                  job->n_argument_sets);
+                                  
+    t_done = _pairwise_stats_clock();
+    
+    if (!n_return) {
+        
+        _pairwise_stats_record(job, t_prepare, t_submit, t_done);
+    
+    }
+    
+    _pairwise_launch_release(job);
+    
+    return n_return;
+    
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Coordinates the parallel execution of pairwise calculations to be done
+        distributed fairly across multiple threads.
+        
+        f_calculation is a pointer to a function representing a single round of
+        the pairwise calculations to be done. n_collections is the number of
+        collections in a_collections, n_points is the number of points per
+        collection, and n_coordinates is the number of coordinates per point.
+        a_collections is a pointer to an input array containing a set of
+        collections, a_results is a pointer to an output array of sufficient
+        size to store the results of all pairwise calculations. n_threads is
+        the number of threads across which to distribute the pairwise
+        calculations to be done.
+        
+        The caller is responsible for ensuring that a_collections has the
+        expected form (see the prologue comment for pairwise_rmsds()), and that
+        a_results is large enough to store
+        0.5 * n_collections * (n_collections - 1) doubles.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code,
+        and makes no guarantee about the state a_results, which may or may not
+        have been changed.
+        
+    Further Information:
+    
+        It is expected that this function will be indirectly called by a public
+        wrapper function that binds it to a specific calculation function.
+        
+        This function describes the calculation in a _pairwise_job_t, and
+        passes it to _pairwise_launch_job().
+        
+*******************************************************************************/
+
+int
+_pairwise_launch
+(
+
+    double (*f_calculation)(size_t n_points,
+                            size_t n_coordinates,
+                            double* collection_a,
+                            double* collection_b),
+                            
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    double* a_results,
+    
+    size_t n_threads
+
+)
+{
+
+    _pairwise_job_t job;
+    
+    job.f_calculation = f_calculation;
+    job.f_calculation_float = NULL;
+    job.f_row = _pairwise_launch_row;
+    
+    job.a_collections = a_collections;
+    job.a_results = a_results;
+    
+    job.s_element = sizeof(double);
+    
+    job.a_sinks = NULL;
+    job.s_sink = 0;
+    
+    job.cutoff = 0;
+    
+    job.b_cross = 0;
+    job.b_append = 0;
+    
+    job.n_collections = n_collections;
+    job.n_points = n_points;
+    job.n_coordinates = n_coordinates;
+    
+    return _pairwise_launch_job(&job, n_threads);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_float
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch(), but for a calculation on collections of floats,
+        f_calculation, whose results are stored in an output array of floats.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_float
+(
+
+    float (*f_calculation)(size_t n_points,
+                           size_t n_coordinates,
+                           float* collection_a,
+                           float* collection_b),
+                           
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    float* a_results,
+    
+    size_t n_threads
+
+)
+{
+
+    _pairwise_job_t job;
+    
+    job.f_calculation = NULL;
+    job.f_calculation_float = f_calculation;
+    job.f_row = _pairwise_launch_row_float;
+    
+    job.a_collections = a_collections;
+    job.a_results = a_results;
+    
+    job.s_element = sizeof(float);
+    
+    job.a_sinks = NULL;
+    job.s_sink = 0;
+    
+    job.cutoff = 0;
+    
+    job.b_cross = 0;
+    job.b_append = 0;
+    
+    job.n_collections = n_collections;
+    job.n_points = n_points;
+    job.n_coordinates = n_coordinates;
+    
+    return _pairwise_launch_job(&job, n_threads);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_cross
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch(), but applies f_calculation to every pair of one
+        collection from a_collections and one from a_collections_b, rather than
+        to every pair of collections from one set.
+        
+        n_collections and n_collections_b are the numbers of collections in
+        a_collections and a_collections_b, whose collections must each have
+        n_points points of n_coordinates coordinates. a_results must be large
+        enough to store n_collections * n_collections_b doubles. The result
+        for collection i of a_collections and collection j of a_collections_b
+        is stored in element i * n_collections_b + j.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code,
+        and makes no guarantee about the state a_results, which may or may not
+        have been changed.
+        
+    Further Information:
+    
+        This function describes the calculation in a _pairwise_job_t with
+        b_cross set, and passes it to _pairwise_launch_job(), which cuts the
+        rectangle of pairwise calculations into tiles just as it does the
+        triangle.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_cross
+(
+
+    double (*f_calculation)(size_t n_points,
+                            size_t n_coordinates,
+                            double* collection_a,
+                            double* collection_b),
+                            
+    size_t n_collections,
+    size_t n_collections_b,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    double* a_collections_b,
+    double* a_results,
+    
+    size_t n_threads
+
+)
+{
+
+    _pairwise_job_t job;
+    
+    job.f_calculation = f_calculation;
+    job.f_calculation_float = NULL;
+    job.f_row = _pairwise_launch_row;
+    
+    job.a_collections = a_collections;
+    job.a_collections_b = a_collections_b;
+    job.a_results = a_results;
+    
+    job.s_element = sizeof(double);
+    
+    job.a_sinks = NULL;
+    job.s_sink = 0;
+    
+    job.cutoff = 0;
+    
+    job.b_cross = 1;
+    job.b_append = 0;
+    
+    job.n_collections = n_collections;
+    job.n_collections_b = n_collections_b;
+    job.n_points = n_points;
+    job.n_coordinates = n_coordinates;
+    
+    return _pairwise_launch_job(&job, n_threads);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_cross_float
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch_cross(), but for a calculation on collections of
+        floats, f_calculation, whose results are stored in an output array of
+        floats.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_cross_float
+(
+
+    float (*f_calculation)(size_t n_points,
+                           size_t n_coordinates,
+                           float* collection_a,
+                           float* collection_b),
+                           
+    size_t n_collections,
+    size_t n_collections_b,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    float* a_collections_b,
+    float* a_results,
+    
+    size_t n_threads
+
+)
+{
+
+    _pairwise_job_t job;
+    
+    job.f_calculation = NULL;
+    job.f_calculation_float = f_calculation;
+    job.f_row = _pairwise_launch_row_float;
+    
+    job.a_collections = a_collections;
+    job.a_collections_b = a_collections_b;
+    job.a_results = a_results;
+    
+    job.s_element = sizeof(float);
+    
+    job.a_sinks = NULL;
+    job.s_sink = 0;
+    
+    job.cutoff = 0;
+    
+    job.b_cross = 1;
+    job.b_append = 0;
+    
+    job.n_collections = n_collections;
+    job.n_collections_b = n_collections_b;
+    job.n_points = n_points;
+    job.n_coordinates = n_coordinates;
+    
+    return _pairwise_launch_job(&job, n_threads);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_append_move
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Moves the condensed results across n_collections_old collections in
+        a_results_old, of s_element bytes each, to their places in a_results
+        among the results across n_collections_old + n_collections_new, as
+        described for _pairwise_launch_append().
+        
+        Returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+static void
+_pairwise_append_move
+(
+
+    size_t n_collections_old,
+    size_t n_collections_new,
+    
+    size_t s_element,
+    
+    void* a_results_old,
+    void* a_results
+
+)
+{
+
+    size_t i_collection;
+    size_t i_result;
+    
+    if (n_collections_old < 2) {
+        
+        return;
+    
+    }
+    
+    for (i_collection = n_collections_old - 1; i_collection -- > 0;) {
+        
+        i_result = (i_collection * ((2 * n_collections_old) - i_collection - 1)) / 2;
+        
+        memmove((char*)a_results + ((i_result + (i_collection * n_collections_new)) * s_element),
+                (char*)a_results_old + (i_result * s_element),
+                (n_collections_old - i_collection - 1) * s_element);
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_append
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch(), but extends the results of every pairwise
+        calculation across n_collections_old collections to those across
+        n_collections_old + n_collections_new, calculating only the results
+        which involve at least one of the n_collections_new new collections.
+        
+        a_collections holds all n_collections_old + n_collections_new
+        collections, old first, each of n_points points of n_coordinates
+        coordinates. a_results_old holds the condensed results across the old
+        collections, as _pairwise_launch() stores them, and a_results must be
+        large enough to store the results across all collections. The old
+        results are moved to their places among those, as pairwise_index()
+        gives them, and the new results are calculated into the rest.
+        a_results may be a_results_old itself, once enlarged, in which case
+        the old results are moved in place; otherwise the two must not
+        overlap.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code,
+        and makes no guarantee about the state a_results, which may or may not
+        have been changed.
+        
+    Further Information:
+    
+        Every row of results grows by n_collections_new, so each old result
+        moves forward by n_collections_new times its row; the old rows are
+        moved last first, so that moving in place never overwrites a row yet
+        to be moved. The new results form a rectangle of every collection by
+        every new collection, less the pairs on or below the diagonal among
+        the new collections, so the calculation is described in a
+        _pairwise_job_t with both b_cross and b_append set, and cut into tiles
+        as _pairwise_launch_cross() does.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_append
+(
+
+    double (*f_calculation)(size_t n_points,
+                            size_t n_coordinates,
+                            double* collection_a,
+                            double* collection_b),
+                            
+    size_t n_collections_old,
+    size_t n_collections_new,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    double* a_results_old,
+    double* a_results,
+    
+    size_t n_threads
+
+)
+{
+
+    _pairwise_job_t job;
+    
+    _pairwise_append_move(n_collections_old,
+                          n_collections_new,
+                          sizeof(double),
+                          a_results_old,
+                          a_results);
+                          
+    job.f_calculation = f_calculation;
+    job.f_calculation_float = NULL;
+    job.f_row = _pairwise_launch_row;
+    
+    job.a_collections = a_collections;
+    job.a_collections_b = a_collections + (n_collections_old * n_points * n_coordinates);
+    job.a_results = a_results;
+    
+    job.s_element = sizeof(double);
+    
+    job.a_sinks = NULL;
+    job.s_sink = 0;
+    
+    job.cutoff = 0;
+    
+    job.b_cross = 1;
+    job.b_append = 1;
+    
+    job.n_collections = n_collections_old + n_collections_new;
+    job.n_collections_b = n_collections_new;
+    job.n_points = n_points;
+    job.n_coordinates = n_coordinates;
+    
+    return _pairwise_launch_job(&job, n_threads);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_append_float
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch_append(), but for a calculation on collections of
+        floats, f_calculation, whose results are stored in arrays of floats.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_append_float
+(
+
+    float (*f_calculation)(size_t n_points,
+                           size_t n_coordinates,
+                           float* collection_a,
+                           float* collection_b),
+                           
+    size_t n_collections_old,
+    size_t n_collections_new,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    float* a_results_old,
+    float* a_results,
+    
+    size_t n_threads
+
+)
+{
+
+    _pairwise_job_t job;
+    
+    _pairwise_append_move(n_collections_old,
+                          n_collections_new,
+                          sizeof(float),
+                          a_results_old,
+                          a_results);
+                          
+    job.f_calculation = NULL;
+    job.f_calculation_float = f_calculation;
+    job.f_row = _pairwise_launch_row_float;
+    
+    job.a_collections = a_collections;
+    job.a_collections_b = a_collections + (n_collections_old * n_points * n_coordinates);
+    job.a_results = a_results;
+    
+    job.s_element = sizeof(float);
+    
+    job.a_sinks = NULL;
+    job.s_sink = 0;
+    
+    job.cutoff = 0;
+    
+    job.b_cross = 1;
+    job.b_append = 1;
+    
+    job.n_collections = n_collections_old + n_collections_new;
+    job.n_collections_b = n_collections_new;
+    job.n_points = n_points;
+    job.n_coordinates = n_coordinates;
+    
+    return _pairwise_launch_job(&job, n_threads);
+
 }
@@ -0,0 +1,707 @@
+#include "pairwise_linkage.h"
+
+/*******************************************************************************
+
+    Symbol: _pairwise_linkage_scan
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Carries out one thread's share of a step of Prim's algorithm, task, a
+        _pairwise_linkage_task_t: calculates the result between the collection
+        last added to the tree and the collection at each of its positions of
+        a_order, by calling f_calculation on doubles, lowers the element of
+        a_nearest at that position to it if it is nearer, and finds the
+        position nearest the tree of all.
+        
+        Returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+static void
+_pairwise_linkage_scan
+(
+
+    void* task
+
+)
+{
+
+    _pairwise_linkage_task_t* share;
+    _pairwise_linkage_t* linkage;
+    
+    double* a_collections;
+    
+    double* collection_added;
+    double* collection;
+    
+    double result;
+    
+    size_t s_collection;
+    
+    size_t i_position;
+    
+    share = task;
+    linkage = share->linkage;
+    
+    a_collections = linkage->a_collections;
+    
+    s_collection = linkage->n_points * linkage->n_coordinates;
+    
+    collection_added = a_collections + (linkage->i_added * s_collection);
+    
+    share->i_nearest = share->i_lower;
+    share->nearest = HUGE_VAL;
+    
+    for (i_position = share->i_lower;
+         i_position < share->i_upper;
+         i_position ++) {
+             
+        collection = a_collections + (*(linkage->a_order + i_position) * s_collection);
+        
+        result = linkage->f_calculation(linkage->n_points,
+                                        linkage->n_coordinates,
+                                        collection_added,
+                                        collection);
+                                        
+        if (result < *(linkage->a_nearest + i_position)) {
+            
+            *(linkage->a_nearest + i_position) = result;
+            *(linkage->a_from + i_position) = linkage->i_added;
+        
+        }
+        
+        if (*(linkage->a_nearest + i_position) < share->nearest) {
+            
+            share->i_nearest = i_position;
+            share->nearest = *(linkage->a_nearest + i_position);
+        
+        }
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_linkage_scan_float
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_linkage_scan(), but calling f_calculation_float on
+        floats.
+        
+*******************************************************************************/
+
+static void
+_pairwise_linkage_scan_float
+(
+
+    void* task
+
+)
+{
+
+    _pairwise_linkage_task_t* share;
+    _pairwise_linkage_t* linkage;
+    
+    float* a_collections;
+    
+    float* collection_added;
+    float* collection;
+    
+    double result;
+    
+    size_t s_collection;
+    
+    size_t i_position;
+    
+    share = task;
+    linkage = share->linkage;
+    
+    a_collections = linkage->a_collections;
+    
+    s_collection = linkage->n_points * linkage->n_coordinates;
+    
+    collection_added = a_collections + (linkage->i_added * s_collection);
+    
+    share->i_nearest = share->i_lower;
+    share->nearest = HUGE_VAL;
+    
+    for (i_position = share->i_lower;
+         i_position < share->i_upper;
+         i_position ++) {
+             
+        collection = a_collections + (*(linkage->a_order + i_position) * s_collection);
+        
+        result = linkage->f_calculation_float(linkage->n_points,
+                                              linkage->n_coordinates,
+                                              collection_added,
+                                              collection);
+                                              
+        if (result < *(linkage->a_nearest + i_position)) {
+            
+            *(linkage->a_nearest + i_position) = result;
+            *(linkage->a_from + i_position) = linkage->i_added;
+        
+        }
+        
+        if (*(linkage->a_nearest + i_position) < share->nearest) {
+            
+            share->i_nearest = i_position;
+            share->nearest = *(linkage->a_nearest + i_position);
+        
+        }
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_linkage_compare
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Comparison function for qsort() over the rows of a linkage whose
+        fourth column still holds the order in which Prim's algorithm found
+        each edge. Orders rows by result, NaN last, and rows of equal result
+        by that order, so that the sort is stable.
+        
+        Returns a negative, zero or positive integer as row_a sorts before,
+        with or after row_b. Not expected to fail.
+        
+*******************************************************************************/
+
+static int
+_pairwise_linkage_compare
+(
+
+    const void* row_a,
+    const void* row_b
+
+)
+{
+
+    const double* a_row_a;
+    const double* a_row_b;
+    
+    a_row_a = row_a;
+    a_row_b = row_b;
+    
+    if (isnan(*(a_row_a + 2)) != isnan(*(a_row_b + 2))) {
+        
+        return isnan(*(a_row_a + 2)) ? 1 : -1;
+    
+    }
+    
+    if (*(a_row_a + 2) != *(a_row_b + 2)
+    &&  !isnan(*(a_row_a + 2))) {
+        
+        return *(a_row_a + 2) < *(a_row_b + 2) ? -1 : 1;
+    
+    }
+    
+    return *(a_row_a + 3) < *(a_row_b + 3) ? -1 : 1;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_linkage_find
+    
+    Type: Static function returning size_t
+    
+    Intent: Private
+    
+    Description:
+    
+        Returns the label of the cluster which cluster i_cluster has been
+        merged into, following a_parent, in which each label maps to the
+        label of the cluster it was merged into, or to itself if it has not
+        been. Points every label on the way straight at the result, so that
+        later calls are quicker. Not expected to fail.
+        
+*******************************************************************************/
+
+static size_t
+_pairwise_linkage_find
+(
+
+    size_t* a_parent,
+    
+    size_t i_cluster
+
+)
+{
+
+    size_t i_root;
+    size_t i_next;
+    
+    i_root = i_cluster;
+    
+    while (*(a_parent + i_root) != i_root) {
+        
+        i_root = *(a_parent + i_root);
+    
+    }
+    
+    while (*(a_parent + i_cluster) != i_root) {
+        
+        i_next = *(a_parent + i_cluster);
+        
+        *(a_parent + i_cluster) = i_root;
+        
+        i_cluster = i_next;
+    
+    }
+    
+    return i_root;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_linkage_label
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Turns the n_collections - 1 edges of a minimum spanning tree in
+        a_linkage, each a row of two collections, the result between them and
+        the order it was found in, into the linkage described for
+        _pairwise_launch_linkage().
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns PAIRWISE_RETURN_MALLOC_FAIL.
+        
+    Further Information:
+    
+        Single linkage merges clusters in order of the least result between
+        them, which is exactly the order of the tree's edges by result, so
+        sorting them and labelling each merge with a union-find gives the
+        same linkage as SciPy does from the full matrix. The size of a merged
+        cluster is already in the fourth column of the row which made it, so
+        only the union-find's parents need any further memory.
+        
+*******************************************************************************/
+
+static int
+_pairwise_linkage_label
+(
+
+    size_t n_collections,
+    
+    double* a_linkage
+
+)
+{
+
+    size_t* a_parent;
+    
+    double* row;
+    
+    size_t i_root_a;
+    size_t i_root_b;
+    
+    size_t n_size_a;
+    size_t n_size_b;
+    
+    size_t i_cluster;
+    size_t i_merge;
+    
+    a_parent = malloc(((2 * n_collections) - 1) * sizeof(size_t));
+    
+    if (!a_parent) {
+        
+        return PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    for (i_cluster = 0; i_cluster < (2 * n_collections) - 1; i_cluster ++) {
+        
+        *(a_parent + i_cluster) = i_cluster;
+    
+    }
+    
+    qsort(a_linkage, n_collections - 1, 4 * sizeof(double), _pairwise_linkage_compare);
+    
+    for (i_merge = 0; i_merge < n_collections - 1; i_merge ++) {
+        
+        row = a_linkage + (i_merge * 4);
+        
+        i_root_a = _pairwise_linkage_find(a_parent, (size_t)*(row + 0));
+        i_root_b = _pairwise_linkage_find(a_parent, (size_t)*(row + 1));
+        
+        n_size_a = i_root_a < n_collections ? 1 : (size_t)*(a_linkage + ((i_root_a - n_collections) * 4) + 3);
+        n_size_b = i_root_b < n_collections ? 1 : (size_t)*(a_linkage + ((i_root_b - n_collections) * 4) + 3);
+        
+        *(row + 0) = i_root_a < i_root_b ? i_root_a : i_root_b;
+        *(row + 1) = i_root_a < i_root_b ? i_root_b : i_root_a;
+        *(row + 3) = n_size_a + n_size_b;
+        
+        *(a_parent + i_root_a) = n_collections + i_merge;
+        *(a_parent + i_root_b) = n_collections + i_merge;
+    
+    }
+    
+    free(a_parent);
+    
+    return PAIRWISE_RETURN_SUCCESS;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_linkage_job
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Clusters the collections described by linkage, whose calculation,
+        input array and dimensions must already be set, by single linkage
+        over n_threads threads, and stores the clustering in a_linkage as
+        described for _pairwise_launch_linkage().
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+    Further Information:
+    
+        The minimum spanning tree is grown by Prim's algorithm, one collection
+        at a time, from collection zero. Every step calculates the results
+        between the collection added last and each collection not yet in the
+        tree, keeping for each the least result so far, so every pairwise
+        result is calculated exactly once, as pairwise_rmsds() would, but
+        none is kept beyond its step and memory grows only with
+        n_collections. Each step splits the remaining collections between the
+        threads of the libpairwise worker pool, and the nearest of each
+        thread's nearest collections joins the tree. Collections which join
+        are swapped to the end of a_order, so the remaining collections stay
+        contiguous and each thread's share is a simple range.
+        
+*******************************************************************************/
+
+static int
+_pairwise_launch_linkage_job
+(
+
+    _pairwise_linkage_t* linkage,
+    
+    double* a_linkage,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    void (*f_scan)(void* task);
+    
+    _pairwise_linkage_task_t* a_tasks;
+    
+    size_t n_collections;
+    size_t n_tasks;
+    
+    size_t i_collection;
+    size_t i_merge;
+    size_t i_task;
+    size_t i_nearest;
+    size_t i_last;
+    
+    size_t swap_order;
+    double swap_nearest;
+    size_t swap_from;
+    
+    double* row;
+    
+    n_collections = linkage->n_collections;
+    
+    if (n_collections < 2) {
+        
+        return PAIRWISE_RETURN_SUCCESS;
+    
+    }
+    
+    if (!n_threads) {
+        
+        return PAIRWISE_RETURN_ERROR_NTHREADS;
+    
+    }
+    
+    f_scan = linkage->f_calculation ? _pairwise_linkage_scan : _pairwise_linkage_scan_float;
+    
+    linkage->a_order = malloc((n_collections - 1) * sizeof(size_t));
+    linkage->a_nearest = malloc((n_collections - 1) * sizeof(double));
+    linkage->a_from = malloc((n_collections - 1) * sizeof(size_t));
+    
+    a_tasks = malloc(n_threads * sizeof(_pairwise_linkage_task_t));
+    
+    if (!linkage->a_order || !linkage->a_nearest || !linkage->a_from || !a_tasks) {
+        
+        free(linkage->a_order);
+        free(linkage->a_nearest);
+        free(linkage->a_from);
+        
+        free(a_tasks);
+        
+        return PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    /*
+    *   Start the tree from collection zero, which every other collection is
+    *   so far infinitely far from.
+    */
+    
+    for (i_collection = 1; i_collection < n_collections; i_collection ++) {
+        
+        *(linkage->a_order + i_collection - 1) = i_collection;
+        *(linkage->a_nearest + i_collection - 1) = HUGE_VAL;
+        *(linkage->a_from + i_collection - 1) = 0;
+    
+    }
+    
+    linkage->n_remaining = n_collections - 1;
+    
+    linkage->i_added = 0;
+    
+    n_return = PAIRWISE_RETURN_SUCCESS;
+    
+    for (i_merge = 0; i_merge < n_collections - 1 && !n_return; i_merge ++) {
+        
+        n_tasks = (linkage->n_remaining + _PAIRWISE_LINKAGE_GRAIN - 1) / _PAIRWISE_LINKAGE_GRAIN;
+        
+        if (n_tasks > n_threads) {
+            
+            n_tasks = n_threads;
+        
+        }
+        
+        for (i_task = 0; i_task < n_tasks; i_task ++) {
+            
+            (a_tasks + i_task)->linkage = linkage;
+            
+            (a_tasks + i_task)->i_lower = (linkage->n_remaining * i_task) / n_tasks;
+            (a_tasks + i_task)->i_upper = (linkage->n_remaining * (i_task + 1)) / n_tasks;
+        
+        }
+        
+        n_return = _pairwise_pool_run(f_scan,
+                                      a_tasks,
+                                      sizeof(_pairwise_linkage_task_t),
+                                      n_tasks);
+                                      
+        if (n_return) {
+            
+            break;
+        
+        }
+        
+        /*
+        *   Ties go to the earliest position, whatever the number of threads,
+        *   so the tree found never depends on it.
+        */
+        
+        i_nearest = a_tasks->i_nearest;
+        
+        for (i_task = 1; i_task < n_tasks; i_task ++) {
+            
+            if ((a_tasks + i_task)->nearest < *(linkage->a_nearest + i_nearest)) {
+                
+                i_nearest = (a_tasks + i_task)->i_nearest;
+            
+            }
+        
+        }
+        
+        row = a_linkage + (i_merge * 4);
+        
+        *(row + 0) = *(linkage->a_from + i_nearest);
+        *(row + 1) = *(linkage->a_order + i_nearest);
+        *(row + 2) = *(linkage->a_nearest + i_nearest);
+        *(row + 3) = i_merge;
+        
+        linkage->i_added = *(linkage->a_order + i_nearest);
+        
+        /*
+        *   Swap the collection which joined the tree to the end of the
+        *   remaining collections, and drop it from them.
+        */
+        
+        i_last = linkage->n_remaining - 1;
+        
+        swap_order = *(linkage->a_order + i_nearest);
+        swap_nearest = *(linkage->a_nearest + i_nearest);
+        swap_from = *(linkage->a_from + i_nearest);
+        
+        *(linkage->a_order + i_nearest) = *(linkage->a_order + i_last);
+        *(linkage->a_nearest + i_nearest) = *(linkage->a_nearest + i_last);
+        *(linkage->a_from + i_nearest) = *(linkage->a_from + i_last);
+        
+        *(linkage->a_order + i_last) = swap_order;
+        *(linkage->a_nearest + i_last) = swap_nearest;
+        *(linkage->a_from + i_last) = swap_from;
+        
+        linkage->n_remaining --;
+    
+    }
+    
+    free(linkage->a_order);
+    free(linkage->a_nearest);
+    free(linkage->a_from);
+    
+    free(a_tasks);
+    
+    if (n_return) {
+        
+        return n_return;
+    
+    }
+    
+    return _pairwise_linkage_label(n_collections, a_linkage);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_linkage
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Clusters a set of collections, a_collections, by single linkage under
+        a calculation function, f_calculation, without storing the results of
+        all pairwise calculations between them, and stores the clustering in
+        a_linkage in the form of scipy.cluster.hierarchy.linkage().
+        
+        n_collections, n_points, n_coordinates, a_collections and n_threads
+        are as for _pairwise_launch(). a_linkage must have room for
+        (n_collections - 1) * 4 doubles, and holds a row-major matrix of
+        n_collections - 1 merges in order of increasing result. Row i merges
+        the clusters whose labels are in columns 0 and 1, the lesser first,
+        at the result in column 2, into a cluster of as many collections as
+        column 3 holds, which is labelled n_collections + i. Each collection
+        is a cluster of its own to begin with, labelled by its index.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code,
+        and makes no guarantee about the state of a_linkage.
+        
+    Further Information:
+    
+        This function describes the clustering in a _pairwise_linkage_t, and
+        passes it to _pairwise_launch_linkage_job().
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_linkage
+(
+
+    double (*f_calculation)(size_t n_points,
+                            size_t n_coordinates,
+                            double* collection_a,
+                            double* collection_b),
+                            
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    
+    double* a_linkage,
+    
+    size_t n_threads
+
+)
+{
+
+    _pairwise_linkage_t linkage;
+    
+    linkage.f_calculation = f_calculation;
+    linkage.f_calculation_float = NULL;
+    
+    linkage.a_collections = a_collections;
+    
+    linkage.n_collections = n_collections;
+    linkage.n_points = n_points;
+    linkage.n_coordinates = n_coordinates;
+    
+    return _pairwise_launch_linkage_job(&linkage, a_linkage, n_threads);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_linkage_float
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch_linkage(), but for a calculation on collections of
+        floats, f_calculation. The linkage is stored in double precision
+        nonetheless, as SciPy expects.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_linkage_float
+(
+
+    float (*f_calculation)(size_t n_points,
+                           size_t n_coordinates,
+                           float* collection_a,
+                           float* collection_b),
+                           
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    
+    double* a_linkage,
+    
+    size_t n_threads
+
+)
+{
+
+    _pairwise_linkage_t linkage;
+    
+    linkage.f_calculation = NULL;
+    linkage.f_calculation_float = f_calculation;
+    
+    linkage.a_collections = a_collections;
+    
+    linkage.n_collections = n_collections;
+    linkage.n_points = n_points;
+    linkage.n_coordinates = n_coordinates;
+    
+    return _pairwise_launch_linkage_job(&linkage, a_linkage, n_threads);
+
+}
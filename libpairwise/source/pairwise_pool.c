@@ -0,0 +1,1415 @@
+/*
+*   pthread_setaffinity_np() and the CPU_* macros are GNU extensions, and must
+*   be asked for before any system header is included.
+*/
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "pairwise_pool.h"
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+/*******************************************************************************
+
+    Symbol: _pairwise_pool_*
+    
+    Type: Family of static variables
+    
+    Intent: Private
+    
+    Description:
+    
+        The state of the libpairwise worker pool.
+        
+        _pairwise_pool_mutex protects the job queue, which runs from
+        _pairwise_pool_head to _pairwise_pool_tail and holds every submitted
+        job with tasks still to be claimed, as well as _pairwise_pool_n_target
+        and _pairwise_pool_n_busy, the number of workers running a task.
+        Idle workers wait on _pairwise_pool_work for jobs to be queued.
+        
+        _pairwise_pool_resize_mutex serialises changes to the number of
+        workers. It protects _pairwise_pool_threads, the array of worker
+        thread IDs, and _pairwise_pool_n_workers, its length. Workers whose
+        index is at least _pairwise_pool_n_target exit as soon as they are
+        idle; this is how the pool shrinks.
+        
+        _pairwise_pool_resize_mutex also protects _pairwise_pool_affinity, the
+        PAIRWISE_AFFINITY_* identifier set by pairwise_pool_set_affinity(),
+        and on Linux _pairwise_pool_places, the _pairwise_pool_n_places sets
+        of CPUs among which workers are placed round-robin under it.
+        
+*******************************************************************************/
+
+static pthread_mutex_t
+_pairwise_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_mutex_t
+_pairwise_pool_resize_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_cond_t
+_pairwise_pool_work = PTHREAD_COND_INITIALIZER;
+
+static pthread_once_t
+_pairwise_pool_once = PTHREAD_ONCE_INIT;
+
+static _pairwise_pool_job_t*
+_pairwise_pool_head = NULL;
+
+static _pairwise_pool_job_t*
+_pairwise_pool_tail = NULL;
+
+static pthread_t*
+_pairwise_pool_threads = NULL;
+
+static size_t
+_pairwise_pool_n_workers = 0;
+
+static size_t
+_pairwise_pool_n_target = 0;
+
+static size_t
+_pairwise_pool_n_busy = 0;
+
+static int
+_pairwise_pool_affinity = PAIRWISE_AFFINITY_NONE;
+
+#if defined(__linux__)
+
+static cpu_set_t*
+_pairwise_pool_places = NULL;
+
+static size_t
+_pairwise_pool_n_places = 0;
+
+#endif
+
+/*******************************************************************************
+
+    Symbol: _pairwise_pool_after_fork
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Resets the worker pool to empty in the child of a fork(). Only the
+        forking thread survives into the child, so the workers recorded in
+        the parent's pool no longer exist there, and the pool mutexes may have
+        been held by one of them.
+        
+        On success returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+static void
+_pairwise_pool_after_fork
+(void)
+{
+
+    pthread_mutex_init(&_pairwise_pool_mutex, NULL);
+    pthread_mutex_init(&_pairwise_pool_resize_mutex, NULL);
+    
+    pthread_cond_init(&_pairwise_pool_work, NULL);
+    
+    free(_pairwise_pool_threads);
+    
+    _pairwise_pool_threads = NULL;
+    
+    _pairwise_pool_head = NULL;
+    _pairwise_pool_tail = NULL;
+    
+    _pairwise_pool_n_workers = 0;
+    _pairwise_pool_n_target = 0;
+    _pairwise_pool_n_busy = 0;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_pool_register_after_fork
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Registers _pairwise_pool_after_fork() with pthread_atfork(). Called
+        exactly once, via pthread_once(), before the first worker is created.
+        
+        On success returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+static void
+_pairwise_pool_register_after_fork
+(void)
+{
+
+    pthread_atfork(NULL, NULL, _pairwise_pool_after_fork);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_pool_claim
+    
+    Type: Static function returning size_t
+    
+    Intent: Private
+    
+    Description:
+    
+        Claims the next unclaimed task of job, and removes job from the queue
+        if that was its last one. The caller must hold _pairwise_pool_mutex
+        and must have checked that job has an unclaimed task.
+        
+        On success returns the index of the claimed task. Not expected to
+        fail.
+        
+*******************************************************************************/
+
+static size_t
+_pairwise_pool_claim
+(
+
+    _pairwise_pool_job_t* job
+
+)
+{
+
+    size_t i_task;
+    
+    _pairwise_pool_job_t* previous;
+    
+    i_task = job->i_task_next ++;
+    
+    if (job->i_task_next < job->n_tasks) {
+        
+        return i_task;
+    
+    }
+    
+    /*
+    *   All tasks of job are now claimed, so unlink it from the queue. Jobs
+    *   are not necessarily claimed out in queue order, since the thread which
+    *   submitted a job may also claim tasks from it, so search for job's
+    *   predecessor. The queue holds at most one job per calling thread, plus
+    *   one per future still running.
+    */
+    
+    if (_pairwise_pool_head == job) {
+        
+        _pairwise_pool_head = job->next;
+        
+        previous = NULL;
+    
+    } else {
+        
+        previous = _pairwise_pool_head;
+        
+        while (previous->next != job) {
+            
+            previous = previous->next;
+        
+        }
+        
+        previous->next = job->next;
+    
+    }
+    
+    if (_pairwise_pool_tail == job) {
+        
+        _pairwise_pool_tail = previous;
+    
+    }
+    
+    job->next = NULL;
+    
+    return i_task;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_pool_finish
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Records that one task of job has finished, waking every thread
+        waiting for job if that was its last one. The caller must hold
+        _pairwise_pool_mutex.
+        
+        On success returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+static void
+_pairwise_pool_finish
+(
+
+    _pairwise_pool_job_t* job
+
+)
+{
+
+    job->n_tasks_done ++;
+    
+    if (job->n_tasks_done == job->n_tasks) {
+        
+        pthread_cond_broadcast(&job->done);
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_pool_worker
+    
+    Type: Static function returning void*
+    
+    Intent: Private
+    
+    Description:
+    
+        The body of every worker thread in the pool. i_worker is the index of
+        this worker in _pairwise_pool_threads, cast to a pointer.
+        
+        Repeatedly claims and runs the next task of the job at the head of the
+        queue, sleeping while the queue is empty, until the pool shrinks below
+        i_worker + 1 workers and the queue is empty. A worker being removed
+        thus first helps to claim every task already queued, since those of a
+        job submitted by _pairwise_pool_submit() have no other thread to run
+        them.
+        
+        On success returns a null pointer. Not expected to fail.
+        
+*******************************************************************************/
+
+static void*
+_pairwise_pool_worker
+(
+
+    void* i_worker
+
+)
+{
+
+    _pairwise_pool_job_t* job;
+    
+    size_t i_task;
+    
+    pthread_mutex_lock(&_pairwise_pool_mutex);
+    
+    while ((size_t)i_worker < _pairwise_pool_n_target || _pairwise_pool_head) {
+        
+        job = _pairwise_pool_head;
+        
+        if (!job) {
+            
+            pthread_cond_wait(&_pairwise_pool_work, &_pairwise_pool_mutex);
+            
+            continue;
+        
+        }
+        
+        i_task = _pairwise_pool_claim(job);
+        
+        _pairwise_pool_n_busy ++;
+        
+        pthread_mutex_unlock(&_pairwise_pool_mutex);
+        
+        job->f_task(job->a_tasks + (i_task * job->s_task));
+        
+        pthread_mutex_lock(&_pairwise_pool_mutex);
+        
+        _pairwise_pool_n_busy --;
+        
+        _pairwise_pool_finish(job);
+    
+    }
+    
+    pthread_mutex_unlock(&_pairwise_pool_mutex);
+    
+    return NULL;
+
+}
+
+#if defined(__linux__)
+
+/*******************************************************************************
+
+    Symbol: _pairwise_pool_read_list
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Reads the file at path, which must hold a list of numbers and ranges
+        of numbers in the format of the Linux sysfs, such as "0-3,8-11", into
+        set, as a set of CPUs or of NUMA nodes.
+        
+        Returns integer zero on success, or integer minus one if the file
+        could not be read. Not otherwise expected to fail.
+        
+*******************************************************************************/
+
+static int
+_pairwise_pool_read_list
+(
+
+    const char* path,
+    
+    cpu_set_t* set
+
+)
+{
+
+    FILE* file;
+    
+    char a_list[4096];
+    char* i_list;
+    
+    unsigned long i_lower;
+    unsigned long i_upper;
+    
+    CPU_ZERO(set);
+    
+    file = fopen(path, "r");
+    
+    if (!file) {
+        
+        return -1;
+    
+    }
+    
+    i_list = fgets(a_list, sizeof(a_list), file);
+    
+    fclose(file);
+    
+    if (!i_list) {
+        
+        return -1;
+    
+    }
+    
+    while (*i_list >= '0' && *i_list <= '9') {
+        
+        i_lower = strtoul(i_list, &i_list, 10);
+        i_upper = i_lower;
+        
+        if (*i_list == '-') {
+            
+            i_upper = strtoul(i_list + 1, &i_list, 10);
+        
+        }
+        
+        for (; i_lower <= i_upper && i_lower < CPU_SETSIZE; i_lower ++) {
+            
+            CPU_SET(i_lower, set);
+        
+        }
+        
+        if (*i_list == ',') {
+            
+            i_list ++;
+        
+        }
+    
+    }
+    
+    return 0;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_pool_map_places
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Allocates an array of sets of CPUs, a_places, and stores in it and in
+        n_places the places among which workers are spread under the
+        PAIRWISE_AFFINITY_* identifier n_affinity: for PAIRWISE_AFFINITY_CORES
+        each CPU the calling thread may run on, for PAIRWISE_AFFINITY_NODES
+        those CPUs of each NUMA node which has any, and otherwise all of
+        them, as a single place.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. If the CPUs of the calling thread could not be found,
+        returns PAIRWISE_RETURN_ERROR_AFFINITY, and on failure to allocate
+        a_places returns PAIRWISE_RETURN_MALLOC_FAIL.
+        
+    Further Information:
+    
+        The NUMA nodes and their CPUs are read from the Linux sysfs, so that
+        libpairwise needs no NUMA library. A host whose sysfs lists no nodes,
+        or none with any CPUs of the calling thread, is treated as a single
+        node.
+        
+*******************************************************************************/
+
+static int
+_pairwise_pool_map_places
+(
+
+    int n_affinity,
+    
+    cpu_set_t** a_places,
+    size_t* n_places
+
+)
+{
+
+    cpu_set_t cpus;
+    cpu_set_t nodes;
+    cpu_set_t* place;
+    
+    char path[64];
+    
+    size_t n_slots;
+    size_t i_slot;
+    
+    if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpus)
+    ||  !CPU_COUNT(&cpus)) {
+        
+        return PAIRWISE_RETURN_ERROR_AFFINITY;
+    
+    }
+    
+    n_slots = 1;
+    
+    if (n_affinity == PAIRWISE_AFFINITY_CORES) {
+        
+        n_slots = CPU_COUNT(&cpus);
+    
+    }
+    
+    if (n_affinity == PAIRWISE_AFFINITY_NODES
+    &&  !_pairwise_pool_read_list("/sys/devices/system/node/online", &nodes)
+    &&  CPU_COUNT(&nodes)) {
+        
+        n_slots = CPU_COUNT(&nodes);
+    
+    }
+    
+    *a_places = malloc(n_slots * sizeof(cpu_set_t));
+    
+    if (!*a_places) {
+        
+        return PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    *n_places = 0;
+    
+    for (i_slot = 0; i_slot < CPU_SETSIZE && n_slots > 1; i_slot ++) {
+        
+        place = *a_places + *n_places;
+        
+        if (n_affinity == PAIRWISE_AFFINITY_CORES && CPU_ISSET(i_slot, &cpus)) {
+            
+            CPU_ZERO(place);
+            CPU_SET(i_slot, place);
+            
+            (*n_places) ++;
+        
+        }
+        
+        if (n_affinity == PAIRWISE_AFFINITY_NODES && CPU_ISSET(i_slot, &nodes)) {
+            
+            sprintf(path, "/sys/devices/system/node/node%lu/cpulist",
+                    (unsigned long)i_slot);
+                    
+            if (!_pairwise_pool_read_list(path, place)) {
+                
+                CPU_AND(place, place, &cpus);
+                
+                *n_places += CPU_COUNT(place) ? 1 : 0;
+            
+            }
+        
+        }
+    
+    }
+    
+    if (!*n_places) {
+        
+        **a_places = cpus;
+        
+        *n_places = 1;
+    
+    }
+    
+    return PAIRWISE_RETURN_SUCCESS;
+
+}
+
+#endif
+
+/*******************************************************************************
+
+    Symbol: _pairwise_pool_place
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Pins worker i_worker to its place under the current affinity, the
+        place after it in _pairwise_pool_places, round-robin. Place zero is
+        left to the thread which calls into libpairwise, since it always takes
+        part in its own calculations. The caller must hold
+        _pairwise_pool_resize_mutex.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns PAIRWISE_RETURN_ERROR_AFFINITY.
+        
+*******************************************************************************/
+
+static int
+_pairwise_pool_place
+(
+
+    size_t i_worker
+
+)
+{
+
+#if defined(__linux__)
+
+    cpu_set_t* place;
+    
+    if (!_pairwise_pool_n_places) {
+        
+        return PAIRWISE_RETURN_SUCCESS;
+    
+    }
+    
+    place = _pairwise_pool_places + ((i_worker + 1) % _pairwise_pool_n_places);
+    
+    if (pthread_setaffinity_np(*(_pairwise_pool_threads + i_worker),
+                               sizeof(cpu_set_t),
+                               place)) {
+                                   
+        return PAIRWISE_RETURN_ERROR_AFFINITY;
+    
+    }
+    
+#endif
+
+    return PAIRWISE_RETURN_SUCCESS;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_pool_resize_locked
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Grows or shrinks the worker pool to exactly n_workers threads. The
+        caller must hold _pairwise_pool_resize_mutex.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code;
+        the pool then keeps whichever workers were successfully created or
+        not yet joined.
+        
+    Further Information:
+    
+        Growing sets the new target before creating the new workers, so that
+        each sees itself as wanted as soon as it starts. Shrinking lowers the
+        target, wakes every idle worker so that the unwanted ones notice, and
+        then joins those from the highest index downwards.
+        
+*******************************************************************************/
+
+static int
+_pairwise_pool_resize_locked
+(
+
+    size_t n_workers
+
+)
+{
+
+    int n_return;
+    
+    size_t i_worker;
+    
+    pthread_t* a_threads;
+    
+    if (n_workers > _pairwise_pool_n_workers) {
+        
+        pthread_once(&_pairwise_pool_once, _pairwise_pool_register_after_fork);
+        
+        a_threads = realloc(_pairwise_pool_threads,
+                            n_workers * sizeof(pthread_t));
+                            
+        if (!a_threads) {
+            
+            return PAIRWISE_RETURN_MALLOC_FAIL;
+        
+        }
+        
+        _pairwise_pool_threads = a_threads;
+        
+        pthread_mutex_lock(&_pairwise_pool_mutex);
+        
+        _pairwise_pool_n_target = n_workers;
+        
+        pthread_mutex_unlock(&_pairwise_pool_mutex);
+        
+        for (i_worker = _pairwise_pool_n_workers;
+             i_worker < n_workers;
+             i_worker ++) {
+                 
+            n_return = pthread_create(_pairwise_pool_threads + i_worker,
+                                      NULL,
+                                      _pairwise_pool_worker,
+                                      (void*)i_worker);
+                                      
+            if (n_return) {
+                
+                /*
+                *   Keep the workers created so far, and lower the target to
+                *   match so that the pool's bookkeeping remains consistent.
+                */
+                
+                pthread_mutex_lock(&_pairwise_pool_mutex);
+                
+                _pairwise_pool_n_target = i_worker;
+                
+                pthread_mutex_unlock(&_pairwise_pool_mutex);
+                
+                switch (n_return) {
+                    
+                    case EAGAIN: return PAIRWISE_RETURN_PTHREAD_CREATE_EAGAIN;
+                    
+                    case EINVAL: return PAIRWISE_RETURN_PTHREAD_CREATE_EINVAL;
+                    
+                    case EPERM: return PAIRWISE_RETURN_PTHREAD_CREATE_EPERM;
+                    
+                    default: return PAIRWISE_RETURN_PTHREAD_CREATE_UNKNOWN;
+                
+                }
+            
+            }
+            
+            _pairwise_pool_n_workers = i_worker + 1;
+            
+            /*
+            *   Placement is best effort for workers created on demand: a
+            *   worker which cannot be pinned still runs, wherever the
+            *   operating system puts it.
+            */
+            
+            if (_pairwise_pool_affinity != PAIRWISE_AFFINITY_NONE) {
+                
+                _pairwise_pool_place(i_worker);
+            
+            }
+        
+        }
+        
+        return PAIRWISE_RETURN_SUCCESS;
+    
+    }
+    
+    pthread_mutex_lock(&_pairwise_pool_mutex);
+    
+    _pairwise_pool_n_target = n_workers;
+    
+    pthread_cond_broadcast(&_pairwise_pool_work);
+    
+    pthread_mutex_unlock(&_pairwise_pool_mutex);
+    
+    for (i_worker = _pairwise_pool_n_workers; i_worker > n_workers; i_worker --) {
+        
+        n_return = pthread_join(*(_pairwise_pool_threads + i_worker - 1), NULL);
+        
+        if (n_return) {
+            
+            switch (n_return) {
+                
+                case EDEADLK: return PAIRWISE_RETURN_PTHREAD_JOIN_EDEADLK;
+                
+                case EINVAL: return PAIRWISE_RETURN_PTHREAD_JOIN_EINVAL;
+                
+                case ESRCH: return PAIRWISE_RETURN_PTHREAD_JOIN_ESRCH;
+                
+                default: return PAIRWISE_RETURN_PTHREAD_JOIN_UNKNOWN;
+            
+            }
+        
+        }
+        
+        _pairwise_pool_n_workers = i_worker - 1;
+    
+    }
+    
+    if (!n_workers) {
+        
+        free(_pairwise_pool_threads);
+        
+        _pairwise_pool_threads = NULL;
+    
+    }
+    
+    return PAIRWISE_RETURN_SUCCESS;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_pool_resize
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Grows or shrinks the libpairwise worker pool to exactly n_workers
+        long-lived threads. Workers removed by shrinking first finish any task
+        they are running, and help to run any task already queued. Passing
+        zero is equivalent to calling pairwise_pool_shutdown().
+        
+        Calling this function is never required: the pool grows on demand to
+        n_threads - 1 workers whenever a calculation asks for n_threads
+        threads, since the calling thread always takes part itself.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code;
+        the pool then keeps whichever workers were successfully created or
+        not yet joined.
+        
+*******************************************************************************/
+
+int
+pairwise_pool_resize
+(
+
+    size_t n_workers
+
+)
+{
+
+    int n_return;
+    
+    pthread_mutex_lock(&_pairwise_pool_resize_mutex);
+    
+    n_return = _pairwise_pool_resize_locked(n_workers);
+    
+    pthread_mutex_unlock(&_pairwise_pool_resize_mutex);
+    
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_pool_size
+    
+    Type: Function returning size_t
+    
+    Intent: Public
+    
+    Description:
+    
+        Returns the number of worker threads currently in the libpairwise
+        worker pool. Not expected to fail.
+        
+*******************************************************************************/
+
+size_t
+pairwise_pool_size
+(void)
+{
+
+    size_t n_workers;
+    
+    pthread_mutex_lock(&_pairwise_pool_resize_mutex);
+    
+    n_workers = _pairwise_pool_n_workers;
+    
+    pthread_mutex_unlock(&_pairwise_pool_resize_mutex);
+    
+    return n_workers;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_pool_shutdown
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Stops and joins every worker thread in the libpairwise worker pool,
+        releasing their resources. Subsequent calculations recreate workers
+        on demand.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+*******************************************************************************/
+
+int
+pairwise_pool_shutdown
+(void)
+{
+
+    return pairwise_pool_resize(0);
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_pool_set_affinity
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Selects how the workers of the libpairwise worker pool are placed on
+        the CPUs which the calling thread may run on. n_affinity is one of
+        PAIRWISE_AFFINITY_*. Applies at once to every existing worker, and to
+        every worker created later.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. If n_affinity is not a recognised identifier, or the
+        host does not support pinning threads, returns
+        PAIRWISE_RETURN_ERROR_AFFINITY, and on failure to allocate memory
+        returns PAIRWISE_RETURN_MALLOC_FAIL, leaving the current selection
+        unchanged in either case. If some worker could not be pinned, returns
+        PAIRWISE_RETURN_ERROR_AFFINITY having made the selection nonetheless.
+        
+    Further Information:
+    
+        The CPUs are those of the calling thread when this function is
+        called, so a process confined to part of a host, for example by
+        taskset or a container, is only ever spread over that part.
+        
+*******************************************************************************/
+
+int
+pairwise_pool_set_affinity
+(
+
+    int n_affinity
+
+)
+{
+
+    int n_return;
+    int n_return_place;
+    
+    size_t i_worker;
+    
+#if defined(__linux__)
+
+    cpu_set_t* a_places;
+    
+    size_t n_places;
+    
+#endif
+
+    if (n_affinity != PAIRWISE_AFFINITY_NONE
+    &&  n_affinity != PAIRWISE_AFFINITY_CORES
+    &&  n_affinity != PAIRWISE_AFFINITY_NODES) {
+        
+        return PAIRWISE_RETURN_ERROR_AFFINITY;
+    
+    }
+    
+    pthread_mutex_lock(&_pairwise_pool_resize_mutex);
+    
+#if defined(__linux__)
+
+    n_return = _pairwise_pool_map_places(n_affinity, &a_places, &n_places);
+    
+    if (n_return) {
+        
+        pthread_mutex_unlock(&_pairwise_pool_resize_mutex);
+        
+        return n_return;
+    
+    }
+    
+    free(_pairwise_pool_places);
+    
+    _pairwise_pool_places = a_places;
+    _pairwise_pool_n_places = n_places;
+    
+#else
+
+    if (n_affinity != PAIRWISE_AFFINITY_NONE) {
+        
+        pthread_mutex_unlock(&_pairwise_pool_resize_mutex);
+        
+        return PAIRWISE_RETURN_ERROR_AFFINITY;
+    
+    }
+    
+#endif
+
+    _pairwise_pool_affinity = n_affinity;
+    
+    /*
+    *   Under PAIRWISE_AFFINITY_NONE every worker's place is all the CPUs of
+    *   the calling thread, which undoes any earlier pinning.
+    */
+    
+    n_return = PAIRWISE_RETURN_SUCCESS;
+    
+    for (i_worker = 0; i_worker < _pairwise_pool_n_workers; i_worker ++) {
+        
+        n_return_place = _pairwise_pool_place(i_worker);
+        
+        if (!n_return) {
+            
+            n_return = n_return_place;
+        
+        }
+    
+    }
+    
+    pthread_mutex_unlock(&_pairwise_pool_resize_mutex);
+    
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_pool_get_affinity
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Returns the PAIRWISE_AFFINITY_* identifier last selected by
+        pairwise_pool_set_affinity(), or PAIRWISE_AFFINITY_NONE if it has
+        never been called. Not expected to fail.
+        
+*******************************************************************************/
+
+int
+pairwise_pool_get_affinity
+(void)
+{
+
+    int n_affinity;
+    
+    pthread_mutex_lock(&_pairwise_pool_resize_mutex);
+    
+    n_affinity = _pairwise_pool_affinity;
+    
+    pthread_mutex_unlock(&_pairwise_pool_resize_mutex);
+    
+    return n_affinity;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_pool_enqueue
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Initialises job to describe n_tasks tasks, each a call to f_task with
+        the pointer a_tasks + (i_task * s_task), grows the pool first if it
+        has fewer than n_workers workers, or if b_idle is set, fewer than
+        n_workers workers not already running a task, and queues job for the
+        workers.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero, with job queued; the caller must hold
+        _pairwise_pool_mutex on return, which this function locks. On failure
+        returns a non-zero libpairwise error code, having queued nothing and
+        without holding the mutex.
+        
+*******************************************************************************/
+
+static int
+_pairwise_pool_enqueue
+(
+
+    _pairwise_pool_job_t* job,
+    
+    void (*f_task)(void* task),
+    
+    void* a_tasks,
+    
+    size_t s_task,
+    size_t n_tasks,
+    
+    size_t n_workers,
+    
+    int b_idle
+
+)
+{
+
+    int n_return;
+    
+    pthread_mutex_lock(&_pairwise_pool_resize_mutex);
+    
+    n_return = PAIRWISE_RETURN_SUCCESS;
+    
+    if (b_idle) {
+        
+        pthread_mutex_lock(&_pairwise_pool_mutex);
+        
+        n_workers += _pairwise_pool_n_busy;
+        
+        pthread_mutex_unlock(&_pairwise_pool_mutex);
+    
+    }
+    
+    if (_pairwise_pool_n_workers < n_workers) {
+        
+        n_return = _pairwise_pool_resize_locked(n_workers);
+    
+    }
+    
+    pthread_mutex_unlock(&_pairwise_pool_resize_mutex);
+    
+    if (n_return) {
+        
+        return n_return;
+    
+    }
+    
+    job->f_task = f_task;
+    
+    job->a_tasks = a_tasks;
+    
+    job->s_task = s_task;
+    job->n_tasks = n_tasks;
+    
+    job->i_task_next = 0;
+    job->n_tasks_done = 0;
+    
+    job->next = NULL;
+    
+    if (pthread_cond_init(&job->done, NULL)) {
+        
+        return PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    pthread_mutex_lock(&_pairwise_pool_mutex);
+    
+    if (_pairwise_pool_tail) {
+        
+        _pairwise_pool_tail->next = job;
+    
+    } else {
+        
+        _pairwise_pool_head = job;
+    
+    }
+    
+    _pairwise_pool_tail = job;
+    
+    pthread_cond_broadcast(&_pairwise_pool_work);
+    
+    return PAIRWISE_RETURN_SUCCESS;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_pool_run
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Runs n_tasks tasks, each a call to f_task with the pointer
+        a_tasks + (i_task * s_task), on the libpairwise worker pool and on the
+        calling thread, and returns once all have finished. Grows the pool to
+        n_tasks - 1 workers first if it is smaller.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure to grow the pool returns a non-zero
+        libpairwise error code without having run any task.
+        
+    Further Information:
+    
+        The job describing the tasks lives on this function's stack, which is
+        safe because this function does not return until every task has
+        finished. The calling thread claims tasks from its own job alongside
+        the workers rather than sleeping, so a job always makes progress even
+        if the pool is shrunk or shut down while it runs, and several threads
+        may run jobs on the same pool at once.
+        
+*******************************************************************************/
+
+int
+_pairwise_pool_run
+(
+
+    void (*f_task)(void* task),
+    
+    void* a_tasks,
+    
+    size_t s_task,
+    size_t n_tasks
+
+)
+{
+
+    int n_return;
+    
+    size_t i_task;
+    
+    _pairwise_pool_job_t job;
+    
+    if (!n_tasks) {
+        
+        return PAIRWISE_RETURN_SUCCESS;
+    
+    }
+    
+    /*
+    *   A single task gains nothing from the pool, so run it directly.
+    */
+    
+    if (n_tasks == 1) {
+        
+        f_task(a_tasks);
+        
+        return PAIRWISE_RETURN_SUCCESS;
+    
+    }
+    
+    n_return = _pairwise_pool_enqueue(&job, f_task, a_tasks, s_task, n_tasks, n_tasks - 1, 0);
+    
+    if (n_return) {
+        
+        return n_return;
+    
+    }
+    
+    while (job.i_task_next < job.n_tasks) {
+        
+        i_task = _pairwise_pool_claim(&job);
+        
+        pthread_mutex_unlock(&_pairwise_pool_mutex);
+        
+        f_task(job.a_tasks + (i_task * s_task));
+        
+        pthread_mutex_lock(&_pairwise_pool_mutex);
+        
+        _pairwise_pool_finish(&job);
+    
+    }
+    
+    while (job.n_tasks_done < job.n_tasks) {
+        
+        pthread_cond_wait(&job.done, &_pairwise_pool_mutex);
+    
+    }
+    
+    pthread_mutex_unlock(&_pairwise_pool_mutex);
+    
+    pthread_cond_destroy(&job.done);
+    
+    return PAIRWISE_RETURN_SUCCESS;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_pool_submit
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Queues n_tasks tasks, each a call to f_task with the pointer
+        a_tasks + (i_task * s_task), to be run on the libpairwise worker pool
+        alone, describing them in job, and returns at once. Grows the pool
+        first if fewer than n_tasks of its workers are idle, since the
+        calling thread takes no part.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero; job and the tasks must then stay valid until
+        _pairwise_pool_wait() has found every task finished, and the caller
+        must then pass job to _pairwise_pool_forget(). On failure to grow the
+        pool returns a non-zero libpairwise error code, having queued
+        nothing.
+        
+    Further Information:
+    
+        Workers removed from the pool while job is queued first help to claim
+        its remaining tasks, so job finishes even if the pool is shut down.
+        
+        Idle workers are counted rather than all workers because a busy one
+        may not be free again for as long as the caller likes: the workers of
+        an open stream wait inside their tasks for its reader to take tiles,
+        and if that reader is waiting for job in turn, only workers beyond
+        them can ever run it.
+        
+*******************************************************************************/
+
+int
+_pairwise_pool_submit
+(
+
+    _pairwise_pool_job_t* job,
+    
+    void (*f_task)(void* task),
+    
+    void* a_tasks,
+    
+    size_t s_task,
+    size_t n_tasks
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_pool_enqueue(job, f_task, a_tasks, s_task, n_tasks, n_tasks, 1);
+    
+    if (n_return) {
+        
+        return n_return;
+    
+    }
+    
+    pthread_mutex_unlock(&_pairwise_pool_mutex);
+    
+    return PAIRWISE_RETURN_SUCCESS;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_pool_wait
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Waits for every task of job, as submitted by _pairwise_pool_submit(),
+        to finish, or until the absolute time deadline, of the realtime
+        clock, has passed. A null deadline waits for as long as it takes, and
+        any deadline already passed returns at once. Any number of threads
+        may wait for the same job at once.
+        
+        Returns integer one if every task has finished, or integer zero if
+        the deadline passed first. Not expected to fail.
+        
+*******************************************************************************/
+
+int
+_pairwise_pool_wait
+(
+
+    _pairwise_pool_job_t* job,
+    
+    const struct timespec* deadline
+
+)
+{
+
+    int b_done;
+    
+    pthread_mutex_lock(&_pairwise_pool_mutex);
+    
+    while (job->n_tasks_done < job->n_tasks) {
+        
+        if (!deadline) {
+            
+            pthread_cond_wait(&job->done, &_pairwise_pool_mutex);
+        
+        } else if (pthread_cond_timedwait(&job->done, &_pairwise_pool_mutex, deadline)) {
+            
+            break;
+        
+        }
+    
+    }
+    
+    b_done = job->n_tasks_done == job->n_tasks;
+    
+    pthread_mutex_unlock(&_pairwise_pool_mutex);
+    
+    return b_done;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_pool_forget
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Releases the resources of job, as submitted by
+        _pairwise_pool_submit(), once _pairwise_pool_wait() has found every
+        task of job finished and no thread waits for it any longer.
+        
+        Returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+void
+_pairwise_pool_forget
+(
+
+    _pairwise_pool_job_t* job
+
+)
+{
+
+    pthread_cond_destroy(&job->done);
+
+}
@@ -0,0 +1,748 @@
+#include "pairwise_reduce.h"
+
+/*******************************************************************************
+
+    Symbol: _pairwise_reduction_allocate
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Allocates the counts and sums of reduction which were asked for, all
+        zero.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure records and returns
+        PAIRWISE_RETURN_MALLOC_FAIL.
+        
+*******************************************************************************/
+
+static int
+_pairwise_reduction_allocate
+(
+
+    _pairwise_reduction_t* reduction
+
+)
+{
+
+    if (reduction->b_counts) {
+        
+        reduction->a_counts = calloc(reduction->n_bins, sizeof(size_t));
+    
+    }
+    
+    if (reduction->b_sums) {
+        
+        reduction->a_sums = calloc(reduction->n_collections, sizeof(double));
+    
+    }
+    
+    if ((reduction->b_counts && !reduction->a_counts)
+    ||  (reduction->b_sums && !reduction->a_sums)) {
+        
+        free(reduction->a_counts);
+        free(reduction->a_sums);
+        
+        reduction->a_counts = NULL;
+        reduction->a_sums = NULL;
+        
+        reduction->n_return = PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    return reduction->n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_reduction_offer
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Offers result, that of the pairwise calculation between collections
+        i_collection_a and i_collection_b, to every reduction of reduction.
+        
+        Returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+static void
+_pairwise_reduction_offer
+(
+
+    _pairwise_reduction_t* reduction,
+    
+    size_t i_collection_a,
+    size_t i_collection_b,
+    
+    double result
+
+)
+{
+
+    double shifted;
+    
+    size_t i_bin;
+    
+    if (!reduction->n_results) {
+        
+        reduction->shift = result;
+        
+        reduction->minimum = result;
+        reduction->maximum = result;
+    
+    }
+    
+    reduction->n_results ++;
+    
+    shifted = result - reduction->shift;
+    
+    reduction->sum += shifted;
+    reduction->sum_squares += shifted * shifted;
+    
+    if (result < reduction->minimum) {
+        
+        reduction->minimum = result;
+    
+    }
+    
+    if (result > reduction->maximum) {
+        
+        reduction->maximum = result;
+    
+    }
+    
+    if (reduction->b_counts
+    &&  result >= reduction->lower
+    &&  result <= reduction->upper) {
+        
+        /*
+        *   A result on the upper edge of the range belongs to the last bin,
+        *   as does one which rounding puts just past it.
+        */
+        
+        i_bin = (result - reduction->lower) * reduction->scale;
+        
+        if (i_bin >= reduction->n_bins) {
+            
+            i_bin = reduction->n_bins - 1;
+        
+        }
+        
+        (*(reduction->a_counts + i_bin)) ++;
+    
+    }
+    
+    if (reduction->b_sums) {
+        
+        *(reduction->a_sums + i_collection_a) += result;
+        *(reduction->a_sums + i_collection_b) += result;
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_row_reduce
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Row driver for job->f_row. Carries out the pairwise calculations
+        between collection i_collection_a of job and each of collections
+        i_collection_b_lower up to but excluding i_collection_b_upper, by
+        calling job->f_calculation on doubles, and offers each result to the
+        reductions of sink, a _pairwise_reduction_t. a_results_row is
+        ignored.
+        
+        On success returns nothing. On failure to allocate the counts or sums
+        of sink, records PAIRWISE_RETURN_MALLOC_FAIL in it.
+        
+*******************************************************************************/
+
+void
+_pairwise_launch_row_reduce
+(
+
+    _pairwise_job_t* job,
+    
+    void* sink,
+    
+    size_t i_collection_a,
+    size_t i_collection_b_lower,
+    size_t i_collection_b_upper,
+    
+    void* a_results_row
+
+)
+{
+
+    double (*f_calculation)(size_t n_points,
+                            size_t n_coordinates,
+                            double* collection_a,
+                            double* collection_b);
+                            
+    _pairwise_reduction_t* reduction;
+    
+    double* a_collections;
+    double* a_collections_b;
+    
+    double* collection_a;
+    double* collection_b;
+    
+    double result;
+    
+    size_t n_points;
+    size_t n_coordinates;
+    
+    size_t i_collection_b;
+    
+    reduction = sink;
+    
+    if (reduction->n_return) {
+        
+        return;
+    
+    }
+    
+    if (((reduction->b_counts && !reduction->a_counts)
+    ||   (reduction->b_sums && !reduction->a_sums))
+    &&  _pairwise_reduction_allocate(reduction)) {
+        
+        return;
+    
+    }
+    
+    f_calculation = job->f_calculation;
+    
+    a_collections = job->a_collections;
+    a_collections_b = job->a_collections_b;
+    
+    n_points = job->n_points;
+    n_coordinates = job->n_coordinates;
+    
+    collection_a = a_collections + (i_collection_a * n_points * n_coordinates);
+    
+    for (i_collection_b = i_collection_b_lower;
+         i_collection_b < i_collection_b_upper;
+         i_collection_b ++) {
+             
+        collection_b = a_collections_b + (i_collection_b * n_points * n_coordinates);
+        
+        result = f_calculation(n_points, n_coordinates, collection_a, collection_b);
+        
+        _pairwise_reduction_offer(reduction, i_collection_a, i_collection_b, result);
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_row_reduce_float
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch_row_reduce(), but calling
+        job->f_calculation_float on floats.
+        
+*******************************************************************************/
+
+void
+_pairwise_launch_row_reduce_float
+(
+
+    _pairwise_job_t* job,
+    
+    void* sink,
+    
+    size_t i_collection_a,
+    size_t i_collection_b_lower,
+    size_t i_collection_b_upper,
+    
+    void* a_results_row
+
+)
+{
+
+    float (*f_calculation)(size_t n_points,
+                           size_t n_coordinates,
+                           float* collection_a,
+                           float* collection_b);
+                           
+    _pairwise_reduction_t* reduction;
+    
+    float* a_collections;
+    float* a_collections_b;
+    
+    float* collection_a;
+    float* collection_b;
+    
+    float result;
+    
+    size_t n_points;
+    size_t n_coordinates;
+    
+    size_t i_collection_b;
+    
+    reduction = sink;
+    
+    if (reduction->n_return) {
+        
+        return;
+    
+    }
+    
+    if (((reduction->b_counts && !reduction->a_counts)
+    ||   (reduction->b_sums && !reduction->a_sums))
+    &&  _pairwise_reduction_allocate(reduction)) {
+        
+        return;
+    
+    }
+    
+    f_calculation = job->f_calculation_float;
+    
+    a_collections = job->a_collections;
+    a_collections_b = job->a_collections_b;
+    
+    n_points = job->n_points;
+    n_coordinates = job->n_coordinates;
+    
+    collection_a = a_collections + (i_collection_a * n_points * n_coordinates);
+    
+    for (i_collection_b = i_collection_b_lower;
+         i_collection_b < i_collection_b_upper;
+         i_collection_b ++) {
+             
+        collection_b = a_collections_b + (i_collection_b * n_points * n_coordinates);
+        
+        result = f_calculation(n_points, n_coordinates, collection_a, collection_b);
+        
+        _pairwise_reduction_offer(reduction, i_collection_a, i_collection_b, result);
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_reduce_job
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Carries out every pairwise calculation described by job, whose
+        calculation, reduction row driver, input array and dimensions must
+        already be set, over n_threads threads, and reduces the results into
+        a_statistics, a_counts and a_sums as described for
+        _pairwise_launch_reduce().
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+    Further Information:
+    
+        Every thread reduces the results of its own chunks into a sink of its
+        own, so threads never wait on one another, and memory grows with
+        n_threads * (n_bins + n_collections) rather than with the number of
+        pairwise calculations. Once every chunk is done, the sinks are merged:
+        counts and sums simply add, and the mean and variance of each thread
+        are combined pairwise by the method of Chan, Golub and LeVeque, so
+        that no sum of squares of unshifted results is ever formed.
+        
+*******************************************************************************/
+
+static int
+_pairwise_launch_reduce_job
+(
+
+    _pairwise_job_t* job,
+    
+    double* a_statistics,
+    
+    double lower,
+    double upper,
+    size_t n_bins,
+    size_t* a_counts,
+    
+    double* a_sums,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    _pairwise_reduction_t* a_sinks;
+    _pairwise_reduction_t* reduction;
+    
+    size_t n_collections;
+    size_t n_sinks;
+    size_t n_results;
+    
+    double minimum;
+    double maximum;
+    double mean;
+    double m2;
+    
+    double mean_sink;
+    double m2_sink;
+    double delta;
+    
+    size_t i_sink;
+    size_t i_bin;
+    size_t i_collection;
+    
+    n_collections = job->n_collections;
+    
+    if (a_counts && (!n_bins || !(lower < upper))) {
+        
+        return PAIRWISE_RETURN_ERROR_RANGE;
+    
+    }
+    
+    /*
+    *   Give every thread a sink of its own. (A request for zero threads is
+    *   refused by _pairwise_launch_job(), but still needs a sink here.)
+    */
+    
+    n_sinks = n_threads ? n_threads : 1;
+    
+    a_sinks = calloc(n_sinks, sizeof(_pairwise_reduction_t));
+    
+    if (!a_sinks) {
+        
+        return PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    for (i_sink = 0; i_sink < n_sinks; i_sink ++) {
+        
+        reduction = a_sinks + i_sink;
+        
+        reduction->n_collections = n_collections;
+        reduction->n_bins = n_bins;
+        
+        reduction->lower = lower;
+        reduction->upper = upper;
+        reduction->scale = n_bins / (upper - lower);
+        
+        reduction->b_counts = a_counts != NULL;
+        reduction->b_sums = a_sums != NULL;
+    
+    }
+    
+    job->a_results = NULL;
+    
+    job->a_sinks = a_sinks;
+    job->s_sink = sizeof(_pairwise_reduction_t);
+    
+    job->cutoff = 0;
+    
+    job->b_cross = 0;
+    job->b_append = 0;
+    
+    n_return = _pairwise_launch_job(job, n_threads);
+    
+    for (i_sink = 0; i_sink < n_sinks && !n_return; i_sink ++) {
+        
+        n_return = (a_sinks + i_sink)->n_return;
+    
+    }
+    
+    /*
+    *   Merge the reductions of every thread which was offered any results.
+    */
+    
+    n_results = 0;
+    
+    minimum = 0;
+    maximum = 0;
+    mean = 0;
+    m2 = 0;
+    
+    for (i_bin = 0; i_bin < n_bins && a_counts && !n_return; i_bin ++) {
+        
+        *(a_counts + i_bin) = 0;
+    
+    }
+    
+    for (i_collection = 0;
+         i_collection < n_collections && a_sums && !n_return;
+         i_collection ++) {
+             
+        *(a_sums + i_collection) = 0;
+    
+    }
+    
+    for (i_sink = 0; i_sink < n_sinks && !n_return; i_sink ++) {
+        
+        reduction = a_sinks + i_sink;
+        
+        if (!reduction->n_results) {
+            
+            continue;
+        
+        }
+        
+        mean_sink = reduction->sum / reduction->n_results;
+        m2_sink = reduction->sum_squares - (reduction->sum * mean_sink);
+        
+        mean_sink += reduction->shift;
+        
+        if (m2_sink < 0) {
+            
+            m2_sink = 0;
+        
+        }
+        
+        if (!n_results || reduction->minimum < minimum) {
+            
+            minimum = reduction->minimum;
+        
+        }
+        
+        if (!n_results || reduction->maximum > maximum) {
+            
+            maximum = reduction->maximum;
+        
+        }
+        
+        delta = mean_sink - mean;
+        
+        n_results += reduction->n_results;
+        
+        mean += delta * ((double)reduction->n_results / n_results);
+        m2 += m2_sink + (delta * (mean_sink - mean) * reduction->n_results);
+        
+        for (i_bin = 0; i_bin < n_bins && a_counts; i_bin ++) {
+            
+            *(a_counts + i_bin) += *(reduction->a_counts + i_bin);
+        
+        }
+        
+        for (i_collection = 0;
+             i_collection < n_collections && a_sums;
+             i_collection ++) {
+                 
+            *(a_sums + i_collection) += *(reduction->a_sums + i_collection);
+        
+        }
+    
+    }
+    
+    if (a_statistics && !n_return) {
+        
+        *(a_statistics + 0) = n_results ? minimum : NAN;
+        *(a_statistics + 1) = n_results ? maximum : NAN;
+        *(a_statistics + 2) = n_results ? mean : NAN;
+        *(a_statistics + 3) = n_results ? m2 / n_results : NAN;
+    
+    }
+    
+    for (i_sink = 0; i_sink < n_sinks; i_sink ++) {
+        
+        free((a_sinks + i_sink)->a_counts);
+        free((a_sinks + i_sink)->a_sums);
+    
+    }
+    
+    free(a_sinks);
+    
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_reduce
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Applies a calculation function, f_calculation, to all pairwise
+        combinations of collections in a set of collections, a_collections,
+        as _pairwise_launch() does, but stores no result, and instead reduces
+        them all at once to whichever of three summaries are asked for.
+        
+        n_collections, n_points, n_coordinates, a_collections and n_threads
+        are as for _pairwise_launch().
+        
+        If a_statistics is not a null pointer, it must have room for four
+        elements, which are set to the minimum, maximum, mean and variance
+        of all results, in that order. The variance is that of the results
+        themselves, dividing by their number rather than by one less. If
+        there are no results, all four are set to NaN.
+        
+        If a_counts is not a null pointer, it must have room for n_bins
+        elements, which must be at least one, and lower must be less than
+        upper. The range from lower to upper is split into n_bins equal bins,
+        each including its lower edge but not its upper edge, except for the
+        last, which includes both; element i of a_counts is set to the number
+        of results within bin i. Results outside the range are not counted.
+        
+        If a_sums is not a null pointer, it must have room for n_collections
+        elements, and element i is set to the sum of the results of every
+        pairwise calculation between collection i and any other.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. If a_counts is given with no bins or an empty range,
+        returns PAIRWISE_RETURN_ERROR_RANGE. On any other failure returns a
+        non-zero libpairwise error code, and makes no guarantee about the
+        state of a_statistics, a_counts or a_sums.
+        
+    Further Information:
+    
+        This function describes the calculation in a _pairwise_job_t with
+        the row driver _pairwise_launch_row_reduce(), and passes it to
+        _pairwise_launch_reduce_job().
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_reduce
+(
+
+    double (*f_calculation)(size_t n_points,
+                            size_t n_coordinates,
+                            double* collection_a,
+                            double* collection_b),
+                            
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    
+    double* a_statistics,
+    
+    double lower,
+    double upper,
+    size_t n_bins,
+    size_t* a_counts,
+    
+    double* a_sums,
+    
+    size_t n_threads
+
+)
+{
+
+    _pairwise_job_t job;
+    
+    job.f_calculation = f_calculation;
+    job.f_calculation_float = NULL;
+    job.f_row = _pairwise_launch_row_reduce;
+    
+    job.a_collections = a_collections;
+    
+    job.s_element = sizeof(double);
+    
+    job.n_collections = n_collections;
+    job.n_points = n_points;
+    job.n_coordinates = n_coordinates;
+    
+    return _pairwise_launch_reduce_job(&job,
+                                       a_statistics,
+                                       lower,
+                                       upper,
+                                       n_bins,
+                                       a_counts,
+                                       a_sums,
+                                       n_threads);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_reduce_float
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch_reduce(), but for a calculation on collections of
+        floats, f_calculation. Results are reduced in double precision
+        nonetheless.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_reduce_float
+(
+
+    float (*f_calculation)(size_t n_points,
+                           size_t n_coordinates,
+                           float* collection_a,
+                           float* collection_b),
+                           
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    
+    double* a_statistics,
+    
+    double lower,
+    double upper,
+    size_t n_bins,
+    size_t* a_counts,
+    
+    double* a_sums,
+    
+    size_t n_threads
+
+)
+{
+
+    _pairwise_job_t job;
+    
+    job.f_calculation = NULL;
+    job.f_calculation_float = f_calculation;
+    job.f_row = _pairwise_launch_row_reduce_float;
+    
+    job.a_collections = a_collections;
+    
+    job.s_element = sizeof(float);
+    
+    job.n_collections = n_collections;
+    job.n_points = n_points;
+    job.n_coordinates = n_coordinates;
+    
+    return _pairwise_launch_reduce_job(&job,
+                                       a_statistics,
+                                       lower,
+                                       upper,
+                                       n_bins,
+                                       a_counts,
+                                       a_sums,
+                                       n_threads);
+
+}
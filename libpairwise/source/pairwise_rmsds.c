@@ -86,72 +86,1872 @@ pairwise_rmsds
 
 }
 
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_rmsds(), but for collections of points whose coordinates are
+        floats rather than doubles, with the RMSDs stored as floats. Arithmetic
+        is carried out in single precision throughout, which roughly halves the
+        memory traffic and doubles the number of coordinates handled per SIMD
+        instruction, at the cost of precision.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_rmsd_float() with
+        _pairwise_launch_float().
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_float
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    float* a_rmsds,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_float(_pairwise_single_rmsd_float,
+                                      n_collections,
+                                      n_points,
+                                      n_coordinates,
+                                      a_collections,
+                                      a_rmsds,
+                                      n_threads);
+                                      
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_cutoff
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Calculates, as pairwise_rmsds() does, all pairwise RMSDs across a set
+        of collections of points, but keeps only those no greater than
+        cutoff, in compressed sparse row (CSR) form. Memory is needed only for
+        the RMSDs kept, however many collections there are.
+        
+        n_collections, n_points, n_coordinates, a_collections and n_threads
+        are as for pairwise_rmsds(). On success allocates three arrays and
+        stores pointers to them in a_indptr, a_indices and a_rmsds; the caller
+        must free all three with free().
+        
+        *a_indptr holds n_collections + 1 offsets, and *a_indices and *a_rmsds
+        each hold (*a_indptr)[n_collections] elements. For each collection i,
+        elements (*a_indptr)[i] up to but excluding (*a_indptr)[i + 1] of
+        *a_indices hold, in increasing order, every collection j > i whose
+        RMSD from collection i is no greater than cutoff, and the same
+        elements of *a_rmsds hold those RMSDs.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code,
+        and allocates nothing.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_rmsd() with
+        _pairwise_launch_cutoff().
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_cutoff
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    
+    double cutoff,
+    
+    size_t** a_indptr,
+    size_t** a_indices,
+    double** a_rmsds,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_cutoff(_pairwise_single_rmsd,
+                                       n_collections,
+                                       n_points,
+                                       n_coordinates,
+                                       a_collections,
+                                       cutoff,
+                                       a_indptr,
+                                       a_indices,
+                                       a_rmsds,
+                                       n_threads);
+                                       
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_cutoff_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_rmsds_cutoff(), but for collections of points whose
+        coordinates are floats, with the RMSDs kept stored as floats.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_rmsd_float() with
+        _pairwise_launch_cutoff_float().
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_cutoff_float
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    
+    float cutoff,
+    
+    size_t** a_indptr,
+    size_t** a_indices,
+    float** a_rmsds,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_cutoff_float(_pairwise_single_rmsd_float,
+                                             n_collections,
+                                             n_points,
+                                             n_coordinates,
+                                             a_collections,
+                                             cutoff,
+                                             a_indptr,
+                                             a_indices,
+                                             a_rmsds,
+                                             n_threads);
+                                             
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_knn
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Calculates, as pairwise_rmsds() does, all pairwise RMSDs across a set
+        of collections, but keeps for each collection only the n_neighbours
+        other collections nearest to it. Memory is needed only for the RMSDs
+        kept, however many collections there are.
+        
+        n_collections, n_points, n_coordinates, a_collections and n_threads
+        are as for pairwise_rmsds(). n_neighbours must be less than
+        n_collections, unless it is zero. a_indices and a_rmsds must each
+        have room for n_collections * n_neighbours elements.
+        
+        For each collection i, elements i * n_neighbours up to but excluding
+        (i + 1) * n_neighbours of a_indices hold the n_neighbours collections
+        nearest to collection i, nearest first, and the same elements of
+        a_rmsds hold their RMSDs from it. Collections at equal RMSDs are
+        ordered by index.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_rmsd() with
+        _pairwise_launch_knn().
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_knn
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    
+    size_t n_neighbours,
+    
+    size_t* a_indices,
+    double* a_rmsds,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_knn(_pairwise_single_rmsd,
+                                    n_collections,
+                                    n_points,
+                                    n_coordinates,
+                                    a_collections,
+                                    n_neighbours,
+                                    a_indices,
+                                    a_rmsds,
+                                    n_threads);
+                                    
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_knn_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_rmsds_knn(), but for collections whose coordinates are
+        floats, with the RMSDs kept stored as floats.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_rmsd_float() with
+        _pairwise_launch_knn_float().
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_knn_float
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    
+    size_t n_neighbours,
+    
+    size_t* a_indices,
+    float* a_rmsds,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_knn_float(_pairwise_single_rmsd_float,
+                                          n_collections,
+                                          n_points,
+                                          n_coordinates,
+                                          a_collections,
+                                          n_neighbours,
+                                          a_indices,
+                                          a_rmsds,
+                                          n_threads);
+                                          
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_reduce
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Calculates, as pairwise_rmsds() does, all pairwise RMSDs across a set
+        of collections, but keeps none of them, reducing them instead as they
+        are calculated, as pairwise_distances_reduce() does with distances.
+        
+        n_collections, n_points, n_coordinates, a_collections and n_threads
+        are as for pairwise_rmsds(), and a_statistics, lower, upper, n_bins,
+        a_counts and a_sums as for pairwise_distances_reduce(), with a_sums
+        having room for n_collections elements.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_rmsd() with
+        _pairwise_launch_reduce().
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_reduce
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    
+    double* a_statistics,
+    
+    double lower,
+    double upper,
+    size_t n_bins,
+    size_t* a_counts,
+    
+    double* a_sums,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_reduce(_pairwise_single_rmsd,
+                                       n_collections,
+                                       n_points,
+                                       n_coordinates,
+                                       a_collections,
+                                       a_statistics,
+                                       lower,
+                                       upper,
+                                       n_bins,
+                                       a_counts,
+                                       a_sums,
+                                       n_threads);
+                                       
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_reduce_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_rmsds_reduce(), but for collections whose coordinates are
+        floats. The RMSDs are reduced in double precision nonetheless.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_rmsd_float() with
+        _pairwise_launch_reduce_float().
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_reduce_float
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    
+    double* a_statistics,
+    
+    double lower,
+    double upper,
+    size_t n_bins,
+    size_t* a_counts,
+    
+    double* a_sums,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_reduce_float(_pairwise_single_rmsd_float,
+                                             n_collections,
+                                             n_points,
+                                             n_coordinates,
+                                             a_collections,
+                                             a_statistics,
+                                             lower,
+                                             upper,
+                                             n_bins,
+                                             a_counts,
+                                             a_sums,
+                                             n_threads);
+                                             
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_linkage
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Clusters a set of collections by single linkage under the RMSD, as
+        pairwise_distances_linkage() does points under the Euclidean distance.
+        
+        n_collections, n_points, n_coordinates, a_collections and n_threads
+        are as for pairwise_rmsds(). a_linkage must have room for
+        (n_collections - 1) * 4 doubles.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_rmsd() with
+        _pairwise_launch_linkage().
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_linkage
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    
+    double* a_linkage,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_linkage(_pairwise_single_rmsd,
+                                        n_collections,
+                                        n_points,
+                                        n_coordinates,
+                                        a_collections,
+                                        a_linkage,
+                                        n_threads);
+                                        
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_linkage_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_rmsds_linkage(), but for collections whose coordinates
+        are floats. The linkage is stored in double precision nonetheless.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_rmsd_float() with
+        _pairwise_launch_linkage_float().
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_linkage_float
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    
+    double* a_linkage,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_linkage_float(_pairwise_single_rmsd_float,
+                                              n_collections,
+                                              n_points,
+                                              n_coordinates,
+                                              a_collections,
+                                              a_linkage,
+                                              n_threads);
+                                              
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_append
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Extends the RMSDs between every pair of n_collections_old collections,
+        as calculated by pairwise_rmsds(), to those between every pair of
+        n_collections_old + n_collections_new collections, as
+        pairwise_distances_append() does distances.
+        
+        a_collections holds all n_collections_old + n_collections_new
+        collections, old first, each of n_points points of n_coordinates
+        coordinates. a_rmsds_old and a_rmsds are as a_distances_old and
+        a_distances are for pairwise_distances_append().
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_rmsd() with
+        _pairwise_launch_append().
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_append
+(
+
+    size_t n_collections_old,
+    size_t n_collections_new,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    double* a_rmsds_old,
+    double* a_rmsds,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_append(_pairwise_single_rmsd,
+                                       n_collections_old,
+                                       n_collections_new,
+                                       n_points,
+                                       n_coordinates,
+                                       a_collections,
+                                       a_rmsds_old,
+                                       a_rmsds,
+                                       n_threads);
+                                       
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_append_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_rmsds_append(), but for collections whose coordinates are
+        floats, and RMSDs which are stored as floats.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_rmsd_float() with
+        _pairwise_launch_append_float().
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_append_float
+(
+
+    size_t n_collections_old,
+    size_t n_collections_new,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    float* a_rmsds_old,
+    float* a_rmsds,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_append_float(_pairwise_single_rmsd_float,
+                                             n_collections_old,
+                                             n_collections_new,
+                                             n_points,
+                                             n_coordinates,
+                                             a_collections,
+                                             a_rmsds_old,
+                                             a_rmsds,
+                                             n_threads);
+                                             
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_stream
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Calculates, as pairwise_rmsds() does, all pairwise RMSDs across a set
+        of collections, but hands them to the caller tile by tile, through a
+        stream, as threads finish them, so that however many collections
+        there are memory is needed only for a fixed number of tiles.
+        
+        n_collections, n_points, n_coordinates, a_collections and n_threads
+        are as for pairwise_rmsds(). Tiles span no more than
+        n_tile_collections collections a side, and no more than n_queue tiles
+        are in flight at once, threads waiting whenever the caller falls
+        behind; zero for either chooses it automatically. a_collections must
+        outlive the stream.
+        
+        On success stores a pointer to the new stream in stream, from which
+        tiles are read with pairwise_stream_next() and which must be passed
+        to pairwise_stream_close() once done with, and returns
+        PAIRWISE_RETURN_SUCCESS which is always equivalent to integer zero.
+        On failure returns a non-zero libpairwise error code.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_rmsd() with
+        _pairwise_launch_stream().
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_stream
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    
+    size_t n_tile_collections,
+    size_t n_queue,
+    
+    size_t n_threads,
+    
+    pairwise_stream_t** stream
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_stream(_pairwise_single_rmsd,
+                                       n_collections,
+                                       n_points,
+                                       n_coordinates,
+                                       a_collections,
+                                       n_tile_collections,
+                                       n_queue,
+                                       n_threads,
+                                       stream);
+                                       
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_stream_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_rmsds_stream(), but for collections whose coordinates are
+        floats, with the RMSDs handed over as floats.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_rmsd_float() with
+        _pairwise_launch_stream_float().
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_stream_float
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    
+    size_t n_tile_collections,
+    size_t n_queue,
+    
+    size_t n_threads,
+    
+    pairwise_stream_t** stream
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_stream_float(_pairwise_single_rmsd_float,
+                                             n_collections,
+                                             n_points,
+                                             n_coordinates,
+                                             a_collections,
+                                             n_tile_collections,
+                                             n_queue,
+                                             n_threads,
+                                             stream);
+                                             
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_submit
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Calculates, as pairwise_rmsds() does, all pairwise RMSDs across a set
+        of collections, but on the libpairwise worker pool alone, returning
+        at once with a future through which the calculation can be followed,
+        cancelled and waited for while the calling thread goes on with other
+        work.
+        
+        n_collections, n_points, n_coordinates, a_collections, a_rmsds and
+        n_threads are as for pairwise_rmsds(). a_collections and a_rmsds must
+        outlive the future, and a_rmsds must not be read until
+        pairwise_future_wait() has found the calculation complete.
+        
+        On success stores a pointer to the new future in future, which must
+        be passed to pairwise_future_close() once done with, and returns
+        PAIRWISE_RETURN_SUCCESS which is always equivalent to integer zero.
+        On failure returns a non-zero libpairwise error code.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_rmsd() with
+        _pairwise_launch_submit().
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_submit
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    double* a_rmsds,
+    
+    size_t n_threads,
+    
+    pairwise_future_t** future
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_submit(_pairwise_single_rmsd,
+                                       n_collections,
+                                       n_points,
+                                       n_coordinates,
+                                       a_collections,
+                                       a_rmsds,
+                                       n_threads,
+                                       future);
+                                       
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_submit_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_rmsds_submit(), but for collections whose coordinates are
+        floats, with the RMSDs stored as floats.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_rmsd_float() with
+        _pairwise_launch_submit_float().
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_submit_float
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    float* a_rmsds,
+    
+    size_t n_threads,
+    
+    pairwise_future_t** future
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_submit_float(_pairwise_single_rmsd_float,
+                                             n_collections,
+                                             n_points,
+                                             n_coordinates,
+                                             a_collections,
+                                             a_rmsds,
+                                             n_threads,
+                                             future);
+                                             
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_cross_rmsds
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Calculates the RMSD between every collection in one set,
+        a_collections_a, and every collection in another, a_collections_b,
+        rather than between every pair of collections in one set.
+        
+        n_collections_a and n_collections_b are the numbers of collections in
+        a_collections_a and a_collections_b, n_points is the number of points
+        per collection and n_coordinates the number of coordinates per point
+        in both. n_threads is as for pairwise_rmsds(). a_rmsds must be large
+        enough to store n_collections_a * n_collections_b doubles; the RMSD
+        between collection i of a_collections_a and collection j of
+        a_collections_b is stored in element i * n_collections_b + j, so
+        a_rmsds is a row-major n_collections_a by n_collections_b matrix.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_rmsd() with
+        _pairwise_launch_cross().
+        
+*******************************************************************************/
+
+int
+pairwise_cross_rmsds
+(
+
+    size_t n_collections_a,
+    size_t n_collections_b,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections_a,
+    double* a_collections_b,
+    double* a_rmsds,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_cross(_pairwise_single_rmsd,
+                                      n_collections_a,
+                                      n_collections_b,
+                                      n_points,
+                                      n_coordinates,
+                                      a_collections_a,
+                                      a_collections_b,
+                                      a_rmsds,
+                                      n_threads);
+                                      
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_cross_rmsds_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_cross_rmsds(), but for collections whose coordinates are
+        floats, with the RMSDs stored as floats.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_rmsd_float() with
+        _pairwise_launch_cross_float().
+        
+*******************************************************************************/
+
+int
+pairwise_cross_rmsds_float
+(
+
+    size_t n_collections_a,
+    size_t n_collections_b,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections_a,
+    float* a_collections_b,
+    float* a_rmsds,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    n_return = _pairwise_launch_cross_float(_pairwise_single_rmsd_float,
+                                            n_collections_a,
+                                            n_collections_b,
+                                            n_points,
+                                            n_coordinates,
+                                            a_collections_a,
+                                            a_collections_b,
+                                            a_rmsds,
+                                            n_threads);
+                                            
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_superposed
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Calculates all pairwise RMSDs across a set of collections of points in
+        three-dimensional space, as pairwise_rmsds() does, but after optimally
+        superposing each pair: that is, the smallest RMSD between the two
+        collections over every translation and rotation of one onto the
+        other.
+        
+        n_collections, n_points, a_collections, a_rmsds and n_threads are as
+        for pairwise_rmsds(). n_coordinates must be three.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code.
+        
+    Further Information:
+    
+        Every collection is first centred on its centroid, and the sum of the
+        squared norms of its centred points, G, calculated, once per
+        collection, by _pairwise_superpose_collections(). Each pairwise
+        calculation is then left only the inner products of the two centred
+        collections, from which _pairwise_single_rmsd_superposed() finds the
+        superposed RMSD by the quaternion characteristic polynomial (QCP)
+        method, without ever forming a rotation.
+        
+        This function wraps together _pairwise_single_rmsd_superposed() with
+        _pairwise_launch(), over the centred collections, each of which is
+        followed by its G as one more point.
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_superposed
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    double* a_rmsds,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    double* a_superposed;
+    
+    if (n_coordinates != 3) {
+        
+        return PAIRWISE_RETURN_ERROR_NCOORDINATES;
+    
+    }
+    
+    if (n_collections < 2 || !n_points) {
+        
+        return PAIRWISE_RETURN_SUCCESS;
+    
+    }
+    
+    a_superposed = _pairwise_superpose_collections(n_collections,
+                                                   n_points,
+                                                   a_collections);
+                                                   
+    if (!a_superposed) {
+        
+        return PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    n_return = _pairwise_launch(_pairwise_single_rmsd_superposed,
+                                n_collections,
+                                n_points + 1,
+                                n_coordinates,
+                                a_superposed,
+                                a_rmsds,
+                                n_threads);
+                                
+    free(a_superposed);
+    
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_rmsds_superposed_float
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        As pairwise_rmsds_superposed(), but for collections whose coordinates
+        are floats, with the RMSDs stored as floats.
+        
+    Further Information:
+    
+        This function wraps together _pairwise_single_rmsd_superposed_float()
+        with _pairwise_launch_float(), over collections centred by
+        _pairwise_superpose_collections_float().
+        
+*******************************************************************************/
+
+int
+pairwise_rmsds_superposed_float
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    float* a_rmsds,
+    
+    size_t n_threads
+
+)
+{
+
+    int n_return;
+    
+    float* a_superposed;
+    
+    if (n_coordinates != 3) {
+        
+        return PAIRWISE_RETURN_ERROR_NCOORDINATES;
+    
+    }
+    
+    if (n_collections < 2 || !n_points) {
+        
+        return PAIRWISE_RETURN_SUCCESS;
+    
+    }
+    
+    a_superposed = _pairwise_superpose_collections_float(n_collections,
+                                                         n_points,
+                                                         a_collections);
+                                                         
+    if (!a_superposed) {
+        
+        return PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    n_return = _pairwise_launch_float(_pairwise_single_rmsd_superposed_float,
+                                      n_collections,
+                                      n_points + 1,
+                                      n_coordinates,
+                                      a_superposed,
+                                      a_rmsds,
+                                      n_threads);
+                                      
+    free(a_superposed);
+    
+    return n_return;
+
+}
+
 /*******************************************************************************
 
     Symbol: _pairwise_single_rmsd
     
-    Type: Inline function returning double
+    Type: Function returning double
+    
+    Intent: Private
+    
+    Description:
+    
+        Calculates the single RMSD between two collections of points.
+        
+        n_points is the number of points per collection, and n_coordinates is
+        the number of coordinates per point. collection_a and collection_b are
+        pointers to arrays containing the coordinates of the two collections
+        involved in this calculation.
+        
+        On success returns the calculated RMSD. Not expected to fail.
+        
+    Further Information:
+    
+        Since the points of a collection are stored contiguously, the sum over
+        all points of their squared distances is just the sum of the squared
+        differences over n_points * n_coordinates consecutive doubles. That
+        sum is delegated to the kernel for the instruction set selected by
+        pairwise_set_isa(), or at load time, through
+        _pairwise_sum_squared_differences, except for collections of 2 or 4
+        points of 3 coordinates, which are summed inline by
+        _PAIRWISE_SUM_SQUARED_DIFFERENCES_6 and its kin, just as the row
+        drivers specialised for those shapes sum them.
+        
+        Only powers of two of points are so specialised, since dividing by
+        them gives the same result whether or not the compiler, knowing the
+        divisor, multiplies by its reciprocal instead. Larger collections are
+        left to the kernels, which sum them faster than scalar code can.
+        
+*******************************************************************************/
+
+_PAIRWISE_UNVECTORISED
+double
+_pairwise_single_rmsd
+(
+    
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* collection_a,
+    double* collection_b
+
+)
+{
+
+    double working;
+    
+    switch (n_coordinates == 3 ? n_points : 0) {
+        
+        case 2:
+        
+            working = _PAIRWISE_SUM_SQUARED_DIFFERENCES_6(collection_a, collection_b);
+            
+            break;
+            
+        case 4:
+        
+            working = _PAIRWISE_SUM_SQUARED_DIFFERENCES_12(collection_a, collection_b);
+            
+            break;
+            
+        default:
+        
+            working = _pairwise_sum_squared_differences(n_points * n_coordinates,
+                                                        collection_a,
+                                                        collection_b);
+    
+    }
+    
+    working /= n_points;
+    
+    working = sqrt(working);
+    
+    return working;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_single_rmsd_float
+    
+    Type: Function returning float
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_single_rmsd(), but for collections of floats. Compatible
+        with _pairwise_launch_float().
+        
+    Further Information:
+    
+        The sum of squared coordinate differences is delegated to the kernel
+        selected by pairwise_set_isa(), or at load time, through
+        _pairwise_sum_squared_differences_float, except for the shapes summed
+        inline by _pairwise_single_rmsd().
+        
+*******************************************************************************/
+
+_PAIRWISE_UNVECTORISED
+float
+_pairwise_single_rmsd_float
+(
+
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* collection_a,
+    float* collection_b
+
+)
+{
+
+    float working;
+    
+    switch (n_coordinates == 3 ? n_points : 0) {
+        
+        case 2:
+        
+            working = _PAIRWISE_SUM_SQUARED_DIFFERENCES_6(collection_a, collection_b);
+            
+            break;
+            
+        case 4:
+        
+            working = _PAIRWISE_SUM_SQUARED_DIFFERENCES_12(collection_a, collection_b);
+            
+            break;
+            
+        default:
+        
+            working = _pairwise_sum_squared_differences_float(n_points * n_coordinates,
+                                                              collection_a,
+                                                              collection_b);
+    
+    }
+    
+    working /= n_points;
+    
+    working = sqrtf(working);
+    
+    return working;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_superpose_collections
+    
+    Type: Function returning double*
     
     Intent: Private
     
     Description:
     
-        Calculates the single RMSD between two collections of points.
-        
-        n_points is the number of points per collection, and n_coordinates is
-        the number of coordinates per point. collection_a and collection_b are
-        pointers to arrays containing the coordinates of the two collections
-        involved in this calculation.
+        Prepares a set of n_collections collections of n_points points in
+        three-dimensional space, a_collections, for
+        _pairwise_single_rmsd_superposed(). Copies every collection, centred
+        on its centroid, to a new array, and follows it with one more point
+        whose first coordinate is G, the sum of the squared norms of the
+        centred points, and whose other coordinates are zero.
         
-        On success returns the calculated RMSD. Not expected to fail.
+        On success returns a pointer to the new array of
+        n_collections * (n_points + 1) points, which the caller must free. On
+        failure returns a null pointer.
         
 *******************************************************************************/
 
-inline double
-_pairwise_single_rmsd
+double*
+_pairwise_superpose_collections
 (
+
+    size_t n_collections,
+    size_t n_points,
+    
+    double* a_collections
+
+)
+{
+
+    double* a_superposed;
+    
+    double* collection;
+    double* superposed;
+    
+    double centroid[3];
+    
+    double g;
+    
+    size_t i_collection;
+    size_t i_point;
+    size_t i_coordinate;
+    
+    a_superposed = malloc(n_collections * (n_points + 1) * 3 * sizeof(double));
+    
+    if (!a_superposed) {
+        
+        return NULL;
+    
+    }
+    
+    for (i_collection = 0; i_collection < n_collections; i_collection ++) {
+        
+        collection = a_collections + (i_collection * n_points * 3);
+        superposed = a_superposed + (i_collection * (n_points + 1) * 3);
+        
+        for (i_coordinate = 0; i_coordinate < 3; i_coordinate ++) {
+            
+            centroid[i_coordinate] = 0;
+            
+            for (i_point = 0; i_point < n_points; i_point ++) {
+                
+                centroid[i_coordinate] += *(collection + (i_point * 3) + i_coordinate);
+            
+            }
+            
+            centroid[i_coordinate] /= n_points;
+        
+        }
+        
+        g = 0;
+        
+        for (i_point = 0; i_point < n_points * 3; i_point ++) {
+            
+            *(superposed + i_point) = *(collection + i_point) - centroid[i_point % 3];
+            
+            g += _PAIRWISE_SQUARE(*(superposed + i_point));
+        
+        }
+        
+        *(superposed + (n_points * 3)) = g;
+        *(superposed + (n_points * 3) + 1) = 0;
+        *(superposed + (n_points * 3) + 2) = 0;
+    
+    }
+    
+    return a_superposed;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_superpose_collections_float
+    
+    Type: Function returning float*
     
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_superpose_collections(), but for collections of floats.
+        Centroids and G are accumulated in double precision, and G is stored
+        as the sum of the first two coordinates of the extra point, a float
+        and the float nearest to its rounding error.
+        
+*******************************************************************************/
+
+float*
+_pairwise_superpose_collections_float
+(
+
+    size_t n_collections,
     size_t n_points,
-    size_t n_coordinates,
     
-    double* collection_a,
-    double* collection_b
+    float* a_collections
 
 )
 {
 
+    float* a_superposed;
+    
+    float* collection;
+    float* superposed;
+    
+    double centroid[3];
+    
+    double g;
+    
+    size_t i_collection;
     size_t i_point;
     size_t i_coordinate;
     
-    double working;
-    double point_distance_squared;
+    a_superposed = malloc(n_collections * (n_points + 1) * 3 * sizeof(float));
     
-    double coordinate_a;
-    double coordinate_b;
+    if (!a_superposed) {
+        
+        return NULL;
     
-    working = 0;
+    }
     
-    for (i_point = 0; i_point < n_points; i_point ++) {
+    for (i_collection = 0; i_collection < n_collections; i_collection ++) {
+        
+        collection = a_collections + (i_collection * n_points * 3);
+        superposed = a_superposed + (i_collection * (n_points + 1) * 3);
+        
+        for (i_coordinate = 0; i_coordinate < 3; i_coordinate ++) {
+            
+            centroid[i_coordinate] = 0;
+            
+            for (i_point = 0; i_point < n_points; i_point ++) {
+                
+                centroid[i_coordinate] += *(collection + (i_point * 3) + i_coordinate);
+            
+            }
+            
+            centroid[i_coordinate] /= n_points;
+        
+        }
         
-        point_distance_squared = 0;
+        g = 0;
         
-        for (i_coordinate = 0; i_coordinate < n_coordinates; i_coordinate ++) {
+        for (i_point = 0; i_point < n_points * 3; i_point ++) {
             
-            coordinate_a = *(collection_a + (i_point * n_coordinates) + i_coordinate);
-            coordinate_b = *(collection_b + (i_point * n_coordinates) + i_coordinate);
+            *(superposed + i_point) = *(collection + i_point) - centroid[i_point % 3];
             
-            point_distance_squared += _PAIRWISE_SQUARE(coordinate_a - coordinate_b);
+            g += _PAIRWISE_SQUARE((double)*(superposed + i_point));
         
         }
         
-        working += point_distance_squared;
+        /*
+        *   G is the difference of nearly equal terms in the superposed RMSD,
+        *   so a float would lose too much of it. Store it as a float and the
+        *   float nearest to what that float lost.
+        */
+        
+        *(superposed + (n_points * 3)) = g;
+        *(superposed + (n_points * 3) + 1) = g - *(superposed + (n_points * 3));
+        *(superposed + (n_points * 3) + 2) = 0;
     
     }
     
-    working /= n_points;
+    return a_superposed;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_qcp_rmsd
     
-    working = sqrt(working);
+    Type: Static function returning double
     
-    return working;
+    Intent: Private
+    
+    Description:
+    
+        Finds the RMSD between two centred collections of n_points points
+        in three-dimensional space after optimal rotation, from the sums of
+        the squared norms of their points, g_a and g_b, and the nine inner
+        products of their coordinates, a_inner, in which element
+        (3 * i) + j is the sum over all points of coordinate i of the first
+        collection times coordinate j of the second.
+        
+        On success returns the superposed RMSD. Not expected to fail.
+        
+    Further Information:
+    
+        This is the quaternion characteristic polynomial (QCP) method of
+        Theobald (Acta Cryst. A61, 2005) as refined by Liu, Agrafiotis and
+        Theobald (J. Comput. Chem. 31, 2010). The superposed RMSD follows from
+        the largest eigenvalue of a symmetric 4 by 4 key matrix built from
+        the inner products. Rather than diagonalise it, the coefficients of
+        its characteristic polynomial are formed directly, and the largest
+        root found by Newton-Raphson iteration starting from
+        0.5 * (g_a + g_b), an upper bound on it; convergence takes a handful
+        of iterations.
+        
+        Collections of one point, or of coincident points, give zero at
+        once. Between collinear collections the largest root is a repeated
+        one, and iteration stops as soon as the polynomial's value is lost in
+        rounding rather than divide by a derivative which is no more than
+        rounding itself; such RMSDs are then good to about the square root of
+        the precision, relative to the collections' spread.
+        
+*******************************************************************************/
+
+static double
+_pairwise_qcp_rmsd
+(
+
+    size_t n_points,
+    
+    double g_a,
+    double g_b,
+    
+    double* a_inner
+
+)
+{
+
+    double sxx, sxy, sxz, syx, syy, syz, szx, szy, szz;
+    
+    double sxx2, syy2, szz2, sxy2, syz2, sxz2, syx2, szy2, szx2;
+    
+    double syzszymsyyszz2, sxx2syy2szz2syz2szy2, sxy2sxz2syx2szx2;
+    
+    double sxzpszx, syzpszy, sxypsyx, syzmszy, sxzmszx, sxymsyx;
+    double sxxpsyy, sxxmsyy;
+    
+    double c0, c1, c2;
+    
+    double e0;
+    double eigenvalue;
+    double eigenvalue_old;
+    double x2, a, b;
+    double value;
+    double derivative;
+    double noise;
+    
+    int i_iteration;
+    
+    sxx = *(a_inner);     sxy = *(a_inner + 1); sxz = *(a_inner + 2);
+    syx = *(a_inner + 3); syy = *(a_inner + 4); syz = *(a_inner + 5);
+    szx = *(a_inner + 6); szy = *(a_inner + 7); szz = *(a_inner + 8);
+    
+    sxx2 = sxx * sxx; syy2 = syy * syy; szz2 = szz * szz;
+    sxy2 = sxy * sxy; syz2 = syz * syz; sxz2 = sxz * sxz;
+    syx2 = syx * syx; szy2 = szy * szy; szx2 = szx * szx;
+    
+    syzszymsyyszz2 = 2.0 * ((syz * szy) - (syy * szz));
+    sxx2syy2szz2syz2szy2 = syy2 + szz2 - sxx2 + syz2 + szy2;
+    
+    c2 = -2.0 * (sxx2 + syy2 + szz2 + sxy2 + syx2 + sxz2 + szx2 + syz2 + szy2);
+    
+    c1 = 8.0 * ((sxx * syz * szy) + (syy * szx * sxz) + (szz * sxy * syx)
+              - (sxx * syy * szz) - (syz * szx * sxy) - (szy * syx * sxz));
+              
+    sxzpszx = sxz + szx;
+    syzpszy = syz + szy;
+    sxypsyx = sxy + syx;
+    syzmszy = syz - szy;
+    sxzmszx = sxz - szx;
+    sxymsyx = sxy - syx;
+    sxxpsyy = sxx + syy;
+    sxxmsyy = sxx - syy;
+    
+    sxy2sxz2syx2szx2 = sxy2 + sxz2 - syx2 - szx2;
+    
+    c0 = (sxy2sxz2syx2szx2 * sxy2sxz2syx2szx2)
+       + ((sxx2syy2szz2syz2szy2 + syzszymsyyszz2) * (sxx2syy2szz2syz2szy2 - syzszymsyyszz2))
+       + ((-(sxzpszx * syzmszy) + (sxymsyx * (sxxmsyy - szz))) * (-(sxzmszx * syzpszy) + (sxymsyx * (sxxmsyy + szz))))
+       + ((-(sxzpszx * syzpszy) - (sxypsyx * (sxxpsyy - szz))) * (-(sxzmszx * syzmszy) - (sxypsyx * (sxxpsyy + szz))))
+       + (((sxypsyx * syzpszy) + (sxzpszx * (sxxmsyy + szz))) * (-(sxymsyx * syzmszy) + (sxzpszx * (sxxpsyy + szz))))
+       + (((sxypsyx * syzmszy) + (sxzmszx * (sxxmsyy - szz))) * (-(sxymsyx * syzpszy) + (sxzmszx * (sxxpsyy - szz))));
+       
+    e0 = 0.5 * (g_a + g_b);
+    
+    /*
+    *   Collections of one point, or whose points all coincide, have nothing
+    *   to rotate, and every coefficient of the polynomial is zero.
+    */
+    
+    if (e0 <= 0) {
+        
+        return 0;
+    
+    }
+    
+    eigenvalue = e0;
+    
+    for (i_iteration = 0; i_iteration < _PAIRWISE_QCP_ITERATIONS; i_iteration ++) {
+        
+        eigenvalue_old = eigenvalue;
+        
+        x2 = eigenvalue * eigenvalue;
+        b = (x2 + c2) * eigenvalue;
+        a = b + c1;
+        
+        value = (a * eigenvalue) + c0;
+        derivative = (2.0 * x2 * eigenvalue) + b + a;
+        
+        noise = _PAIRWISE_QCP_NOISE * DBL_EPSILON * ((x2 * x2)
+                                                   + (fabs(c2) * x2)
+                                                   + fabs(c1 * eigenvalue)
+                                                   + fabs(c0));
+        
+        /*
+        *   Right of the largest root the polynomial is positive. Once its
+        *   value is lost in the rounding of its terms the estimate is as good
+        *   as it can be made, and the derivative may be no more than rounding
+        *   too: the largest root is a repeated one when the optimal rotation
+        *   is not unique, as between identical collinear collections, and a
+        *   step from there could land anywhere.
+        */
+        
+        if (value <= noise || !(fabs(derivative) >= DBL_MIN)) {
+            
+            break;
+        
+        }
+        
+        eigenvalue -= value / derivative;
+        
+        if (fabs(eigenvalue - eigenvalue_old) < fabs(_PAIRWISE_QCP_PRECISION * eigenvalue)) {
+            
+            break;
+        
+        }
+    
+    }
+    
+    /*
+    *   Rounding can leave e0 - eigenvalue very slightly negative for
+    *   identical collections.
+    */
+    
+    return sqrt(fabs(2.0 * (e0 - eigenvalue) / n_points));
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_single_rmsd_superposed
+    
+    Type: Function returning double
+    
+    Intent: Private
+    
+    Description:
+    
+        Calculates the single RMSD between two collections of points in
+        three-dimensional space after optimal superposition, given each as
+        prepared by _pairwise_superpose_collections(): centred, and followed
+        by one more point holding its G.
+        
+        n_points is the number of points per prepared collection, one more
+        than in the collection itself, and n_coordinates must be three.
+        collection_a and collection_b are pointers to the two prepared
+        collections involved in this calculation.
+        
+        On success returns the superposed RMSD. Not expected to fail.
+        
+    Further Information:
+    
+        All that is left to each pairwise calculation is to accumulate the
+        nine inner products of the two collections' coordinates, in one pass
+        over their points, and hand them to _pairwise_qcp_rmsd().
+        
+*******************************************************************************/
+
+double
+_pairwise_single_rmsd_superposed
+(
+
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* collection_a,
+    double* collection_b
+
+)
+{
+
+    double a_inner[9];
+    
+    double xa, ya, za;
+    double xb, yb, zb;
+    
+    size_t i_point;
+    
+    n_points --;
+    
+    a_inner[0] = a_inner[1] = a_inner[2] = 0;
+    a_inner[3] = a_inner[4] = a_inner[5] = 0;
+    a_inner[6] = a_inner[7] = a_inner[8] = 0;
+    
+    for (i_point = 0; i_point < n_points; i_point ++) {
+        
+        xa = *(collection_a ++); ya = *(collection_a ++); za = *(collection_a ++);
+        xb = *(collection_b ++); yb = *(collection_b ++); zb = *(collection_b ++);
+        
+        a_inner[0] += xa * xb; a_inner[1] += xa * yb; a_inner[2] += xa * zb;
+        a_inner[3] += ya * xb; a_inner[4] += ya * yb; a_inner[5] += ya * zb;
+        a_inner[6] += za * xb; a_inner[7] += za * yb; a_inner[8] += za * zb;
+    
+    }
+    
+    return _pairwise_qcp_rmsd(n_points, *collection_a, *collection_b, a_inner);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_single_rmsd_superposed_float
+    
+    Type: Function returning float
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_single_rmsd_superposed(), but for collections of floats
+        prepared by _pairwise_superpose_collections_float(). Compatible with
+        _pairwise_launch_float(). The inner products are accumulated, and the
+        QCP root found, in double precision, since the characteristic
+        polynomial is ill-conditioned for nearly identical collections.
+        
+*******************************************************************************/
+
+float
+_pairwise_single_rmsd_superposed_float
+(
+
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* collection_a,
+    float* collection_b
+
+)
+{
+
+    double a_inner[9];
+    
+    double xa, ya, za;
+    double xb, yb, zb;
+    
+    double g_a;
+    double g_b;
+    
+    size_t i_point;
+    
+    n_points --;
+    
+    a_inner[0] = a_inner[1] = a_inner[2] = 0;
+    a_inner[3] = a_inner[4] = a_inner[5] = 0;
+    a_inner[6] = a_inner[7] = a_inner[8] = 0;
+    
+    for (i_point = 0; i_point < n_points; i_point ++) {
+        
+        xa = *(collection_a ++); ya = *(collection_a ++); za = *(collection_a ++);
+        xb = *(collection_b ++); yb = *(collection_b ++); zb = *(collection_b ++);
+        
+        a_inner[0] += xa * xb; a_inner[1] += xa * yb; a_inner[2] += xa * zb;
+        a_inner[3] += ya * xb; a_inner[4] += ya * yb; a_inner[5] += ya * zb;
+        a_inner[6] += za * xb; a_inner[7] += za * yb; a_inner[8] += za * zb;
+    
+    }
+    
+    g_a = (double)*collection_a + *(collection_a + 1);
+    g_b = (double)*collection_b + *(collection_b + 1);
+    
+    return _pairwise_qcp_rmsd(n_points, g_a, g_b, a_inner);
 
 }
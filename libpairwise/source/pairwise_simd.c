@@ -0,0 +1,998 @@
+#include "pairwise_simd.h"
+
+#if defined(_PAIRWISE_SIMD_X86)
+#include <immintrin.h>
+#endif
+
+/*******************************************************************************
+
+    Symbol: _pairwise_isa_detected, _pairwise_isa_selected
+    
+    Type: Static ints
+    
+    Intent: Private
+    
+    Description:
+    
+        The widest instruction set architecture supported by the host, as
+        detected when libpairwise is loaded, and the instruction set
+        architecture whose kernel _pairwise_sum_squared_differences currently
+        points to. Both hold one of PAIRWISE_ISA_*.
+        
+*******************************************************************************/
+
+static int
+_pairwise_isa_detected = PAIRWISE_ISA_SCALAR;
+
+static int
+_pairwise_isa_selected = PAIRWISE_ISA_SCALAR;
+
+/*******************************************************************************
+
+    Symbol: _pairwise_sum_squared_differences,
+            _pairwise_sum_squared_differences_float
+    
+    Type: Pointers to functions returning double and float
+    
+    Intent: Private
+    
+    Description:
+    
+        Point to the kernels for the instruction set architecture currently
+        selected by pairwise_set_isa(), or at load time. The kernels return
+        the sum of the squared differences between the n_elements doubles (or
+        floats) starting at a and the n_elements doubles (or floats) starting
+        at b.
+        
+    Further Information:
+    
+        These pointers are statically initialised to the scalar kernels so
+        that they are always safe to call, even before
+        _pairwise_simd_initialise() has run.
+        
+*******************************************************************************/
+
+double
+(*_pairwise_sum_squared_differences)
+(
+
+    size_t n_elements,
+    
+    const double* a,
+    const double* b
+
+) = _pairwise_sum_squared_differences_scalar;
+
+float
+(*_pairwise_sum_squared_differences_float)
+(
+
+    size_t n_elements,
+    
+    const float* a,
+    const float* b
+
+) = _pairwise_sum_squared_differences_float_scalar;
+
+/*******************************************************************************
+
+    Symbol: _pairwise_simd_kernel
+    
+    Type: Static function returning pointer to function returning double
+    
+    Intent: Private
+    
+    Description:
+    
+        Returns a pointer to the kernel for the instruction set architecture
+        n_isa, one of PAIRWISE_ISA_* other than PAIRWISE_ISA_AUTO, or a null
+        pointer if libpairwise was not built with a kernel for n_isa.
+        
+*******************************************************************************/
+
+static double
+(*_pairwise_simd_kernel(int n_isa))
+(
+
+    size_t n_elements,
+    
+    const double* a,
+    const double* b
+
+)
+{
+
+    switch (n_isa) {
+        
+        case PAIRWISE_ISA_SCALAR: return _pairwise_sum_squared_differences_scalar;
+        
+        #if defined(_PAIRWISE_SIMD_X86)
+        
+        case PAIRWISE_ISA_SSE2: return _pairwise_sum_squared_differences_sse2;
+        
+        case PAIRWISE_ISA_AVX2: return _pairwise_sum_squared_differences_avx2;
+        
+        case PAIRWISE_ISA_AVX512: return _pairwise_sum_squared_differences_avx512;
+        
+        #endif
+        
+        default: return NULL;
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_simd_kernel_float
+    
+    Type: Static function returning pointer to function returning float
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_simd_kernel(), but for the single-precision kernels.
+        
+*******************************************************************************/
+
+static float
+(*_pairwise_simd_kernel_float(int n_isa))
+(
+
+    size_t n_elements,
+    
+    const float* a,
+    const float* b
+
+)
+{
+
+    switch (n_isa) {
+        
+        case PAIRWISE_ISA_SCALAR: return _pairwise_sum_squared_differences_float_scalar;
+        
+        #if defined(_PAIRWISE_SIMD_X86)
+        
+        case PAIRWISE_ISA_SSE2: return _pairwise_sum_squared_differences_float_sse2;
+        
+        case PAIRWISE_ISA_AVX2: return _pairwise_sum_squared_differences_float_avx2;
+        
+        case PAIRWISE_ISA_AVX512: return _pairwise_sum_squared_differences_float_avx512;
+        
+        #endif
+        
+        default: return NULL;
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_simd_initialise
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Detects with cpuid the widest instruction set architecture supported by
+        the host, and points _pairwise_sum_squared_differences and
+        _pairwise_sum_squared_differences_float at the corresponding kernels.
+        Called automatically when libpairwise is loaded.
+        
+        On success returns nothing. Not expected to fail.
+        
+    Further Information:
+    
+        AVX2 kernels additionally require FMA, which every AVX2 host shipped
+        to date provides. __builtin_cpu_supports() also checks that the
+        operating system saves the wider register state on context switches.
+        
+*******************************************************************************/
+
+#if defined(__GNUC__)
+__attribute__((constructor))
+#endif
+static void
+_pairwise_simd_initialise
+(void)
+{
+
+    int n_isa;
+    
+    n_isa = PAIRWISE_ISA_SCALAR;
+    
+    #if defined(_PAIRWISE_SIMD_X86)
+    
+    __builtin_cpu_init();
+    
+    if (__builtin_cpu_supports("avx512f")) {
+        
+        n_isa = PAIRWISE_ISA_AVX512;
+    
+    } else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        
+        n_isa = PAIRWISE_ISA_AVX2;
+    
+    } else if (__builtin_cpu_supports("sse2")) {
+        
+        n_isa = PAIRWISE_ISA_SSE2;
+    
+    }
+    
+    #endif
+    
+    _pairwise_isa_detected = n_isa;
+    
+    pairwise_set_isa(PAIRWISE_ISA_AUTO);
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_isa_supported
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Returns integer one if the host supports the instruction set
+        architecture identified by n_isa, one of PAIRWISE_ISA_*, and if
+        libpairwise was built with kernels for it. Otherwise returns integer
+        zero. Not expected to fail.
+        
+    Further Information:
+    
+        Instruction set architectures are ordered by PAIRWISE_ISA_* such that
+        each is a subset of the next, so any instruction set no wider than
+        that detected at load time is supported.
+        
+*******************************************************************************/
+
+int
+pairwise_isa_supported
+(
+
+    int n_isa
+
+)
+{
+
+    if (n_isa == PAIRWISE_ISA_AUTO) {
+        
+        return 1;
+    
+    }
+    
+    if (!_pairwise_simd_kernel(n_isa)) {
+        
+        return 0;
+    
+    }
+    
+    return n_isa <= _pairwise_isa_detected;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_set_isa
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Selects the instruction set architecture whose kernels all subsequent
+        libpairwise calculations will use. n_isa is one of PAIRWISE_ISA_*.
+        Passing PAIRWISE_ISA_AUTO restores the selection made when libpairwise
+        was loaded.
+        
+        Fails if n_isa is not a recognised identifier, or if the host does not
+        support the requested instruction set.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code,
+        and leaves the current selection unchanged.
+        
+    Further Information:
+    
+        The kernel pointers are swapped atomically, so calculations already
+        running on other threads carry on safely with whichever kernel they
+        loaded. This makes it possible to A/B time instruction sets from one
+        process.
+        
+*******************************************************************************/
+
+int
+pairwise_set_isa
+(
+
+    int n_isa
+
+)
+{
+
+    if (n_isa == PAIRWISE_ISA_AUTO) {
+        
+        n_isa = _pairwise_isa_detected;
+    
+    }
+    
+    if (!pairwise_isa_supported(n_isa)) {
+        
+        return PAIRWISE_RETURN_ERROR_ISA;
+    
+    }
+    
+    __atomic_store_n(&_pairwise_sum_squared_differences,
+                     _pairwise_simd_kernel(n_isa),
+                     __ATOMIC_RELEASE);
+                     
+    __atomic_store_n(&_pairwise_sum_squared_differences_float,
+                     _pairwise_simd_kernel_float(n_isa),
+                     __ATOMIC_RELEASE);
+                     
+    __atomic_store_n(&_pairwise_isa_selected, n_isa, __ATOMIC_RELEASE);
+    
+    return PAIRWISE_RETURN_SUCCESS;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_get_isa
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Returns the PAIRWISE_ISA_* identifier of the instruction set
+        architecture whose kernels libpairwise calculations currently use.
+        Never returns PAIRWISE_ISA_AUTO. Not expected to fail.
+        
+*******************************************************************************/
+
+int
+pairwise_get_isa
+(void)
+{
+
+    return __atomic_load_n(&_pairwise_isa_selected, __ATOMIC_ACQUIRE);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_sum_squared_differences_scalar
+    
+    Type: Function returning double
+    
+    Intent: Private
+    
+    Description:
+    
+        Returns the sum of the squared differences between the n_elements
+        doubles starting at a and the n_elements doubles starting at b, using
+        no instructions beyond those of the host's baseline. Not expected to
+        fail.
+        
+*******************************************************************************/
+
+double
+_pairwise_sum_squared_differences_scalar
+(
+
+    size_t n_elements,
+    
+    const double* a,
+    const double* b
+
+)
+{
+
+    size_t i_element;
+    
+    double working;
+    
+    working = 0;
+    
+    for (i_element = 0; i_element < n_elements; i_element ++) {
+        
+        working += _PAIRWISE_SQUARE(*(a + i_element) - *(b + i_element));
+    
+    }
+    
+    return working;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_sum_squared_differences_float_scalar
+    
+    Type: Function returning float
+    
+    Intent: Private
+    
+    Description:
+    
+        Returns the sum of the squared differences between the n_elements
+        floats starting at a and the n_elements floats starting at b, using
+        no instructions beyond those of the host's baseline. Not expected to
+        fail.
+        
+*******************************************************************************/
+
+float
+_pairwise_sum_squared_differences_float_scalar
+(
+
+    size_t n_elements,
+    
+    const float* a,
+    const float* b
+
+)
+{
+
+    size_t i_element;
+    
+    float working;
+    
+    working = 0;
+    
+    for (i_element = 0; i_element < n_elements; i_element ++) {
+        
+        working += _PAIRWISE_SQUARE(*(a + i_element) - *(b + i_element));
+    
+    }
+    
+    return working;
+
+}
+
+#if defined(_PAIRWISE_SIMD_X86)
+
+/*******************************************************************************
+
+    Symbol: _pairwise_sum_squared_differences_sse2
+    
+    Type: Function returning double
+    
+    Intent: Private
+    
+    Description:
+    
+        Returns the sum of the squared differences between the n_elements
+        doubles starting at a and the n_elements doubles starting at b, two
+        elements at a time using SSE2. Not expected to fail.
+        
+    Further Information:
+    
+        Two independent accumulators hide the latency of the additions. Any
+        odd final element is handled by scalar code.
+        
+*******************************************************************************/
+
+__attribute__((target("sse2")))
+double
+_pairwise_sum_squared_differences_sse2
+(
+
+    size_t n_elements,
+    
+    const double* a,
+    const double* b
+
+)
+{
+
+    size_t i_element;
+    
+    __m128d working_0;
+    __m128d working_1;
+    __m128d delta_0;
+    __m128d delta_1;
+    
+    double a_working[2];
+    double working;
+    
+    working_0 = _mm_setzero_pd();
+    working_1 = _mm_setzero_pd();
+    
+    for (i_element = 0; i_element + 4 <= n_elements; i_element += 4) {
+        
+        delta_0 = _mm_sub_pd(_mm_loadu_pd(a + i_element),
+                             _mm_loadu_pd(b + i_element));
+                             
+        delta_1 = _mm_sub_pd(_mm_loadu_pd(a + i_element + 2),
+                             _mm_loadu_pd(b + i_element + 2));
+                             
+        working_0 = _mm_add_pd(working_0, _mm_mul_pd(delta_0, delta_0));
+        working_1 = _mm_add_pd(working_1, _mm_mul_pd(delta_1, delta_1));
+    
+    }
+    
+    if (i_element + 2 <= n_elements) {
+        
+        delta_0 = _mm_sub_pd(_mm_loadu_pd(a + i_element),
+                             _mm_loadu_pd(b + i_element));
+                             
+        working_0 = _mm_add_pd(working_0, _mm_mul_pd(delta_0, delta_0));
+        
+        i_element += 2;
+    
+    }
+    
+    _mm_storeu_pd(a_working, _mm_add_pd(working_0, working_1));
+    
+    working = a_working[0] + a_working[1];
+    
+    if (i_element < n_elements) {
+        
+        working += _PAIRWISE_SQUARE(*(a + i_element) - *(b + i_element));
+    
+    }
+    
+    return working;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_sum_squared_differences_avx2
+    
+    Type: Function returning double
+    
+    Intent: Private
+    
+    Description:
+    
+        Returns the sum of the squared differences between the n_elements
+        doubles starting at a and the n_elements doubles starting at b, four
+        elements at a time using AVX2 and FMA. Not expected to fail.
+        
+    Further Information:
+    
+        Two independent accumulators hide the latency of the fused
+        multiply-adds. Fewer than four final elements are handled by scalar
+        code.
+        
+*******************************************************************************/
+
+__attribute__((target("avx2,fma")))
+double
+_pairwise_sum_squared_differences_avx2
+(
+
+    size_t n_elements,
+    
+    const double* a,
+    const double* b
+
+)
+{
+
+    size_t i_element;
+    
+    __m256d working_0;
+    __m256d working_1;
+    __m256d delta_0;
+    __m256d delta_1;
+    
+    __m128d working_half;
+    
+    double working;
+    
+    working_0 = _mm256_setzero_pd();
+    working_1 = _mm256_setzero_pd();
+    
+    for (i_element = 0; i_element + 8 <= n_elements; i_element += 8) {
+        
+        delta_0 = _mm256_sub_pd(_mm256_loadu_pd(a + i_element),
+                                _mm256_loadu_pd(b + i_element));
+                                
+        delta_1 = _mm256_sub_pd(_mm256_loadu_pd(a + i_element + 4),
+                                _mm256_loadu_pd(b + i_element + 4));
+                                
+        working_0 = _mm256_fmadd_pd(delta_0, delta_0, working_0);
+        working_1 = _mm256_fmadd_pd(delta_1, delta_1, working_1);
+    
+    }
+    
+    if (i_element + 4 <= n_elements) {
+        
+        delta_0 = _mm256_sub_pd(_mm256_loadu_pd(a + i_element),
+                                _mm256_loadu_pd(b + i_element));
+                                
+        working_0 = _mm256_fmadd_pd(delta_0, delta_0, working_0);
+        
+        i_element += 4;
+    
+    }
+    
+    working_0 = _mm256_add_pd(working_0, working_1);
+    
+    working_half = _mm_add_pd(_mm256_castpd256_pd128(working_0),
+                              _mm256_extractf128_pd(working_0, 1));
+                              
+    working_half = _mm_add_sd(working_half, _mm_unpackhi_pd(working_half,
+                                                            working_half));
+                                                            
+    working = _mm_cvtsd_f64(working_half);
+    
+    for (; i_element < n_elements; i_element ++) {
+        
+        working += _PAIRWISE_SQUARE(*(a + i_element) - *(b + i_element));
+    
+    }
+    
+    return working;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_sum_squared_differences_avx512
+    
+    Type: Function returning double
+    
+    Intent: Private
+    
+    Description:
+    
+        Returns the sum of the squared differences between the n_elements
+        doubles starting at a and the n_elements doubles starting at b, eight
+        elements at a time using AVX-512F. Not expected to fail.
+        
+    Further Information:
+    
+        Fewer than eight final elements are handled with a masked load rather
+        than with scalar code, so that the common case of a single three-
+        dimensional point costs one iteration.
+        
+*******************************************************************************/
+
+__attribute__((target("avx512f")))
+double
+_pairwise_sum_squared_differences_avx512
+(
+
+    size_t n_elements,
+    
+    const double* a,
+    const double* b
+
+)
+{
+
+    size_t i_element;
+    
+    __m512d working_0;
+    __m512d working_1;
+    __m512d delta_0;
+    __m512d delta_1;
+    
+    __mmask8 mask;
+    
+    working_0 = _mm512_setzero_pd();
+    working_1 = _mm512_setzero_pd();
+    
+    for (i_element = 0; i_element + 16 <= n_elements; i_element += 16) {
+        
+        delta_0 = _mm512_sub_pd(_mm512_loadu_pd(a + i_element),
+                                _mm512_loadu_pd(b + i_element));
+                                
+        delta_1 = _mm512_sub_pd(_mm512_loadu_pd(a + i_element + 8),
+                                _mm512_loadu_pd(b + i_element + 8));
+                                
+        working_0 = _mm512_fmadd_pd(delta_0, delta_0, working_0);
+        working_1 = _mm512_fmadd_pd(delta_1, delta_1, working_1);
+    
+    }
+    
+    if (i_element + 8 <= n_elements) {
+        
+        delta_0 = _mm512_sub_pd(_mm512_loadu_pd(a + i_element),
+                                _mm512_loadu_pd(b + i_element));
+                                
+        working_0 = _mm512_fmadd_pd(delta_0, delta_0, working_0);
+        
+        i_element += 8;
+    
+    }
+    
+    if (i_element < n_elements) {
+        
+        mask = (__mmask8)((1u << (n_elements - i_element)) - 1);
+        
+        delta_1 = _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, a + i_element),
+                                _mm512_maskz_loadu_pd(mask, b + i_element));
+                                
+        working_1 = _mm512_fmadd_pd(delta_1, delta_1, working_1);
+    
+    }
+    
+    return _mm512_reduce_add_pd(_mm512_add_pd(working_0, working_1));
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_sum_squared_differences_float_sse2
+    
+    Type: Function returning float
+    
+    Intent: Private
+    
+    Description:
+    
+        Returns the sum of the squared differences between the n_elements
+        floats starting at a and the n_elements floats starting at b, four
+        elements at a time using SSE2. Not expected to fail.
+        
+    Further Information:
+    
+        As _pairwise_sum_squared_differences_sse2(), but with twice as many
+        elements per instruction. Fewer than four final elements are handled
+        by scalar code.
+        
+*******************************************************************************/
+
+__attribute__((target("sse2")))
+float
+_pairwise_sum_squared_differences_float_sse2
+(
+
+    size_t n_elements,
+    
+    const float* a,
+    const float* b
+
+)
+{
+
+    size_t i_element;
+    
+    __m128 working_0;
+    __m128 working_1;
+    __m128 delta_0;
+    __m128 delta_1;
+    
+    float a_working[4];
+    float working;
+    
+    working_0 = _mm_setzero_ps();
+    working_1 = _mm_setzero_ps();
+    
+    for (i_element = 0; i_element + 8 <= n_elements; i_element += 8) {
+        
+        delta_0 = _mm_sub_ps(_mm_loadu_ps(a + i_element),
+                             _mm_loadu_ps(b + i_element));
+                             
+        delta_1 = _mm_sub_ps(_mm_loadu_ps(a + i_element + 4),
+                             _mm_loadu_ps(b + i_element + 4));
+                             
+        working_0 = _mm_add_ps(working_0, _mm_mul_ps(delta_0, delta_0));
+        working_1 = _mm_add_ps(working_1, _mm_mul_ps(delta_1, delta_1));
+    
+    }
+    
+    if (i_element + 4 <= n_elements) {
+        
+        delta_0 = _mm_sub_ps(_mm_loadu_ps(a + i_element),
+                             _mm_loadu_ps(b + i_element));
+                             
+        working_0 = _mm_add_ps(working_0, _mm_mul_ps(delta_0, delta_0));
+        
+        i_element += 4;
+    
+    }
+    
+    _mm_storeu_ps(a_working, _mm_add_ps(working_0, working_1));
+    
+    working = (a_working[0] + a_working[1]) + (a_working[2] + a_working[3]);
+    
+    for (; i_element < n_elements; i_element ++) {
+        
+        working += _PAIRWISE_SQUARE(*(a + i_element) - *(b + i_element));
+    
+    }
+    
+    return working;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_sum_squared_differences_float_avx2
+    
+    Type: Function returning float
+    
+    Intent: Private
+    
+    Description:
+    
+        Returns the sum of the squared differences between the n_elements
+        floats starting at a and the n_elements floats starting at b, eight
+        elements at a time using AVX2 and FMA. Not expected to fail.
+        
+    Further Information:
+    
+        As _pairwise_sum_squared_differences_avx2(), but with twice as many
+        elements per instruction. Fewer than eight final elements are handled
+        by scalar code.
+        
+*******************************************************************************/
+
+__attribute__((target("avx2,fma")))
+float
+_pairwise_sum_squared_differences_float_avx2
+(
+
+    size_t n_elements,
+    
+    const float* a,
+    const float* b
+
+)
+{
+
+    size_t i_element;
+    
+    __m256 working_0;
+    __m256 working_1;
+    __m256 delta_0;
+    __m256 delta_1;
+    
+    __m128 working_half;
+    
+    float working;
+    
+    working_0 = _mm256_setzero_ps();
+    working_1 = _mm256_setzero_ps();
+    
+    for (i_element = 0; i_element + 16 <= n_elements; i_element += 16) {
+        
+        delta_0 = _mm256_sub_ps(_mm256_loadu_ps(a + i_element),
+                                _mm256_loadu_ps(b + i_element));
+                                
+        delta_1 = _mm256_sub_ps(_mm256_loadu_ps(a + i_element + 8),
+                                _mm256_loadu_ps(b + i_element + 8));
+                                
+        working_0 = _mm256_fmadd_ps(delta_0, delta_0, working_0);
+        working_1 = _mm256_fmadd_ps(delta_1, delta_1, working_1);
+    
+    }
+    
+    if (i_element + 8 <= n_elements) {
+        
+        delta_0 = _mm256_sub_ps(_mm256_loadu_ps(a + i_element),
+                                _mm256_loadu_ps(b + i_element));
+                                
+        working_0 = _mm256_fmadd_ps(delta_0, delta_0, working_0);
+        
+        i_element += 8;
+    
+    }
+    
+    working_0 = _mm256_add_ps(working_0, working_1);
+    
+    working_half = _mm_add_ps(_mm256_castps256_ps128(working_0),
+                              _mm256_extractf128_ps(working_0, 1));
+                              
+    working_half = _mm_add_ps(working_half, _mm_movehl_ps(working_half,
+                                                          working_half));
+                                                          
+    working_half = _mm_add_ss(working_half, _mm_shuffle_ps(working_half,
+                                                           working_half,
+                                                           1));
+                                                           
+    working = _mm_cvtss_f32(working_half);
+    
+    for (; i_element < n_elements; i_element ++) {
+        
+        working += _PAIRWISE_SQUARE(*(a + i_element) - *(b + i_element));
+    
+    }
+    
+    return working;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_sum_squared_differences_float_avx512
+    
+    Type: Function returning float
+    
+    Intent: Private
+    
+    Description:
+    
+        Returns the sum of the squared differences between the n_elements
+        floats starting at a and the n_elements floats starting at b, sixteen
+        elements at a time using AVX-512F. Not expected to fail.
+        
+    Further Information:
+    
+        As _pairwise_sum_squared_differences_avx512(), but with twice as many
+        elements per instruction. Fewer than sixteen final elements are
+        handled with a masked load.
+        
+*******************************************************************************/
+
+__attribute__((target("avx512f")))
+float
+_pairwise_sum_squared_differences_float_avx512
+(
+
+    size_t n_elements,
+    
+    const float* a,
+    const float* b
+
+)
+{
+
+    size_t i_element;
+    
+    __m512 working_0;
+    __m512 working_1;
+    __m512 delta_0;
+    __m512 delta_1;
+    
+    __mmask16 mask;
+    
+    working_0 = _mm512_setzero_ps();
+    working_1 = _mm512_setzero_ps();
+    
+    for (i_element = 0; i_element + 32 <= n_elements; i_element += 32) {
+        
+        delta_0 = _mm512_sub_ps(_mm512_loadu_ps(a + i_element),
+                                _mm512_loadu_ps(b + i_element));
+                                
+        delta_1 = _mm512_sub_ps(_mm512_loadu_ps(a + i_element + 16),
+                                _mm512_loadu_ps(b + i_element + 16));
+                                
+        working_0 = _mm512_fmadd_ps(delta_0, delta_0, working_0);
+        working_1 = _mm512_fmadd_ps(delta_1, delta_1, working_1);
+    
+    }
+    
+    if (i_element + 16 <= n_elements) {
+        
+        delta_0 = _mm512_sub_ps(_mm512_loadu_ps(a + i_element),
+                                _mm512_loadu_ps(b + i_element));
+                                
+        working_0 = _mm512_fmadd_ps(delta_0, delta_0, working_0);
+        
+        i_element += 16;
+    
+    }
+    
+    if (i_element < n_elements) {
+        
+        mask = (__mmask16)((1u << (n_elements - i_element)) - 1);
+        
+        delta_1 = _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, a + i_element),
+                                _mm512_maskz_loadu_ps(mask, b + i_element));
+                                
+        working_1 = _mm512_fmadd_ps(delta_1, delta_1, working_1);
+    
+    }
+    
+    return _mm512_reduce_add_ps(_mm512_add_ps(working_0, working_1));
+
+}
+
+#endif /* _PAIRWISE_SIMD_X86 */
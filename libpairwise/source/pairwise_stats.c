@@ -0,0 +1,407 @@
+#include <string.h>
+#include <time.h>
+
+#include "pairwise_stats.h"
+
+/*******************************************************************************
+
+    Symbol: _pairwise_stats_slot_t
+    
+    Type: Structure
+    
+    Intent: Private
+    
+    Description:
+    
+        The statistics of one thread's last calculation, stats, whose
+        per-thread arrays point into a_thread_seconds and a_thread_pairs,
+        each of which has room for n_capacity elements. Allocated the first
+        time the thread records statistics, and freed when it exits.
+        
+*******************************************************************************/
+
+typedef struct
+_pairwise_stats_slot
+{
+
+    pairwise_stats_t stats;
+    
+    double* a_thread_seconds;
+    size_t* a_thread_pairs;
+    
+    size_t n_capacity;
+
+} _pairwise_stats_slot_t;
+
+/*******************************************************************************
+
+    Symbol: _pairwise_stats_key, _pairwise_stats_once, _pairwise_stats_b_key
+    
+    Type: Static variables
+    
+    Intent: Private
+    
+    Description:
+    
+        The key of every thread's _pairwise_stats_slot_t, created once, by
+        whichever thread first needs it, through _pairwise_stats_once.
+        _pairwise_stats_b_key is set if the key was created, and clear if
+        creating it failed, in which case no statistics are ever recorded.
+        
+*******************************************************************************/
+
+static pthread_key_t
+_pairwise_stats_key;
+
+static pthread_once_t
+_pairwise_stats_once = PTHREAD_ONCE_INIT;
+
+static int
+_pairwise_stats_b_key;
+
+/*******************************************************************************
+
+    Symbol: _pairwise_stats_free
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        The destructor of _pairwise_stats_key: frees slot, a
+        _pairwise_stats_slot_t, when its thread exits.
+        
+        Returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+static void
+_pairwise_stats_free
+(
+
+    void* slot
+
+)
+{
+
+    free(((_pairwise_stats_slot_t*)slot)->a_thread_seconds);
+    free(((_pairwise_stats_slot_t*)slot)->a_thread_pairs);
+    
+    free(slot);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_stats_create_key
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Creates _pairwise_stats_key. Called once, through
+        _pairwise_stats_once.
+        
+        Returns nothing. On failure leaves _pairwise_stats_b_key clear.
+        
+*******************************************************************************/
+
+static void
+_pairwise_stats_create_key
+(void)
+{
+
+    _pairwise_stats_b_key = !pthread_key_create(&_pairwise_stats_key,
+                                                _pairwise_stats_free);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_stats_slot
+    
+    Type: Static function returning _pairwise_stats_slot_t*
+    
+    Intent: Private
+    
+    Description:
+    
+        Returns the _pairwise_stats_slot_t of the calling thread, first
+        allocating it, all zero, if b_create is set and it has none.
+        
+        Returns a null pointer if the thread has no slot and b_create is
+        clear, or if one could not be allocated.
+        
+*******************************************************************************/
+
+static _pairwise_stats_slot_t*
+_pairwise_stats_slot
+(
+
+    int b_create
+
+)
+{
+
+    _pairwise_stats_slot_t* slot;
+    
+    pthread_once(&_pairwise_stats_once, _pairwise_stats_create_key);
+    
+    if (!_pairwise_stats_b_key) {
+        
+        return NULL;
+    
+    }
+    
+    slot = pthread_getspecific(_pairwise_stats_key);
+    
+    if (slot || !b_create) {
+        
+        return slot;
+    
+    }
+    
+    slot = calloc(1, sizeof(_pairwise_stats_slot_t));
+    
+    if (slot && pthread_setspecific(_pairwise_stats_key, slot)) {
+        
+        free(slot);
+        
+        slot = NULL;
+    
+    }
+    
+    return slot;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_stats_last
+    
+    Type: Function returning void
+    
+    Intent: Public
+    
+    Description:
+    
+        Stores in stats the statistics of the last calculation carried out
+        by the calling thread, by any libpairwise function whose calculation
+        the calling thread waits for, such as pairwise_distances() or
+        pairwise_rmsds_knn(). Calculations through streams and futures are
+        not recorded. If the calling thread has carried out no calculation,
+        or its statistics could not be recorded, every member of stats is
+        zero, or null.
+        
+        Returns nothing. Not expected to fail.
+        
+    Further Information:
+    
+        Statistics are kept per thread, so that threads carrying out
+        calculations at once each find their own. Recording them costs a few
+        readings of the clock per thread per calculation, and no locking.
+        
+*******************************************************************************/
+
+void
+pairwise_stats_last
+(
+
+    pairwise_stats_t* stats
+
+)
+{
+
+    _pairwise_stats_slot_t* slot;
+    
+    slot = _pairwise_stats_slot(0);
+    
+    if (!slot) {
+        
+        memset(stats, 0, sizeof(pairwise_stats_t));
+        
+        return;
+    
+    }
+    
+    *stats = slot->stats;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_stats_clock
+    
+    Type: Function returning double
+    
+    Intent: Private
+    
+    Description:
+    
+        Returns the time, in seconds, of the monotonic clock, which is
+        unaffected by changes to the time of day. Only differences between
+        its values are meaningful.
+        
+*******************************************************************************/
+
+double
+_pairwise_stats_clock
+(void)
+{
+
+    struct timespec now;
+    
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    
+    return now.tv_sec + (now.tv_nsec * 1e-9);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_stats_record
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Records, as the statistics of the calling thread's last calculation,
+        those of job, whose every thread has finished but whose argument sets
+        have not yet been released. t_prepare, t_submit and t_done are the
+        times, of _pairwise_stats_clock(), at which job began to be prepared,
+        was handed to the worker pool, and was found finished.
+        
+        Returns nothing. If memory for the statistics cannot be allocated,
+        records none, so that pairwise_stats_last() finds zeros.
+        
+    Further Information:
+    
+        Each thread stamps its argument set as it begins and finishes its
+        call to _pairwise_launch_bounded(), so that the latest beginning
+        divides the time the job spent on the pool between spawning and
+        computing.
+        
+*******************************************************************************/
+
+void
+_pairwise_stats_record
+(
+
+    _pairwise_job_t* job,
+    
+    double t_prepare,
+    double t_submit,
+    double t_done
+
+)
+{
+
+    _pairwise_stats_slot_t* slot;
+    
+    _pairwise_as_t* argument_set;
+    
+    double* a_thread_seconds;
+    size_t* a_thread_pairs;
+    
+    double t_started;
+    
+    size_t n_threads;
+    
+    size_t i_argument_set;
+    
+    slot = _pairwise_stats_slot(1);
+    
+    if (!slot) {
+        
+        return;
+    
+    }
+    
+    n_threads = job->n_argument_sets;
+    
+    if (n_threads > slot->n_capacity) {
+        
+        a_thread_seconds = realloc(slot->a_thread_seconds, n_threads * sizeof(double));
+        
+        if (a_thread_seconds) {
+            
+            slot->a_thread_seconds = a_thread_seconds;
+        
+        }
+        
+        a_thread_pairs = realloc(slot->a_thread_pairs, n_threads * sizeof(size_t));
+        
+        if (a_thread_pairs) {
+            
+            slot->a_thread_pairs = a_thread_pairs;
+        
+        }
+        
+        if (!a_thread_seconds || !a_thread_pairs) {
+            
+            memset(&slot->stats, 0, sizeof(pairwise_stats_t));
+            
+            return;
+        
+        }
+        
+        slot->n_capacity = n_threads;
+    
+    }
+    
+    slot->stats.n_threads = n_threads;
+    slot->stats.n_pairs = 0;
+    
+    t_started = t_submit;
+    
+    for (i_argument_set = 0; i_argument_set < n_threads; i_argument_set ++) {
+        
+        argument_set = job->a_argument_sets + i_argument_set;
+        
+        *(slot->a_thread_seconds + i_argument_set) = argument_set->t_end - argument_set->t_start;
+        *(slot->a_thread_pairs + i_argument_set) = argument_set->n_pairs;
+        
+        slot->stats.n_pairs += argument_set->n_pairs;
+        
+        if (argument_set->t_start > t_started) {
+            
+            t_started = argument_set->t_start;
+        
+        }
+    
+    }
+    
+    slot->stats.prepare_seconds = t_submit - t_prepare;
+    slot->stats.spawn_seconds = t_started - t_submit;
+    slot->stats.compute_seconds = t_done - t_started;
+    
+    /*
+    *   Count the input array once, and the results only if every one of them
+    *   was stored.
+    */
+    
+    slot->stats.n_bytes = job->n_collections * job->n_points * job->n_coordinates;
+    
+    if (job->b_cross) {
+        
+        slot->stats.n_bytes += job->n_collections_b * job->n_points * job->n_coordinates;
+    
+    }
+    
+    if (job->a_results) {
+        
+        slot->stats.n_bytes += slot->stats.n_pairs;
+    
+    }
+    
+    slot->stats.n_bytes *= job->s_element;
+    
+    slot->stats.a_thread_seconds = slot->a_thread_seconds;
+    slot->stats.a_thread_pairs = slot->a_thread_pairs;
+
+}
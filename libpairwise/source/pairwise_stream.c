@@ -0,0 +1,1105 @@
+#include "pairwise_stream.h"
+
+/*******************************************************************************
+
+    Symbol: struct _pairwise_stream
+    
+    Type: Structure
+    
+    Intent: Private
+    
+    Description:
+    
+        The members of pairwise_stream_t, a calculation whose results are
+        handed to the caller tile by tile, by pairwise_stream_next(), as
+        threads finish them, rather than stored in one array. Created by
+        pairwise_distances_stream(), pairwise_rmsds_stream() or their float
+        counterparts, and destroyed by pairwise_stream_close(). Declared in
+        pairwise.h, and opaque outside this file.
+        
+        job describes the calculation; it is the first member, so that a
+        pointer to job is also one to the stream. Its n_tiles tiles, in
+        a_tiles, are either in the list of free tiles beginning with
+        free_tiles, filled by a thread, in the queue of ready tiles from
+        ready_head to ready_tail, or held by the reader as held_tile. mutex
+        protects the tiles and flags; threads wait on tile_free for a free
+        tile and the reader waits on tile_ready for a ready one.
+        
+        The calculation runs on a thread of its own, driver, which takes part
+        in it alongside the libpairwise worker pool. b_driver is set once
+        driver has been created, and b_done once every tile has been filled,
+        with the result in n_return. b_closing is set by
+        pairwise_stream_close() to stop threads filling more tiles.
+        
+*******************************************************************************/
+
+struct
+_pairwise_stream
+{
+
+    _pairwise_job_t job;
+    
+    _pairwise_tile_t* a_tiles;
+    size_t n_tiles;
+    
+    void* a_blocks;
+    
+    _pairwise_tile_t* free_tiles;
+    _pairwise_tile_t* ready_head;
+    _pairwise_tile_t* ready_tail;
+    _pairwise_tile_t* held_tile;
+    
+    pthread_mutex_t mutex;
+    pthread_cond_t tile_free;
+    pthread_cond_t tile_ready;
+    
+    pthread_t driver;
+    
+    int b_driver;
+    int b_done;
+    int b_closing;
+    
+    int n_return;
+
+};
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_row_stream
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Row driver for job->f_row. Carries out the pairwise calculations
+        between collection i_collection_a of job and each of collections
+        i_collection_b_lower up to but excluding i_collection_b_upper, by
+        calling job->f_calculation on doubles, and stores their results in
+        the row of the block of sink, the _pairwise_tile_t being filled.
+        a_results_row is ignored.
+        
+        On success returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+void
+_pairwise_launch_row_stream
+(
+
+    _pairwise_job_t* job,
+    
+    void* sink,
+    
+    size_t i_collection_a,
+    size_t i_collection_b_lower,
+    size_t i_collection_b_upper,
+    
+    void* a_results_row
+
+)
+{
+
+    double (*f_calculation)(size_t n_points,
+                            size_t n_coordinates,
+                            double* collection_a,
+                            double* collection_b);
+                            
+    _pairwise_tile_t* tile;
+    
+    double* a_collections;
+    double* a_collections_b;
+    
+    double* collection_a;
+    double* collection_b;
+    
+    double* result;
+    
+    size_t n_points;
+    size_t n_coordinates;
+    
+    size_t i_collection_b;
+    
+    tile = sink;
+    
+    f_calculation = job->f_calculation;
+    
+    a_collections = job->a_collections;
+    a_collections_b = job->a_collections_b;
+    
+    n_points = job->n_points;
+    n_coordinates = job->n_coordinates;
+    
+    collection_a = a_collections + (i_collection_a * n_points * n_coordinates);
+    
+    result = (double*)tile->a_block
+           + ((i_collection_a - tile->i_row_lower) * (tile->i_column_upper - tile->i_column_lower))
+           + (i_collection_b_lower - tile->i_column_lower);
+           
+    for (i_collection_b = i_collection_b_lower;
+         i_collection_b < i_collection_b_upper;
+         i_collection_b ++) {
+             
+        collection_b = a_collections_b + (i_collection_b * n_points * n_coordinates);
+        
+        *(result ++) = f_calculation(n_points, n_coordinates, collection_a, collection_b);
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_row_stream_float
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch_row_stream(), but calling job->f_calculation_float
+        on floats.
+        
+*******************************************************************************/
+
+void
+_pairwise_launch_row_stream_float
+(
+
+    _pairwise_job_t* job,
+    
+    void* sink,
+    
+    size_t i_collection_a,
+    size_t i_collection_b_lower,
+    size_t i_collection_b_upper,
+    
+    void* a_results_row
+
+)
+{
+
+    float (*f_calculation)(size_t n_points,
+                           size_t n_coordinates,
+                           float* collection_a,
+                           float* collection_b);
+                           
+    _pairwise_tile_t* tile;
+    
+    float* a_collections;
+    float* a_collections_b;
+    
+    float* collection_a;
+    float* collection_b;
+    
+    float* result;
+    
+    size_t n_points;
+    size_t n_coordinates;
+    
+    size_t i_collection_b;
+    
+    tile = sink;
+    
+    f_calculation = job->f_calculation_float;
+    
+    a_collections = job->a_collections;
+    a_collections_b = job->a_collections_b;
+    
+    n_points = job->n_points;
+    n_coordinates = job->n_coordinates;
+    
+    collection_a = a_collections + (i_collection_a * n_points * n_coordinates);
+    
+    result = (float*)tile->a_block
+           + ((i_collection_a - tile->i_row_lower) * (tile->i_column_upper - tile->i_column_lower))
+           + (i_collection_b_lower - tile->i_column_lower);
+           
+    for (i_collection_b = i_collection_b_lower;
+         i_collection_b < i_collection_b_upper;
+         i_collection_b ++) {
+             
+        collection_b = a_collections_b + (i_collection_b * n_points * n_coordinates);
+        
+        *(result ++) = f_calculation(n_points, n_coordinates, collection_a, collection_b);
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_stream_fill
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Waits for a free tile of stream, fills it with the results of chunk
+        i_chunk of the stream's job, and queues it to be read.
+        
+        Returns integer one once the tile has been queued, or integer zero
+        without carrying out the chunk if the stream is being closed. Not
+        expected to fail.
+        
+    Further Information:
+    
+        Waiting here is what bounds the memory of a stream: once every tile
+        is in flight, threads go no further until the reader hands one back.
+        
+        A tile on the diagonal holds only the calculations above it, so the
+        rest of its block is completed by symmetry once the chunk is done.
+        
+*******************************************************************************/
+
+static int
+_pairwise_stream_fill
+(
+
+    pairwise_stream_t* stream,
+    
+    size_t i_chunk
+
+)
+{
+
+    _pairwise_job_t* job;
+    
+    _pairwise_tile_t* tile;
+    
+    size_t n_side;
+    
+    size_t i_row;
+    size_t i_column;
+    
+    job = &stream->job;
+    
+    pthread_mutex_lock(&stream->mutex);
+    
+    while (!stream->free_tiles && !stream->b_closing) {
+        
+        pthread_cond_wait(&stream->tile_free, &stream->mutex);
+    
+    }
+    
+    if (stream->b_closing) {
+        
+        pthread_mutex_unlock(&stream->mutex);
+        
+        return 0;
+    
+    }
+    
+    tile = stream->free_tiles;
+    
+    stream->free_tiles = tile->next;
+    
+    pthread_mutex_unlock(&stream->mutex);
+    
+    _pairwise_locate_chunk(job,
+                           i_chunk,
+                           &tile->i_row_lower,
+                           &tile->i_row_upper,
+                           &tile->i_column_lower,
+                           &tile->i_column_upper);
+                           
+    _pairwise_launch_chunk(job, tile, i_chunk);
+    
+    if (tile->i_row_lower == tile->i_column_lower) {
+        
+        n_side = tile->i_row_upper - tile->i_row_lower;
+        
+        for (i_row = 0; i_row < n_side; i_row ++) {
+            
+            for (i_column = 0; i_column <= i_row; i_column ++) {
+                
+                if (job->s_element == sizeof(float)) {
+                    
+                    *((float*)tile->a_block + (i_row * n_side) + i_column) =
+                        i_row == i_column ? 0 : *((float*)tile->a_block + (i_column * n_side) + i_row);
+                
+                } else {
+                    
+                    *((double*)tile->a_block + (i_row * n_side) + i_column) =
+                        i_row == i_column ? 0 : *((double*)tile->a_block + (i_column * n_side) + i_row);
+                
+                }
+            
+            }
+        
+        }
+    
+    }
+    
+    pthread_mutex_lock(&stream->mutex);
+    
+    tile->next = NULL;
+    
+    if (stream->ready_tail) {
+        
+        stream->ready_tail->next = tile;
+    
+    } else {
+        
+        stream->ready_head = tile;
+    
+    }
+    
+    stream->ready_tail = tile;
+    
+    pthread_cond_signal(&stream->tile_ready);
+    
+    pthread_mutex_unlock(&stream->mutex);
+    
+    return 1;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_stream_bounded
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch_bounded(), but for the job of a stream: fills one
+        tile with each chunk it claims, first from the share of argument_set
+        and then from the shares of the others, until no chunk remains
+        unclaimed or the stream is being closed.
+        
+        On success returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+static void
+_pairwise_stream_bounded
+(
+
+    _pairwise_as_t* argument_set
+
+)
+{
+
+    _pairwise_job_t* job;
+    
+    _pairwise_as_t* victim;
+    
+    size_t i_argument_set;
+    size_t i_victim;
+    
+    size_t i_chunk;
+    
+    job = argument_set->job;
+    
+    i_argument_set = argument_set - job->a_argument_sets;
+    
+    /*
+    *   The first share visited is this thread's own, claimed from the front;
+    *   every other share is stolen from, from the back.
+    */
+    
+    for (i_victim = 0; i_victim < job->n_argument_sets; i_victim ++) {
+        
+        victim = job->a_argument_sets + ((i_argument_set + i_victim) % job->n_argument_sets);
+        
+        while (_pairwise_claim_chunk(victim, i_victim != 0, &i_chunk)) {
+            
+            if (!_pairwise_stream_fill((pairwise_stream_t*)job, i_chunk)) {
+                
+                return;
+            
+            }
+        
+        }
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_stream_drive
+    
+    Type: Static function returning void*
+    
+    Intent: Private
+    
+    Description:
+    
+        The start routine of the driver thread of stream. Passes one call to
+        _pairwise_stream_bounded() per _pairwise_as_t of the stream's job to
+        _pairwise_pool_run(), records its result, and wakes the reader.
+        
+        Returns a null pointer. Not expected to fail.
+        
+*******************************************************************************/
+
+static void*
+_pairwise_stream_drive
+(
+
+    void* stream
+
+)
+{
+
+    pairwise_stream_t* self;
+    
+    int n_return;
+    
+    self = stream;
+    
+    n_return = _pairwise_pool_run((void (*)(void*))_pairwise_stream_bounded,
+                                  self->job.a_argument_sets,
+                                  sizeof(_pairwise_as_t),
+                                  self->job.n_argument_sets);
+                                  
+    pthread_mutex_lock(&self->mutex);
+    
+    self->n_return = n_return;
+    self->b_done = 1;
+    
+    pthread_cond_broadcast(&self->tile_ready);
+    
+    pthread_mutex_unlock(&self->mutex);
+    
+    return NULL;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_stream_free
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Frees stream and everything it owns. Its driver thread, if any, must
+        already have been joined.
+        
+        On success returns nothing. Not expected to fail.
+        
+*******************************************************************************/
+
+static void
+_pairwise_stream_free
+(
+
+    pairwise_stream_t* stream
+
+)
+{
+
+    free(stream->job.a_tile_offsets);
+    free(stream->job.a_argument_sets);
+    
+    free(stream->a_tiles);
+    free(stream->a_blocks);
+    
+    pthread_mutex_destroy(&stream->mutex);
+    pthread_cond_destroy(&stream->tile_free);
+    pthread_cond_destroy(&stream->tile_ready);
+    
+    free(stream);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_stream_job
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Creates a stream for the calculation described by job, whose
+        calculation, stream row driver, input array, element size and
+        dimensions must already be set, and starts it, as described for
+        _pairwise_launch_stream().
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code,
+        and creates no stream.
+        
+    Further Information:
+    
+        The job is cut into tiles by _pairwise_populate_chunks(), asking for
+        as many chunks as tiles n_tile_collections a side would give, and
+        shared between threads by _pairwise_populate_argument_sets(), just as
+        by _pairwise_launch_job(). Only the tiles' blocks differ: rather than
+        one output array, n_queue blocks, each with room for the largest
+        tile, are allocated up front and passed from thread to reader and
+        back again.
+        
+        A stream with no pairwise calculations to carry out is created
+        already done, and no driver thread is started for it.
+        
+*******************************************************************************/
+
+static int
+_pairwise_launch_stream_job
+(
+
+    _pairwise_job_t* job,
+    
+    size_t n_tile_collections,
+    size_t n_queue,
+    
+    size_t n_threads,
+    
+    pairwise_stream_t** stream
+
+)
+{
+
+    int n_return;
+    
+    pairwise_stream_t* self;
+    
+    size_t n_collections;
+    size_t n_tile_blocks;
+    
+    size_t s_block;
+    
+    size_t i_tile;
+    
+    n_collections = job->n_collections;
+    
+    self = calloc(1, sizeof(pairwise_stream_t));
+    
+    if (!self) {
+        
+        return PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    if (pthread_mutex_init(&self->mutex, NULL)) {
+        
+        free(self);
+        
+        return PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    if (pthread_cond_init(&self->tile_free, NULL)) {
+        
+        pthread_mutex_destroy(&self->mutex);
+        
+        free(self);
+        
+        return PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    if (pthread_cond_init(&self->tile_ready, NULL)) {
+        
+        pthread_mutex_destroy(&self->mutex);
+        pthread_cond_destroy(&self->tile_free);
+        
+        free(self);
+        
+        return PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    self->job = *job;
+    
+    job = &self->job;
+    
+    job->a_collections_b = job->a_collections;
+    job->a_results = NULL;
+    
+    job->a_sinks = NULL;
+    job->s_sink = 0;
+    
+    job->b_cross = 0;
+    job->b_append = 0;
+    
+    job->n_collections_b = n_collections;
+    
+    job->f_tile = NULL;
+    
+    job->b_cancel = 0;
+    
+    job->a_tile_offsets = NULL;
+    
+    job->n_argument_sets = 0;
+    job->a_argument_sets = NULL;
+    
+    /*
+    *   As in _pairwise_launch_job(), there may be nothing to calculate.
+    */
+    
+    if (n_collections < 2 || !job->n_points || !job->n_coordinates) {
+        
+        self->b_done = 1;
+        
+        *stream = self;
+        
+        return PAIRWISE_RETURN_SUCCESS;
+    
+    }
+    
+    if (!n_threads) {
+        
+        _pairwise_stream_free(self);
+        
+        return PAIRWISE_RETURN_ERROR_NTHREADS;
+    
+    }
+    
+    if (!n_tile_collections) {
+        
+        n_tile_collections = _PAIRWISE_STREAM_TILE_COLLECTIONS;
+    
+    }
+    
+    if (!n_queue) {
+        
+        n_queue = n_threads * _PAIRWISE_STREAM_TILES_PER_THREAD;
+    
+    }
+    
+    /*
+    *   A triangle n_tile_blocks tiles to a side holds
+    *   0.5 * n_tile_blocks * (n_tile_blocks + 1) tiles, which is the target
+    *   from which _pairwise_populate_chunks() recovers n_tile_blocks.
+    */
+    
+    n_tile_blocks = (n_collections + n_tile_collections - 1) / n_tile_collections;
+    
+    n_return = _pairwise_populate_chunks(job, (n_tile_blocks * (n_tile_blocks + 1)) / 2);
+    
+    if (n_return) {
+        
+        _pairwise_stream_free(self);
+        
+        return n_return;
+    
+    }
+    
+    /*
+    *   There is no use for more threads, or more tiles in flight, than
+    *   chunks.
+    */
+    
+    if (n_threads > job->n_chunks) {
+        
+        n_threads = job->n_chunks;
+    
+    }
+    
+    if (n_queue > job->n_chunks) {
+        
+        n_queue = job->n_chunks;
+    
+    }
+    
+    s_block = job->n_tile_collections * job->n_tile_collections * job->s_element;
+    
+    job->a_argument_sets = malloc(n_threads * sizeof(_pairwise_as_t));
+    
+    self->a_tiles = malloc(n_queue * sizeof(_pairwise_tile_t));
+    self->a_blocks = malloc(n_queue * s_block);
+    
+    if (!job->a_argument_sets || !self->a_tiles || !self->a_blocks) {
+        
+        _pairwise_stream_free(self);
+        
+        return PAIRWISE_RETURN_MALLOC_FAIL;
+    
+    }
+    
+    _pairwise_populate_argument_sets(job, n_threads, job->a_argument_sets);
+    
+    self->n_tiles = n_queue;
+    
+    for (i_tile = 0; i_tile < n_queue; i_tile ++) {
+        
+        (self->a_tiles + i_tile)->a_block = (char*)self->a_blocks + (i_tile * s_block);
+        
+        (self->a_tiles + i_tile)->next = i_tile + 1 < n_queue ? self->a_tiles + i_tile + 1 : NULL;
+    
+    }
+    
+    self->free_tiles = self->a_tiles;
+    
+    n_return = pthread_create(&self->driver, NULL, _pairwise_stream_drive, self);
+    
+    if (n_return) {
+        
+        _pairwise_stream_free(self);
+        
+        switch (n_return) {
+            
+            case EAGAIN: return PAIRWISE_RETURN_PTHREAD_CREATE_EAGAIN;
+            
+            case EINVAL: return PAIRWISE_RETURN_PTHREAD_CREATE_EINVAL;
+            
+            case EPERM: return PAIRWISE_RETURN_PTHREAD_CREATE_EPERM;
+            
+            default: return PAIRWISE_RETURN_PTHREAD_CREATE_UNKNOWN;
+        
+        }
+    
+    }
+    
+    self->b_driver = 1;
+    
+    *stream = self;
+    
+    return PAIRWISE_RETURN_SUCCESS;
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_stream
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Starts applying a calculation function, f_calculation, to all
+        pairwise combinations of collections in a set of collections,
+        a_collections, as _pairwise_launch() does, but hands the results to
+        the caller tile by tile through a new stream, a pointer to which is
+        stored in stream.
+        
+        n_collections, n_points, n_coordinates, a_collections and n_threads
+        are as for _pairwise_launch(). Tiles are no more than
+        n_tile_collections collections a side, and smaller if the
+        collections would not otherwise fit in cache. No more than n_queue
+        tiles are in flight at once - being filled, waiting to be read or
+        being read - so threads wait whenever the reader falls behind, and
+        memory is fixed at n_queue tiles. Zero for either chooses it
+        automatically. a_collections must outlive the stream.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero; the caller must then pass the stream to
+        pairwise_stream_close(). On failure returns a non-zero libpairwise
+        error code, and creates no stream.
+        
+    Further Information:
+    
+        This function describes the calculation in a _pairwise_job_t with
+        the row driver _pairwise_launch_row_stream(), and passes it to
+        _pairwise_launch_stream_job().
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_stream
+(
+
+    double (*f_calculation)(size_t n_points,
+                            size_t n_coordinates,
+                            double* collection_a,
+                            double* collection_b),
+                            
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    double* a_collections,
+    
+    size_t n_tile_collections,
+    size_t n_queue,
+    
+    size_t n_threads,
+    
+    pairwise_stream_t** stream
+
+)
+{
+
+    _pairwise_job_t job;
+    
+    job.f_calculation = f_calculation;
+    job.f_calculation_float = NULL;
+    job.f_row = _pairwise_launch_row_stream;
+    
+    job.a_collections = a_collections;
+    
+    job.s_element = sizeof(double);
+    
+    job.cutoff = 0;
+    
+    job.n_collections = n_collections;
+    job.n_points = n_points;
+    job.n_coordinates = n_coordinates;
+    
+    return _pairwise_launch_stream_job(&job,
+                                       n_tile_collections,
+                                       n_queue,
+                                       n_threads,
+                                       stream);
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_launch_stream_float
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        As _pairwise_launch_stream(), but for a calculation on collections of
+        floats, f_calculation, whose results are handed over as floats.
+        
+*******************************************************************************/
+
+int
+_pairwise_launch_stream_float
+(
+
+    float (*f_calculation)(size_t n_points,
+                           size_t n_coordinates,
+                           float* collection_a,
+                           float* collection_b),
+                           
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates,
+    
+    float* a_collections,
+    
+    size_t n_tile_collections,
+    size_t n_queue,
+    
+    size_t n_threads,
+    
+    pairwise_stream_t** stream
+
+)
+{
+
+    _pairwise_job_t job;
+    
+    job.f_calculation = NULL;
+    job.f_calculation_float = f_calculation;
+    job.f_row = _pairwise_launch_row_stream_float;
+    
+    job.a_collections = a_collections;
+    
+    job.s_element = sizeof(float);
+    
+    job.cutoff = 0;
+    
+    job.n_collections = n_collections;
+    job.n_points = n_points;
+    job.n_coordinates = n_coordinates;
+    
+    return _pairwise_launch_stream_job(&job,
+                                       n_tile_collections,
+                                       n_queue,
+                                       n_threads,
+                                       stream);
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_stream_next
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Waits for the next tile of stream to be finished, and stores in
+        a_block a pointer to its results and in i_row_lower, i_row_upper,
+        i_column_lower and i_column_upper the collections - or points - it
+        covers. The results are those between every collection from
+        i_row_lower up to but excluding i_row_upper and every collection from
+        i_column_lower up to but excluding i_column_upper, as a row-major
+        matrix of doubles or floats, as the stream was created for.
+        
+        Tiles cover the upper triangle of the matrix of all pairwise results
+        once each, in whatever order threads finish them. A tile on the
+        diagonal, whose rows and columns are the same collections, is
+        completed by symmetry, with zero on its diagonal.
+        
+        The results stay valid until the next call to pairwise_stream_next()
+        or pairwise_stream_close() for stream, after which the tile is reused.
+        Once every tile has been handed over, stores a null pointer in
+        a_block. Only one thread at a time may read from a stream.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure of the calculation returns a non-zero
+        libpairwise error code, in place of the end of the stream.
+        
+    Further Information:
+    
+        The tile read last time is handed back first, waking one thread if
+        any is waiting for a free tile. Ready tiles are read in the order in
+        which they were finished.
+        
+*******************************************************************************/
+
+int
+pairwise_stream_next
+(
+
+    pairwise_stream_t* stream,
+    
+    size_t* i_row_lower,
+    size_t* i_row_upper,
+    size_t* i_column_lower,
+    size_t* i_column_upper,
+    
+    void** a_block
+
+)
+{
+
+    _pairwise_tile_t* tile;
+    
+    int n_return;
+    
+    pthread_mutex_lock(&stream->mutex);
+    
+    if (stream->held_tile) {
+        
+        stream->held_tile->next = stream->free_tiles;
+        
+        stream->free_tiles = stream->held_tile;
+        stream->held_tile = NULL;
+        
+        pthread_cond_signal(&stream->tile_free);
+    
+    }
+    
+    while (!stream->ready_head && !stream->b_done) {
+        
+        pthread_cond_wait(&stream->tile_ready, &stream->mutex);
+    
+    }
+    
+    tile = stream->ready_head;
+    
+    if (!tile) {
+        
+        n_return = stream->n_return;
+        
+        pthread_mutex_unlock(&stream->mutex);
+        
+        *a_block = NULL;
+        
+        return n_return;
+    
+    }
+    
+    stream->ready_head = tile->next;
+    
+    if (!stream->ready_head) {
+        
+        stream->ready_tail = NULL;
+    
+    }
+    
+    stream->held_tile = tile;
+    
+    pthread_mutex_unlock(&stream->mutex);
+    
+    *i_row_lower = tile->i_row_lower;
+    *i_row_upper = tile->i_row_upper;
+    *i_column_lower = tile->i_column_lower;
+    *i_column_upper = tile->i_column_upper;
+    
+    *a_block = tile->a_block;
+    
+    return PAIRWISE_RETURN_SUCCESS;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_stream_close
+    
+    Type: Function returning int
+    
+    Intent: Public
+    
+    Description:
+    
+        Stops stream, whether or not every tile has been read, waits for its
+        threads to finish the tiles they are filling, and frees it.
+        
+        On success returns PAIRWISE_RETURN_SUCCESS which is always equivalent
+        to integer zero. On failure returns a non-zero libpairwise error code;
+        stream is freed nonetheless.
+        
+    Further Information:
+    
+        Threads waiting for a free tile are woken to find the stream closing,
+        and claim no more chunks, so the driver thread's call to
+        _pairwise_pool_run() returns once the tiles already being filled are
+        done.
+        
+*******************************************************************************/
+
+int
+pairwise_stream_close
+(
+
+    pairwise_stream_t* stream
+
+)
+{
+
+    int n_return;
+    
+    pthread_mutex_lock(&stream->mutex);
+    
+    stream->b_closing = 1;
+    
+    pthread_cond_broadcast(&stream->tile_free);
+    
+    pthread_mutex_unlock(&stream->mutex);
+    
+    n_return = PAIRWISE_RETURN_SUCCESS;
+    
+    if (stream->b_driver) {
+        
+        n_return = pthread_join(stream->driver, NULL);
+        
+        switch (n_return) {
+            
+            case 0: n_return = stream->n_return; break;
+            
+            case EDEADLK: n_return = PAIRWISE_RETURN_PTHREAD_JOIN_EDEADLK; break;
+            
+            case EINVAL: n_return = PAIRWISE_RETURN_PTHREAD_JOIN_EINVAL; break;
+            
+            case ESRCH: n_return = PAIRWISE_RETURN_PTHREAD_JOIN_ESRCH; break;
+            
+            default: n_return = PAIRWISE_RETURN_PTHREAD_JOIN_UNKNOWN;
+        
+        }
+    
+    }
+    
+    _pairwise_stream_free(stream);
+    
+    return n_return;
+
+}
@@ -0,0 +1,265 @@
+/*
+*   sched_getaffinity() and the CPU_* macros are GNU extensions, and must be
+*   requested before any system header is included.
+*/
+
+#define _GNU_SOURCE
+
+#include <sched.h>
+
+#include "pairwise_threads.h"
+
+static pthread_once_t _pairwise_threads_quota_once = PTHREAD_ONCE_INIT;
+
+static size_t _pairwise_threads_quota_value = 0;
+
+/*******************************************************************************
+
+    Symbol: _pairwise_threads_read_quota
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Reads the CPU quota of the control group of the calling process into
+        _pairwise_threads_quota_value. Run once by _pairwise_threads_quota().
+        
+    Further Information:
+    
+        Under cgroup v2 the quota is the file cpu.max, which holds either
+        "max PERIOD" for no quota, or "QUOTA PERIOD" in microseconds. Under
+        cgroup v1 the quota and period are the files cpu.cfs_quota_us and
+        cpu.cfs_period_us, and a quota of -1 means none. Only the control
+        group mounted at /sys/fs/cgroup is read, which inside a container
+        with its own cgroup namespace - the case this exists for - is the
+        container's own.
+        
+*******************************************************************************/
+
+static void
+_pairwise_threads_read_quota
+(void)
+{
+
+    FILE* file;
+    
+    long long n_quota;
+    long long n_period;
+    
+    int n_read;
+    
+    n_read = 0;
+    
+    file = fopen("/sys/fs/cgroup/cpu.max", "r");
+    
+    if (file) {
+        
+        n_read = fscanf(file, "%lld %lld", &n_quota, &n_period);
+        
+        fclose(file);
+    
+    } else {
+        
+        file = fopen("/sys/fs/cgroup/cpu/cpu.cfs_quota_us", "r");
+        
+        if (file) {
+            
+            n_read = fscanf(file, "%lld", &n_quota);
+            
+            fclose(file);
+        
+        }
+        
+        file = fopen("/sys/fs/cgroup/cpu/cpu.cfs_period_us", "r");
+        
+        if (file) {
+            
+            n_read += fscanf(file, "%lld", &n_period);
+            
+            fclose(file);
+        
+        }
+    
+    }
+    
+    /*
+    *   A failed or partial read, "max", or -1 all leave no quota.
+    */
+    
+    if (n_read == 2 && n_quota > 0 && n_period > 0) {
+        
+        _pairwise_threads_quota_value = (n_quota + n_period - 1) / n_period;
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: _pairwise_threads_quota
+    
+    Type: Function returning size_t
+    
+    Intent: Private
+    
+    Description:
+    
+        Returns the CPU quota of the control group of the calling process,
+        rounded up to whole processors, or zero if there is no quota or it
+        cannot be read. Looked up once, on first call. Not expected to fail.
+        
+*******************************************************************************/
+
+size_t
+_pairwise_threads_quota
+(void)
+{
+
+    pthread_once(&_pairwise_threads_quota_once, _pairwise_threads_read_quota);
+    
+    return _pairwise_threads_quota_value;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_threads_available
+    
+    Type: Function returning size_t
+    
+    Intent: Public
+    
+    Description:
+    
+        Returns the number of threads which the calling thread can usefully
+        run in parallel: the number of processors in its CPU affinity mask,
+        further limited by any CPU quota set on its control group. Always
+        returns at least one. Not expected to fail.
+        
+    Further Information:
+    
+        The affinity mask is read afresh on every call, since it may be
+        changed at any time, for example by taskset. If it cannot be read,
+        the number of processors online is used instead. The count of
+        processors online alone would oversubscribe jobs confined by a batch
+        scheduler or container runtime to a few of a large host's cores.
+        
+*******************************************************************************/
+
+size_t
+pairwise_threads_available
+(void)
+{
+
+    size_t n_threads;
+    size_t n_quota;
+    
+    long n_online;
+    
+    n_threads = 0;
+    
+    #if defined(CPU_COUNT)
+    {
+        
+        cpu_set_t cpus;
+        
+        if (!sched_getaffinity(0, sizeof(cpu_set_t), &cpus)) {
+            
+            n_threads = CPU_COUNT(&cpus);
+        
+        }
+    
+    }
+    #endif
+    
+    if (!n_threads) {
+        
+        n_online = sysconf(_SC_NPROCESSORS_ONLN);
+        
+        n_threads = (n_online > 0) ? n_online : 1;
+    
+    }
+    
+    n_quota = _pairwise_threads_quota();
+    
+    if (n_quota && n_quota < n_threads) {
+        
+        n_threads = n_quota;
+    
+    }
+    
+    return n_threads;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pairwise_threads_suggested
+    
+    Type: Function returning size_t
+    
+    Intent: Public
+    
+    Description:
+    
+        Returns the number of threads with which to carry out all pairwise
+        calculations across n_collections collections of n_points points of
+        n_coordinates coordinates each. This is pairwise_threads_available(),
+        reduced for small inputs so that every thread has enough work to
+        repay waking it. Always returns at least one. Not expected to fail.
+        
+    Further Information:
+    
+        Work is measured in coordinate differences: each of the
+        0.5 * n_collections * (n_collections - 1) pairwise calculations
+        visits n_points * n_coordinates of them. Each thread is given at
+        least _PAIRWISE_THREADS_MIN_ELEMENTS, which takes a core roughly a
+        hundred microseconds - several times what it costs to hand a task to
+        a sleeping worker of the libpairwise worker pool.
+        
+*******************************************************************************/
+
+size_t
+pairwise_threads_suggested
+(
+
+    size_t n_collections,
+    size_t n_points,
+    size_t n_coordinates
+
+)
+{
+
+    size_t n_threads;
+    
+    double n_elements;
+    double n_threads_useful;
+    
+    n_threads = pairwise_threads_available();
+    
+    if (n_collections < 2) {
+        
+        return 1;
+    
+    }
+    
+    /*
+    *   Work in double precision, which cannot overflow for any input that
+    *   fits in memory.
+    */
+    
+    n_elements = 0.5 * n_collections * (n_collections - 1) * (double)n_points * n_coordinates;
+    
+    n_threads_useful = n_elements / _PAIRWISE_THREADS_MIN_ELEMENTS;
+    
+    if (n_threads_useful < n_threads) {
+        
+        n_threads = (n_threads_useful < 1) ? 1 : n_threads_useful;
+    
+    }
+    
+    return n_threads;
+
+}
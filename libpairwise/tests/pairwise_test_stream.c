@@ -0,0 +1,335 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pairwise.h"
+
+/*******************************************************************************
+
+    pairwise_test_stream
+    
+    A unit test for pairwise_distances_stream() and
+    pairwise_distances_stream_float(), checking that the tiles they hand over
+    cover the upper triangle of the matrix of results exactly once and agree
+    with pairwise_distances() and pairwise_distances_float().
+    
+    Usage: ./pairwise_test_stream
+    
+    Before each stream is opened, the stack beneath the caller is filled with
+    a non-zero pattern, so that any part of a stream's job left uninitialised
+    is found at any level of optimisation rather than only by chance.
+    
+    Built and run by "make test" in the libpairwise directory.
+    
+*******************************************************************************/
+
+#define TEST_N_POINTS 700
+#define TEST_N_COORDINATES 3
+#define TEST_N_TILE 64
+#define TEST_N_QUEUE 3
+#define TEST_N_THREADS 3
+
+static const char* test_name = "pairwise_test_stream";
+
+/*******************************************************************************
+
+    Symbol: test_sizes
+    
+    Type: Static array of size_t
+    
+    Intent: Private
+    
+    Description:
+    
+        The numbers of points to stream: fewer than a tile, a tile and one
+        point, and many tiles.
+        
+*******************************************************************************/
+
+static const size_t
+test_sizes[] = {
+    
+    2,
+    TEST_N_TILE + 1,
+    TEST_N_POINTS
+
+};
+
+/*******************************************************************************
+
+    Symbol: test_dirty_stack
+    
+    Type: Static function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Fills a large stack frame with a non-zero pattern, leaving it behind
+        for the frames of the next call made by its caller.
+        
+*******************************************************************************/
+
+static void
+test_dirty_stack
+(void)
+{
+
+    volatile unsigned char a_stack[1 << 16];
+    
+    size_t i_byte;
+    
+    for (i_byte = 0; i_byte < sizeof(a_stack); i_byte ++) {
+        
+        a_stack[i_byte] = 0xA5;
+    
+    }
+
+}
+
+/*******************************************************************************
+
+    Symbol: test_stream
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Opens a stream over the n_points points of a_points, of doubles or,
+        if b_float, floats, reads every tile from it and compares each result
+        with the condensed a_expected, counting how often each is seen.
+        Returns zero if every result was seen exactly once and agreed, and
+        otherwise prints why not and returns one.
+        
+*******************************************************************************/
+
+static int
+test_stream
+(
+
+    size_t n_points,
+    
+    void* a_points,
+    void* a_expected,
+    
+    int b_float
+
+)
+{
+
+    pairwise_stream_t* stream;
+    
+    unsigned char* a_seen;
+    
+    void* a_block;
+    
+    size_t i_row_lower, i_row_upper, i_column_lower, i_column_upper;
+    size_t i_row, i_column, i_result, i_block;
+    
+    double result, expected;
+    
+    int n_return;
+    int b_failed;
+    
+    a_seen = calloc((n_points * (n_points - 1)) / 2, 1);
+    
+    if (!a_seen) {
+        
+        printf("%s: Failed - couldn't allocate memory.\n", test_name);
+        
+        return 1;
+    
+    }
+    
+    b_failed = 0;
+    
+    test_dirty_stack();
+    
+    n_return = b_float ? pairwise_distances_stream_float(n_points,
+                                                         TEST_N_COORDINATES,
+                                                         a_points,
+                                                         TEST_N_TILE,
+                                                         TEST_N_QUEUE,
+                                                         TEST_N_THREADS,
+                                                         &stream)
+                       : pairwise_distances_stream(n_points,
+                                                   TEST_N_COORDINATES,
+                                                   a_points,
+                                                   TEST_N_TILE,
+                                                   TEST_N_QUEUE,
+                                                   TEST_N_THREADS,
+                                                   &stream);
+                                                   
+    if (n_return) {
+        
+        printf("%s: Failed - opening a stream returned %d.\n", test_name,
+               n_return);
+               
+        free(a_seen);
+        
+        return 1;
+    
+    }
+    
+    while (!(n_return = pairwise_stream_next(stream,
+                                             &i_row_lower,
+                                             &i_row_upper,
+                                             &i_column_lower,
+                                             &i_column_upper,
+                                             &a_block)) && a_block) {
+        
+        for (i_row = i_row_lower; i_row < i_row_upper; i_row ++) {
+            
+            for (i_column = i_column_lower; i_column < i_column_upper; i_column ++) {
+                
+                if (i_column <= i_row) {
+                    
+                    continue;
+                
+                }
+                
+                i_result = (i_row * n_points) - ((i_row * (i_row + 1)) / 2)
+                         + (i_column - i_row - 1);
+                         
+                i_block = ((i_row - i_row_lower) * (i_column_upper - i_column_lower))
+                        + (i_column - i_column_lower);
+                        
+                result = b_float ? *((float*)a_block + i_block)
+                                 : *((double*)a_block + i_block);
+                                 
+                expected = b_float ? *((float*)a_expected + i_result)
+                                   : *((double*)a_expected + i_result);
+                                   
+                if (result != expected) {
+                    
+                    b_failed = 1;
+                
+                }
+                
+                *(a_seen + i_result) += 1;
+            
+            }
+        
+        }
+    
+    }
+    
+    if (n_return) {
+        
+        printf("%s: Failed - reading a stream returned %d.\n", test_name,
+               n_return);
+               
+        b_failed = 1;
+    
+    }
+    
+    pairwise_stream_close(stream);
+    
+    for (i_result = 0; i_result < (n_points * (n_points - 1)) / 2; i_result ++) {
+        
+        if (*(a_seen + i_result) != 1) {
+            
+            b_failed = 1;
+        
+        }
+    
+    }
+    
+    free(a_seen);
+    
+    if (b_failed) {
+        
+        printf("%s: Failed - a %s stream of %zu points disagreed with "
+               "pairwise_distances%s().\n", test_name,
+               b_float ? "float" : "double", n_points, b_float ? "_float" : "");
+               
+        return 1;
+    
+    }
+    
+    return 0;
+
+}
+
+int
+main
+(void)
+{
+
+    double* a_points;
+    double* a_expected;
+    
+    float* a_points_float;
+    float* a_expected_float;
+    
+    size_t n_points;
+    size_t i_size;
+    size_t i_coordinate;
+    
+    int b_failed;
+    
+    a_points = malloc(TEST_N_POINTS * TEST_N_COORDINATES * sizeof(double));
+    a_expected = malloc(((TEST_N_POINTS * (TEST_N_POINTS - 1)) / 2) * sizeof(double));
+    
+    a_points_float = malloc(TEST_N_POINTS * TEST_N_COORDINATES * sizeof(float));
+    a_expected_float = malloc(((TEST_N_POINTS * (TEST_N_POINTS - 1)) / 2) * sizeof(float));
+    
+    if (!a_points || !a_expected || !a_points_float || !a_expected_float) {
+        
+        printf("%s: Failed - couldn't allocate memory.\n", test_name);
+        
+        return 1;
+    
+    }
+    
+    srand(1);
+    
+    for (i_coordinate = 0; i_coordinate < TEST_N_POINTS * TEST_N_COORDINATES; i_coordinate ++) {
+        
+        *(a_points + i_coordinate) = (double)rand() / RAND_MAX;
+        *(a_points_float + i_coordinate) = (float)*(a_points + i_coordinate);
+    
+    }
+    
+    b_failed = 0;
+    
+    for (i_size = 0; i_size < sizeof(test_sizes) / sizeof(size_t) && !b_failed; i_size ++) {
+        
+        n_points = test_sizes[i_size];
+        
+        if (pairwise_distances(n_points, TEST_N_COORDINATES, a_points,
+                               a_expected, TEST_N_THREADS)
+        ||  pairwise_distances_float(n_points, TEST_N_COORDINATES,
+                                     a_points_float, a_expected_float,
+                                     TEST_N_THREADS)) {
+            
+            printf("%s: Failed - couldn't calculate reference distances.\n",
+                   test_name);
+                   
+            return 1;
+        
+        }
+        
+        b_failed = test_stream(n_points, a_points, a_expected, 0)
+                || test_stream(n_points, a_points_float, a_expected_float, 1);
+    
+    }
+    
+    free(a_points);
+    free(a_expected);
+    free(a_points_float);
+    free(a_expected_float);
+    
+    if (b_failed) {
+        
+        return 1;
+    
+    }
+    
+    printf("%s: Passed!\n", test_name);
+    
+    return 0;
+
+}
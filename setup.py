@@ -61,11 +61,23 @@ if __name__ == "__main__":
         sources = [
             
             os.path.join("source", "pywise_exception.c"),
+            os.path.join("source", "pywise_buffer.c"),
             os.path.join("source", "pywise_build_collections_array.c"),
             os.path.join("source", "pywise_build_points_array.c"),
             os.path.join("source", "pywise_rmsds.c"),
             os.path.join("source", "pywise_distances.c"),
+            os.path.join("source", "pywise_knn.c"),
+            os.path.join("source", "pywise_cross.c"),
+            os.path.join("source", "pywise_tiles.c"),
+            os.path.join("source", "pywise_future.c"),
+            os.path.join("source", "pywise_file.c"),
+            os.path.join("source", "pywise_reduce.c"),
+            os.path.join("source", "pywise_linkage.c"),
+            os.path.join("source", "pywise_append.c"),
             os.path.join("source", "pywise_index.c"),
+            os.path.join("source", "pywise_isa.c"),
+            os.path.join("source", "pywise_pool.c"),
+            os.path.join("source", "pywise_stats.c"),
             os.path.join("source", "pywise.c")
         
         ],
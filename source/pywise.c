@@ -35,6 +35,114 @@ pywise_methods[] = {
 	
 	},
 	
+	{
+	
+	    "knn",
+	    (PyCFunction)pywise_knn,
+	    METH_VARARGS | METH_KEYWORDS,
+	    NULL
+	
+	},
+	
+	{
+	
+	    "cross_distances",
+	    (PyCFunction)pywise_cross_distances,
+	    METH_VARARGS | METH_KEYWORDS,
+	    NULL
+	
+	},
+	
+	{
+	
+	    "cross_rmsds",
+	    (PyCFunction)pywise_cross_rmsds,
+	    METH_VARARGS | METH_KEYWORDS,
+	    NULL
+	
+	},
+	
+	{
+	
+	    "tiles",
+	    (PyCFunction)pywise_tiles,
+	    METH_VARARGS | METH_KEYWORDS,
+	    NULL
+	
+	},
+	
+	{
+	
+	    "submit_distances",
+	    (PyCFunction)pywise_submit_distances,
+	    METH_VARARGS | METH_KEYWORDS,
+	    NULL
+	
+	},
+	
+	{
+	
+	    "submit_rmsds",
+	    (PyCFunction)pywise_submit_rmsds,
+	    METH_VARARGS | METH_KEYWORDS,
+	    NULL
+	
+	},
+	
+	{
+	
+	    "load",
+	    (PyCFunction)pywise_load,
+	    METH_VARARGS | METH_KEYWORDS,
+	    NULL
+	
+	},
+	
+	{
+	
+	    "pair_stats",
+	    (PyCFunction)pywise_pair_stats,
+	    METH_VARARGS | METH_KEYWORDS,
+	    NULL
+	
+	},
+	
+	{
+	
+	    "histogram",
+	    (PyCFunction)pywise_histogram,
+	    METH_VARARGS | METH_KEYWORDS,
+	    NULL
+	
+	},
+	
+	{
+	
+	    "row_sums",
+	    (PyCFunction)pywise_row_sums,
+	    METH_VARARGS | METH_KEYWORDS,
+	    NULL
+	
+	},
+	
+	{
+	
+	    "single_linkage",
+	    (PyCFunction)pywise_single_linkage,
+	    METH_VARARGS | METH_KEYWORDS,
+	    NULL
+	
+	},
+	
+	{
+	
+	    "append",
+	    (PyCFunction)pywise_append,
+	    METH_VARARGS | METH_KEYWORDS,
+	    NULL
+	
+	},
+	
 	{
 	
 	    "index",
@@ -44,6 +152,96 @@ pywise_methods[] = {
 	
 	},
 	
+	{
+	
+	    "indices",
+	    (PyCFunction)pywise_indices,
+	    METH_VARARGS | METH_KEYWORDS,
+	    NULL
+	
+	},
+	
+	{
+	
+	    "indices_inverse",
+	    (PyCFunction)pywise_indices_inverse,
+	    METH_VARARGS | METH_KEYWORDS,
+	    NULL
+	
+	},
+	
+	{
+	    
+	    "set_isa",
+	    (PyCFunction)pywise_set_isa,
+	    METH_VARARGS | METH_KEYWORDS,
+	    NULL
+	
+	},
+	
+	{
+	    
+	    "get_isa",
+	    (PyCFunction)pywise_get_isa,
+	    METH_NOARGS,
+	    NULL
+	
+	},
+	
+	{
+	
+	    "pool_resize",
+	    (PyCFunction)pywise_pool_resize,
+	    METH_VARARGS | METH_KEYWORDS,
+	    NULL
+	
+	},
+	
+	{
+	
+	    "pool_size",
+	    (PyCFunction)pywise_pool_size,
+	    METH_NOARGS,
+	    NULL
+	
+	},
+	
+	{
+	
+	    "pool_shutdown",
+	    (PyCFunction)pywise_pool_shutdown,
+	    METH_NOARGS,
+	    NULL
+	
+	},
+	
+	{
+	
+	    "pool_set_affinity",
+	    (PyCFunction)pywise_pool_set_affinity,
+	    METH_VARARGS | METH_KEYWORDS,
+	    NULL
+	
+	},
+	
+	{
+	
+	    "pool_get_affinity",
+	    (PyCFunction)pywise_pool_get_affinity,
+	    METH_NOARGS,
+	    NULL
+	
+	},
+	
+	{
+	
+	    "last_stats",
+	    (PyCFunction)pywise_last_stats,
+	    METH_NOARGS,
+	    NULL
+	
+	},
+	
 	{
 	    
 	    NULL,
@@ -65,8 +263,9 @@ pywise_methods[] = {
     
     Description:
     
-        Registers the methods listed in pywise_methods, registers module
-        constants, and then initialises the C-API for NumPy arrays.
+        Readies the pywise.Tiles and pywise.Future types, registers the
+        methods listed in pywise_methods, registers module constants and
+        types, and then initialises the C-API for NumPy arrays.
         Automatically called by the Python interpreter when the pywise module
         is imported.
         
@@ -78,11 +277,41 @@ initpywise
 {
 
     PyObject* o_module;
+    PyObject* o_tiles_type;
+    PyObject* o_future_type;
+    
+    if (pywise_tiles_prepare_type() || pywise_future_prepare_type()) {
+        
+        return;
+    
+    }
     
     o_module = Py_InitModule("pywise", pywise_methods);
     
     PyModule_AddStringConstant(o_module, "__version__", PYWISE_VERSION);
     
+    PyModule_AddIntConstant(o_module, "ISA_AUTO", PAIRWISE_ISA_AUTO);
+    PyModule_AddIntConstant(o_module, "ISA_SCALAR", PAIRWISE_ISA_SCALAR);
+    PyModule_AddIntConstant(o_module, "ISA_SSE2", PAIRWISE_ISA_SSE2);
+    PyModule_AddIntConstant(o_module, "ISA_AVX2", PAIRWISE_ISA_AVX2);
+    PyModule_AddIntConstant(o_module, "ISA_AVX512", PAIRWISE_ISA_AVX512);
+    
+    PyModule_AddIntConstant(o_module, "AFFINITY_NONE", PAIRWISE_AFFINITY_NONE);
+    PyModule_AddIntConstant(o_module, "AFFINITY_CORES", PAIRWISE_AFFINITY_CORES);
+    PyModule_AddIntConstant(o_module, "AFFINITY_NODES", PAIRWISE_AFFINITY_NODES);
+    
+    o_tiles_type = (PyObject*)&pywise_tiles_type;
+    
+    Py_INCREF(o_tiles_type);
+    
+    PyModule_AddObject(o_module, "Tiles", o_tiles_type);
+    
+    o_future_type = (PyObject*)&pywise_future_type;
+    
+    Py_INCREF(o_future_type);
+    
+    PyModule_AddObject(o_module, "Future", o_future_type);
+    
     import_array();
 
 }
@@ -0,0 +1,437 @@
+#include "pywise_append.h"
+
+/*******************************************************************************
+
+    Symbol: pywise_append
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.append()
+    
+    Python Signature:
+    
+        pywise.append(results, source, threads = 0, out = None,
+                      metric = "euclidean", dtype = None)
+            -> numpy.ndarray
+            
+    Description:
+    
+        Extends results, the condensed results of pywise.distances() or
+        pywise.rmsds() across some number N of points or collections, to the
+        condensed results across every point or collection of source, which
+        must hold those N followed by any number M of new ones. Only the
+        results which involve a new point are calculated. metric is
+        "euclidean" or "rmsd", as for pywise.knn(), and the results are
+        calculated in the precision of results unless dtype says otherwise.
+        
+        If out is given, it must be a writable, one-dimensional array of the
+        results' dtype with exactly one element per pair of points of source,
+        sharing no memory with source, and the results are stored in it;
+        results may be a view of the start of out, as out[:len(results)], in
+        which case the old results are moved in place, and otherwise the two
+        must not overlap.
+        
+        On success pywise_append() returns out if given, or otherwise a new
+        one-dimensional NumPy array of the results, laid out as
+        pywise.index() describes for N + M points. On failure it raises a
+        Python exception.
+        
+    Further Information:
+    
+        N is found from the length of results. No results at all may be
+        those of either none or one point, but both need every result of
+        source calculated, so the ambiguity is harmless. results is borrowed
+        without copying if it is already a contiguous array of the right
+        dtype, as it always is when it came from pywise; an out which starts
+        at the same memory then lets a growing set of results be kept in one
+        preallocated buffer, from which each call calculates only the new
+        results and moves the old ones forward, as pairwise_rmsds_append()
+        describes.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_append
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+)
+{
+
+    char* keywords[7] = {"results", "source", "threads", "out", "metric",
+                         "dtype", NULL};
+                         
+    Py_ssize_t n_threads;
+    
+    PyObject* o_results_old;
+    PyObject* o_source;
+    PyObject* o_out;
+    PyObject* o_dtype;
+    PyObject* o_results;
+    
+    char* metric;
+    
+    size_t n_collections;
+    size_t n_collections_old;
+    size_t n_points;
+    size_t n_coordinates;
+    
+    void* a_collections;
+    void* a_results_old;
+    void* a_results;
+    
+    size_t l_a_results_old;
+    size_t l_a_results;
+    size_t s_element;
+    
+    Py_ssize_t a_shape[1];
+    
+    int b_rmsd;
+    
+    int n_type;
+    
+    Py_buffer view;
+    Py_buffer view_old;
+    Py_buffer view_out;
+    
+    npy_intp npy_l_a_results[1];
+    
+    int n_return;
+    
+    n_threads = PYWISE_DEFAULT_THREADS;
+    
+    metric = "euclidean";
+    
+    o_out = NULL;
+    o_dtype = NULL;
+    
+    n_return = PyArg_ParseTupleAndKeywords(values, keys, "OO|nOsO:append",
+                                           keywords, &o_results_old, &o_source,
+                                           &n_threads, &o_out, &metric,
+                                           &o_dtype);
+                                           
+    if (!n_return) {
+        
+        return NULL;
+    
+    }
+    
+    if (n_threads < 0) {
+        
+        PyErr_Format(PyExc_ValueError, "Argument threads must be a positive "
+                     "integer, or zero to choose automatically.");
+                     
+        return NULL;
+    
+    }
+    
+    if (!strcmp(metric, "euclidean")) {
+        
+        b_rmsd = 0;
+    
+    } else if (!strcmp(metric, "rmsd")) {
+        
+        b_rmsd = 1;
+    
+    } else {
+        
+        PyErr_Format(PyExc_ValueError, "Argument metric must be either "
+                     "\"euclidean\" or \"rmsd\".");
+                     
+        return NULL;
+    
+    }
+    
+    if (o_out == Py_None) {
+        
+        o_out = NULL;
+    
+    }
+    
+    /*
+    *   Calculate in the precision of the old results, unless told otherwise.
+    */
+    
+    n_type = pywise_resolve_type(o_results_old, o_dtype);
+    
+    if (n_type < 0) {
+        
+        return NULL;
+    
+    }
+    
+    s_element = n_type == NPY_FLOAT ? sizeof(float) : sizeof(double);
+    
+    /*
+    *   Borrow the old results, converting them if they are not already a
+    *   contiguous array of n_type. Only an empty sequence cannot be
+    *   borrowed and is still acceptable.
+    */
+    
+    l_a_results_old = 0;
+    
+    a_results_old = pywise_borrow_input(o_results_old, n_type, 1, &view_old,
+                                        a_shape);
+                                        
+    if (a_results_old) {
+        
+        l_a_results_old = a_shape[0];
+    
+    } else if (PyObject_Length(o_results_old) != 0) {
+        
+        PyErr_Clear();
+        
+        PyErr_Format(PyExc_TypeError, "Argument results must be a "
+                     "one-dimensional array of condensed results.");
+                     
+        return NULL;
+    
+    }
+    
+    /*
+    *   Find N from the length of the old results, N * (N - 1) / 2.
+    */
+    
+    n_collections_old = (1 + sqrt(1 + (8.0 * l_a_results_old))) / 2;
+    
+    while (n_collections_old > 1
+    &&     (n_collections_old * (n_collections_old - 1)) / 2 > l_a_results_old) {
+        
+        n_collections_old --;
+    
+    }
+    
+    while (((n_collections_old + 1) * n_collections_old) / 2 <= l_a_results_old) {
+        
+        n_collections_old ++;
+    
+    }
+    
+    if ((n_collections_old * (n_collections_old - 1)) / 2 != l_a_results_old) {
+        
+        pywise_release_array(a_results_old, &view_old);
+        
+        PyErr_Format(PyExc_ValueError, "Argument results must hold the "
+                     "condensed results across some number of points, but "
+                     "has %zu elements.", l_a_results_old);
+                     
+        return NULL;
+    
+    }
+    
+    /*
+    *   Build an input array of collections, or of points, from o_source, as
+    *   pywise_knn() does.
+    */
+    
+    if (b_rmsd) {
+        
+        a_collections = pywise_build_collections_array(o_source,
+                                                       n_type,
+                                                       &n_collections,
+                                                       &n_points,
+                                                       &n_coordinates,
+                                                       &view);
+    
+    } else {
+        
+        a_collections = pywise_build_points_array(o_source,
+                                                  n_type,
+                                                  &n_collections,
+                                                  &n_coordinates,
+                                                  &view);
+                                                  
+        n_points = 1;
+    
+    }
+    
+    if (!a_collections) {
+        
+        pywise_release_array(a_results_old, &view_old);
+        
+        return NULL;
+    
+    }
+    
+    if (!l_a_results_old && n_collections_old > n_collections) {
+        
+        n_collections_old = n_collections;
+    
+    }
+    
+    if (n_collections_old > n_collections) {
+        
+        pywise_release_array(a_collections, &view);
+        pywise_release_array(a_results_old, &view_old);
+        
+        PyErr_Format(PyExc_ValueError, "Argument source must hold the %zu "
+                     "points of results, followed by any new points, but "
+                     "holds only %zu.", n_collections_old, n_collections);
+                     
+        return NULL;
+    
+    }
+    
+    if (!n_threads) {
+        
+        n_threads = pairwise_threads_suggested(n_collections,
+                                               n_points,
+                                               n_coordinates);
+    
+    }
+    
+    l_a_results = (n_collections * (n_collections ? n_collections - 1 : 0)) / 2;
+    
+    /*
+    *   Store the results in o_out if given, which must not overlap the
+    *   source, and must either start at the old results or not overlap them
+    *   at all; otherwise in a newly allocated array.
+    */
+    
+    view_out.buf = NULL;
+    view_out.obj = NULL;
+    
+    if (o_out) {
+        
+        a_results = pywise_borrow_output(o_out, n_type, l_a_results,
+                                         a_collections,
+                                         n_collections * n_points *
+                                         n_coordinates * s_element,
+                                         &view_out);
+        
+        if (a_results
+        &&  a_results != a_results_old
+        &&  (char*)a_results < (char*)a_results_old + (l_a_results_old * s_element)
+        &&  (char*)a_results_old < (char*)a_results + (l_a_results * s_element)) {
+            
+            pywise_release_array(a_results, &view_out);
+            
+            a_results = NULL;
+            
+            PyErr_Format(PyExc_ValueError, "Argument out must either start at "
+                         "results or not overlap it.");
+        
+        }
+    
+    } else {
+        
+        a_results = malloc((l_a_results ? l_a_results : 1) * s_element);
+        
+        if (!a_results) {
+            
+            PyErr_Format(PyExc_MemoryError, "Failed to allocate memory for "
+                         "output results array of %zu elements.",
+                         l_a_results);
+        
+        }
+    
+    }
+    
+    if (!a_results) {
+        
+        pywise_release_array(a_collections, &view);
+        pywise_release_array(a_results_old, &view_old);
+        
+        return NULL;
+    
+    }
+    
+    Py_BEGIN_ALLOW_THREADS
+    
+    if (b_rmsd && n_type == NPY_FLOAT) {
+        
+        n_return = pairwise_rmsds_append_float(n_collections_old,
+                                               n_collections - n_collections_old,
+                                               n_points,
+                                               n_coordinates,
+                                               a_collections,
+                                               a_results_old,
+                                               a_results,
+                                               n_threads);
+    
+    } else if (b_rmsd) {
+        
+        n_return = pairwise_rmsds_append(n_collections_old,
+                                         n_collections - n_collections_old,
+                                         n_points,
+                                         n_coordinates,
+                                         a_collections,
+                                         a_results_old,
+                                         a_results,
+                                         n_threads);
+    
+    } else if (n_type == NPY_FLOAT) {
+        
+        n_return = pairwise_distances_append_float(n_collections_old,
+                                                   n_collections - n_collections_old,
+                                                   n_coordinates,
+                                                   a_collections,
+                                                   a_results_old,
+                                                   a_results,
+                                                   n_threads);
+    
+    } else {
+        
+        n_return = pairwise_distances_append(n_collections_old,
+                                             n_collections - n_collections_old,
+                                             n_coordinates,
+                                             a_collections,
+                                             a_results_old,
+                                             a_results,
+                                             n_threads);
+    
+    }
+    
+    Py_END_ALLOW_THREADS
+    
+    pywise_release_array(a_collections, &view);
+    pywise_release_array(a_results_old, &view_old);
+    
+    if (n_return) {
+        
+        pywise_release_array(a_results, &view_out);
+        
+        pywise_set_python_exception_from_pairwise_calculations_return_code(n_return);
+        
+        return NULL;
+    
+    }
+    
+    if (o_out) {
+        
+        pywise_release_array(a_results, &view_out);
+        
+        Py_INCREF(o_out);
+        
+        return o_out;
+    
+    }
+    
+    /*
+    *   Wrap a_results in a NumPy array, which takes ownership of it.
+    */
+    
+    npy_l_a_results[0] = l_a_results;
+    
+    o_results = PyArray_SimpleNewFromData(1, npy_l_a_results, n_type, a_results);
+    
+    if (!o_results) {
+        
+        free(a_results);
+        
+        return NULL;
+    
+    }
+    
+    #if defined(NPY_ARRAY_OWNDATA)
+    PyArray_ENABLEFLAGS((PyArrayObject*)o_results, NPY_ARRAY_OWNDATA);
+    #else
+    PyArray_ENABLEFLAGS((PyArrayObject*)o_results, NPY_OWNDATA);
+    #endif
+    
+    return o_results;
+
+}
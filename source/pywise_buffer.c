@@ -0,0 +1,704 @@
+#include "pywise_buffer.h"
+
+/*******************************************************************************
+
+    Symbol: pywise_borrow_input
+    
+    Type: Function returning void*
+    
+    Intent: Private
+    
+    Description:
+    
+        Attempts to borrow, without copying, the memory of a Python object
+        which supports the buffer protocol and holds a C-contiguous, aligned
+        array of native doubles (if n_type is NPY_DOUBLE) or floats (if n_type
+        is NPY_FLOAT) with n_dimensions non-empty dimensions. If o_source is a
+        NumPy array which does not meet these conditions but has n_dimensions
+        dimensions, it is first converted to one which does.
+        
+        o_source is a pointer to the input Python object, and view is a
+        pointer to the Py_buffer which will describe the borrowed memory. On
+        success stores the length of each dimension in a_shape, and returns a
+        pointer to the borrowed elements, which remain valid until view is
+        released with pywise_release_array().
+        
+        If o_source cannot be borrowed in this way returns a null pointer,
+        leaves view->buf null, and sets no Python exception; the caller should
+        then fall back on walking o_source as a generic sequence.
+        
+    Further Information:
+    
+        A contiguous array of n_type already has exactly the form that
+        libpairwise expects, so borrowing it avoids visiting every coordinate
+        through the Python C-API. For large NumPy inputs this is much faster
+        than the generic sequence walk, which is kept for Python lists and
+        other sequences.
+        
+        A NumPy array of another dtype or layout (integers, Fortran order, a
+        strided slice, ...) is converted with one call to
+        PyArray_FROMANY(). This is still a copy, but one done in a single C
+        loop, and the converted array is then borrowed like any other. The
+        buffer view keeps the converted array alive until it is released.
+        
+        Buffers with empty dimensions are not borrowed, so that the generic
+        sequence walk reports them with its usual exceptions.
+        
+*******************************************************************************/
+
+void*
+pywise_borrow_input
+(
+
+    PyObject* o_source,
+    
+    int n_type,
+    int n_dimensions,
+    
+    Py_buffer* view,
+    Py_ssize_t* a_shape
+
+)
+{
+
+    PyObject* o_converted;
+    
+    int i_dimension;
+    
+    int n_return;
+    
+    char* format;
+    
+    const char* format_expected;
+    
+    size_t s_element;
+    
+    format_expected = n_type == NPY_FLOAT ? "f" : "d";
+    
+    s_element = n_type == NPY_FLOAT ? sizeof(float) : sizeof(double);
+    
+    view->buf = NULL;
+    view->obj = NULL;
+    
+    /*
+    *   Convert NumPy arrays with the right number of dimensions to C-
+    *   contiguous, aligned arrays of native n_type. PyArray_FROMANY() returns
+    *   a new reference to o_source itself if it already meets these
+    *   conditions. Anything it can't convert falls back to the generic path.
+    */
+    
+    if (PyArray_Check(o_source)) {
+        
+        if (PyArray_NDIM((PyArrayObject*)o_source) != n_dimensions) {
+            
+            return NULL;
+        
+        }
+        
+        o_converted = PyArray_FROMANY(o_source, n_type, n_dimensions,
+                                      n_dimensions, NPY_ARRAY_CARRAY_RO);
+                                      
+        if (!o_converted) {
+            
+            PyErr_Clear();
+            
+            return NULL;
+        
+        }
+    
+    } else if (PyObject_CheckBuffer(o_source)) {
+        
+        Py_INCREF(o_source);
+        
+        o_converted = o_source;
+    
+    } else {
+        
+        return NULL;
+    
+    }
+    
+    n_return = PyObject_GetBuffer(o_converted, view, PyBUF_C_CONTIGUOUS |
+                                                     PyBUF_FORMAT);
+                                                     
+    /*
+    *   On success the buffer view holds its own reference to o_converted, so
+    *   ours can be dropped either way.
+    */
+    
+    Py_DECREF(o_converted);
+    
+    if (n_return) {
+        
+        PyErr_Clear();
+        
+        view->buf = NULL;
+        
+        return NULL;
+    
+    }
+    
+    /*
+    *   Accept only native-order n_type: a format of format_expected, or of
+    *   format_expected prefixed with a byte-order character that means native
+    *   order on this host.
+    */
+    
+    format = view->format;
+    
+    #if NPY_BYTE_ORDER == NPY_BIG_ENDIAN
+    if (format && (*format == '@' || *format == '=' || *format == '>' ||
+                   *format == '!')) {
+    #else
+    if (format && (*format == '@' || *format == '=' || *format == '<')) {
+    #endif
+                       
+        format ++;
+    
+    }
+    
+    if (!format || strcmp(format, format_expected) ||
+        (size_t)view->itemsize != s_element ||
+        view->ndim != n_dimensions ||
+        ((size_t)view->buf) % s_element) {
+            
+        goto incompatible;
+    
+    }
+    
+    for (i_dimension = 0; i_dimension < n_dimensions; i_dimension ++) {
+        
+        if (*(view->shape + i_dimension) < 1) {
+            
+            goto incompatible;
+        
+        }
+        
+        *(a_shape + i_dimension) = *(view->shape + i_dimension);
+    
+    }
+    
+    return view->buf;
+    
+incompatible:
+
+    PyBuffer_Release(view);
+    
+    view->buf = NULL;
+    view->obj = NULL;
+    
+    return NULL;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_borrow_output
+    
+    Type: Function returning void*
+    
+    Intent: Private
+    
+    Description:
+    
+        Borrows the memory of a caller-supplied Python object, o_out, in which
+        to store the l_output results of a libpairwise calculation. o_out must
+        support the buffer protocol and be a writable, C-contiguous, aligned,
+        one-dimensional array of exactly l_output native doubles (if n_type is
+        NPY_DOUBLE) or floats (if n_type is NPY_FLOAT), such as a NumPy
+        ndarray of dtype float64 or float32 respectively. a_input points to
+        the s_input bytes of the calculation's input, which o_out must not
+        overlap.
+        
+        view is a pointer to the Py_buffer which will describe the borrowed
+        memory. On success returns a pointer to it, which remains valid until
+        view is released with pywise_release_array(). On failure sets a
+        Python exception and returns a null pointer.
+        
+    Further Information:
+    
+        Results are written straight into o_out while the GIL is released,
+        as the threads read the input, so an o_out sharing memory with the
+        input, such as a view of the same NumPy array, would have its inputs
+        overwritten by results partway through. Input which was copied rather
+        than borrowed can never overlap o_out.
+        
+        The buffer view held meanwhile stops o_out from being resized or
+        freed, though not from being read or written by other Python threads;
+        the caller should not touch o_out until the calculation returns.
+        
+*******************************************************************************/
+
+void*
+pywise_borrow_output
+(
+
+    PyObject* o_out,
+    
+    int n_type,
+    
+    size_t l_output,
+    
+    const void* a_input,
+    size_t s_input,
+    
+    Py_buffer* view
+
+)
+{
+
+    char* format;
+    
+    const char* format_expected;
+    
+    size_t s_element;
+    
+    format_expected = n_type == NPY_FLOAT ? "f" : "d";
+    
+    s_element = n_type == NPY_FLOAT ? sizeof(float) : sizeof(double);
+    
+    if (!PyObject_CheckBuffer(o_out)) {
+        
+        PyErr_Format(PyExc_TypeError, "Argument out must be a NumPy array or "
+                     "other object supporting the buffer protocol.");
+                     
+        return NULL;
+    
+    }
+    
+    /*
+    *   Ask for strides, so that any array can be described and a more useful
+    *   exception raised than the exporter's own; then check every property
+    *   required of the output array in turn.
+    */
+    
+    if (PyObject_GetBuffer(o_out, view, PyBUF_STRIDES | PyBUF_FORMAT)) {
+        
+        return NULL;
+    
+    }
+    
+    format = view->format;
+    
+    #if NPY_BYTE_ORDER == NPY_BIG_ENDIAN
+    if (format && (*format == '@' || *format == '=' || *format == '>' ||
+                   *format == '!')) {
+    #else
+    if (format && (*format == '@' || *format == '=' || *format == '<')) {
+    #endif
+    
+        format ++;
+    
+    }
+    
+    if (view->readonly) {
+        
+        PyErr_Format(PyExc_ValueError, "Argument out must be writable.");
+        
+        goto exception;
+    
+    }
+    
+    if (!format || strcmp(format, format_expected) ||
+        (size_t)view->itemsize != s_element) {
+            
+        PyErr_Format(PyExc_TypeError, "Argument out must have dtype %s in "
+                     "native byte order.", n_type == NPY_FLOAT ? "float32" :
+                                                                 "float64");
+                     
+        goto exception;
+    
+    }
+    
+    if (view->ndim != 1 || (size_t)*(view->shape) != l_output) {
+        
+        PyErr_Format(PyExc_ValueError, "Argument out must be one-dimensional "
+                     "with exactly %zu elements.", l_output);
+                     
+        goto exception;
+    
+    }
+    
+    if (!PyBuffer_IsContiguous(view, 'C') ||
+        ((size_t)view->buf) % s_element) {
+            
+        PyErr_Format(PyExc_ValueError, "Argument out must be C-contiguous and "
+                     "aligned.");
+                     
+        goto exception;
+    
+    }
+    
+    if ((char*)view->buf < (char*)a_input + s_input &&
+        (char*)a_input < (char*)view->buf + (l_output * s_element)) {
+        
+        PyErr_Format(PyExc_ValueError, "Argument out must not share memory "
+                     "with the input.");
+                     
+        goto exception;
+    
+    }
+    
+    return view->buf;
+    
+exception:
+
+    PyBuffer_Release(view);
+    
+    view->buf = NULL;
+    view->obj = NULL;
+    
+    return NULL;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_release_array
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Releases an array returned by pywise_build_points_array(),
+        pywise_build_collections_array() or pywise_borrow_output(). a_array
+        is the returned pointer, and view is the Py_buffer passed to that call.
+        If a_array was borrowed from the caller's Python object releases view;
+        otherwise frees a_array.
+        
+        Returns nothing, and will not fail.
+        
+*******************************************************************************/
+
+void
+pywise_release_array
+(
+
+    void* a_array,
+    
+    Py_buffer* view
+
+)
+{
+
+    if (view->buf && view->buf == a_array) {
+        
+        PyBuffer_Release(view);
+        
+        view->buf = NULL;
+        view->obj = NULL;
+        
+        return;
+    
+    }
+    
+    free(a_array);
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_resolve_type
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Decides in which precision to carry out a calculation on the input
+        Python object o_source. o_dtype is the caller's dtype argument, or a
+        null pointer or Py_None if none was given.
+        
+        If o_dtype is given it must describe either float32 or float64.
+        Otherwise a NumPy array of float32 selects float32, so that it can be
+        borrowed without any conversion, and anything else selects float64.
+        
+        On success returns NPY_FLOAT or NPY_DOUBLE. On failure sets a Python
+        exception and returns -1.
+        
+*******************************************************************************/
+
+int
+pywise_resolve_type
+(
+
+    PyObject* o_source,
+    PyObject* o_dtype
+
+)
+{
+
+    PyArray_Descr* descr;
+    
+    int n_type;
+    
+    if (o_dtype && o_dtype != Py_None) {
+        
+        if (!PyArray_DescrConverter(o_dtype, &descr)) {
+            
+            return -1;
+        
+        }
+        
+        n_type = descr->type_num;
+        
+        Py_DECREF(descr);
+        
+        if (n_type != NPY_FLOAT && n_type != NPY_DOUBLE) {
+            
+            PyErr_Format(PyExc_TypeError, "Argument dtype must be float32 or "
+                         "float64.");
+                         
+            return -1;
+        
+        }
+        
+        return n_type;
+    
+    }
+    
+    if (PyArray_Check(o_source) &&
+        PyArray_TYPE((PyArrayObject*)o_source) == NPY_FLOAT) {
+            
+        return NPY_FLOAT;
+    
+    }
+    
+    return NPY_DOUBLE;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_narrow_array
+    
+    Type: Function returning float*
+    
+    Intent: Private
+    
+    Description:
+    
+        Copies the l_array doubles in a_doubles to a newly allocated array of
+        floats, and frees a_doubles.
+        
+        On success returns a pointer to the floats, which the caller must
+        free. On failure frees a_doubles all the same, sets a Python exception
+        and returns a null pointer.
+        
+*******************************************************************************/
+
+float*
+pywise_narrow_array
+(
+
+    double* a_doubles,
+    
+    size_t l_array
+
+)
+{
+
+    float* a_floats;
+    
+    size_t i_element;
+    
+    a_floats = malloc(l_array * sizeof(float));
+    
+    if (!a_floats) {
+        
+        PyErr_Format(PyExc_MemoryError, "Failed to allocate memory for "
+                     "single precision input array; needed %zu bytes.",
+                     l_array * sizeof(float));
+                     
+        free(a_doubles);
+        
+        return NULL;
+    
+    }
+    
+    for (i_element = 0; i_element < l_array; i_element ++) {
+        
+        *(a_floats + i_element) = (float)*(a_doubles + i_element);
+    
+    }
+    
+    free(a_doubles);
+    
+    return a_floats;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_wrap_csr
+    
+    Type: Function returning PyObject*
+    
+    Intent: Private
+    
+    Description:
+    
+        Wraps the compressed sparse row (CSR) arrays returned by a libpairwise
+        cutoff function over n_rows collections (or points) in a tuple of
+        three one-dimensional NumPy arrays, (indptr, indices, values), each of
+        which takes ownership of the corresponding memory.
+        
+        a_indptr holds n_rows + 1 offsets, and a_indices and a_values each
+        hold a_indptr[n_rows] elements; a_values holds doubles if n_type is
+        NPY_DOUBLE, or floats if n_type is NPY_FLOAT.
+        
+        On success returns a new reference to the tuple. On failure frees all
+        three arrays, sets a Python exception and returns a null pointer.
+        
+    Further Information:
+    
+        indptr and indices are returned with dtype numpy.intp, which has the
+        same size as size_t on every platform supported by NumPy, so that
+        they can be passed straight to scipy.sparse.csr_matrix().
+        
+*******************************************************************************/
+
+PyObject*
+pywise_wrap_csr
+(
+
+    size_t n_rows,
+    
+    size_t* a_indptr,
+    size_t* a_indices,
+    
+    void* a_values,
+    
+    int n_type
+
+)
+{
+
+    PyObject* o_indptr;
+    PyObject* o_indices;
+    PyObject* o_values;
+    
+    npy_intp npy_l_array[1];
+    
+    npy_l_array[0] = n_rows + 1;
+    
+    o_indptr = PyArray_SimpleNewFromData(1, npy_l_array, NPY_INTP, a_indptr);
+    
+    npy_l_array[0] = *(a_indptr + n_rows);
+    
+    o_indices = PyArray_SimpleNewFromData(1, npy_l_array, NPY_INTP, a_indices);
+    o_values = PyArray_SimpleNewFromData(1, npy_l_array, n_type, a_values);
+    
+    if (!o_indptr || !o_indices || !o_values) {
+        
+        /*
+        *   None of the arrays yet owns its memory, so releasing them frees
+        *   nothing but the array objects themselves.
+        */
+        
+        Py_XDECREF(o_indptr);
+        Py_XDECREF(o_indices);
+        Py_XDECREF(o_values);
+        
+        free(a_indptr);
+        free(a_indices);
+        free(a_values);
+        
+        return NULL;
+    
+    }
+    
+    #if defined(NPY_ARRAY_OWNDATA)
+    PyArray_ENABLEFLAGS((PyArrayObject*)o_indptr, NPY_ARRAY_OWNDATA);
+    PyArray_ENABLEFLAGS((PyArrayObject*)o_indices, NPY_ARRAY_OWNDATA);
+    PyArray_ENABLEFLAGS((PyArrayObject*)o_values, NPY_ARRAY_OWNDATA);
+    #else
+    PyArray_ENABLEFLAGS((PyArrayObject*)o_indptr, NPY_OWNDATA);
+    PyArray_ENABLEFLAGS((PyArrayObject*)o_indices, NPY_OWNDATA);
+    PyArray_ENABLEFLAGS((PyArrayObject*)o_values, NPY_OWNDATA);
+    #endif
+    
+    return Py_BuildValue("(NNN)", o_indptr, o_indices, o_values);
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_wrap_neighbours
+    
+    Type: Function returning PyObject*
+    
+    Intent: Private
+    
+    Description:
+    
+        Wraps the arrays filled by a libpairwise k-nearest-neighbour function
+        over n_rows collections (or points) in a tuple of two two-dimensional
+        NumPy arrays of shape (n_rows, n_neighbours), (indices, values), each
+        of which takes ownership of the corresponding memory.
+        
+        a_values holds doubles if n_type is NPY_DOUBLE, or floats if n_type is
+        NPY_FLOAT.
+        
+        On success returns a new reference to the tuple. On failure frees both
+        arrays, sets a Python exception and returns a null pointer.
+        
+    Further Information:
+    
+        indices is returned with dtype numpy.intp, as for pywise_wrap_csr().
+        
+*******************************************************************************/
+
+PyObject*
+pywise_wrap_neighbours
+(
+
+    size_t n_rows,
+    size_t n_neighbours,
+    
+    size_t* a_indices,
+    
+    void* a_values,
+    
+    int n_type
+
+)
+{
+
+    PyObject* o_indices;
+    PyObject* o_values;
+    
+    npy_intp npy_l_array[2];
+    
+    npy_l_array[0] = n_rows;
+    npy_l_array[1] = n_neighbours;
+    
+    o_indices = PyArray_SimpleNewFromData(2, npy_l_array, NPY_INTP, a_indices);
+    o_values = PyArray_SimpleNewFromData(2, npy_l_array, n_type, a_values);
+    
+    if (!o_indices || !o_values) {
+        
+        Py_XDECREF(o_indices);
+        Py_XDECREF(o_values);
+        
+        free(a_indices);
+        free(a_values);
+        
+        return NULL;
+    
+    }
+    
+    #if defined(NPY_ARRAY_OWNDATA)
+    PyArray_ENABLEFLAGS((PyArrayObject*)o_indices, NPY_ARRAY_OWNDATA);
+    PyArray_ENABLEFLAGS((PyArrayObject*)o_values, NPY_ARRAY_OWNDATA);
+    #else
+    PyArray_ENABLEFLAGS((PyArrayObject*)o_indices, NPY_OWNDATA);
+    PyArray_ENABLEFLAGS((PyArrayObject*)o_values, NPY_OWNDATA);
+    #endif
+    
+    return Py_BuildValue("(NN)", o_indices, o_values);
+
+}
@@ -4,7 +4,7 @@
 
     Symbol: pywise_build_points_array
     
-    Type: Function returning double*
+    Type: Function returning void*
     
     Intent: Private
     
@@ -14,11 +14,12 @@
         appropriate for passing to a libpairwise calculation function.
         
         o_source is a pointer to the input Python object. On success stores the
-        number of points in o_source and the number of coordinates per point in 
-        n_points and n_coordinates respectively. Also returns a pointer to a
-        new array of these points, the responsibility to free which is passed
-        on to the caller. On failure sets a Python exception and returns a null
-        pointer.
+        number of points in o_source and the number of coordinates per point in
+        n_points and n_coordinates respectively. Also returns a pointer to an
+        array of these points, as doubles if n_type is NPY_DOUBLE or as floats
+        if n_type is NPY_FLOAT, which the caller must release by passing it and
+        view to pywise_release_array(). On failure sets a Python exception and
+        returns a null pointer.
     
     Further Information:
     
@@ -37,16 +38,29 @@
         where [COORDINATE_B] is a Python number, and the number of coordinates
         per point B is constant across all A collections.
         
+        Before any of this, this function tries to borrow the memory of
+        o_source through pywise_borrow_input(). If o_source is a two-
+        dimensional NumPy array (or other buffer) of n_type, the points are
+        then used in place without any copy, and view records the borrowed
+        buffer. Only other sequences, such as Python lists, are copied.
+        
+        Copies are always built as doubles. If n_type is NPY_FLOAT they are
+        then narrowed to floats by pywise_narrow_array().
+        
 *******************************************************************************/
 
-double*
+void*
 pywise_build_points_array
 (
     
     PyObject* o_source,
     
+    int n_type,
+    
     size_t* n_points,
-    size_t* n_coordinates
+    size_t* n_coordinates,
+    
+    Py_buffer* view
 
 )
 {
@@ -73,18 +87,41 @@ pywise_build_points_array
     
     size_t s_b_error;
     
+    Py_ssize_t a_shape[2];
+    
+    void* a_borrowed;
+    
+    /*
+    *   Borrow o_source in place if it is a suitable buffer of n_type, in
+    *   which case there's nothing to copy or validate element by element.
+    */
+    
+    a_borrowed = pywise_borrow_input(o_source, n_type, 2, view, a_shape);
+    
+    if (a_borrowed) {
+        
+        *n_points = a_shape[0];
+        *n_coordinates = a_shape[1];
+        
+        return a_borrowed;
+    
+    }
+    
     /*
-    *   Initialise pointers to the output array (yet to be allocated) to null.
-    *   This suppresses compiler warnings about potential uninitialisations
-    *   which come from having the memory allocation for a_collections nested
-    *   in a conditional block. (The compiler doesn't know that this
-    *   conditional block will always be executed exactly once in a successful
-    *   call - so those warnings are actually unfounded!)
+    *   Initialise pointers to the output array (yet to be allocated) to null,
+    *   and its length to zero. This suppresses compiler warnings about
+    *   potential uninitialisations which come from having the memory
+    *   allocation for a_collections nested in a conditional block. (The
+    *   compiler doesn't know that this conditional block will always be
+    *   executed exactly once in a successful call - so those warnings are
+    *   actually unfounded!)
     */
         
     a_points = NULL;
     a_points_temp = NULL;
     
+    l_a_points = 0;
+    
     /*
     *   Allocate memory for an error buffer. This allows us to report error
     *   strings which contain runtime information via Python functions which
@@ -327,11 +364,18 @@ pywise_build_points_array
     
     /*
     *   Free only memory allocated for the error buffer, and then return a
-    *   pointer to the successfully populated output array.
+    *   pointer to the successfully populated output array, first narrowed to
+    *   floats if the caller asked for them.
     */
     
     free(b_error);
     
+    if (n_type == NPY_FLOAT) {
+        
+        return pywise_narrow_array(a_points, l_a_points);
+    
+    }
+    
     return a_points;
     
 exception:
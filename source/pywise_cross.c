@@ -0,0 +1,426 @@
+#include "pywise_cross.h"
+
+/*******************************************************************************
+
+    Symbol: pywise_cross_distances
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.cross_distances()
+    
+    Python Signature:
+    
+        pywise.cross_distances(a, b, threads = 0, dtype = None)
+            -> numpy.ndarray
+            
+    Description:
+    
+        Calculates the Euclidean distance between every point in one set of
+        points, a, and every point in another, b, such as a batch of new
+        frames and a reference library. Binds libpairwise to distribute the
+        calculations over the requested number of threads, as
+        pywise.distances() does. threads and dtype are as for
+        pywise.distances(); calculates in single precision only if both a
+        and b would be on their own.
+        
+        On success pywise_cross_distances() returns a two-dimensional NumPy
+        array of shape (len(a), len(b)), whose element [i, j] is the distance
+        between point i of a and point j of b. On failure it raises a Python
+        exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_cross_distances
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+)
+{
+
+    return pywise_cross(values, keys, 0, "cross_distances");
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_cross_rmsds
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.cross_rmsds()
+    
+    Python Signature:
+    
+        pywise.cross_rmsds(a, b, threads = 0, dtype = None)
+            -> numpy.ndarray
+            
+    Description:
+    
+        As pywise.cross_distances(), but calculates the RMSD between every
+        collection of points in one set of collections, a, and every
+        collection in another, b, as pywise.rmsds() does within one set.
+        
+        On success pywise_cross_rmsds() returns a two-dimensional NumPy array
+        of shape (len(a), len(b)), whose element [i, j] is the RMSD between
+        collection i of a and collection j of b. On failure it raises a Python
+        exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_cross_rmsds
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+)
+{
+
+    return pywise_cross(values, keys, 1, "cross_rmsds");
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_cross
+    
+    Type: Function returning PyObject*
+    
+    Intent: Private
+    
+    Description:
+    
+        Carries out the work of pywise_cross_distances() if b_rmsd is zero,
+        or of pywise_cross_rmsds() otherwise, parsing their Python arguments,
+        values and keys, under the function name name.
+        
+        On success returns a new reference to a two-dimensional NumPy array of
+        results. On failure raises a Python exception and returns a null
+        pointer.
+        
+    Further Information:
+    
+        Both input sets are borrowed or copied as for pywise_distances() or
+        pywise_rmsds(), and are passed to libpairwise's
+        pairwise_cross_distances() or pairwise_cross_rmsds(), or to their
+        float counterparts in single precision, with the GIL released.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_cross
+(
+
+    PyObject* values,
+    PyObject* keys,
+    
+    int b_rmsd,
+    
+    char* name
+
+)
+
+{
+
+    char* keywords[5] = {"a", "b", "threads", "dtype", NULL};
+    
+    char format[32];
+    
+    size_t n_collections_a;
+    size_t n_collections_b;
+    size_t n_points_a;
+    size_t n_points_b;
+    size_t n_coordinates_a;
+    size_t n_coordinates_b;
+    
+    Py_ssize_t n_threads;
+    
+    PyObject* o_a;
+    PyObject* o_b;
+    PyObject* o_dtype;
+    PyObject* o_results;
+    
+    void* a_collections_a;
+    void* a_collections_b;
+    void* a_results;
+    
+    int n_type;
+    int n_type_b;
+    
+    size_t l_a_results;
+    size_t s_a_results;
+    
+    npy_intp npy_l_a_results[2];
+    
+    Py_buffer view_a;
+    Py_buffer view_b;
+    
+    int n_return;
+    
+    n_threads = PYWISE_DEFAULT_THREADS;
+    
+    o_dtype = NULL;
+    
+    /*
+    *   Attempt to parse arguments with keywords "a", "b", "threads" and
+    *   "dtype" as two Python objects, a signed integer and a Python object,
+    *   respectively, naming the calling function in any exception raised.
+    */
+    
+    PyOS_snprintf(format, sizeof(format), "OO|nO:%s", name);
+    
+    n_return = PyArg_ParseTupleAndKeywords(values, keys, format, keywords,
+                                           &o_a, &o_b, &n_threads, &o_dtype);
+                                           
+    if (!n_return) {
+        
+        return NULL;
+    
+    }
+    
+    if (n_threads < 0) {
+        
+        PyErr_Format(PyExc_ValueError, "Argument threads must be a positive "
+                     "integer, or zero to choose automatically.");
+                     
+        return NULL;
+    
+    }
+    
+    /*
+    *   Calculate in single precision only if both sets would be calculated
+    *   in single precision on their own, so that neither is narrowed
+    *   unasked.
+    */
+    
+    n_type = pywise_resolve_type(o_a, o_dtype);
+    n_type_b = pywise_resolve_type(o_b, o_dtype);
+    
+    if (n_type < 0 || n_type_b < 0) {
+        
+        return NULL;
+    
+    }
+    
+    if (n_type_b == NPY_DOUBLE) {
+        
+        n_type = NPY_DOUBLE;
+    
+    }
+    
+    /*
+    *   Build an input array from each of the caller-supplied Python objects,
+    *   o_a and o_b; for distances, of points, each of which is treated by
+    *   libpairwise as a collection of one point.
+    */
+    
+    if (b_rmsd) {
+        
+        a_collections_a = pywise_build_collections_array(o_a,
+                                                         n_type,
+                                                         &n_collections_a,
+                                                         &n_points_a,
+                                                         &n_coordinates_a,
+                                                         &view_a);
+    
+    } else {
+        
+        a_collections_a = pywise_build_points_array(o_a,
+                                                    n_type,
+                                                    &n_collections_a,
+                                                    &n_coordinates_a,
+                                                    &view_a);
+                                                    
+        n_points_a = 1;
+    
+    }
+    
+    if (!a_collections_a) {
+        
+        return NULL;
+    
+    }
+    
+    if (b_rmsd) {
+        
+        a_collections_b = pywise_build_collections_array(o_b,
+                                                         n_type,
+                                                         &n_collections_b,
+                                                         &n_points_b,
+                                                         &n_coordinates_b,
+                                                         &view_b);
+    
+    } else {
+        
+        a_collections_b = pywise_build_points_array(o_b,
+                                                    n_type,
+                                                    &n_collections_b,
+                                                    &n_coordinates_b,
+                                                    &view_b);
+                                                    
+        n_points_b = 1;
+    
+    }
+    
+    if (!a_collections_b) {
+        
+        pywise_release_array(a_collections_a, &view_a);
+        
+        return NULL;
+    
+    }
+    
+    /*
+    *   Every collection (or point) of a must be comparable with every one of
+    *   b.
+    */
+    
+    if (n_points_a != n_points_b || n_coordinates_a != n_coordinates_b) {
+        
+        pywise_release_array(a_collections_a, &view_a);
+        pywise_release_array(a_collections_b, &view_b);
+        
+        PyErr_Format(PyExc_ValueError, "Arguments a and b must have the same "
+                     "number of %s per %s.",
+                     n_points_a != n_points_b ? "points" : "coordinates",
+                     n_points_a != n_points_b ? "collection" : "point");
+                     
+        return NULL;
+    
+    }
+    
+    /*
+    *   If asked to, choose the number of threads as for the single set of
+    *   both a and b together, which holds at least as many pairwise
+    *   calculations as the rectangle between them.
+    */
+    
+    if (!n_threads) {
+        
+        n_threads = pairwise_threads_suggested(n_collections_a + n_collections_b,
+                                               n_points_a,
+                                               n_coordinates_a);
+    
+    }
+    
+    l_a_results = n_collections_a * n_collections_b;
+    
+    s_a_results = l_a_results * (n_type == NPY_FLOAT ? sizeof(float) :
+                                                       sizeof(double));
+                                                       
+    a_results = malloc(s_a_results ? s_a_results : 1);
+    
+    if (!a_results) {
+        
+        pywise_release_array(a_collections_a, &view_a);
+        pywise_release_array(a_collections_b, &view_b);
+        
+        PyErr_Format(PyExc_MemoryError, "Failed to allocate memory for "
+                     "output results array; needed %zu bytes.", s_a_results);
+                     
+        return NULL;
+    
+    }
+    
+    /*
+    *   As in pywise_distances(), the calculation touches only C arrays and
+    *   calls no Python function, so release the GIL for its duration.
+    */
+    
+    Py_BEGIN_ALLOW_THREADS
+    
+    if (b_rmsd && n_type == NPY_FLOAT) {
+        
+        n_return = pairwise_cross_rmsds_float(n_collections_a,
+                                              n_collections_b,
+                                              n_points_a,
+                                              n_coordinates_a,
+                                              a_collections_a,
+                                              a_collections_b,
+                                              a_results,
+                                              n_threads);
+    
+    } else if (b_rmsd) {
+        
+        n_return = pairwise_cross_rmsds(n_collections_a,
+                                        n_collections_b,
+                                        n_points_a,
+                                        n_coordinates_a,
+                                        a_collections_a,
+                                        a_collections_b,
+                                        a_results,
+                                        n_threads);
+    
+    } else if (n_type == NPY_FLOAT) {
+        
+        n_return = pairwise_cross_distances_float(n_collections_a,
+                                                  n_collections_b,
+                                                  n_coordinates_a,
+                                                  a_collections_a,
+                                                  a_collections_b,
+                                                  a_results,
+                                                  n_threads);
+    
+    } else {
+        
+        n_return = pairwise_cross_distances(n_collections_a,
+                                            n_collections_b,
+                                            n_coordinates_a,
+                                            a_collections_a,
+                                            a_collections_b,
+                                            a_results,
+                                            n_threads);
+    
+    }
+    
+    Py_END_ALLOW_THREADS
+    
+    pywise_release_array(a_collections_a, &view_a);
+    pywise_release_array(a_collections_b, &view_b);
+    
+    if (n_return) {
+        
+        free(a_results);
+        
+        pywise_set_python_exception_from_pairwise_calculations_return_code(n_return);
+        
+        return NULL;
+    
+    }
+    
+    /*
+    *   Wrap a_results in a two-dimensional NumPy array object, o_results, and
+    *   transfer ownership of a_results to it.
+    */
+    
+    npy_l_a_results[0] = n_collections_a;
+    npy_l_a_results[1] = n_collections_b;
+    
+    o_results = PyArray_SimpleNewFromData(2,
+                                          npy_l_a_results,
+                                          n_type,
+                                          a_results);
+                                          
+    if (!o_results) {
+        
+        free(a_results);
+        
+        return NULL;
+    
+    }
+    
+    #if defined(NPY_ARRAY_OWNDATA)
+    PyArray_ENABLEFLAGS((PyArrayObject*)o_results, NPY_ARRAY_OWNDATA);
+    #else
+    PyArray_ENABLEFLAGS((PyArrayObject*)o_results, NPY_OWNDATA);
+    #endif
+    
+    return o_results;
+
+}
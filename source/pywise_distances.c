@@ -10,14 +10,40 @@
     
     Python Signature:
     
-        pywise.distances(points, threads) -> numpy.ndarray
+        pywise.distances(points, threads = 0, out = None, dtype = None,
+                         cutoff = None, file = None)
+            -> numpy.ndarray or tuple
     
     Description:
     
         Calculates all pairwise Euclidean distances across a set of points in
         any-dimensional space. Binds libpairwise to fairly distribute the total
         number of pairwise calculations to be done over the requested number of
-        threads which are launched in parallel.
+        threads which are launched in parallel. If threads is zero, the
+        default, chooses the number of threads automatically.
+        
+        If dtype is float32, or if dtype is None and points is a NumPy array of
+        float32, carries out the calculations in single precision and returns
+        an array of float32; otherwise in double precision, returning an array
+        of float64.
+        
+        If out is given, stores the results in it rather than in a new array,
+        and returns it. out must then be a writable, C-contiguous, one-
+        dimensional array of the results' dtype with exactly one element per
+        pair, which shares no memory with points.
+        
+        If cutoff is given, keeps only the results no greater than cutoff, and
+        returns them in compressed sparse row (CSR) form as a tuple of three
+        one-dimensional NumPy arrays, (indptr, indices, values). For each point
+        i, indices[indptr[i]:indptr[i + 1]] holds in increasing order every
+        point j > i whose result with i is within cutoff, and the same elements
+        of values hold those results. out may not then be given.
+        
+        If file is given, creates a libpairwise results file at that path, and
+        stores the results straight into it through a memory map rather than
+        in memory, returning them as a numpy.memmap of the file opened with
+        mode "r+", as pywise.load() would. Neither out nor cutoff may then be
+        given.
         
         On success pywise_distances() returns a one-dimensional NumPy array
         object which contains the results of all pairwise calculations. On
@@ -28,11 +54,13 @@
         This function receives a Python object which contains a two-dimensional
         sequence of sequences of numbers (representing a set of points in any-
         dimensional space) and passes it pywise_build_points_array() which
-        copies its contents into an input array of form appropriate for passing
-        to libpairwise's pairwise_distances(). Thereafter this function passes
-        that input array to pairwise_distances(), and then returns the
-        resulting output array which contains the calculated pairwise distances
-        in the form of a NumPy array object.
+        borrows or copies its contents as an input array of form appropriate
+        for passing to libpairwise's pairwise_distances(), or to
+        pairwise_distances_float() in single precision. Thereafter this
+        function passes that input array to the libpairwise function, and then
+        returns the resulting output array which contains the calculated
+        pairwise distances in the form of a NumPy array object. Each phase of
+        a call which succeeds is timed for pywise.last_stats().
         
 *******************************************************************************/
 
@@ -47,7 +75,8 @@ pywise_distances
 )
 {
 
-    char* keywords[3] = {"points", "threads", NULL};
+    char* keywords[7] = {"points", "threads", "out", "dtype", "cutoff",
+                         "file", NULL};
     
     size_t n_points;
     size_t n_coordinates;
@@ -56,16 +85,35 @@ pywise_distances
     
     PyObject* o_points;
     PyObject* o_distances;
+    PyObject* o_out;
+    PyObject* o_dtype;
+    PyObject* o_cutoff;
+    
+    char* path;
+    
+    void* a_points;
+    void* a_distances;
+    
+    int n_type;
+    
+    double cutoff;
     
-    double* a_points;
-    double* a_distances;
+    size_t* a_indptr;
+    size_t* a_indices;
     
     size_t l_a_distances;
     size_t s_a_distances;
+    size_t s_a_points;
     
     npy_intp npy_l_a_distances[1];
     
+    Py_buffer view;
+    Py_buffer view_out;
+    
     int n_return;
+    int n_return_file;
+    
+    pywise_stats_t stats;
     
     /*
     *   Set the default number of threads to use if the user doesn't supply
@@ -74,17 +122,27 @@ pywise_distances
     
     n_threads = PYWISE_DEFAULT_THREADS;
     
+    o_out = NULL;
+    o_dtype = NULL;
+    o_cutoff = NULL;
+    
+    path = NULL;
+    
+    cutoff = 0;
+    
     /*
-    *   Attempt to parse aruguments with keywords "points" and "threads" as a
-    *   Python object and a signed integer, respectively. Even though the
-    *   number of threads should only ever be positive, overflow checking is
-    *   not done when parsing unsigned integers, so an incorrectly specified
-    *   negative number parsed in that way would be impossible to detect. Raise
-    *   a Python exception if parsing fails. 
+    *   Attempt to parse aruguments with keywords "points", "threads", "out",
+    *   "dtype", "cutoff" and "file" as a Python object, a signed integer,
+    *   three Python objects and a path or None, respectively. Even though
+    *   the number of threads should only ever be positive, overflow checking
+    *   is not done when parsing unsigned integers, so an incorrectly
+    *   specified negative number parsed in that way would be impossible to
+    *   detect. Raise a Python exception if parsing fails.
     */
     
-    n_return = PyArg_ParseTupleAndKeywords(values, keys, "O|n:distances",
-                                           keywords, &o_points, &n_threads);
+    n_return = PyArg_ParseTupleAndKeywords(values, keys, "O|nOOOz:distances",
+                                           keywords, &o_points, &n_threads,
+                                           &o_out, &o_dtype, &o_cutoff, &path);
     
     if (!n_return) {
         
@@ -93,28 +151,80 @@ pywise_distances
     }
     
     /*
-    *   Ensure that the requested number of threads is greater-than-zero.
+    *   Ensure that the requested number of threads is not negative. Zero
+    *   requests that the number of threads be chosen automatically, once the
+    *   size of the input is known.
     */
     
     if (n_threads < 0) {
     
         PyErr_Format(PyExc_ValueError, "Argument threads must be a positive "
-                     "integer.");
+                     "integer, or zero to choose automatically.");
         
         return NULL;
     
     }
     
     /*
-    *   Future versions of pywise could dynamically detect the number of
-    *   processor cores made available host, and then use that many threads
-    *   given the special value of zero for the threads argument.
+    *   Convert the cutoff, if there is one, to a double, raising a Python
+    *   exception if that fails or if out is also given.
     */
     
-    if (!n_threads) {
+    if (o_cutoff == Py_None) {
+        
+        o_cutoff = NULL;
+    
+    }
+    
+    if (o_cutoff) {
+        
+        if (o_out && o_out != Py_None) {
+            
+            PyErr_Format(PyExc_ValueError, "Arguments out and cutoff cannot "
+                         "be given together.");
+                         
+            return NULL;
+        
+        }
+        
+        cutoff = PyFloat_AsDouble(o_cutoff);
+        
+        if (cutoff == -1.0 && PyErr_Occurred()) {
+            
+            return NULL;
+        
+        }
+    
+    }
+    
+    /*
+    *   A results file is written in full, so it can take neither an array of
+    *   the caller's nor a cutoff.
+    */
+    
+    if (path && ((o_out && o_out != Py_None) || o_cutoff)) {
+        
+        PyErr_Format(PyExc_ValueError, "Argument file cannot be given "
+                     "together with out or cutoff.");
+                     
+        return NULL;
+    
+    }
+    
+    /*
+    *   Time each phase of the call from here on, for pywise.last_stats().
+    */
     
-        PyErr_Format(PyExc_NotImplementedError, "Detection of number of "
-                     "processors provided by host not yet implemented.");
+    pywise_stats_begin(&stats, "distances");
+    
+    /*
+    *   Decide whether to calculate in single or double precision, raising a
+    *   Python exception if dtype is neither float32 nor float64.
+    */
+    
+    n_type = pywise_resolve_type(o_points, o_dtype);
+    
+    if (n_type < 0) {
         
         return NULL;
     
@@ -126,7 +236,11 @@ pywise_distances
     *   an appropriate Python exception on failure.
     */
     
-    a_points = pywise_build_points_array(o_points, &n_points, &n_coordinates);
+    a_points = pywise_build_points_array(o_points,
+                                         n_type,
+                                         &n_points,
+                                         &n_coordinates,
+                                         &view);
     
     if (!a_points) {
     
@@ -134,6 +248,76 @@ pywise_distances
     
     }
     
+    pywise_stats_mark(&stats, &stats.convert_seconds);
+    
+    /*
+    *   If asked to, choose as many threads as the processors available to
+    *   this process (allowing for its CPU affinity and any control group
+    *   quota), but fewer if there are too few points to keep them all busy.
+    */
+    
+    if (!n_threads) {
+        
+        n_threads = pairwise_threads_suggested(n_points, 1, n_coordinates);
+    
+    }
+    
+    /*
+    *   If given a cutoff, keep only the distances within it, and return them as
+    *   CSR arrays rather than as one condensed array. As below, the calculation
+    *   needs no Python function, so the GIL is released.
+    */
+    
+    if (o_cutoff) {
+        
+        Py_BEGIN_ALLOW_THREADS
+        
+        if (n_type == NPY_FLOAT) {
+            
+            n_return = pairwise_distances_cutoff_float(n_points,
+                                                       n_coordinates,
+                                                       a_points,
+                                                       (float)cutoff,
+                                                       &a_indptr,
+                                                       &a_indices,
+                                                       (float**)&a_distances,
+                                                       n_threads);
+        
+        } else {
+            
+            n_return = pairwise_distances_cutoff(n_points,
+                                                 n_coordinates,
+                                                 a_points,
+                                                 cutoff,
+                                                 &a_indptr,
+                                                 &a_indices,
+                                                 (double**)&a_distances,
+                                                 n_threads);
+        
+        }
+        
+        Py_END_ALLOW_THREADS
+        
+        pywise_stats_mark(&stats, &stats.calculate_seconds);
+        
+        pywise_release_array(a_points, &view);
+        
+        if (n_return) {
+            
+            pywise_set_python_exception_from_pairwise_calculations_return_code(n_return);
+            
+            return NULL;
+        
+        }
+        
+        return pywise_stats_commit(&stats, pywise_wrap_csr(n_points,
+                                                           a_indptr,
+                                                           a_indices,
+                                                           a_distances,
+                                                           n_type));
+    
+    }
+    
     /*
     *   Knowing now how many points across which we must calculate pairwise
     *   distances, allocate memory for the output distances array, a_distances.
@@ -141,34 +325,160 @@ pywise_distances
     
     l_a_distances = 0.5 * n_points * (n_points - 1);
     
-    s_a_distances = l_a_distances * sizeof(double);
+    s_a_distances = l_a_distances * (n_type == NPY_FLOAT ? sizeof(float) :
+                                                           sizeof(double));
     
-    a_distances = malloc(s_a_distances);
+    s_a_points = n_points * n_coordinates * (n_type == NPY_FLOAT ?
+                                             sizeof(float) : sizeof(double));
     
-    if (!a_distances) {
+    /*
+    *   Store the results in the caller-supplied array o_out if there is one,
+    *   having checked its size, dtype, contiguity and writability; or in a
+    *   new results file mapped into memory if asked for one; otherwise in a
+    *   newly allocated array.
+    */
+    
+    view_out.buf = NULL;
+    view_out.obj = NULL;
+    
+    if (o_out == Py_None) {
+        
+        o_out = NULL;
+    
+    }
+    
+    if (o_out) {
+        
+        a_distances = pywise_borrow_output(o_out, n_type, l_a_distances,
+                                           a_points, s_a_points, &view_out);
+    
+    } else if (path) {
+        
+        n_return = pairwise_file_create(path,
+                                        n_points,
+                                        n_type == NPY_FLOAT ? sizeof(float) :
+                                                              sizeof(double),
+                                        "euclidean",
+                                        &a_distances);
+                                        
+        if (n_return) {
+            
+            a_distances = NULL;
+            
+            pywise_set_python_exception_from_pairwise_calculations_return_code(n_return);
+        
+        }
     
-        PyErr_Format(PyExc_MemoryError, "Failed to allocate memory for output "
-                     "distances array; needed %zu bytes.", s_a_distances);
+    } else {
         
-        free(a_points);
+        a_distances = malloc(s_a_distances);
+        
+        if (!a_distances) {
+            
+            PyErr_Format(PyExc_MemoryError, "Failed to allocate memory for "
+                         "output distances array; needed %zu bytes.",
+                         s_a_distances);
+        
+        }
+    
+    }
+    
+    if (!a_distances) {
+        
+        pywise_release_array(a_points, &view);
         
         return NULL;
     
     }
     
+    pywise_stats_mark(&stats, &stats.allocate_seconds);
+    
     /*
     *   Calculate pairwise distances across all points in a_points,
     *   distributing the calculations to be carried out over n_threads parallel
     *   threads, and store the calculated distances in a_distances.
+    *   
+    *   pairwise_distances() touches only the C arrays a_points and
+    *   a_distances, and calls no Python function, so release the GIL for its
+    *   duration. (Either array may belong to a caller's Python object, but
+    *   buffer views keep both alive and unresized meanwhile.) Other Python
+    *   threads then stay responsive, and may run their own pywise
+    *   calculations concurrently. The same goes for
+    *   pairwise_distances_float().
     */
     
-    n_return = pairwise_distances(n_points,
-                                  n_coordinates,
-                                  a_points,
-                                  a_distances,
-                                  n_threads);
+    Py_BEGIN_ALLOW_THREADS
     
-    free(a_points);
+    if (n_type == NPY_FLOAT) {
+        
+        n_return = pairwise_distances_float(n_points,
+                                            n_coordinates,
+                                            a_points,
+                                            a_distances,
+                                            n_threads);
+    
+    } else {
+        
+        n_return = pairwise_distances(n_points,
+                                      n_coordinates,
+                                      a_points,
+                                      a_distances,
+                                      n_threads);
+    
+    }
+    
+    Py_END_ALLOW_THREADS
+    
+    pywise_stats_mark(&stats, &stats.calculate_seconds);
+    
+    pywise_release_array(a_points, &view);
+    
+    if (path) {
+        
+        /*
+        *   Write back and unmap the results file whether or not
+        *   pairwise_distances() succeeded. If it did, open the file afresh as a
+        *   numpy.memmap, which maps only the pages read; otherwise remove the
+        *   incomplete file.
+        */
+        
+        n_return_file = pairwise_file_close(a_distances);
+        
+        if (!n_return) {
+            
+            n_return = n_return_file;
+        
+        }
+        
+        if (!n_return) {
+            
+            return pywise_stats_commit(&stats, pywise_open_file(path, "r+"));
+        
+        }
+        
+        pywise_set_python_exception_from_pairwise_calculations_return_code(n_return);
+        
+        remove(path);
+        
+        return NULL;
+    
+    }
+    
+    if (!n_return && o_out) {
+        
+        /*
+        *   If pairwise_distances() succeeded in filling the caller-supplied
+        *   array o_out, release o_out and then return it, as NumPy functions
+        *   do with their out arguments.
+        */
+        
+        pywise_release_array(a_distances, &view_out);
+        
+        Py_INCREF(o_out);
+        
+        return pywise_stats_commit(&stats, o_out);
+    
+    }
     
     if (!n_return) {
     
@@ -182,7 +492,7 @@ pywise_distances
         
         o_distances = PyArray_SimpleNewFromData(1,
                                                 npy_l_a_distances,
-                                                NPY_DOUBLE,
+                                                n_type,
                                                 a_distances);
         
         #if defined(NPY_ARRAY_OWNDATA)
@@ -191,17 +501,17 @@ pywise_distances
         PyArray_ENABLEFLAGS((PyArrayObject*)o_distances, NPY_OWNDATA);
         #endif
         
-        return o_distances;
+        return pywise_stats_commit(&stats, o_distances);
     
     }
     
     /*
-    *   Otherwise if pairwise_distances() failed, free the memory pointed to by
-    *   a_distances, and then raise a Python exception appropriate to the
+    *   Otherwise if pairwise_distances() failed, release the memory pointed
+    *   to by a_distances, and then raise a Python exception appropriate to the
     *   libpairwise return code from pairwise_distances().
     */
     
-    free(a_distances);
+    pywise_release_array(a_distances, &view_out);
     
     pywise_set_python_exception_from_pairwise_calculations_return_code(n_return);
     
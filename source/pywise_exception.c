@@ -112,6 +112,62 @@ pywise_set_python_exception_from_pairwise_calculations_return_code
             
             return;
         
+        case PAIRWISE_RETURN_ERROR_NNEIGHBOURS:
+        
+            PyErr_Format(PyExc_ValueError, "Argument k must be less than the "
+                         "number of points or collections.");
+            
+            return;
+        
+        case PAIRWISE_RETURN_ERROR_NCOORDINATES:
+        
+            PyErr_Format(PyExc_ValueError, "Superposition requires points in "
+                         "three-dimensional space.");
+                         
+            return;
+            
+        case PAIRWISE_RETURN_ERROR_FILE:
+        
+            PyErr_SetFromErrno(PyExc_IOError);
+            
+            return;
+            
+        case PAIRWISE_RETURN_ERROR_FILE_FORMAT:
+        
+            PyErr_Format(PyExc_ValueError, "File is not a libpairwise results "
+                         "file of this version and byte order.");
+                         
+            return;
+            
+        case PAIRWISE_RETURN_ERROR_RANGE:
+        
+            PyErr_Format(PyExc_ValueError, "Argument range must be a pair of "
+                         "floats, the first less than the second.");
+                         
+            return;
+            
+        case PAIRWISE_RETURN_ERROR_AFFINITY:
+        
+            PyErr_Format(PyExc_ValueError, "Argument affinity must be one of "
+                         "the pywise.AFFINITY_* constants, and the host must "
+                         "allow worker threads to be pinned to CPUs.");
+                         
+            return;
+            
+        case PAIRWISE_RETURN_ERROR_TIMEOUT:
+        
+            PyErr_Format(PyExc_RuntimeError, "Timed out waiting for the "
+                         "calculation to complete.");
+                         
+            return;
+            
+        case PAIRWISE_RETURN_ERROR_CANCELLED:
+        
+            PyErr_Format(PyExc_RuntimeError, "The calculation was cancelled "
+                         "before it was complete.");
+                         
+            return;
+    
     }
 
 }
@@ -127,16 +183,20 @@ pywise_set_python_exception_from_pairwise_calculations_return_code
     Description:
     
         Sets an appropriate Python exception given a failure return code from
-        libpairwise's public pairwise_index().
+        libpairwise's public pairwise_index(), pairwise_index_inverse() or
+        their array forms, pairwise_indices() and pairwise_indices_inverse().
+        Codes those share with the calculations functions, such as failure to
+        allocate memory or to start a thread, are passed on to
+        pywise_set_python_exception_from_pairwise_calculations_return_code().
         
         Ignores unrecognised error codes, returns nothing, and will not fail.
         
     Further Information:
     
         This function is intended to translate a failure return code from
-        pairwise_index() to a Python exception and error string. The caller
-        should then return NULL to the Python interpreter to raise that
-        exception.
+        pairwise_index() and its kin to a Python exception and error string.
+        The caller should then return NULL to the Python interpreter to raise
+        that exception.
         
 *******************************************************************************/
 
@@ -181,6 +241,56 @@ pywise_set_python_exception_from_pairwise_index_return_code
                          "collection.");
             
             return;
+            
+        case PAIRWISE_RETURN_ERROR_IRESULT:
+        
+            PyErr_Format(PyExc_IndexError, "Argument i_results must hold "
+                         "valid indices into the results of n_collections "
+                         "collections.");
+                         
+            return;
+    
+    }
+    
+    pywise_set_python_exception_from_pairwise_calculations_return_code(n_return);
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_set_python_exception_from_pairwise_isa_return_code
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Sets an appropriate Python exception given a failure return code from
+        libpairwise's public pairwise_set_isa().
+        
+        Ignores unrecognised error codes, returns nothing, and will not fail.
+        
+*******************************************************************************/
+
+void
+pywise_set_python_exception_from_pairwise_isa_return_code
+(
+
+    int n_return
+
+)
+{
+
+    switch (n_return) {
+        
+        case PAIRWISE_RETURN_ERROR_ISA:
+        
+            PyErr_Format(PyExc_ValueError, "Argument isa must be one of the "
+                         "pywise.ISA_* constants, and the host must support "
+                         "the instruction set it identifies.");
+                         
+            return;
     
     }
 
@@ -0,0 +1,205 @@
+#include "pywise_file.h"
+
+/*******************************************************************************
+
+    Symbol: pywise_load
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.load()
+    
+    Python Signature:
+    
+        pywise.load(file, mode = "r") -> numpy.memmap
+        
+    Description:
+    
+        Opens the libpairwise results file at path file, as written by
+        pywise.distances() or pywise.rmsds() when given a file, without
+        reading its results into memory.
+        
+        mode is as for numpy.memmap(), and must be "r", "r+" or "c".
+        
+        On success pywise_load() returns a one-dimensional numpy.memmap of
+        the condensed results in the file, of the dtype they were calculated
+        in. On failure it raises a Python exception.
+        
+    Further Information:
+    
+        This function checks its arguments and passes them to
+        pywise_open_file(), which is shared with pywise_distances() and
+        pywise_rmsds() so that the arrays they return for a file are exactly
+        those which pywise.load() would give.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_load
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+)
+{
+
+    char* keywords[3] = {"file", "mode", NULL};
+    
+    char* path;
+    char* mode;
+    
+    int n_return;
+    
+    mode = "r";
+    
+    n_return = PyArg_ParseTupleAndKeywords(values, keys, "s|s:load", keywords,
+                                           &path, &mode);
+                                           
+    if (!n_return) {
+        
+        return NULL;
+    
+    }
+    
+    /*
+    *   Refuse "w+", which numpy.memmap() would take as a request to create a
+    *   new file, overwriting the results.
+    */
+    
+    if (strcmp(mode, "r") && strcmp(mode, "r+") && strcmp(mode, "c")) {
+        
+        PyErr_Format(PyExc_ValueError, "Argument mode must be \"r\", \"r+\" "
+                     "or \"c\".");
+                     
+        return NULL;
+    
+    }
+    
+    return pywise_open_file(path, mode);
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_open_file
+    
+    Type: Function returning PyObject*
+    
+    Intent: Private
+    
+    Description:
+    
+        Maps the results in the libpairwise results file at path into a
+        numpy.memmap with mode mode, as described for pywise_load().
+        
+        On success returns a new reference to the numpy.memmap, or to an
+        empty array if the file holds no results. On failure sets a Python
+        exception and returns a null pointer.
+        
+    Further Information:
+    
+        libpairwise's pairwise_file_describe() checks the header and finds
+        the number of results and their type. The mapping itself is left to
+        numpy.memmap, which refuses to map a file with no results, so an
+        ordinary empty array stands in for it then.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_open_file
+(
+
+    const char* path,
+    const char* mode
+
+)
+{
+
+    char metric[PAIRWISE_FILE_METRIC_LENGTH];
+    
+    size_t n_collections;
+    size_t s_element;
+    size_t n_offset;
+    
+    size_t l_results;
+    
+    npy_intp npy_l_results[1];
+    
+    int n_type;
+    int n_return;
+    
+    PyObject* o_numpy;
+    PyObject* o_memmap;
+    PyObject* o_values;
+    PyObject* o_keys;
+    PyObject* o_results;
+    
+    n_return = pairwise_file_describe(path,
+                                      &n_collections,
+                                      &s_element,
+                                      metric,
+                                      &n_offset);
+                                      
+    if (n_return) {
+        
+        pywise_set_python_exception_from_pairwise_calculations_return_code(n_return);
+        
+        return NULL;
+    
+    }
+    
+    l_results = n_collections > 1 ? (n_collections * (n_collections - 1)) / 2 : 0;
+    
+    n_type = s_element == sizeof(float) ? NPY_FLOAT : NPY_DOUBLE;
+    
+    if (!l_results) {
+        
+        npy_l_results[0] = 0;
+        
+        return PyArray_SimpleNew(1, npy_l_results, n_type);
+    
+    }
+    
+    o_numpy = PyImport_ImportModule("numpy");
+    
+    if (!o_numpy) {
+        
+        return NULL;
+    
+    }
+    
+    o_memmap = PyObject_GetAttrString(o_numpy, "memmap");
+    
+    Py_DECREF(o_numpy);
+    
+    if (!o_memmap) {
+        
+        return NULL;
+    
+    }
+    
+    o_values = Py_BuildValue("(s)", path);
+    
+    o_keys = Py_BuildValue("{s:N,s:s,s:n,s:(n)}",
+                           "dtype", PyArray_DescrFromType(n_type),
+                           "mode", mode,
+                           "offset", (Py_ssize_t)n_offset,
+                           "shape", (Py_ssize_t)l_results);
+                           
+    o_results = NULL;
+    
+    if (o_values && o_keys) {
+        
+        o_results = PyObject_Call(o_memmap, o_values, o_keys);
+    
+    }
+    
+    Py_DECREF(o_memmap);
+    
+    Py_XDECREF(o_values);
+    Py_XDECREF(o_keys);
+    
+    return o_results;
+
+}
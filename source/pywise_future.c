@@ -0,0 +1,932 @@
+#include "pywise_future.h"
+
+/*******************************************************************************
+
+    Symbol: pywise_future_methods
+    
+    Type: Array of PyMethodDef
+    
+    Intent: Private
+    
+    Description:
+    
+        A manifest of all public methods to be exposed by pywise.Future.
+        
+*******************************************************************************/
+
+PyMethodDef
+pywise_future_methods[] = {
+    
+	{
+	
+	    "done",
+	    (PyCFunction)pywise_future_done,
+	    METH_NOARGS,
+	    NULL
+	
+	},
+	
+	{
+	
+	    "progress",
+	    (PyCFunction)pywise_future_progress,
+	    METH_NOARGS,
+	    NULL
+	
+	},
+	
+	{
+	
+	    "cancel",
+	    (PyCFunction)pywise_future_cancel,
+	    METH_NOARGS,
+	    NULL
+	
+	},
+	
+	{
+	
+	    "result",
+	    (PyCFunction)pywise_future_result,
+	    METH_VARARGS | METH_KEYWORDS,
+	    NULL
+	
+	},
+	
+	{
+	    
+	    NULL,
+	    NULL,
+	    0,
+	    NULL
+	
+	}
+	
+};
+
+/*******************************************************************************
+
+    Symbol: pywise_future_type
+    
+    Type: PyTypeObject
+    
+    Intent: Private
+    
+    Description:
+    
+        The Python type of pywise_future_t, pywise.Future, whose members are
+        set by pywise_future_prepare_type().
+        
+*******************************************************************************/
+
+PyTypeObject
+pywise_future_type = {
+    
+    PyVarObject_HEAD_INIT(NULL, 0)
+
+};
+
+/*******************************************************************************
+
+    Symbol: pywise_future_submit
+    
+    Type: Static function returning PyObject*
+    
+    Intent: Private
+    
+    Description:
+    
+        Parses the arguments of pywise.submit_distances(), if b_rmsd is
+        clear, or of pywise.submit_rmsds(), if it is set, whose name is
+        format, and starts the calculation on libpairwise's worker pool.
+        
+        On success returns a new pywise.Future. On failure returns a null
+        pointer and sets a Python exception.
+        
+    Further Information:
+    
+        This function builds its input array as pywise.distances() or
+        pywise.rmsds() does, and allocates the output array at once, and then
+        passes both to libpairwise's pairwise_distances_submit() or
+        pairwise_rmsds_submit(), or their float counterparts in single
+        precision. Both arrays are kept by the pywise.Future until its
+        calculation has stopped.
+        
+*******************************************************************************/
+
+static PyObject*
+pywise_future_submit
+(
+
+    PyObject* values,
+    PyObject* keys,
+    
+    int b_rmsd,
+    
+    const char* format
+
+)
+{
+
+    char* keywords_distances[4] = {"points", "threads", "dtype", NULL};
+    char* keywords_rmsds[4] = {"collections", "threads", "dtype", NULL};
+    
+    size_t n_collections;
+    size_t n_points;
+    size_t n_coordinates;
+    
+    Py_ssize_t n_threads;
+    
+    PyObject* o_source;
+    PyObject* o_dtype;
+    
+    void* a_collections;
+    void* a_results;
+    
+    size_t l_results;
+    size_t s_results;
+    
+    pairwise_future_t* handle;
+    
+    pywise_future_t* future;
+    
+    int n_type;
+    
+    int n_return;
+    
+    n_threads = PYWISE_DEFAULT_THREADS;
+    
+    o_dtype = NULL;
+    
+    /*
+    *   Attempt to parse arguments with keywords "points" or "collections",
+    *   "threads" and "dtype" as a Python object, a signed integer and a
+    *   Python object, respectively. As for pywise_distances(), the number of
+    *   threads is parsed as signed so that negative values can be detected.
+    */
+    
+    n_return = PyArg_ParseTupleAndKeywords(values, keys, format,
+                                           b_rmsd ? keywords_rmsds :
+                                                    keywords_distances,
+                                           &o_source, &n_threads, &o_dtype);
+                                           
+    if (!n_return) {
+        
+        return NULL;
+    
+    }
+    
+    if (n_threads < 0) {
+        
+        PyErr_Format(PyExc_ValueError, "Argument threads must be a positive "
+                     "integer, or zero to choose automatically.");
+                     
+        return NULL;
+    
+    }
+    
+    n_type = pywise_resolve_type(o_source, o_dtype);
+    
+    if (n_type < 0) {
+        
+        return NULL;
+    
+    }
+    
+    /*
+    *   Build an input array of collections, or of points, from o_source. The
+    *   workers read it until the calculation has stopped, so it is kept, with
+    *   its buffer view, by the future.
+    */
+    
+    future = PyObject_New(pywise_future_t, &pywise_future_type);
+    
+    if (!future) {
+        
+        return NULL;
+    
+    }
+    
+    future->future = NULL;
+    
+    future->a_results = NULL;
+    
+    future->o_result = NULL;
+    
+    if (b_rmsd) {
+        
+        a_collections = pywise_build_collections_array(o_source,
+                                                       n_type,
+                                                       &n_collections,
+                                                       &n_points,
+                                                       &n_coordinates,
+                                                       &future->view);
+    
+    } else {
+        
+        a_collections = pywise_build_points_array(o_source,
+                                                  n_type,
+                                                  &n_collections,
+                                                  &n_coordinates,
+                                                  &future->view);
+                                                  
+        n_points = 1;
+    
+    }
+    
+    if (!a_collections) {
+        
+        Py_DECREF(future);
+        
+        return NULL;
+    
+    }
+    
+    if (!n_threads) {
+        
+        n_threads = pairwise_threads_suggested(n_collections,
+                                               n_points,
+                                               n_coordinates);
+    
+    }
+    
+    l_results = 0.5 * n_collections * (n_collections - 1);
+    
+    s_results = l_results * (n_type == NPY_FLOAT ? sizeof(float) :
+                                                   sizeof(double));
+                                                   
+    a_results = malloc(s_results);
+    
+    if (!a_results) {
+        
+        pywise_release_array(a_collections, &future->view);
+        
+        Py_DECREF(future);
+        
+        PyErr_Format(PyExc_MemoryError, "Failed to allocate memory for "
+                     "output results array; needed %zu bytes.", s_results);
+                     
+        return NULL;
+    
+    }
+    
+    /*
+    *   Submitting cuts the calculation into chunks and may start workers,
+    *   neither of which touches any Python object.
+    */
+    
+    Py_BEGIN_ALLOW_THREADS
+    
+    if (b_rmsd && n_type == NPY_FLOAT) {
+        
+        n_return = pairwise_rmsds_submit_float(n_collections,
+                                               n_points,
+                                               n_coordinates,
+                                               a_collections,
+                                               a_results,
+                                               n_threads,
+                                               &handle);
+    
+    } else if (b_rmsd) {
+        
+        n_return = pairwise_rmsds_submit(n_collections,
+                                         n_points,
+                                         n_coordinates,
+                                         a_collections,
+                                         a_results,
+                                         n_threads,
+                                         &handle);
+    
+    } else if (n_type == NPY_FLOAT) {
+        
+        n_return = pairwise_distances_submit_float(n_collections,
+                                                   n_coordinates,
+                                                   a_collections,
+                                                   a_results,
+                                                   n_threads,
+                                                   &handle);
+    
+    } else {
+        
+        n_return = pairwise_distances_submit(n_collections,
+                                             n_coordinates,
+                                             a_collections,
+                                             a_results,
+                                             n_threads,
+                                             &handle);
+    
+    }
+    
+    Py_END_ALLOW_THREADS
+    
+    if (n_return) {
+        
+        free(a_results);
+        
+        pywise_release_array(a_collections, &future->view);
+        
+        Py_DECREF(future);
+        
+        pywise_set_python_exception_from_pairwise_calculations_return_code(n_return);
+        
+        return NULL;
+    
+    }
+    
+    future->future = handle;
+    
+    future->a_collections = a_collections;
+    
+    future->a_results = a_results;
+    future->l_results = l_results;
+    
+    future->n_type = n_type;
+    
+    future->n_done = 0;
+    future->n_total = 0;
+    
+    future->b_busy = 0;
+    
+    return (PyObject*)future;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_submit_distances
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.submit_distances()
+    
+    Python Signature:
+    
+        pywise.submit_distances(points, threads = 0, dtype = None)
+            -> pywise.Future
+            
+    Description:
+    
+        Starts calculating all pairwise Euclidean distances across a set of
+        points in any-dimensional space, as pywise.distances() does, on
+        libpairwise's worker pool, and returns at once with a pywise.Future
+        through which the calculation can be followed, cancelled and waited
+        for while the calling thread goes on with other work.
+        
+        points, threads and dtype are as for pywise.distances().
+        
+        On success pywise_submit_distances() returns a pywise.Future. On
+        failure it raises a Python exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_submit_distances
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+)
+{
+
+    return pywise_future_submit(values, keys, 0, "O|nO:submit_distances");
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_submit_rmsds
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.submit_rmsds()
+    
+    Python Signature:
+    
+        pywise.submit_rmsds(collections, threads = 0, dtype = None)
+            -> pywise.Future
+            
+    Description:
+    
+        Starts calculating all pairwise RMSDs across a set of collections of
+        points, as pywise.rmsds() does, on libpairwise's worker pool, and
+        returns at once with a pywise.Future through which the calculation
+        can be followed, cancelled and waited for while the calling thread
+        goes on with other work.
+        
+        collections, threads and dtype are as for pywise.rmsds().
+        
+        On success pywise_submit_rmsds() returns a pywise.Future. On failure
+        it raises a Python exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_submit_rmsds
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+)
+{
+
+    return pywise_future_submit(values, keys, 1, "O|nO:submit_rmsds");
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_future_done
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.Future.done()
+    
+    Python Signature:
+    
+        future.done() -> bool
+        
+    Description:
+    
+        Returns True if the calculation has stopped, whether because it is
+        complete or because it was cancelled, and False if it is still being
+        carried out. Never waits.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_future_done
+(
+
+    PyObject* self,
+    PyObject* unused
+
+)
+{
+
+    pywise_future_t* future;
+    
+    future = (pywise_future_t*)self;
+    
+    /*
+    *   A closed future is one whose calculation was complete.
+    */
+    
+    return PyBool_FromLong(!future->future
+                           || pairwise_future_done(future->future));
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_future_progress
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.Future.progress()
+    
+    Python Signature:
+    
+        future.progress() -> (int, int)
+        
+    Description:
+    
+        Returns a tuple of the number of pairwise calculations carried out so
+        far and the number there are in all. The first grows a chunk of
+        calculations at a time, and equals the second once the calculation is
+        complete.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_future_progress
+(
+
+    PyObject* self,
+    PyObject* unused
+
+)
+{
+
+    pywise_future_t* future;
+    
+    size_t n_done;
+    size_t n_total;
+    
+    future = (pywise_future_t*)self;
+    
+    n_done = future->n_done;
+    n_total = future->n_total;
+    
+    if (future->future) {
+        
+        pairwise_future_progress(future->future, &n_done, &n_total);
+    
+    }
+    
+    return Py_BuildValue("(nn)", (Py_ssize_t)n_done, (Py_ssize_t)n_total);
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_future_cancel
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.Future.cancel()
+    
+    Python Signature:
+    
+        future.cancel() -> None
+        
+    Description:
+    
+        Asks the threads carrying out the calculation to stop once each has
+        finished its chunk of calculations, and returns at once. A
+        calculation which is already complete is left as it is.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_future_cancel
+(
+
+    PyObject* self,
+    PyObject* unused
+
+)
+{
+
+    pywise_future_t* future;
+    
+    future = (pywise_future_t*)self;
+    
+    if (future->future) {
+        
+        pairwise_future_cancel(future->future);
+    
+    }
+    
+    Py_RETURN_NONE;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_future_result
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.Future.result()
+    
+    Python Signature:
+    
+        future.result(timeout = None) -> numpy.ndarray
+        
+    Description:
+    
+        Waits for up to timeout seconds, or for as long as it takes if
+        timeout is None, for the calculation to complete, without holding the
+        GIL, and returns its results as a one-dimensional NumPy array, as
+        pywise.distances() or pywise.rmsds() would have. Every call once the
+        calculation is complete returns the same array.
+        
+        Raises RuntimeError if the calculation is still being carried out
+        once timeout has passed, or if it was cancelled. If the wait is
+        interrupted by a signal, as by Ctrl-C, cancels the calculation and
+        raises the exception of the signal handler, such as
+        KeyboardInterrupt.
+        
+    Further Information:
+    
+        Python runs signal handlers only on the main thread, and only between
+        bytecodes, so a thread blocked in C for the whole calculation could
+        not be interrupted. This function instead waits in slices of at most
+        PYWISE_FUTURE_WAIT_SLICE seconds, running any pending handlers with
+        PyErr_CheckSignals() between them.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_future_result
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+)
+{
+
+    char* keywords[2] = {"timeout", NULL};
+    
+    pywise_future_t* future;
+    
+    PyObject* o_timeout;
+    
+    double timeout;
+    double waited;
+    double slice;
+    
+    npy_intp npy_l_results[1];
+    
+    int n_return;
+    
+    future = (pywise_future_t*)self;
+    
+    o_timeout = NULL;
+    
+    n_return = PyArg_ParseTupleAndKeywords(values, keys, "|O:result",
+                                           keywords, &o_timeout);
+                                           
+    if (!n_return) {
+        
+        return NULL;
+    
+    }
+    
+    /*
+    *   A negative timeout stands for no timeout below.
+    */
+    
+    timeout = -1;
+    
+    if (o_timeout && o_timeout != Py_None) {
+        
+        timeout = PyFloat_AsDouble(o_timeout);
+        
+        if (timeout == -1.0 && PyErr_Occurred()) {
+            
+            return NULL;
+        
+        }
+        
+        if (timeout < 0) {
+            
+            PyErr_Format(PyExc_ValueError, "Argument timeout must be a "
+                         "positive number of seconds, or None to wait for "
+                         "as long as it takes.");
+                         
+            return NULL;
+        
+        }
+    
+    }
+    
+    if (future->o_result) {
+        
+        Py_INCREF(future->o_result);
+        
+        return future->o_result;
+    
+    }
+    
+    /*
+    *   Only one thread at a time may wait, since it closes the future once
+    *   the calculation is complete, and this one is about to release the
+    *   GIL.
+    */
+    
+    if (future->b_busy) {
+        
+        PyErr_Format(PyExc_ValueError, "The result is already being waited "
+                     "for by another thread.");
+                     
+        return NULL;
+    
+    }
+    
+    future->b_busy = 1;
+    
+    waited = 0;
+    
+    do {
+        
+        slice = PYWISE_FUTURE_WAIT_SLICE;
+        
+        if (timeout >= 0 && timeout - waited < slice) {
+            
+            slice = timeout - waited;
+        
+        }
+        
+        Py_BEGIN_ALLOW_THREADS
+        
+        n_return = pairwise_future_wait(future->future, slice);
+        
+        Py_END_ALLOW_THREADS
+        
+        if (n_return != PAIRWISE_RETURN_ERROR_TIMEOUT) {
+            
+            break;
+        
+        }
+        
+        waited += slice;
+        
+        if (PyErr_CheckSignals()) {
+            
+            pairwise_future_cancel(future->future);
+            
+            future->b_busy = 0;
+            
+            return NULL;
+        
+        }
+    
+    } while (timeout < 0 || waited < timeout);
+    
+    future->b_busy = 0;
+    
+    if (n_return) {
+        
+        pywise_set_python_exception_from_pairwise_calculations_return_code(n_return);
+        
+        return NULL;
+    
+    }
+    
+    /*
+    *   The calculation is complete, so close the future, and wrap the
+    *   results in a NumPy array object, o_result, transferring ownership of
+    *   the memory pointed to by a_results to it.
+    */
+    
+    n_return = pywise_future_close(future);
+    
+    if (n_return) {
+        
+        pywise_set_python_exception_from_pairwise_calculations_return_code(n_return);
+        
+        return NULL;
+    
+    }
+    
+    npy_l_results[0] = future->l_results;
+    
+    future->o_result = PyArray_SimpleNewFromData(1,
+                                                 npy_l_results,
+                                                 future->n_type,
+                                                 future->a_results);
+                                                 
+    if (!future->o_result) {
+        
+        return NULL;
+    
+    }
+    
+    #if defined(NPY_ARRAY_OWNDATA)
+    PyArray_ENABLEFLAGS((PyArrayObject*)future->o_result, NPY_ARRAY_OWNDATA);
+    #else
+    PyArray_ENABLEFLAGS((PyArrayObject*)future->o_result, NPY_OWNDATA);
+    #endif
+    
+    future->a_results = NULL;
+    
+    Py_INCREF(future->o_result);
+    
+    return future->o_result;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_future_close
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Closes the libpairwise future of future, if it is not already closed,
+        without holding the GIL, cancelling it if it is still running, and
+        releases its input array. The results are kept.
+        
+        Returns the libpairwise return code of pairwise_future_close(), or
+        PAIRWISE_RETURN_SUCCESS if future was already closed.
+        
+*******************************************************************************/
+
+int
+pywise_future_close
+(
+
+    pywise_future_t* future
+
+)
+{
+
+    int n_return;
+    
+    if (!future->future) {
+        
+        return PAIRWISE_RETURN_SUCCESS;
+    
+    }
+    
+    /*
+    *   Waiting for the workers to stop touches no Python object. The final
+    *   progress is kept for pywise_future_progress().
+    */
+    
+    Py_BEGIN_ALLOW_THREADS
+    
+    pairwise_future_cancel(future->future);
+    pairwise_future_wait(future->future, -1);
+    
+    pairwise_future_progress(future->future, &future->n_done, &future->n_total);
+    
+    n_return = pairwise_future_close(future->future);
+    
+    Py_END_ALLOW_THREADS
+    
+    future->future = NULL;
+    
+    pywise_release_array(future->a_collections, &future->view);
+    
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_future_dealloc
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        The tp_dealloc of pywise_future_type. Closes the future of self, if
+        it is still open, which cancels a calculation still running, frees
+        any results not handed over to a NumPy array, and frees self.
+        
+        Returns nothing, and will not fail.
+        
+*******************************************************************************/
+
+void
+pywise_future_dealloc
+(
+
+    PyObject* self
+
+)
+{
+
+    pywise_future_t* future;
+    
+    future = (pywise_future_t*)self;
+    
+    pywise_future_close(future);
+    
+    free(future->a_results);
+    
+    Py_XDECREF(future->o_result);
+    
+    PyObject_Del(self);
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_future_prepare_type
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Sets the members of pywise_future_type and readies it for use. Called
+        once, by initpywise().
+        
+        On success returns integer zero. On failure returns integer minus one
+        and sets a Python exception.
+        
+*******************************************************************************/
+
+int
+pywise_future_prepare_type
+(void)
+{
+
+    pywise_future_type.tp_name = "pywise.Future";
+    pywise_future_type.tp_basicsize = sizeof(pywise_future_t);
+    pywise_future_type.tp_flags = Py_TPFLAGS_DEFAULT;
+    pywise_future_type.tp_doc = "A pairwise calculation running on the "
+                                "worker pool, from pywise.submit_distances() "
+                                "or pywise.submit_rmsds().";
+                                
+    pywise_future_type.tp_dealloc = pywise_future_dealloc;
+    pywise_future_type.tp_methods = pywise_future_methods;
+    
+    return PyType_Ready(&pywise_future_type);
+
+}
@@ -110,3 +110,404 @@ pywise_index
     return NULL;
 
 }
+
+/*******************************************************************************
+
+    Symbol: pywise_index_broadcast
+    
+    Type: Static function returning PyObject*
+    
+    Intent: Private
+    
+    Description:
+    
+        Stretches o_array, a C-contiguous NumPy array of npy_intp, to the
+        shape of n_dimensions dimensions given by npy_l_array, to which it
+        must be broadcastable, so that the arrays passed to libpairwise all
+        have one element per index. Steals the reference to o_array.
+        
+        On success returns a new reference to a C-contiguous NumPy array of
+        npy_intp of that shape, which is o_array itself if it already has as
+        many elements. On failure returns NULL with a Python exception set.
+        
+*******************************************************************************/
+
+static PyObject*
+pywise_index_broadcast
+(
+
+    PyObject* o_array,
+    
+    int n_dimensions,
+    npy_intp* npy_l_array
+
+)
+{
+
+    PyObject* o_broadcast;
+    
+    npy_intp n_elements;
+    
+    n_elements = PyArray_MultiplyList(npy_l_array, n_dimensions);
+    
+    if (PyArray_SIZE((PyArrayObject*)o_array) == n_elements) {
+                                                                          
+        return o_array;
+    
+    }
+    
+    o_broadcast = PyArray_SimpleNew(n_dimensions, npy_l_array, NPY_INTP);
+    
+    if (o_broadcast && PyArray_CopyInto((PyArrayObject*)o_broadcast,
+                                        (PyArrayObject*)o_array)) {
+                                            
+        Py_DECREF(o_broadcast);
+        
+        o_broadcast = NULL;
+    
+    }
+    
+    Py_DECREF(o_array);
+    
+    return o_broadcast;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_indices
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.indices()
+    
+    Python Signature:
+    
+        pywise.indices(n_collections, i_collections_a, i_collections_b,
+                       threads = 0)
+            -> numpy.ndarray
+            
+    Description:
+    
+        pywise.index() over arrays. i_collections_a and i_collections_b are
+        integers, or arrays of them, which are broadcast against each other
+        as NumPy broadcasts operands. For each pair of elements, the index of
+        the result of the calculation between the two collections they
+        indicate is found, exactly as pywise.index() would find it. threads
+        is as for pywise.distances().
+        
+        On success returns a NumPy array of intp of the broadcast shape, so
+        that, for instance, results[pywise.indices(N, i, others)] gathers row
+        i of the full matrix of results at once. On failure raises a Python
+        exception, which is the one pywise.index() would have raised for the
+        first pair to fail.
+        
+    Further Information:
+    
+        Both arrays are converted to C-contiguous npy_intp, broadcast to a
+        common shape, and passed to libpairwise's pairwise_indices(), which
+        applies pairwise_index() to every pair, over several threads for
+        large arrays. The GIL is released for its duration.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_indices
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+)
+{
+
+    char* keywords[5] = {"n_collections", "i_collections_a", "i_collections_b",
+                         "threads", NULL};
+                         
+    Py_ssize_t n_collections;
+    Py_ssize_t n_threads;
+    
+    PyObject* o_collections_a;
+    PyObject* o_collections_b;
+    PyObject* o_multi;
+    PyObject* o_results;
+    
+    int n_dimensions;
+    
+    npy_intp npy_l_array[NPY_MAXDIMS];
+    
+    int n_return;
+    
+    n_threads = PYWISE_DEFAULT_THREADS;
+    
+    n_return = PyArg_ParseTupleAndKeywords(values, keys, "nOO|n:indices",
+                                           keywords, &n_collections,
+                                           &o_collections_a, &o_collections_b,
+                                           &n_threads);
+                                           
+    if (!n_return) {
+        
+        return NULL;
+    
+    }
+    
+    if (n_collections < 0) {
+        
+        PyErr_Format(PyExc_ValueError, "Argument n_collections must be a "
+                     "positive integer.");
+                     
+        return NULL;
+    
+    }
+    
+    if (n_threads < 0) {
+        
+        PyErr_Format(PyExc_ValueError, "Argument threads must be a positive "
+                     "integer, or zero to choose automatically.");
+                     
+        return NULL;
+    
+    }
+    
+    if (!n_threads) {
+        
+        n_threads = pairwise_threads_available();
+    
+    }
+    
+    o_collections_a = PyArray_FROMANY(o_collections_a, NPY_INTP, 0, 0,
+                                      NPY_ARRAY_CARRAY_RO);
+                                      
+    if (!o_collections_a) {
+        
+        return NULL;
+    
+    }
+    
+    o_collections_b = PyArray_FROMANY(o_collections_b, NPY_INTP, 0, 0,
+                                      NPY_ARRAY_CARRAY_RO);
+                                      
+    if (!o_collections_b) {
+        
+        Py_DECREF(o_collections_a);
+        
+        return NULL;
+    
+    }
+    
+    /*
+    *   Find the shape the two arrays broadcast to, raising NumPy's own
+    *   ValueError if they don't, and stretch each to it.
+    */
+    
+    o_multi = PyArray_MultiIterNew(2, o_collections_a, o_collections_b);
+    
+    if (!o_multi) {
+        
+        Py_DECREF(o_collections_a);
+        Py_DECREF(o_collections_b);
+        
+        return NULL;
+    
+    }
+    
+    n_dimensions = ((PyArrayMultiIterObject*)o_multi)->nd;
+    
+    memcpy(npy_l_array, ((PyArrayMultiIterObject*)o_multi)->dimensions,
+           n_dimensions * sizeof(npy_intp));
+    
+    Py_DECREF(o_multi);
+    
+    o_collections_a = pywise_index_broadcast(o_collections_a, n_dimensions, npy_l_array);
+    o_collections_b = pywise_index_broadcast(o_collections_b, n_dimensions, npy_l_array);
+    
+    o_results = PyArray_SimpleNew(n_dimensions, npy_l_array, NPY_INTP);
+    
+    if (!o_collections_a || !o_collections_b || !o_results) {
+        
+        Py_XDECREF(o_collections_a);
+        Py_XDECREF(o_collections_b);
+        Py_XDECREF(o_results);
+        
+        return NULL;
+    
+    }
+    
+    Py_BEGIN_ALLOW_THREADS
+    
+    n_return = pairwise_indices(n_collections,
+                                PyArray_SIZE((PyArrayObject*)o_results),
+                                PyArray_DATA((PyArrayObject*)o_collections_a),
+                                PyArray_DATA((PyArrayObject*)o_collections_b),
+                                PyArray_DATA((PyArrayObject*)o_results),
+                                n_threads);
+                                
+    Py_END_ALLOW_THREADS
+    
+    Py_DECREF(o_collections_a);
+    Py_DECREF(o_collections_b);
+    
+    if (n_return) {
+        
+        Py_DECREF(o_results);
+        
+        pywise_set_python_exception_from_pairwise_index_return_code(n_return);
+        
+        return NULL;
+    
+    }
+    
+    return o_results;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_indices_inverse
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.indices_inverse()
+    
+    Python Signature:
+    
+        pywise.indices_inverse(n_collections, i_results, threads = 0)
+            -> (numpy.ndarray, numpy.ndarray)
+            
+    Description:
+    
+        The inverse of pywise.indices(). i_results is an integer, or an array
+        of them, each an index into the results of one of pywise's
+        calculation functions for n_collections collections, where negative
+        indices count back from the end of the results. For each, the two
+        collections whose calculation gave that result are found. threads is
+        as for pywise.distances().
+        
+        On success returns a tuple of two NumPy arrays of intp of the shape
+        of i_results, the first holding the lesser index of each pair and the
+        second the greater. On failure raises a Python exception, which is an
+        IndexError if any of i_results is out of bounds.
+        
+    Further Information:
+    
+        i_results is converted to a C-contiguous array of npy_intp and passed
+        to libpairwise's pairwise_indices_inverse(), which applies
+        pairwise_index_inverse() to every element, over several threads for
+        large arrays, in exact integer arithmetic. The GIL is released for
+        its duration.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_indices_inverse
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+)
+{
+
+    char* keywords[4] = {"n_collections", "i_results", "threads", NULL};
+    
+    Py_ssize_t n_collections;
+    Py_ssize_t n_threads;
+    
+    PyObject* o_results;
+    PyObject* o_collections_a;
+    PyObject* o_collections_b;
+    
+    int n_return;
+    
+    n_threads = PYWISE_DEFAULT_THREADS;
+    
+    n_return = PyArg_ParseTupleAndKeywords(values, keys, "nO|n:indices_inverse",
+                                           keywords, &n_collections,
+                                           &o_results, &n_threads);
+                                           
+    if (!n_return) {
+        
+        return NULL;
+    
+    }
+    
+    if (n_collections < 0) {
+        
+        PyErr_Format(PyExc_ValueError, "Argument n_collections must be a "
+                     "positive integer.");
+                     
+        return NULL;
+    
+    }
+    
+    if (n_threads < 0) {
+        
+        PyErr_Format(PyExc_ValueError, "Argument threads must be a positive "
+                     "integer, or zero to choose automatically.");
+                     
+        return NULL;
+    
+    }
+    
+    if (!n_threads) {
+        
+        n_threads = pairwise_threads_available();
+    
+    }
+    
+    o_results = PyArray_FROMANY(o_results, NPY_INTP, 0, 0, NPY_ARRAY_CARRAY_RO);
+    
+    if (!o_results) {
+        
+        return NULL;
+    
+    }
+    
+    o_collections_a = PyArray_SimpleNew(PyArray_NDIM((PyArrayObject*)o_results),
+                                        PyArray_DIMS((PyArrayObject*)o_results),
+                                        NPY_INTP);
+                                        
+    o_collections_b = PyArray_SimpleNew(PyArray_NDIM((PyArrayObject*)o_results),
+                                        PyArray_DIMS((PyArrayObject*)o_results),
+                                        NPY_INTP);
+                                        
+    if (!o_collections_a || !o_collections_b) {
+        
+        Py_DECREF(o_results);
+        
+        Py_XDECREF(o_collections_a);
+        Py_XDECREF(o_collections_b);
+        
+        return NULL;
+    
+    }
+    
+    Py_BEGIN_ALLOW_THREADS
+    
+    n_return = pairwise_indices_inverse(n_collections,
+                                        PyArray_SIZE((PyArrayObject*)o_results),
+                                        PyArray_DATA((PyArrayObject*)o_results),
+                                        PyArray_DATA((PyArrayObject*)o_collections_a),
+                                        PyArray_DATA((PyArrayObject*)o_collections_b),
+                                        n_threads);
+                                        
+    Py_END_ALLOW_THREADS
+    
+    Py_DECREF(o_results);
+    
+    if (n_return) {
+        
+        Py_DECREF(o_collections_a);
+        Py_DECREF(o_collections_b);
+        
+        pywise_set_python_exception_from_pairwise_index_return_code(n_return);
+        
+        return NULL;
+    
+    }
+    
+    return Py_BuildValue("(NN)", o_collections_a, o_collections_b);
+
+}
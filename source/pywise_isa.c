@@ -0,0 +1,104 @@
+#include "pywise_isa.h"
+
+/*******************************************************************************
+
+    Symbol: pywise_set_isa
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.set_isa()
+    
+    Python Signature:
+    
+        pywise.set_isa(isa) -> None
+        
+    Description:
+    
+        Selects the instruction set architecture whose kernels all subsequent
+        pywise calculations will use. isa is one of the module constants
+        pywise.ISA_AUTO, pywise.ISA_SCALAR, pywise.ISA_SSE2, pywise.ISA_AVX2
+        or pywise.ISA_AVX512. pywise.ISA_AUTO restores the widest instruction
+        set supported by the host.
+        
+        On success returns None. On failure raises a Python exception.
+        
+    Further Information:
+    
+        This function is intended for A/B timing of kernels from Python. It
+        passes isa straight to libpairwise's pairwise_set_isa(), which checks
+        that the host supports the requested instruction set.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_set_isa
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+)
+{
+
+    char* keywords[2] = {"isa", NULL};
+    
+    int n_isa;
+    
+    int n_return;
+    
+    n_return = PyArg_ParseTupleAndKeywords(values, keys, "i:set_isa", keywords,
+                                           &n_isa);
+                                           
+    if (!n_return) {
+        
+        return NULL;
+    
+    }
+    
+    n_return = pairwise_set_isa(n_isa);
+    
+    if (!n_return) {
+        
+        Py_RETURN_NONE;
+    
+    }
+    
+    pywise_set_python_exception_from_pairwise_isa_return_code(n_return);
+    
+    return NULL;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_get_isa
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.get_isa()
+    
+    Python Signature:
+    
+        pywise.get_isa() -> int
+        
+    Description:
+    
+        Returns the module constant pywise.ISA_* identifying the instruction
+        set architecture whose kernels pywise calculations currently use.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_get_isa
+(
+
+    PyObject* self,
+    PyObject* values
+
+)
+{
+
+    return Py_BuildValue("i", pairwise_get_isa());
+
+}
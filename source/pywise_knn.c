@@ -0,0 +1,296 @@
+#include "pywise_knn.h"
+
+/*******************************************************************************
+
+    Symbol: pywise_knn
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.knn()
+    
+    Python Signature:
+    
+        pywise.knn(source, k, threads = 0, metric = "euclidean",
+                   dtype = None)
+            -> tuple
+            
+    Description:
+    
+        Finds the k nearest neighbours of every point, or of every collection
+        of points, in any-dimensional space. Binds libpairwise to carry out
+        every pairwise calculation over the requested number of threads, as
+        pywise.distances() and pywise.rmsds() do, but keeps only each row's k
+        nearest results, so that memory grows with N * k rather than with
+        N * N. If threads is zero, the default, chooses the number of threads
+        automatically.
+        
+        If metric is "euclidean", source is a two-dimensional set of points
+        and neighbours are those at the smallest Euclidean distances, as from
+        pywise.distances(). If metric is "rmsd", source is a three-
+        dimensional set of collections and neighbours are those at the
+        smallest RMSDs, as from pywise.rmsds(). k must be less than the
+        number of points or collections. dtype is as for pywise.distances().
+        
+        On success pywise_knn() returns a tuple of two NumPy arrays of shape
+        (N, k), (indices, values). Row i of indices holds the k neighbours of
+        point or collection i, nearest first, and row i of values holds their
+        results; neighbours with equal results are ordered by index. On
+        failure it raises a Python exception.
+        
+    Further Information:
+    
+        This function borrows or copies its source as pywise.distances() or
+        pywise.rmsds() would, and then passes it to libpairwise's
+        pairwise_distances_knn() or pairwise_rmsds_knn(), or their float
+        counterparts in single precision. Each libpairwise thread keeps a
+        bounded heap per row, and offers every result to the rows of both of
+        its operands, so the triangle of results is never stored.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_knn
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+)
+
+{
+
+    char* keywords[6] = {"source", "k", "threads", "metric", "dtype", NULL};
+    
+    size_t n_collections;
+    size_t n_points;
+    size_t n_coordinates;
+    
+    Py_ssize_t n_neighbours;
+    Py_ssize_t n_threads;
+    
+    PyObject* o_source;
+    PyObject* o_dtype;
+    
+    char* metric;
+    
+    int b_rmsd;
+    
+    void* a_collections;
+    void* a_results;
+    
+    size_t* a_indices;
+    
+    int n_type;
+    
+    size_t l_a_results;
+    
+    Py_buffer view;
+    
+    int n_return;
+    
+    n_threads = PYWISE_DEFAULT_THREADS;
+    
+    metric = "euclidean";
+    
+    o_dtype = NULL;
+    
+    /*
+    *   Attempt to parse arguments with keywords "source", "k", "threads",
+    *   "metric" and "dtype" as a Python object, two signed integers, a string
+    *   and a Python object, respectively. As for pywise_distances(), the
+    *   integers are parsed as signed so that negative values can be detected.
+    */
+    
+    n_return = PyArg_ParseTupleAndKeywords(values, keys, "On|nsO:knn",
+                                           keywords, &o_source, &n_neighbours,
+                                           &n_threads, &metric, &o_dtype);
+                                           
+    if (!n_return) {
+        
+        return NULL;
+    
+    }
+    
+    if (n_neighbours < 0) {
+        
+        PyErr_Format(PyExc_ValueError, "Argument k must not be negative.");
+        
+        return NULL;
+    
+    }
+    
+    if (n_threads < 0) {
+        
+        PyErr_Format(PyExc_ValueError, "Argument threads must be a positive "
+                     "integer, or zero to choose automatically.");
+                     
+        return NULL;
+    
+    }
+    
+    if (!strcmp(metric, "euclidean")) {
+        
+        b_rmsd = 0;
+    
+    } else if (!strcmp(metric, "rmsd")) {
+        
+        b_rmsd = 1;
+    
+    } else {
+        
+        PyErr_Format(PyExc_ValueError, "Argument metric must be either "
+                     "\"euclidean\" or \"rmsd\".");
+                     
+        return NULL;
+    
+    }
+    
+    n_type = pywise_resolve_type(o_source, o_dtype);
+    
+    if (n_type < 0) {
+        
+        return NULL;
+    
+    }
+    
+    /*
+    *   Build an input array of collections from the caller-supplied Python
+    *   object, o_source; for the Euclidean metric, of points, each of which
+    *   is treated by libpairwise as a collection of one point.
+    */
+    
+    if (b_rmsd) {
+        
+        a_collections = pywise_build_collections_array(o_source,
+                                                       n_type,
+                                                       &n_collections,
+                                                       &n_points,
+                                                       &n_coordinates,
+                                                       &view);
+    
+    } else {
+        
+        a_collections = pywise_build_points_array(o_source,
+                                                  n_type,
+                                                  &n_collections,
+                                                  &n_coordinates,
+                                                  &view);
+                                                  
+        n_points = 1;
+    
+    }
+    
+    if (!a_collections) {
+        
+        return NULL;
+    
+    }
+    
+    if (!n_threads) {
+        
+        n_threads = pairwise_threads_suggested(n_collections,
+                                               n_points,
+                                               n_coordinates);
+    
+    }
+    
+    /*
+    *   Allocate the (N, k) output arrays, whose ownership passes to the NumPy
+    *   arrays returned.
+    */
+    
+    l_a_results = n_collections * n_neighbours;
+    
+    a_indices = malloc((l_a_results ? l_a_results : 1) * sizeof(size_t));
+    a_results = malloc((l_a_results ? l_a_results : 1) *
+                       (n_type == NPY_FLOAT ? sizeof(float) : sizeof(double)));
+                       
+    if (!a_indices || !a_results) {
+        
+        free(a_indices);
+        free(a_results);
+        
+        pywise_release_array(a_collections, &view);
+        
+        PyErr_Format(PyExc_MemoryError, "Failed to allocate memory for "
+                     "output neighbour arrays of %zu elements each.",
+                     l_a_results);
+                     
+        return NULL;
+    
+    }
+    
+    /*
+    *   As in pywise_distances(), the calculation touches only C arrays and
+    *   calls no Python function, so release the GIL for its duration.
+    */
+    
+    Py_BEGIN_ALLOW_THREADS
+    
+    if (b_rmsd && n_type == NPY_FLOAT) {
+        
+        n_return = pairwise_rmsds_knn_float(n_collections,
+                                            n_points,
+                                            n_coordinates,
+                                            a_collections,
+                                            n_neighbours,
+                                            a_indices,
+                                            a_results,
+                                            n_threads);
+    
+    } else if (b_rmsd) {
+        
+        n_return = pairwise_rmsds_knn(n_collections,
+                                      n_points,
+                                      n_coordinates,
+                                      a_collections,
+                                      n_neighbours,
+                                      a_indices,
+                                      a_results,
+                                      n_threads);
+    
+    } else if (n_type == NPY_FLOAT) {
+        
+        n_return = pairwise_distances_knn_float(n_collections,
+                                                n_coordinates,
+                                                a_collections,
+                                                n_neighbours,
+                                                a_indices,
+                                                a_results,
+                                                n_threads);
+    
+    } else {
+        
+        n_return = pairwise_distances_knn(n_collections,
+                                          n_coordinates,
+                                          a_collections,
+                                          n_neighbours,
+                                          a_indices,
+                                          a_results,
+                                          n_threads);
+    
+    }
+    
+    Py_END_ALLOW_THREADS
+    
+    pywise_release_array(a_collections, &view);
+    
+    if (n_return) {
+        
+        free(a_indices);
+        free(a_results);
+        
+        pywise_set_python_exception_from_pairwise_calculations_return_code(n_return);
+        
+        return NULL;
+    
+    }
+    
+    return pywise_wrap_neighbours(n_collections,
+                                  n_neighbours,
+                                  a_indices,
+                                  a_results,
+                                  n_type);
+
+}
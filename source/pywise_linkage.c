@@ -0,0 +1,267 @@
+#include "pywise_linkage.h"
+
+/*******************************************************************************
+
+    Symbol: pywise_single_linkage
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.single_linkage()
+    
+    Python Signature:
+    
+        pywise.single_linkage(source, threads = 0, metric = "euclidean",
+                              dtype = None)
+            -> numpy.ndarray
+            
+    Description:
+    
+        Clusters a set of points, or of collections of points, by single
+        linkage, as scipy.cluster.hierarchy.linkage() would with method
+        "single" from the results of pywise.distances() or pywise.rmsds(),
+        but without ever storing those results, so that memory grows only
+        with the number of points. source, threads, metric and dtype are as
+        for pywise.knn().
+        
+        On success pywise_single_linkage() returns a two-dimensional NumPy
+        array of float64 of shape (N - 1, 4), the linkage matrix in SciPy's
+        form, or of shape (0, 4) if there are fewer than two points. On
+        failure it raises a Python exception.
+        
+    Further Information:
+    
+        libpairwise grows a minimum spanning tree by Prim's algorithm,
+        calculating each result when it is needed and then discarding it,
+        and turns the tree's edges into the linkage; see
+        _pairwise_launch_linkage(). The linkage is the same as SciPy's
+        whatever the number of threads. As for pywise_distances(), the
+        calculation touches only C arrays and calls no Python function, so
+        the GIL is released for its duration.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_single_linkage
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+)
+{
+
+    char* keywords[5] = {"source", "threads", "metric", "dtype", NULL};
+    
+    Py_ssize_t n_threads;
+    
+    PyObject* o_source;
+    PyObject* o_dtype;
+    PyObject* o_linkage;
+    
+    char* metric;
+    
+    size_t n_collections;
+    size_t n_points;
+    size_t n_coordinates;
+    
+    size_t n_merges;
+    
+    void* a_collections;
+    
+    double* a_linkage;
+    
+    int b_rmsd;
+    
+    int n_type;
+    
+    Py_buffer view;
+    
+    npy_intp npy_l_a_linkage[2];
+    
+    int n_return;
+    
+    n_threads = PYWISE_DEFAULT_THREADS;
+    
+    metric = "euclidean";
+    
+    o_dtype = NULL;
+    
+    n_return = PyArg_ParseTupleAndKeywords(values, keys, "O|nsO:single_linkage",
+                                           keywords, &o_source, &n_threads,
+                                           &metric, &o_dtype);
+                                           
+    if (!n_return) {
+        
+        return NULL;
+    
+    }
+    
+    if (n_threads < 0) {
+        
+        PyErr_Format(PyExc_ValueError, "Argument threads must be a positive "
+                     "integer, or zero to choose automatically.");
+                     
+        return NULL;
+    
+    }
+    
+    if (!strcmp(metric, "euclidean")) {
+        
+        b_rmsd = 0;
+    
+    } else if (!strcmp(metric, "rmsd")) {
+        
+        b_rmsd = 1;
+    
+    } else {
+        
+        PyErr_Format(PyExc_ValueError, "Argument metric must be either "
+                     "\"euclidean\" or \"rmsd\".");
+                     
+        return NULL;
+    
+    }
+    
+    n_type = pywise_resolve_type(o_source, o_dtype);
+    
+    if (n_type < 0) {
+        
+        return NULL;
+    
+    }
+    
+    /*
+    *   Build an input array of collections, or of points, from o_source, as
+    *   pywise_knn() does.
+    */
+    
+    if (b_rmsd) {
+        
+        a_collections = pywise_build_collections_array(o_source,
+                                                       n_type,
+                                                       &n_collections,
+                                                       &n_points,
+                                                       &n_coordinates,
+                                                       &view);
+    
+    } else {
+        
+        a_collections = pywise_build_points_array(o_source,
+                                                  n_type,
+                                                  &n_collections,
+                                                  &n_coordinates,
+                                                  &view);
+                                                  
+        n_points = 1;
+    
+    }
+    
+    if (!a_collections) {
+        
+        return NULL;
+    
+    }
+    
+    if (!n_threads) {
+        
+        n_threads = pairwise_threads_suggested(n_collections,
+                                               n_points,
+                                               n_coordinates);
+    
+    }
+    
+    /*
+    *   Allocate the (N - 1, 4) linkage, whose ownership passes to the NumPy
+    *   array returned.
+    */
+    
+    n_merges = n_collections > 1 ? n_collections - 1 : 0;
+    
+    a_linkage = malloc((n_merges ? n_merges : 1) * 4 * sizeof(double));
+    
+    if (!a_linkage) {
+        
+        pywise_release_array(a_collections, &view);
+        
+        PyErr_Format(PyExc_MemoryError, "Failed to allocate memory for "
+                     "output linkage array of %zu merges.", n_merges);
+                     
+        return NULL;
+    
+    }
+    
+    Py_BEGIN_ALLOW_THREADS
+    
+    if (b_rmsd && n_type == NPY_FLOAT) {
+        
+        n_return = pairwise_rmsds_linkage_float(n_collections,
+                                                n_points,
+                                                n_coordinates,
+                                                a_collections,
+                                                a_linkage,
+                                                n_threads);
+    
+    } else if (b_rmsd) {
+        
+        n_return = pairwise_rmsds_linkage(n_collections,
+                                          n_points,
+                                          n_coordinates,
+                                          a_collections,
+                                          a_linkage,
+                                          n_threads);
+    
+    } else if (n_type == NPY_FLOAT) {
+        
+        n_return = pairwise_distances_linkage_float(n_collections,
+                                                    n_coordinates,
+                                                    a_collections,
+                                                    a_linkage,
+                                                    n_threads);
+    
+    } else {
+        
+        n_return = pairwise_distances_linkage(n_collections,
+                                              n_coordinates,
+                                              a_collections,
+                                              a_linkage,
+                                              n_threads);
+    
+    }
+    
+    Py_END_ALLOW_THREADS
+    
+    pywise_release_array(a_collections, &view);
+    
+    if (n_return) {
+        
+        free(a_linkage);
+        
+        pywise_set_python_exception_from_pairwise_calculations_return_code(n_return);
+        
+        return NULL;
+    
+    }
+    
+    npy_l_a_linkage[0] = n_merges;
+    npy_l_a_linkage[1] = 4;
+    
+    o_linkage = PyArray_SimpleNewFromData(2, npy_l_a_linkage, NPY_DOUBLE, a_linkage);
+    
+    if (!o_linkage) {
+        
+        free(a_linkage);
+        
+        return NULL;
+    
+    }
+    
+    #if defined(NPY_ARRAY_OWNDATA)
+    PyArray_ENABLEFLAGS((PyArrayObject*)o_linkage, NPY_ARRAY_OWNDATA);
+    #else
+    PyArray_ENABLEFLAGS((PyArrayObject*)o_linkage, NPY_OWNDATA);
+    #endif
+    
+    return o_linkage;
+
+}
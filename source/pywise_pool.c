@@ -0,0 +1,278 @@
+#include "pywise_pool.h"
+
+/*******************************************************************************
+
+    Symbol: pywise_pool_resize
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.pool_resize()
+    
+    Python Signature:
+    
+        pywise.pool_resize(threads) -> None
+    
+    Description:
+    
+        Grows or shrinks libpairwise's pool of long-lived worker threads to
+        exactly the requested number of threads.
+        
+        On success returns None. On failure raises a Python exception.
+    
+    Further Information:
+    
+        pywise calculation functions asking for N threads run on the calling
+        thread plus N - 1 pool workers, and the pool grows on demand, so
+        calling this function is never required. It is useful to create the
+        workers ahead of time, or to release them after a burst of work.
+        
+        Shrinking the pool joins the workers removed, which may have to finish
+        work in hand first, so the GIL is released meanwhile.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_pool_resize
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+)
+{
+
+    char* keywords[2] = {"threads", NULL};
+    
+    Py_ssize_t n_threads;
+    
+    int n_return;
+    
+    /*
+    *   As for the threads argument of pywise.distances(), parse threads as a
+    *   signed integer so that negative values can be detected.
+    */
+    
+    n_return = PyArg_ParseTupleAndKeywords(values, keys, "n:pool_resize",
+                                           keywords, &n_threads);
+    
+    if (!n_return) {
+    
+        return NULL;
+    
+    }
+    
+    if (n_threads < 0) {
+    
+        PyErr_Format(PyExc_ValueError, "Argument threads must be a "
+                     "non-negative integer.");
+        
+        return NULL;
+    
+    }
+    
+    Py_BEGIN_ALLOW_THREADS
+    
+    n_return = pairwise_pool_resize(n_threads);
+    
+    Py_END_ALLOW_THREADS
+    
+    if (!n_return) {
+    
+        Py_RETURN_NONE;
+    
+    }
+    
+    pywise_set_python_exception_from_pairwise_calculations_return_code(n_return);
+    
+    return NULL;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_pool_size
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.pool_size()
+    
+    Python Signature:
+    
+        pywise.pool_size() -> int
+    
+    Description:
+    
+        Returns the number of worker threads currently in libpairwise's pool.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_pool_size
+(
+
+    PyObject* self,
+    PyObject* values
+
+)
+{
+
+    return Py_BuildValue("n", (Py_ssize_t)pairwise_pool_size());
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_pool_shutdown
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.pool_shutdown()
+    
+    Python Signature:
+    
+        pywise.pool_shutdown() -> None
+    
+    Description:
+    
+        Stops and joins every worker thread in libpairwise's pool.
+        
+        On success returns None. On failure raises a Python exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_pool_shutdown
+(
+
+    PyObject* self,
+    PyObject* values
+
+)
+{
+
+    int n_return;
+    
+    Py_BEGIN_ALLOW_THREADS
+    
+    n_return = pairwise_pool_shutdown();
+    
+    Py_END_ALLOW_THREADS
+    
+    if (!n_return) {
+    
+        Py_RETURN_NONE;
+    
+    }
+    
+    pywise_set_python_exception_from_pairwise_calculations_return_code(n_return);
+    
+    return NULL;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_pool_set_affinity
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.pool_set_affinity()
+    
+    Python Signature:
+    
+        pywise.pool_set_affinity(affinity) -> None
+        
+    Description:
+    
+        Selects how the workers of libpairwise's pool are placed on the CPUs
+        of the calling thread. affinity is one of the module constants
+        pywise.AFFINITY_NONE, pywise.AFFINITY_CORES or pywise.AFFINITY_NODES.
+        
+        On success returns None. On failure raises a Python exception.
+        
+    Further Information:
+    
+        Pinning workers to NUMA nodes matters on hosts with more than one,
+        where each thread then faults in, on its own node, the slice of the
+        results it fills. Pinning is applied to existing workers at once,
+        under the resize lock of the pool, so the GIL is released meanwhile.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_pool_set_affinity
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+)
+{
+
+    char* keywords[2] = {"affinity", NULL};
+    
+    int n_affinity;
+    
+    int n_return;
+    
+    n_return = PyArg_ParseTupleAndKeywords(values, keys, "i:pool_set_affinity",
+                                           keywords, &n_affinity);
+                                           
+    if (!n_return) {
+        
+        return NULL;
+    
+    }
+    
+    Py_BEGIN_ALLOW_THREADS
+    
+    n_return = pairwise_pool_set_affinity(n_affinity);
+    
+    Py_END_ALLOW_THREADS
+    
+    if (!n_return) {
+        
+        Py_RETURN_NONE;
+    
+    }
+    
+    pywise_set_python_exception_from_pairwise_calculations_return_code(n_return);
+    
+    return NULL;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_pool_get_affinity
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.pool_get_affinity()
+    
+    Python Signature:
+    
+        pywise.pool_get_affinity() -> int
+        
+    Description:
+    
+        Returns the pywise.AFFINITY_* constant last selected by
+        pywise.pool_set_affinity(), or pywise.AFFINITY_NONE by default.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_pool_get_affinity
+(
+
+    PyObject* self,
+    PyObject* values
+
+)
+{
+
+    return Py_BuildValue("i", pairwise_pool_get_affinity());
+
+}
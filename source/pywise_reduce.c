@@ -0,0 +1,682 @@
+#include "pywise_reduce.h"
+
+/*******************************************************************************
+
+    Symbol: pywise_reduce_source
+    
+    Type: Static function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Reduces every pairwise result across the Python object o_source, as
+        libpairwise's pairwise_distances_reduce() or pairwise_rmsds_reduce()
+        does, into a_statistics, a_counts, or a new array of row sums stored
+        in a_sums, each skipped if a null pointer. The number of points or
+        collections in o_source is stored in n_collections. n_threads, metric
+        and o_dtype are the caller's arguments, as for pywise_knn(); lower,
+        upper and n_bins are passed on with a_counts.
+        
+        On success returns zero, and the caller must free *a_sums if it was
+        asked for. On failure sets a Python exception and returns -1.
+        
+    Further Information:
+    
+        This function is shared by pywise_pair_stats(), pywise_histogram()
+        and pywise_row_sums(), which differ only in which reductions they ask
+        libpairwise for and in how they return them. As for
+        pywise_distances(), the calculation touches only C arrays and calls no
+        Python function, so the GIL is released for its duration.
+        
+*******************************************************************************/
+
+static int
+pywise_reduce_source
+(
+
+    PyObject* o_source,
+    
+    Py_ssize_t n_threads,
+    
+    char* metric,
+    
+    PyObject* o_dtype,
+    
+    double* a_statistics,
+    
+    double lower,
+    double upper,
+    size_t n_bins,
+    size_t* a_counts,
+    
+    double** a_sums,
+    
+    size_t* n_collections
+
+)
+{
+
+    size_t n_points;
+    size_t n_coordinates;
+    
+    void* a_collections;
+    
+    double* a_row_sums;
+    
+    int b_rmsd;
+    
+    int n_type;
+    
+    Py_buffer view;
+    
+    int n_return;
+    
+    if (n_threads < 0) {
+        
+        PyErr_Format(PyExc_ValueError, "Argument threads must be a positive "
+                     "integer, or zero to choose automatically.");
+                     
+        return -1;
+    
+    }
+    
+    if (!strcmp(metric, "euclidean")) {
+        
+        b_rmsd = 0;
+    
+    } else if (!strcmp(metric, "rmsd")) {
+        
+        b_rmsd = 1;
+    
+    } else {
+        
+        PyErr_Format(PyExc_ValueError, "Argument metric must be either "
+                     "\"euclidean\" or \"rmsd\".");
+                     
+        return -1;
+    
+    }
+    
+    n_type = pywise_resolve_type(o_source, o_dtype);
+    
+    if (n_type < 0) {
+        
+        return -1;
+    
+    }
+    
+    /*
+    *   Build an input array of collections, or of points, from o_source, as
+    *   pywise_knn() does.
+    */
+    
+    if (b_rmsd) {
+        
+        a_collections = pywise_build_collections_array(o_source,
+                                                       n_type,
+                                                       n_collections,
+                                                       &n_points,
+                                                       &n_coordinates,
+                                                       &view);
+    
+    } else {
+        
+        a_collections = pywise_build_points_array(o_source,
+                                                  n_type,
+                                                  n_collections,
+                                                  &n_coordinates,
+                                                  &view);
+                                                  
+        n_points = 1;
+    
+    }
+    
+    if (!a_collections) {
+        
+        return -1;
+    
+    }
+    
+    if (!n_threads) {
+        
+        n_threads = pairwise_threads_suggested(*n_collections,
+                                               n_points,
+                                               n_coordinates);
+    
+    }
+    
+    a_row_sums = NULL;
+    
+    if (a_sums) {
+        
+        a_row_sums = malloc((*n_collections ? *n_collections : 1) *
+                            sizeof(double));
+                            
+        if (!a_row_sums) {
+            
+            pywise_release_array(a_collections, &view);
+            
+            PyErr_Format(PyExc_MemoryError, "Failed to allocate memory for "
+                         "output row sums array of %zu elements.",
+                         *n_collections);
+                         
+            return -1;
+        
+        }
+    
+    }
+    
+    Py_BEGIN_ALLOW_THREADS
+    
+    if (b_rmsd && n_type == NPY_FLOAT) {
+        
+        n_return = pairwise_rmsds_reduce_float(*n_collections,
+                                               n_points,
+                                               n_coordinates,
+                                               a_collections,
+                                               a_statistics,
+                                               lower,
+                                               upper,
+                                               n_bins,
+                                               a_counts,
+                                               a_row_sums,
+                                               n_threads);
+    
+    } else if (b_rmsd) {
+        
+        n_return = pairwise_rmsds_reduce(*n_collections,
+                                         n_points,
+                                         n_coordinates,
+                                         a_collections,
+                                         a_statistics,
+                                         lower,
+                                         upper,
+                                         n_bins,
+                                         a_counts,
+                                         a_row_sums,
+                                         n_threads);
+    
+    } else if (n_type == NPY_FLOAT) {
+        
+        n_return = pairwise_distances_reduce_float(*n_collections,
+                                                   n_coordinates,
+                                                   a_collections,
+                                                   a_statistics,
+                                                   lower,
+                                                   upper,
+                                                   n_bins,
+                                                   a_counts,
+                                                   a_row_sums,
+                                                   n_threads);
+    
+    } else {
+        
+        n_return = pairwise_distances_reduce(*n_collections,
+                                             n_coordinates,
+                                             a_collections,
+                                             a_statistics,
+                                             lower,
+                                             upper,
+                                             n_bins,
+                                             a_counts,
+                                             a_row_sums,
+                                             n_threads);
+    
+    }
+    
+    Py_END_ALLOW_THREADS
+    
+    pywise_release_array(a_collections, &view);
+    
+    if (n_return) {
+        
+        free(a_row_sums);
+        
+        pywise_set_python_exception_from_pairwise_calculations_return_code(n_return);
+        
+        return -1;
+    
+    }
+    
+    if (a_sums) {
+        
+        *a_sums = a_row_sums;
+    
+    }
+    
+    return 0;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_pair_stats
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.pair_stats()
+    
+    Python Signature:
+    
+        pywise.pair_stats(source, threads = 0, metric = "euclidean",
+                          dtype = None)
+            -> tuple
+            
+    Description:
+    
+        Finds the minimum, maximum, mean and variance of every pairwise
+        result across a set of points, or of collections of points, without
+        storing the results. source, threads, metric and dtype are as for
+        pywise.knn(). The variance is that of the results themselves, as
+        numpy.var() gives by default.
+        
+        On success pywise_pair_stats() returns a tuple of four floats,
+        (minimum, maximum, mean, variance), all NaN if there are fewer than
+        two points. On failure it raises a Python exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_pair_stats
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+)
+{
+
+    char* keywords[5] = {"source", "threads", "metric", "dtype", NULL};
+    
+    Py_ssize_t n_threads;
+    
+    PyObject* o_source;
+    PyObject* o_dtype;
+    
+    char* metric;
+    
+    double a_statistics[4];
+    
+    size_t n_collections;
+    
+    int n_return;
+    
+    n_threads = PYWISE_DEFAULT_THREADS;
+    
+    metric = "euclidean";
+    
+    o_dtype = NULL;
+    
+    n_return = PyArg_ParseTupleAndKeywords(values, keys, "O|nsO:pair_stats",
+                                           keywords, &o_source, &n_threads,
+                                           &metric, &o_dtype);
+                                           
+    if (!n_return) {
+        
+        return NULL;
+    
+    }
+    
+    n_return = pywise_reduce_source(o_source,
+                                    n_threads,
+                                    metric,
+                                    o_dtype,
+                                    a_statistics,
+                                    0,
+                                    0,
+                                    0,
+                                    NULL,
+                                    NULL,
+                                    &n_collections);
+                                    
+    if (n_return) {
+        
+        return NULL;
+    
+    }
+    
+    return Py_BuildValue("(dddd)",
+                         a_statistics[0],
+                         a_statistics[1],
+                         a_statistics[2],
+                         a_statistics[3]);
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_histogram
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.histogram()
+    
+    Python Signature:
+    
+        pywise.histogram(source, bins = 10, range = None, threads = 0,
+                         metric = "euclidean", dtype = None)
+            -> tuple
+            
+    Description:
+    
+        Counts the pairwise results across a set of points, or of
+        collections of points, in each of bins equal bins, without storing
+        the results, as numpy.histogram() would count them. range is a pair
+        of floats (lower, upper) bounding the bins; results outside it are
+        not counted. If range is None, it is the range of the results, found
+        first by pywise.pair_stats(), at the cost of calculating every result
+        twice. source, threads, metric and dtype are as for pywise.knn().
+        
+        On success pywise_histogram() returns a tuple of two NumPy arrays,
+        (counts, edges), of bins counts and bins + 1 bin edges. On failure it
+        raises a Python exception.
+        
+    Further Information:
+    
+        The counts are stored by libpairwise straight into the NumPy array
+        returned, since an npy_intp is the size of a size_t. As
+        numpy.histogram() does, a range of results which is empty is widened
+        by a half either side, and one with no results at all is taken to be
+        from zero to one.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_histogram
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+)
+{
+
+    char* keywords[7] = {"source", "bins", "range", "threads", "metric",
+                         "dtype", NULL};
+                         
+    Py_ssize_t n_bins;
+    Py_ssize_t n_threads;
+    
+    PyObject* o_source;
+    PyObject* o_range;
+    PyObject* o_dtype;
+    PyObject* o_counts;
+    PyObject* o_edges;
+    
+    char* metric;
+    
+    double a_statistics[4];
+    
+    double* a_edges;
+    
+    double lower;
+    double upper;
+    
+    size_t n_collections;
+    
+    npy_intp npy_l_array[1];
+    
+    Py_ssize_t i_edge;
+    
+    int n_return;
+    
+    n_bins = 10;
+    n_threads = PYWISE_DEFAULT_THREADS;
+    
+    metric = "euclidean";
+    
+    o_range = NULL;
+    o_dtype = NULL;
+    
+    n_return = PyArg_ParseTupleAndKeywords(values, keys, "O|nOnsO:histogram",
+                                           keywords, &o_source, &n_bins,
+                                           &o_range, &n_threads, &metric,
+                                           &o_dtype);
+                                           
+    if (!n_return) {
+        
+        return NULL;
+    
+    }
+    
+    if (n_bins < 1) {
+        
+        PyErr_Format(PyExc_ValueError, "Argument bins must be a positive "
+                     "integer.");
+                     
+        return NULL;
+    
+    }
+    
+    /*
+    *   Take the bounds of the bins from range if given, or otherwise from a
+    *   first pass over the results.
+    */
+    
+    if (o_range && o_range != Py_None) {
+        
+        o_range = PySequence_Tuple(o_range);
+        
+        n_return = o_range && PyArg_ParseTuple(o_range, "dd", &lower, &upper);
+        
+        Py_XDECREF(o_range);
+        
+        if (!n_return || !(lower < upper)) {
+            
+            PyErr_Clear();
+            
+            PyErr_Format(PyExc_ValueError, "Argument range must be a pair of "
+                         "floats, the first less than the second.");
+                         
+            return NULL;
+        
+        }
+    
+    } else {
+        
+        n_return = pywise_reduce_source(o_source,
+                                        n_threads,
+                                        metric,
+                                        o_dtype,
+                                        a_statistics,
+                                        0,
+                                        0,
+                                        0,
+                                        NULL,
+                                        NULL,
+                                        &n_collections);
+                                        
+        if (n_return) {
+            
+            return NULL;
+        
+        }
+        
+        lower = n_collections > 1 ? a_statistics[0] : 0;
+        upper = n_collections > 1 ? a_statistics[1] : 1;
+        
+        if (lower == upper) {
+            
+            lower -= 0.5;
+            upper += 0.5;
+        
+        }
+    
+    }
+    
+    npy_l_array[0] = n_bins;
+    
+    o_counts = PyArray_SimpleNew(1, npy_l_array, NPY_INTP);
+    
+    npy_l_array[0] = n_bins + 1;
+    
+    o_edges = PyArray_SimpleNew(1, npy_l_array, NPY_DOUBLE);
+    
+    if (!o_counts || !o_edges) {
+        
+        Py_XDECREF(o_counts);
+        Py_XDECREF(o_edges);
+        
+        return NULL;
+    
+    }
+    
+    n_return = pywise_reduce_source(o_source,
+                                    n_threads,
+                                    metric,
+                                    o_dtype,
+                                    NULL,
+                                    lower,
+                                    upper,
+                                    n_bins,
+                                    PyArray_DATA((PyArrayObject*)o_counts),
+                                    NULL,
+                                    &n_collections);
+                                    
+    if (n_return) {
+        
+        Py_DECREF(o_counts);
+        Py_DECREF(o_edges);
+        
+        return NULL;
+    
+    }
+    
+    /*
+    *   Place the last edge at exactly upper, which the others may fall
+    *   short of by rounding.
+    */
+    
+    a_edges = PyArray_DATA((PyArrayObject*)o_edges);
+    
+    for (i_edge = 0; i_edge < n_bins; i_edge ++) {
+        
+        *(a_edges + i_edge) = lower + (i_edge * ((upper - lower) / n_bins));
+    
+    }
+    
+    *(a_edges + n_bins) = upper;
+    
+    return Py_BuildValue("(NN)", o_counts, o_edges);
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_row_sums
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.row_sums()
+    
+    Python Signature:
+    
+        pywise.row_sums(source, threads = 0, metric = "euclidean",
+                        dtype = None)
+            -> numpy.ndarray
+            
+    Description:
+    
+        Sums for each point, or collection of points, its pairwise results
+        with every other, without storing the results, as the row sums of
+        the full symmetric matrix of results would give. The point with the
+        least sum is the medoid. source, threads, metric and dtype are as for
+        pywise.knn().
+        
+        On success pywise_row_sums() returns a one-dimensional NumPy array of
+        float64 with one element per point. On failure it raises a Python
+        exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_row_sums
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+)
+{
+
+    char* keywords[5] = {"source", "threads", "metric", "dtype", NULL};
+    
+    Py_ssize_t n_threads;
+    
+    PyObject* o_source;
+    PyObject* o_dtype;
+    PyObject* o_sums;
+    
+    char* metric;
+    
+    double* a_sums;
+    
+    size_t n_collections;
+    
+    npy_intp npy_l_a_sums[1];
+    
+    int n_return;
+    
+    n_threads = PYWISE_DEFAULT_THREADS;
+    
+    metric = "euclidean";
+    
+    o_dtype = NULL;
+    
+    n_return = PyArg_ParseTupleAndKeywords(values, keys, "O|nsO:row_sums",
+                                           keywords, &o_source, &n_threads,
+                                           &metric, &o_dtype);
+                                           
+    if (!n_return) {
+        
+        return NULL;
+    
+    }
+    
+    n_return = pywise_reduce_source(o_source,
+                                    n_threads,
+                                    metric,
+                                    o_dtype,
+                                    NULL,
+                                    0,
+                                    0,
+                                    0,
+                                    NULL,
+                                    &a_sums,
+                                    &n_collections);
+                                    
+    if (n_return) {
+        
+        return NULL;
+    
+    }
+    
+    /*
+    *   Wrap a_sums in a NumPy array, which takes ownership of it.
+    */
+    
+    npy_l_a_sums[0] = n_collections;
+    
+    o_sums = PyArray_SimpleNewFromData(1, npy_l_a_sums, NPY_DOUBLE, a_sums);
+    
+    if (!o_sums) {
+        
+        free(a_sums);
+        
+        return NULL;
+    
+    }
+    
+    #if defined(NPY_ARRAY_OWNDATA)
+    PyArray_ENABLEFLAGS((PyArrayObject*)o_sums, NPY_ARRAY_OWNDATA);
+    #else
+    PyArray_ENABLEFLAGS((PyArrayObject*)o_sums, NPY_OWNDATA);
+    #endif
+    
+    return o_sums;
+
+}
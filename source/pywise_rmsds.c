@@ -10,14 +10,45 @@
     
     Python Signature:
     
-        pywise.rmsds(collections, threads) -> numpy.ndarray
+        pywise.rmsds(collections, threads = 0, out = None, dtype = None,
+                     cutoff = None, superpose = False, file = None)
+            -> numpy.ndarray or tuple
     
     Description:
     
         Calculates all pairwise RMSDs across a set of collections of points in
         any-dimensional space. Binds libpairwise to fairly distribute the total
         number of pairwise calculations to be done over the requested number of
-        threads which are launched in parallel.
+        threads which are launched in parallel. If threads is zero, the
+        default, chooses the number of threads automatically.
+        
+        If dtype is float32, or if dtype is None and collections is a NumPy
+        array of float32, carries out the calculations in single precision and
+        returns an array of float32; otherwise in double precision, returning
+        an array of float64.
+        
+        If out is given, stores the results in it rather than in a new array,
+        and returns it. out must then be a writable, C-contiguous, one-
+        dimensional array of the results' dtype with exactly one element per
+        pair, which shares no memory with collections.
+        
+        If cutoff is given, keeps only the results no greater than cutoff, and
+        returns them in compressed sparse row (CSR) form as a tuple of three
+        one-dimensional NumPy arrays, (indptr, indices, values). For each
+        collection i, indices[indptr[i]:indptr[i + 1]] holds in increasing
+        order every collection j > i whose result with i is within cutoff, and
+        the same elements of values hold those results. out may not then be
+        given.
+        
+        If superpose is true, each RMSD is taken after optimally superposing
+        its pair of collections by translation and rotation, which requires
+        points in three-dimensional space. cutoff may not then be given.
+        
+        If file is given, creates a libpairwise results file at that path, and
+        stores the results straight into it through a memory map rather than
+        in memory, returning them as a numpy.memmap of the file opened with
+        mode "r+", as pywise.load() would. Neither out nor cutoff may then be
+        given.
         
         On success pywise_rmsds() returns a one-dimensional NumPy array object
         which contains the results of all pairwise calculations. On failure it
@@ -28,12 +59,13 @@
         This function receives a Python object which contains a three
         dimensional sequence of sequences of sequences of numbers (representing
         a set of collections of points in any-dimensional space) and passes it
-        pywise_build_collections_array() which copies its contents into an
-        input array of form appropriate for passing to libpairwise's
-        pairwise_rmsds(). Thereafter this function passes that input array to
-        pairwise_rmsds(), and then returns the resulting output array which
-        contains the calculated pairwise RMSDs in the form of a NumPy array
-        object.
+        pywise_build_collections_array() which borrows or copies its contents
+        as an input array of form appropriate for passing to libpairwise's
+        pairwise_rmsds(), or to pairwise_rmsds_float() in single precision.
+        Thereafter this function passes that input array to the libpairwise
+        function, and then returns the resulting output array which contains
+        the calculated pairwise RMSDs in the form of a NumPy array object.
+        Each phase of a call which succeeds is timed for pywise.last_stats().
         
 *******************************************************************************/
 
@@ -48,7 +80,8 @@ pywise_rmsds
 )
 {
 
-    char* keywords[3] = {"collections", "threads", NULL};
+    char* keywords[8] = {"collections", "threads", "out", "dtype", "cutoff",
+                         "superpose", "file", NULL};
     
     size_t n_collections;
     size_t n_points;
@@ -58,16 +91,38 @@ pywise_rmsds
     
     PyObject* o_collections;
     PyObject* o_rmsds;
+    PyObject* o_out;
+    PyObject* o_dtype;
+    PyObject* o_cutoff;
+    PyObject* o_superpose;
+    
+    char* path;
+    
+    void* a_collections;
+    void* a_rmsds;
+    
+    int n_type;
+    
+    int b_superpose;
     
-    double* a_collections;
-    double* a_rmsds;
+    double cutoff;
+    
+    size_t* a_indptr;
+    size_t* a_indices;
     
     size_t l_a_rmsds;
     size_t s_a_rmsds;
+    size_t s_a_collections;
     
     npy_intp npy_l_a_rmsds[1];
     
+    Py_buffer view;
+    Py_buffer view_out;
+    
     int n_return;
+    int n_return_file;
+    
+    pywise_stats_t stats;
     
     /*
     *   Set the default number of threads to use if the user doesn't supply
@@ -76,17 +131,29 @@ pywise_rmsds
     
     n_threads = PYWISE_DEFAULT_THREADS;
     
+    o_out = NULL;
+    o_dtype = NULL;
+    o_cutoff = NULL;
+    o_superpose = NULL;
+    
+    path = NULL;
+    
+    cutoff = 0;
+    
     /*
-    *   Attempt to parse aruguments with keywords "collections" and "threads"
-    *   as a Python object and a signed integer, respectively. Even though the
-    *   number of threads should only ever be positive, overflow checking is
-    *   not done when parsing unsigned integers, so an incorrectly specified
-    *   negative number parsed in that way would be impossible to detect. Raise
-    *   a Python exception if parsing fails. 
+    *   Attempt to parse aruguments with keywords "collections", "threads",
+    *   "out", "dtype", "cutoff", "superpose" and "file" as a Python object, a
+    *   signed integer, four Python objects and a path or None, respectively.
+    *   Even though the number of threads should only ever be positive,
+    *   overflow checking is not done when parsing unsigned integers, so an
+    *   incorrectly specified negative number parsed in that way would be
+    *   impossible to detect. Raise a Python exception if parsing fails.
     */
     
-    n_return = PyArg_ParseTupleAndKeywords(values, keys, "O|n:rmsds", keywords,
-                                           &o_collections, &n_threads);
+    n_return = PyArg_ParseTupleAndKeywords(values, keys, "O|nOOOOz:rmsds",
+                                           keywords, &o_collections, &n_threads,
+                                           &o_out, &o_dtype, &o_cutoff,
+                                           &o_superpose, &path);
     
     if (!n_return) {
         
@@ -95,28 +162,102 @@ pywise_rmsds
     }
     
     /*
-    *   Ensure that the requested number of threads is greater-than-zero.
+    *   Ensure that the requested number of threads is not negative. Zero
+    *   requests that the number of threads be chosen automatically, once the
+    *   size of the input is known.
     */
     
     if (n_threads < 0) {
     
         PyErr_Format(PyExc_ValueError, "Argument threads must be a positive "
-                     "integer.");
+                     "integer, or zero to choose automatically.");
         
         return NULL;
     
     }
     
     /*
-    *   Future versions of pywise could dynamically detect the number of
-    *   processor cores made available host, and then use that many threads
-    *   given the special value of zero for the threads argument.
+    *   Convert the cutoff, if there is one, to a double, raising a Python
+    *   exception if that fails or if out is also given.
     */
     
-    if (!n_threads) {
+    if (o_cutoff == Py_None) {
+        
+        o_cutoff = NULL;
+    
+    }
+    
+    /*
+    *   Decide whether to superpose each pair of collections, raising a Python
+    *   exception if superpose has no truth value or if cutoff is also given.
+    */
+    
+    b_superpose = o_superpose ? PyObject_IsTrue(o_superpose) : 0;
+    
+    if (b_superpose < 0) {
+        
+        return NULL;
+    
+    }
+    
+    if (b_superpose && o_cutoff) {
+        
+        PyErr_Format(PyExc_ValueError, "Arguments superpose and cutoff cannot "
+                     "be given together.");
+                     
+        return NULL;
+    
+    }
+    
+    if (o_cutoff) {
+        
+        if (o_out && o_out != Py_None) {
+            
+            PyErr_Format(PyExc_ValueError, "Arguments out and cutoff cannot "
+                         "be given together.");
+                         
+            return NULL;
+        
+        }
+        
+        cutoff = PyFloat_AsDouble(o_cutoff);
+        
+        if (cutoff == -1.0 && PyErr_Occurred()) {
+            
+            return NULL;
+        
+        }
+    
+    }
+    
+    /*
+    *   A results file is written in full, so it can take neither an array of
+    *   the caller's nor a cutoff.
+    */
+    
+    if (path && ((o_out && o_out != Py_None) || o_cutoff)) {
+        
+        PyErr_Format(PyExc_ValueError, "Argument file cannot be given "
+                     "together with out or cutoff.");
+                     
+        return NULL;
+    
+    }
+    
+    /*
+    *   Time each phase of the call from here on, for pywise.last_stats().
+    */
+    
+    pywise_stats_begin(&stats, "rmsds");
+    
+    /*
+    *   Decide whether to calculate in single or double precision, raising a
+    *   Python exception if dtype is neither float32 nor float64.
+    */
     
-        PyErr_Format(PyExc_NotImplementedError, "Detection of number of "
-                     "processors provided by host not yet implemented.");
+    n_type = pywise_resolve_type(o_collections, o_dtype);
+    
+    if (n_type < 0) {
         
         return NULL;
     
@@ -130,9 +271,11 @@ pywise_rmsds
     */
     
     a_collections = pywise_build_collections_array(o_collections,
+                                                   n_type,
                                                    &n_collections,
                                                    &n_points,
-                                                   &n_coordinates);
+                                                   &n_coordinates,
+                                                   &view);
     
     if (!a_collections) {
     
@@ -140,6 +283,81 @@ pywise_rmsds
     
     }
     
+    pywise_stats_mark(&stats, &stats.convert_seconds);
+    
+    /*
+    *   If asked to, choose as many threads as the processors available to
+    *   this process (allowing for its CPU affinity and any control group
+    *   quota), but fewer if there are too few collections to keep them all
+    *   busy.
+    */
+    
+    if (!n_threads) {
+        
+        n_threads = pairwise_threads_suggested(n_collections,
+                                               n_points,
+                                               n_coordinates);
+    
+    }
+    
+    /*
+    *   If given a cutoff, keep only the RMSDs within it, and return them as CSR
+    *   arrays rather than as one condensed array. As below, the calculation
+    *   needs no Python function, so the GIL is released.
+    */
+    
+    if (o_cutoff) {
+        
+        Py_BEGIN_ALLOW_THREADS
+        
+        if (n_type == NPY_FLOAT) {
+            
+            n_return = pairwise_rmsds_cutoff_float(n_collections,
+                                                   n_points,
+                                                   n_coordinates,
+                                                   a_collections,
+                                                   (float)cutoff,
+                                                   &a_indptr,
+                                                   &a_indices,
+                                                   (float**)&a_rmsds,
+                                                   n_threads);
+        
+        } else {
+            
+            n_return = pairwise_rmsds_cutoff(n_collections,
+                                             n_points,
+                                             n_coordinates,
+                                             a_collections,
+                                             cutoff,
+                                             &a_indptr,
+                                             &a_indices,
+                                             (double**)&a_rmsds,
+                                             n_threads);
+        
+        }
+        
+        Py_END_ALLOW_THREADS
+        
+        pywise_stats_mark(&stats, &stats.calculate_seconds);
+        
+        pywise_release_array(a_collections, &view);
+        
+        if (n_return) {
+            
+            pywise_set_python_exception_from_pairwise_calculations_return_code(n_return);
+            
+            return NULL;
+        
+        }
+        
+        return pywise_stats_commit(&stats, pywise_wrap_csr(n_collections,
+                                                           a_indptr,
+                                                           a_indices,
+                                                           a_rmsds,
+                                                           n_type));
+    
+    }
+    
     /*
     *   Knowing now how many collections across which we must calculate
     *   pairwise RMSDs, allocate memory for the output distances array,
@@ -148,35 +366,180 @@ pywise_rmsds
     
     l_a_rmsds = 0.5 * n_collections * (n_collections - 1);
     
-    s_a_rmsds = l_a_rmsds * sizeof(double);
+    s_a_rmsds = l_a_rmsds * (n_type == NPY_FLOAT ? sizeof(float) :
+                                                   sizeof(double));
     
-    a_rmsds = malloc(s_a_rmsds);
+    s_a_collections = n_collections * n_points * n_coordinates *
+                      (n_type == NPY_FLOAT ? sizeof(float) : sizeof(double));
     
-    if (!a_rmsds) {
+    /*
+    *   Store the results in the caller-supplied array o_out if there is one,
+    *   having checked its size, dtype, contiguity and writability; or in a
+    *   new results file mapped into memory if asked for one; otherwise in a
+    *   newly allocated array.
+    */
     
-        PyErr_Format(PyExc_MemoryError, "Failed to allocate memory for output "
-                     "RMSDs array; needed %zu bytes.", s_a_rmsds);
+    view_out.buf = NULL;
+    view_out.obj = NULL;
+    
+    if (o_out == Py_None) {
+        
+        o_out = NULL;
+    
+    }
+    
+    if (o_out) {
+        
+        a_rmsds = pywise_borrow_output(o_out, n_type, l_a_rmsds,
+                                       a_collections, s_a_collections,
+                                       &view_out);
+    
+    } else if (path) {
+        
+        n_return = pairwise_file_create(path,
+                                        n_collections,
+                                        n_type == NPY_FLOAT ? sizeof(float) :
+                                                              sizeof(double),
+                                        b_superpose ? "rmsd_superposed" : "rmsd",
+                                        &a_rmsds);
+                                        
+        if (n_return) {
+            
+            a_rmsds = NULL;
+            
+            pywise_set_python_exception_from_pairwise_calculations_return_code(n_return);
+        
+        }
+    
+    } else {
+        
+        a_rmsds = malloc(s_a_rmsds);
+        
+        if (!a_rmsds) {
+            
+            PyErr_Format(PyExc_MemoryError, "Failed to allocate memory for "
+                         "output RMSDs array; needed %zu bytes.", s_a_rmsds);
+        
+        }
+    
+    }
+    
+    if (!a_rmsds) {
         
-        free(a_collections);
+        pywise_release_array(a_collections, &view);
         
         return NULL;
     
     }
     
+    pywise_stats_mark(&stats, &stats.allocate_seconds);
+    
     /*
     *   Calculate pairwise RMSDs across all collections in a_collections,
     *   distributing the calculations to be carried out over n_threads parallel
     *   threads, and store the calculated distances in a_rmsds.
+    *   
+    *   pairwise_rmsds() touches only the C arrays a_collections and a_rmsds,
+    *   and calls no Python function, so release the GIL for its duration.
+    *   (Either array may belong to a caller's Python object, but buffer views
+    *   keep both alive and unresized meanwhile.) Other Python threads then
+    *   stay responsive, and may run their own pywise calculations
+    *   concurrently. The same goes for pairwise_rmsds_float() and for the
+    *   superposed RMSD functions.
     */
     
-    n_return = pairwise_rmsds(n_collections,
-                              n_points,
-                              n_coordinates,
-                              a_collections,
-                              a_rmsds,
-                              n_threads);
+    Py_BEGIN_ALLOW_THREADS
+    
+    if (b_superpose && n_type == NPY_FLOAT) {
+        
+        n_return = pairwise_rmsds_superposed_float(n_collections,
+                                                   n_points,
+                                                   n_coordinates,
+                                                   a_collections,
+                                                   a_rmsds,
+                                                   n_threads);
+    
+    } else if (b_superpose) {
+        
+        n_return = pairwise_rmsds_superposed(n_collections,
+                                             n_points,
+                                             n_coordinates,
+                                             a_collections,
+                                             a_rmsds,
+                                             n_threads);
+    
+    } else if (n_type == NPY_FLOAT) {
+        
+        n_return = pairwise_rmsds_float(n_collections,
+                                        n_points,
+                                        n_coordinates,
+                                        a_collections,
+                                        a_rmsds,
+                                        n_threads);
+    
+    } else {
+        
+        n_return = pairwise_rmsds(n_collections,
+                                  n_points,
+                                  n_coordinates,
+                                  a_collections,
+                                  a_rmsds,
+                                  n_threads);
+    
+    }
+    
+    Py_END_ALLOW_THREADS
+    
+    pywise_stats_mark(&stats, &stats.calculate_seconds);
+    
+    pywise_release_array(a_collections, &view);
+    
+    if (path) {
+        
+        /*
+        *   Write back and unmap the results file whether or not
+        *   pairwise_rmsds() succeeded. If it did, open the file afresh as a
+        *   numpy.memmap, which maps only the pages read; otherwise remove the
+        *   incomplete file.
+        */
+        
+        n_return_file = pairwise_file_close(a_rmsds);
+        
+        if (!n_return) {
+            
+            n_return = n_return_file;
+        
+        }
+        
+        if (!n_return) {
+            
+            return pywise_stats_commit(&stats, pywise_open_file(path, "r+"));
+        
+        }
+        
+        pywise_set_python_exception_from_pairwise_calculations_return_code(n_return);
+        
+        remove(path);
+        
+        return NULL;
+    
+    }
     
-    free(a_collections);
+    if (!n_return && o_out) {
+        
+        /*
+        *   If pairwise_rmsds() succeeded in filling the caller-supplied
+        *   array o_out, release o_out and then return it, as NumPy functions
+        *   do with their out arguments.
+        */
+        
+        pywise_release_array(a_rmsds, &view_out);
+        
+        Py_INCREF(o_out);
+        
+        return pywise_stats_commit(&stats, o_out);
+    
+    }
     
     if (!n_return) {
         
@@ -190,7 +553,7 @@ pywise_rmsds
         
         o_rmsds = PyArray_SimpleNewFromData(1,
                                             npy_l_a_rmsds,
-                                            NPY_DOUBLE,
+                                            n_type,
                                             a_rmsds);
         
         #if defined(NPY_ARRAY_OWNDATA)
@@ -199,17 +562,17 @@ pywise_rmsds
         PyArray_ENABLEFLAGS((PyArrayObject*)o_rmsds, NPY_OWNDATA);
         #endif
         
-        return o_rmsds;
+        return pywise_stats_commit(&stats, o_rmsds);
     
     }
     
     /*
-    *   Otherwise if pairwise_rmsds() failed, free the memory pointed to by
-    *   a_rmsds, and then raise a Python exception appropriate to the
+    *   Otherwise if pairwise_rmsds() failed, release the memory pointed
+    *   to by a_rmsds, and then raise a Python exception appropriate to the
     *   libpairwise return code from pairwise_rmsds().
     */
     
-    free(a_rmsds);
+    pywise_release_array(a_rmsds, &view_out);
     
     pywise_set_python_exception_from_pairwise_calculations_return_code(n_return);
     
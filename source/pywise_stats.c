@@ -0,0 +1,424 @@
+#include "pywise_stats.h"
+
+#include <time.h>
+
+/*******************************************************************************
+
+    Symbol: pywise_stats_last_call, pywise_stats_last_calculation,
+            pywise_stats_a_thread_seconds, pywise_stats_a_thread_pairs,
+            pywise_stats_n_capacity, pywise_stats_b_recorded
+            
+    Type: Static variables
+    
+    Intent: Private
+    
+    Description:
+    
+        The statistics returned by pywise.last_stats(): the timings of the
+        last call to succeed, pywise_stats_last_call, and those libpairwise
+        recorded for its calculation, pywise_stats_last_calculation, whose
+        per-thread arrays are copied into pywise_stats_a_thread_seconds and
+        pywise_stats_a_thread_pairs, each with room for
+        pywise_stats_n_capacity elements. pywise_stats_b_recorded is set
+        once any call has been recorded. All are read and written only with
+        the GIL held.
+        
+*******************************************************************************/
+
+static pywise_stats_t
+pywise_stats_last_call;
+
+static pairwise_stats_t
+pywise_stats_last_calculation;
+
+static double*
+pywise_stats_a_thread_seconds;
+
+static size_t*
+pywise_stats_a_thread_pairs;
+
+static size_t
+pywise_stats_n_capacity;
+
+static int
+pywise_stats_b_recorded;
+
+/*******************************************************************************
+
+    Symbol: pywise_stats_clock
+    
+    Type: Static function returning double
+    
+    Intent: Private
+    
+    Description:
+    
+        Returns the time, in seconds, of the monotonic clock. Only
+        differences between its values are meaningful.
+        
+*******************************************************************************/
+
+static double
+pywise_stats_clock
+(void)
+{
+
+    struct timespec now;
+    
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    
+    return now.tv_sec + (now.tv_nsec * 1e-9);
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_stats_begin
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Starts timing a call to the pywise method name in stats, with every
+        phase at zero and the first beginning now.
+        
+        Returns nothing, and will not fail.
+        
+*******************************************************************************/
+
+void
+pywise_stats_begin
+(
+
+    pywise_stats_t* stats,
+    
+    const char* name
+
+)
+{
+
+    stats->name = name;
+    
+    stats->convert_seconds = 0;
+    stats->allocate_seconds = 0;
+    stats->calculate_seconds = 0;
+    stats->wrap_seconds = 0;
+    
+    stats->t_mark = pywise_stats_clock();
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_stats_mark
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        Ends the phase of stats being timed, adding the seconds it took to
+        phase_seconds, one of the members of stats, and begins the next. Needs
+        no GIL.
+        
+        Returns nothing, and will not fail.
+        
+*******************************************************************************/
+
+void
+pywise_stats_mark
+(
+
+    pywise_stats_t* stats,
+    
+    double* phase_seconds
+
+)
+{
+
+    double t_now;
+    
+    t_now = pywise_stats_clock();
+    
+    *phase_seconds += t_now - stats->t_mark;
+    
+    stats->t_mark = t_now;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_stats_commit
+    
+    Type: Function returning PyObject*
+    
+    Intent: Private
+    
+    Description:
+    
+        Ends the last phase of stats, that of wrapping the result, and unless
+        o_result is a null pointer records stats, together with the
+        statistics libpairwise recorded for the calculation on this thread,
+        as those to be returned by pywise.last_stats(). Must be called on the
+        thread which carried out the calculation, holding the GIL.
+        
+        Returns o_result, so that a method may end with
+        return pywise_stats_commit(&stats, o_result).
+        
+    Further Information:
+    
+        libpairwise keeps the statistics of each thread's last calculation
+        only until its next, so the per-thread arrays are copied. Should the
+        copy fail for want of memory, the call is recorded without them, as
+        if no thread had taken part.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_stats_commit
+(
+
+    pywise_stats_t* stats,
+    
+    PyObject* o_result
+
+)
+{
+
+    pairwise_stats_t calculation;
+    
+    double* a_thread_seconds;
+    size_t* a_thread_pairs;
+    
+    size_t n_threads;
+    
+    pywise_stats_mark(stats, &stats->wrap_seconds);
+    
+    if (!o_result) {
+        
+        return NULL;
+    
+    }
+    
+    pairwise_stats_last(&calculation);
+    
+    n_threads = calculation.n_threads;
+    
+    if (n_threads > pywise_stats_n_capacity) {
+        
+        a_thread_seconds = realloc(pywise_stats_a_thread_seconds,
+                                   n_threads * sizeof(double));
+                                   
+        if (a_thread_seconds) {
+            
+            pywise_stats_a_thread_seconds = a_thread_seconds;
+        
+        }
+        
+        a_thread_pairs = realloc(pywise_stats_a_thread_pairs,
+                                 n_threads * sizeof(size_t));
+                                 
+        if (a_thread_pairs) {
+            
+            pywise_stats_a_thread_pairs = a_thread_pairs;
+        
+        }
+        
+        if (a_thread_seconds && a_thread_pairs) {
+            
+            pywise_stats_n_capacity = n_threads;
+        
+        } else {
+            
+            n_threads = 0;
+        
+        }
+    
+    }
+    
+    if (n_threads) {
+        
+        memcpy(pywise_stats_a_thread_seconds,
+               calculation.a_thread_seconds,
+               n_threads * sizeof(double));
+               
+        memcpy(pywise_stats_a_thread_pairs,
+               calculation.a_thread_pairs,
+               n_threads * sizeof(size_t));
+    
+    }
+    
+    calculation.n_threads = n_threads;
+    
+    calculation.a_thread_seconds = NULL;
+    calculation.a_thread_pairs = NULL;
+    
+    pywise_stats_last_call = *stats;
+    pywise_stats_last_calculation = calculation;
+    
+    pywise_stats_b_recorded = 1;
+    
+    return o_result;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_last_stats
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.last_stats()
+    
+    Python Signature:
+    
+        pywise.last_stats() -> dict or None
+        
+    Description:
+    
+        Returns a dictionary describing where the time went in the last call
+        to pywise.distances() or pywise.rmsds() to succeed, on any thread, or
+        None if there has been none. Its keys are,
+        
+            "method" -> The name of the method called.
+            
+            "phases" -> A dictionary of the seconds spent in each phase of
+            the call: "convert", building the input array; "allocate",
+            allocating the output array; "prepare", cutting the calculation
+            into chunks; "spawn", handing the chunks to the worker pool until
+            the last thread had begun, including creating any workers;
+            "compute", from then until every thread had finished; and "wrap",
+            wrapping the results and releasing the input.
+            
+            "seconds" -> The seconds taken by the whole call, from building
+            the input array on.
+            
+            "threads" -> The number of threads which took part.
+            
+            "thread_seconds", "thread_pairs" -> Lists of the wall time of
+            each thread, and of the pairwise calculations it carried out.
+            
+            "pairs" -> The number of pairwise calculations carried out.
+            
+            "pairs_per_second", "gb_per_second" -> The pairwise calculations
+            carried out, and the gigabytes of input and results moved, each
+            counted once, per second of "compute".
+            
+            "imbalance" -> The longest wall time of any thread over the mean
+            of them all; 1.0 if the work was spread perfectly evenly.
+            
+        All times are of the monotonic clock. A call with nothing to
+        calculate records zero threads and pairs, and zero rates.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_last_stats
+(
+
+    PyObject* self,
+    PyObject* unused
+
+)
+{
+
+    pywise_stats_t* call;
+    pairwise_stats_t* calculation;
+    
+    PyObject* o_thread_seconds;
+    PyObject* o_thread_pairs;
+    
+    double seconds;
+    double longest;
+    double total;
+    double imbalance;
+    double pairs_per_second;
+    double gb_per_second;
+    
+    size_t i_thread;
+    
+    if (!pywise_stats_b_recorded) {
+        
+        Py_RETURN_NONE;
+    
+    }
+    
+    call = &pywise_stats_last_call;
+    calculation = &pywise_stats_last_calculation;
+    
+    o_thread_seconds = PyList_New(calculation->n_threads);
+    o_thread_pairs = PyList_New(calculation->n_threads);
+    
+    if (!o_thread_seconds || !o_thread_pairs) {
+        
+        Py_XDECREF(o_thread_seconds);
+        Py_XDECREF(o_thread_pairs);
+        
+        return NULL;
+    
+    }
+    
+    longest = 0;
+    total = 0;
+    
+    for (i_thread = 0; i_thread < calculation->n_threads; i_thread ++) {
+        
+        seconds = *(pywise_stats_a_thread_seconds + i_thread);
+        
+        if (seconds > longest) {
+            
+            longest = seconds;
+        
+        }
+        
+        total += seconds;
+        
+        PyList_SET_ITEM(o_thread_seconds, i_thread, PyFloat_FromDouble(seconds));
+        PyList_SET_ITEM(o_thread_pairs, i_thread,
+                        PyLong_FromSize_t(*(pywise_stats_a_thread_pairs + i_thread)));
+    
+    }
+    
+    /*
+    *   Calculations too quick for the clock to time have no rate to speak of,
+    *   and are reported as perfectly balanced.
+    */
+    
+    imbalance = total > 0 ? longest / (total / calculation->n_threads) : 1.0;
+    
+    pairs_per_second = 0;
+    gb_per_second = 0;
+    
+    if (calculation->compute_seconds > 0) {
+        
+        pairs_per_second = calculation->n_pairs / calculation->compute_seconds;
+        gb_per_second = calculation->n_bytes / calculation->compute_seconds / 1e9;
+    
+    }
+    
+    return Py_BuildValue("{s:s,s:{s:d,s:d,s:d,s:d,s:d,s:d},s:d,s:n,s:N,s:N,"
+                         "s:n,s:d,s:d,s:d}",
+                         "method", call->name,
+                         "phases",
+                         "convert", call->convert_seconds,
+                         "allocate", call->allocate_seconds,
+                         "prepare", calculation->prepare_seconds,
+                         "spawn", calculation->spawn_seconds,
+                         "compute", calculation->compute_seconds,
+                         "wrap", call->wrap_seconds,
+                         "seconds", call->convert_seconds
+                                  + call->allocate_seconds
+                                  + call->calculate_seconds
+                                  + call->wrap_seconds,
+                         "threads", (Py_ssize_t)calculation->n_threads,
+                         "thread_seconds", o_thread_seconds,
+                         "thread_pairs", o_thread_pairs,
+                         "pairs", (Py_ssize_t)calculation->n_pairs,
+                         "pairs_per_second", pairs_per_second,
+                         "gb_per_second", gb_per_second,
+                         "imbalance", imbalance);
+
+}
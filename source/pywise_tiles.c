@@ -0,0 +1,560 @@
+#include "pywise_tiles.h"
+
+/*******************************************************************************
+
+    Symbol: pywise_tiles_type
+    
+    Type: PyTypeObject
+    
+    Intent: Private
+    
+    Description:
+    
+        The Python type of pywise_tiles_t, pywise.Tiles, whose members are
+        set by pywise_tiles_prepare_type().
+        
+*******************************************************************************/
+
+PyTypeObject
+pywise_tiles_type = {
+    
+    PyVarObject_HEAD_INIT(NULL, 0)
+
+};
+
+/*******************************************************************************
+
+    Symbol: pywise_tiles
+    
+    Type: Function returning PyObject*
+    
+    Intent: Public exposed in Python as pywise.tiles()
+    
+    Python Signature:
+    
+        pywise.tiles(source, tile = 0, queue = 0, threads = 0,
+                     metric = "euclidean", dtype = None)
+            -> iterator
+            
+    Description:
+    
+        Starts calculating all pairwise results across a set of points, or of
+        collections of points, in any-dimensional space, and returns an
+        iterator which yields them tile by tile as threads finish them, so
+        that matrices of results far larger than memory can be reduced,
+        thresholded or written out as they are made.
+        
+        Each tile is a tuple, ((row_lower, row_upper), (column_lower,
+        column_upper), block), in which block is a two-dimensional NumPy
+        array holding the results between every point or collection from
+        row_lower up to but excluding row_upper and every one from
+        column_lower up to but excluding column_upper. Tiles cover the upper
+        triangle of the square matrix of results once each, in no particular
+        order; tiles on its diagonal are complete, with zeros on the
+        diagonal.
+        
+        Tiles span at most tile points or collections a side, and at most
+        queue tiles are in flight at once, calculations pausing whenever the
+        reader falls behind; zero for either chooses it automatically. source,
+        threads, metric and dtype are as for pywise.knn().
+        
+        On success pywise_tiles() returns a pywise.Tiles iterator. On failure
+        it raises a Python exception.
+        
+    Further Information:
+    
+        This function borrows or copies its source as pywise.knn() does, and
+        then passes it to libpairwise's pairwise_distances_stream() or
+        pairwise_rmsds_stream(), or their float counterparts in single
+        precision, which carry out the calculation on threads of their own
+        while the iterator is read. The source is kept until the stream
+        ends.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_tiles
+(
+
+    PyObject* self,
+    PyObject* values,
+    PyObject* keys
+
+)
+{
+
+    char* keywords[7] = {"source", "tile", "queue", "threads", "metric",
+                         "dtype", NULL};
+                         
+    size_t n_collections;
+    size_t n_points;
+    size_t n_coordinates;
+    
+    Py_ssize_t n_tile_collections;
+    Py_ssize_t n_queue;
+    Py_ssize_t n_threads;
+    
+    PyObject* o_source;
+    PyObject* o_dtype;
+    
+    char* metric;
+    
+    int b_rmsd;
+    
+    void* a_collections;
+    
+    pairwise_stream_t* stream;
+    
+    pywise_tiles_t* tiles;
+    
+    int n_type;
+    
+    int n_return;
+    
+    n_tile_collections = 0;
+    n_queue = 0;
+    n_threads = PYWISE_DEFAULT_THREADS;
+    
+    metric = "euclidean";
+    
+    o_dtype = NULL;
+    
+    /*
+    *   Attempt to parse arguments with keywords "source", "tile", "queue",
+    *   "threads", "metric" and "dtype" as a Python object, three signed
+    *   integers, a string and a Python object, respectively. As for
+    *   pywise_distances(), the integers are parsed as signed so that negative
+    *   values can be detected.
+    */
+    
+    n_return = PyArg_ParseTupleAndKeywords(values, keys, "O|nnnsO:tiles",
+                                           keywords, &o_source,
+                                           &n_tile_collections, &n_queue,
+                                           &n_threads, &metric, &o_dtype);
+                                           
+    if (!n_return) {
+        
+        return NULL;
+    
+    }
+    
+    if (n_tile_collections < 0 || n_queue < 0) {
+        
+        PyErr_Format(PyExc_ValueError, "Arguments tile and queue must be "
+                     "positive integers, or zero to choose automatically.");
+                     
+        return NULL;
+    
+    }
+    
+    if (n_threads < 0) {
+        
+        PyErr_Format(PyExc_ValueError, "Argument threads must be a positive "
+                     "integer, or zero to choose automatically.");
+                     
+        return NULL;
+    
+    }
+    
+    if (!strcmp(metric, "euclidean")) {
+        
+        b_rmsd = 0;
+    
+    } else if (!strcmp(metric, "rmsd")) {
+        
+        b_rmsd = 1;
+    
+    } else {
+        
+        PyErr_Format(PyExc_ValueError, "Argument metric must be either "
+                     "\"euclidean\" or \"rmsd\".");
+                     
+        return NULL;
+    
+    }
+    
+    n_type = pywise_resolve_type(o_source, o_dtype);
+    
+    if (n_type < 0) {
+        
+        return NULL;
+    
+    }
+    
+    /*
+    *   Build an input array of collections, or of points, from o_source, as
+    *   pywise_knn() does. The threads of the stream read it until the stream
+    *   is closed, so it is kept, with its buffer view, by the iterator.
+    */
+    
+    tiles = PyObject_New(pywise_tiles_t, &pywise_tiles_type);
+    
+    if (!tiles) {
+        
+        return NULL;
+    
+    }
+    
+    tiles->stream = NULL;
+    
+    if (b_rmsd) {
+        
+        a_collections = pywise_build_collections_array(o_source,
+                                                       n_type,
+                                                       &n_collections,
+                                                       &n_points,
+                                                       &n_coordinates,
+                                                       &tiles->view);
+    
+    } else {
+        
+        a_collections = pywise_build_points_array(o_source,
+                                                  n_type,
+                                                  &n_collections,
+                                                  &n_coordinates,
+                                                  &tiles->view);
+                                                  
+        n_points = 1;
+    
+    }
+    
+    if (!a_collections) {
+        
+        Py_DECREF(tiles);
+        
+        return NULL;
+    
+    }
+    
+    if (!n_threads) {
+        
+        n_threads = pairwise_threads_suggested(n_collections,
+                                               n_points,
+                                               n_coordinates);
+    
+    }
+    
+    if (b_rmsd && n_type == NPY_FLOAT) {
+        
+        n_return = pairwise_rmsds_stream_float(n_collections,
+                                               n_points,
+                                               n_coordinates,
+                                               a_collections,
+                                               n_tile_collections,
+                                               n_queue,
+                                               n_threads,
+                                               &stream);
+    
+    } else if (b_rmsd) {
+        
+        n_return = pairwise_rmsds_stream(n_collections,
+                                         n_points,
+                                         n_coordinates,
+                                         a_collections,
+                                         n_tile_collections,
+                                         n_queue,
+                                         n_threads,
+                                         &stream);
+    
+    } else if (n_type == NPY_FLOAT) {
+        
+        n_return = pairwise_distances_stream_float(n_collections,
+                                                   n_coordinates,
+                                                   a_collections,
+                                                   n_tile_collections,
+                                                   n_queue,
+                                                   n_threads,
+                                                   &stream);
+    
+    } else {
+        
+        n_return = pairwise_distances_stream(n_collections,
+                                             n_coordinates,
+                                             a_collections,
+                                             n_tile_collections,
+                                             n_queue,
+                                             n_threads,
+                                             &stream);
+    
+    }
+    
+    if (n_return) {
+        
+        pywise_release_array(a_collections, &tiles->view);
+        
+        Py_DECREF(tiles);
+        
+        pywise_set_python_exception_from_pairwise_calculations_return_code(n_return);
+        
+        return NULL;
+    
+    }
+    
+    tiles->stream = stream;
+    
+    tiles->a_collections = a_collections;
+    
+    tiles->n_type = n_type;
+    
+    tiles->b_busy = 0;
+    
+    return (PyObject*)tiles;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_tiles_next
+    
+    Type: Function returning PyObject*
+    
+    Intent: Private
+    
+    Description:
+    
+        The tp_iternext of pywise_tiles_type. Waits for the next tile of the
+        stream of self, without holding the GIL, and copies it into a new
+        NumPy array.
+        
+        On success returns the tuple described for pywise_tiles(). Once every
+        tile has been returned closes the stream and returns a null pointer
+        without setting an exception, which ends the iteration. On failure
+        closes the stream, returns a null pointer and sets a Python
+        exception.
+        
+*******************************************************************************/
+
+PyObject*
+pywise_tiles_next
+(
+
+    PyObject* self
+
+)
+{
+
+    pywise_tiles_t* tiles;
+    
+    PyObject* o_block;
+    
+    void* a_block;
+    
+    size_t i_row_lower;
+    size_t i_row_upper;
+    size_t i_column_lower;
+    size_t i_column_upper;
+    
+    npy_intp npy_l_block[2];
+    
+    int n_return;
+    
+    tiles = (pywise_tiles_t*)self;
+    
+    if (!tiles->stream) {
+        
+        return NULL;
+    
+    }
+    
+    /*
+    *   A stream may be read by only one thread at a time, and this one is
+    *   about to release the GIL.
+    */
+    
+    if (tiles->b_busy) {
+        
+        PyErr_Format(PyExc_ValueError, "Tiles are already being read by "
+                     "another thread.");
+                     
+        return NULL;
+    
+    }
+    
+    tiles->b_busy = 1;
+    
+    Py_BEGIN_ALLOW_THREADS
+    
+    n_return = pairwise_stream_next(tiles->stream,
+                                    &i_row_lower,
+                                    &i_row_upper,
+                                    &i_column_lower,
+                                    &i_column_upper,
+                                    &a_block);
+                                    
+    Py_END_ALLOW_THREADS
+    
+    tiles->b_busy = 0;
+    
+    if (n_return || !a_block) {
+        
+        if (!n_return) {
+            
+            n_return = pywise_tiles_close(tiles);
+        
+        } else {
+            
+            pywise_tiles_close(tiles);
+        
+        }
+        
+        if (n_return) {
+            
+            pywise_set_python_exception_from_pairwise_calculations_return_code(n_return);
+        
+        }
+        
+        return NULL;
+    
+    }
+    
+    /*
+    *   The tile is reused once the next is asked for, so copy it into an
+    *   array of its own.
+    */
+    
+    npy_l_block[0] = i_row_upper - i_row_lower;
+    npy_l_block[1] = i_column_upper - i_column_lower;
+    
+    o_block = PyArray_SimpleNew(2, npy_l_block, tiles->n_type);
+    
+    if (!o_block) {
+        
+        return NULL;
+    
+    }
+    
+    memcpy(PyArray_DATA((PyArrayObject*)o_block),
+           a_block,
+           PyArray_NBYTES((PyArrayObject*)o_block));
+           
+    return Py_BuildValue("((nn)(nn)N)",
+                         (Py_ssize_t)i_row_lower,
+                         (Py_ssize_t)i_row_upper,
+                         (Py_ssize_t)i_column_lower,
+                         (Py_ssize_t)i_column_upper,
+                         o_block);
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_tiles_close
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Closes the stream of tiles, if it is not already closed, without
+        holding the GIL, and releases its input array.
+        
+        Returns the libpairwise return code of pairwise_stream_close(), or
+        PAIRWISE_RETURN_SUCCESS if tiles was already closed.
+        
+*******************************************************************************/
+
+int
+pywise_tiles_close
+(
+
+    pywise_tiles_t* tiles
+
+)
+{
+
+    int n_return;
+    
+    if (!tiles->stream) {
+        
+        return PAIRWISE_RETURN_SUCCESS;
+    
+    }
+    
+    /*
+    *   Closing waits for the threads of the stream to finish the tiles they
+    *   are filling, which touches no Python object.
+    */
+    
+    Py_BEGIN_ALLOW_THREADS
+    
+    n_return = pairwise_stream_close(tiles->stream);
+    
+    Py_END_ALLOW_THREADS
+    
+    tiles->stream = NULL;
+    
+    pywise_release_array(tiles->a_collections, &tiles->view);
+    
+    return n_return;
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_tiles_dealloc
+    
+    Type: Function returning void
+    
+    Intent: Private
+    
+    Description:
+    
+        The tp_dealloc of pywise_tiles_type. Closes the stream of self, if it
+        is still open, and frees self. Tiles not yet read are discarded, and
+        the threads calculating them stopped.
+        
+        Returns nothing, and will not fail.
+        
+*******************************************************************************/
+
+void
+pywise_tiles_dealloc
+(
+
+    PyObject* self
+
+)
+{
+
+    pywise_tiles_close((pywise_tiles_t*)self);
+    
+    PyObject_Del(self);
+
+}
+
+/*******************************************************************************
+
+    Symbol: pywise_tiles_prepare_type
+    
+    Type: Function returning int
+    
+    Intent: Private
+    
+    Description:
+    
+        Sets the members of pywise_tiles_type and readies it for use. Called
+        once, by initpywise().
+        
+        On success returns integer zero. On failure returns integer minus one
+        and sets a Python exception.
+        
+*******************************************************************************/
+
+int
+pywise_tiles_prepare_type
+(void)
+{
+
+    pywise_tiles_type.tp_name = "pywise.Tiles";
+    pywise_tiles_type.tp_basicsize = sizeof(pywise_tiles_t);
+    pywise_tiles_type.tp_flags = Py_TPFLAGS_DEFAULT;
+    pywise_tiles_type.tp_doc = "Tiles of pairwise results, from pywise.tiles().";
+    
+    pywise_tiles_type.tp_dealloc = pywise_tiles_dealloc;
+    pywise_tiles_type.tp_iter = PyObject_SelfIter;
+    pywise_tiles_type.tp_iternext = pywise_tiles_next;
+    
+    return PyType_Ready(&pywise_tiles_type);
+
+}
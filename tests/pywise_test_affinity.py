@@ -0,0 +1,128 @@
+#!/usr/bin/env python
+
+# pywise_test_affinity.py
+#
+# A unit test for pywise.pool_set_affinity() and pywise.pool_get_affinity(),
+# checking that every placement of the worker pool is kept once selected, that
+# unknown placements are refused, and that pywise.distances() and
+# pywise.rmsds() give the same results with workers pinned as without.
+#
+# Usage: python pywise_test_affinity.py
+
+import sys
+import os
+
+n_points = 2000
+n_colls = 200
+n_coll_points = 20
+n_coords = 3
+n_threads = 4
+n_threads_more = 7
+
+test_name = "pywise_test_affinity.py"
+
+
+def refused(name, exception, call, *arguments):
+
+    try:
+    
+        call(*arguments)
+        
+    except exception:
+    
+        pass
+        
+    else:
+    
+        print("%s: Failed - %s was not refused." % (test_name, name))
+        exit(1)
+
+
+if __name__ == "__main__":
+
+    # Add the distribution root to the system path in case pywise has been
+    # built in place, rather than installed permanently.
+    
+    test_directory = os.path.dirname(os.path.realpath(__file__))
+    dist_directory = os.path.join(test_directory, os.path.pardir)
+    
+    sys.path.append(dist_directory)
+    
+    # Try to import the required modules, including pywise.
+    
+    try:
+    
+        import pywise
+        
+    except:
+    
+        print("%s: Failed - couldn't import pywise." % test_name)
+        exit(1)
+        
+    try:
+    
+        import numpy
+        
+    except:
+    
+        print("%s: Failed - couldn't import NumPy." % test_name)
+        exit(1)
+        
+    if pywise.pool_get_affinity() != pywise.AFFINITY_NONE:
+    
+        print("%s: Failed - the workers were pinned before any affinity was "
+              "selected." % test_name)
+        exit(1)
+        
+    # Calculate reference results with workers left to the operating system.
+    
+    points = numpy.random.rand(n_points, n_coords)
+    colls = numpy.random.rand(n_colls, n_coll_points, n_coords)
+    
+    dists_reference = pywise.distances(points, n_threads)
+    rmsds_reference = pywise.rmsds(colls, n_threads)
+    
+    # Every placement must be kept once selected, and must give the same
+    # results, including once the pool grows for more threads than before.
+    
+    for name in ("AFFINITY_CORES", "AFFINITY_NODES", "AFFINITY_NONE"):
+    
+        affinity = getattr(pywise, name)
+        
+        pywise.pool_set_affinity(affinity)
+        
+        if pywise.pool_get_affinity() != affinity:
+        
+            print("%s: Failed - pool_get_affinity() did not give %s once "
+                  "selected." % (test_name, name))
+            exit(1)
+            
+        for n in (n_threads, n_threads_more):
+        
+            if not numpy.array_equal(pywise.distances(points, n),
+                                     dists_reference) \
+            or not numpy.array_equal(pywise.rmsds(colls, n),
+                                     rmsds_reference):
+                
+                print("%s: Failed - %d threads under %s gave different "
+                      "results to unpinned workers." % (test_name, n, name))
+                exit(1)
+                
+    # Unknown placements are refused, leaving the selection unchanged.
+    
+    pywise.pool_set_affinity(pywise.AFFINITY_CORES)
+    
+    refused("pool_set_affinity(-1)", ValueError, pywise.pool_set_affinity, -1)
+    refused("pool_set_affinity(3)", ValueError, pywise.pool_set_affinity, 3)
+    refused("pool_set_affinity(\"cores\")", TypeError,
+            pywise.pool_set_affinity, "cores")
+            
+    if pywise.pool_get_affinity() != pywise.AFFINITY_CORES:
+    
+        print("%s: Failed - a refused affinity changed the selection."
+              % test_name)
+        exit(1)
+        
+    pywise.pool_set_affinity(pywise.AFFINITY_NONE)
+    
+    print("%s: Passed!" % test_name)
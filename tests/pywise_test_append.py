@@ -0,0 +1,149 @@
+#!/usr/bin/env python
+
+# pywise_test_append.py
+#
+# A unit test for pywise.append(), checking that extending the results across
+# some points by new points gives the same results as calculating them all at
+# once with pywise.distances() or pywise.rmsds().
+#
+# Usage: python pywise_test_append.py
+
+import sys
+import os
+
+n_points_old = 600
+n_points_new = 150
+n_colls_old = 90
+n_colls_new = 30
+n_coll_points = 10
+n_coords = 3
+n_threads = 3
+
+test_name = "pywise_test_append.py"
+
+
+def check(name, got, expected):
+
+    if got.shape != expected.shape or (got != expected).any():
+    
+        print("%s: Failed - %s gave the wrong results." % (test_name, name))
+        exit(1)
+
+
+if __name__ == "__main__":
+
+    # Add the distribution root to the system path in case pywise has been
+    # built in place, rather than installed permanently.
+    
+    test_directory = os.path.dirname(os.path.realpath(__file__))
+    dist_directory = os.path.join(test_directory, os.path.pardir)
+    
+    sys.path.append(dist_directory)
+    
+    # Try to import the required modules, including pywise.
+    
+    try:
+    
+        import pywise
+        
+    except:
+    
+        print("%s: Failed - couldn't import pywise." % test_name)
+        exit(1)
+        
+    try:
+    
+        import numpy
+        
+    except:
+    
+        print("%s: Failed - couldn't import NumPy." % test_name)
+        exit(1)
+        
+    points = numpy.random.rand(n_points_old + n_points_new, n_coords)
+    colls = numpy.random.rand(n_colls_old + n_colls_new, n_coll_points,
+                              n_coords)
+                              
+    expected = pywise.distances(points, n_threads)
+    
+    old = pywise.distances(points[:n_points_old], n_threads)
+    
+    check("append()", pywise.append(old, points, n_threads), expected)
+    
+    # The results must agree with pywise.index() for the enlarged set.
+    
+    i_pair = pywise.index(n_points_old + n_points_new, n_points_old - 1,
+                          n_points_old + 3)
+                          
+    if expected[i_pair] != numpy.linalg.norm(points[n_points_old - 1]
+                                             - points[n_points_old + 3]):
+                                             
+        print("%s: Failed - append() disagreed with index()." % test_name)
+        exit(1)
+        
+    # Appending into a separate buffer, and in place within a buffer whose
+    # start holds the old results, must both give the same results.
+    
+    out = numpy.zeros(len(expected))
+    
+    check("append() into out",
+          pywise.append(old, points, n_threads, out), expected)
+          
+    out[:len(old)] = old
+    
+    check("append() in place",
+          pywise.append(out[:len(old)], points, n_threads, out), expected)
+          
+    # Appending to nothing, or nothing new, leaves the full results.
+    
+    check("append() to no results",
+          pywise.append(numpy.zeros(0), points, n_threads), expected)
+          
+    check("append() of no new points",
+          pywise.append(expected, points, n_threads), expected)
+          
+    # Single precision and collections.
+    
+    points_single = points.astype(numpy.float32)
+    
+    check("append() of float32 results",
+          pywise.append(pywise.distances(points_single[:n_points_old]),
+                        points_single, n_threads),
+          pywise.distances(points_single, n_threads))
+          
+    check("append() of collections",
+          pywise.append(pywise.rmsds(colls[:n_colls_old]), colls, n_threads,
+                        metric = "rmsd"),
+          pywise.rmsds(colls, n_threads))
+          
+    # Results of no number of points, too few points, overlapping buffers and
+    # unknown metrics are refused.
+    
+    shifted = numpy.zeros(len(expected) + 1)
+    shifted[1:len(old) + 1] = old
+    
+    shared = numpy.zeros(points.size + len(expected))
+    shared[:points.size] = points.ravel()
+    
+    for arguments in ((old[1:], points), (old, points[:n_points_old - 1]),
+                      (shifted[1:len(old) + 1], points, n_threads,
+                       shifted[:len(expected)]),
+                      (old, shared[:points.size].reshape(points.shape),
+                       n_threads, shared[points.size - 1:-1]),
+                      (old, points, n_threads, None, "manhattan")):
+                      
+        try:
+        
+            pywise.append(*arguments)
+            
+        except ValueError:
+        
+            pass
+            
+        else:
+        
+            print("%s: Failed - append() accepted invalid arguments."
+                  % test_name)
+            exit(1)
+            
+    print("%s: Passed!" % test_name)
@@ -0,0 +1,275 @@
+#!/usr/bin/env python
+
+# pywise_test_buffers.py
+#
+# A unit test for the NumPy inputs which pywise.distances() and pywise.rmsds()
+# use in place or convert directly, checking that each gives the same results
+# as the equivalent nested Python lists, for the out arrays into which they
+# may write their results, and for single precision calculations.
+#
+# Usage: python pywise_test_buffers.py
+
+import sys
+import os
+
+n_points = 300
+n_colls = 60
+n_coll_points = 10
+n_coords = 3
+n_threads = 2
+
+test_name = "pywise_test_buffers.py"
+
+
+if __name__ == "__main__":
+
+    # Add the distribution root to the system path in case pywise has been
+    # built in place, rather than installed permanently.
+    
+    test_directory = os.path.dirname(os.path.realpath(__file__))
+    dist_directory = os.path.join(test_directory, os.path.pardir)
+    
+    sys.path.append(dist_directory)
+    
+    # Try to import the required modules, including pywise.
+    
+    try:
+    
+        import pywise
+    
+    except:
+        
+        print("%s: Failed - couldn't import pywise." % test_name)
+        exit(1)
+    
+    try:
+    
+        import numpy
+    
+    except:
+    
+        print("%s: Failed - couldn't import NumPy." % test_name)
+        exit(1)
+    
+    # Calculate reference results from nested Python lists, and then compare
+    # them against results from NumPy arrays of several dtypes and layouts.
+    
+    points = numpy.random.rand(n_points, n_coords)
+    colls = numpy.random.rand(n_colls, n_coll_points, n_coords)
+    
+    dists_reference = pywise.distances(points.tolist(), n_threads)
+    rmsds_reference = pywise.rmsds(colls.tolist(), n_threads)
+    
+    variants = [
+        
+        ("float64", lambda a: a),
+        ("Fortran-ordered", lambda a: numpy.asfortranarray(a)),
+        ("strided", lambda a: numpy.repeat(a, 2, axis = 0)[::2]),
+        ("read-only", lambda a: numpy.frombuffer(a.tobytes()).reshape(a.shape)),
+        ("big-endian", lambda a: a.astype(">f8"))
+    
+    ]
+    
+    for name, variant in variants:
+    
+        if not numpy.array_equal(pywise.distances(variant(points), n_threads),
+                                 dists_reference):
+        
+            print("%s: Failed - %s points gave different distances to a list."
+                  % (test_name, name))
+            exit(1)
+        
+        if not numpy.array_equal(pywise.rmsds(variant(colls), n_threads),
+                                 rmsds_reference):
+        
+            print("%s: Failed - %s collections gave different RMSDs to a list."
+                  % (test_name, name))
+            exit(1)
+    
+    # Integer arrays are converted rather than borrowed, and so should agree
+    # with lists of the same integers.
+    
+    int_points = (points * 100).astype(numpy.int32)
+    
+    if not numpy.array_equal(pywise.distances(int_points, n_threads),
+                             pywise.distances(int_points.tolist(), n_threads)):
+    
+        print("%s: Failed - integer points gave different distances to a "
+              "list." % test_name)
+        exit(1)
+    
+    # Arrays with the wrong number of dimensions must still raise exceptions.
+    
+    for bad in [numpy.zeros(5), numpy.zeros((0, 3)), numpy.zeros((4, 0))]:
+    
+        try:
+        
+            pywise.distances(bad, n_threads)
+        
+        except (TypeError, IndexError, ValueError):
+        
+            continue
+        
+        print("%s: Failed - points of shape %s didn't raise an exception."
+              % (test_name, bad.shape))
+        exit(1)
+    
+    # Results written into caller-supplied out arrays must match, and the out
+    # array itself must be returned.
+    
+    out = numpy.empty(len(dists_reference))
+    
+    if pywise.distances(points, n_threads, out = out) is not out \
+    or not numpy.array_equal(out, dists_reference):
+    
+        print("%s: Failed - distances written to out were wrong." % test_name)
+        exit(1)
+    
+    out = numpy.empty(len(rmsds_reference))
+    
+    if pywise.rmsds(colls, n_threads, out = out) is not out \
+    or not numpy.array_equal(out, rmsds_reference):
+    
+        print("%s: Failed - RMSDs written to out were wrong." % test_name)
+        exit(1)
+    
+    # Unsuitable out arrays must be refused.
+    
+    n_pairs = len(dists_reference)
+    
+    read_only = numpy.empty(n_pairs)
+    read_only.flags.writeable = False
+    
+    bad_outs = [
+        
+        ("too short", numpy.empty(n_pairs - 1)),
+        ("float32", numpy.empty(n_pairs, dtype = numpy.float32)),
+        ("strided", numpy.empty(2 * n_pairs)[::2]),
+        ("two-dimensional", numpy.empty((1, n_pairs))),
+        ("read-only", read_only),
+        ("a list", [0.0] * n_pairs)
+    
+    ]
+    
+    for name, bad in bad_outs:
+    
+        try:
+        
+            pywise.distances(points, n_threads, out = bad)
+        
+        except (TypeError, ValueError):
+        
+            continue
+        
+        print("%s: Failed - a %s out array was accepted." % (test_name, name))
+        exit(1)
+    
+    # An out array sharing memory with the input must be refused, while one
+    # just beyond the input in the same buffer is fine.
+    
+    shared = numpy.empty(points.size + n_pairs)
+    shared[:points.size] = points.ravel()
+    
+    points_shared = shared[:points.size].reshape(points.shape)
+    
+    try:
+    
+        pywise.distances(points_shared, n_threads,
+                         out = shared[points.size - 1:-1])
+    
+    except ValueError:
+    
+        pass
+    
+    else:
+    
+        print("%s: Failed - an out array overlapping points was accepted."
+              % test_name)
+        exit(1)
+    
+    if not numpy.array_equal(pywise.distances(points_shared, n_threads,
+                                              out = shared[points.size:]),
+                             dists_reference) \
+    or not numpy.array_equal(points_shared, points):
+    
+        print("%s: Failed - an out array following points in one buffer gave "
+              "wrong distances." % test_name)
+        exit(1)
+    
+    shared = numpy.empty(colls.size + len(rmsds_reference))
+    shared[:colls.size] = colls.ravel()
+    
+    try:
+    
+        pywise.rmsds(shared[:colls.size].reshape(colls.shape), n_threads,
+                     out = shared[colls.size // 2:][:len(rmsds_reference)])
+    
+    except ValueError:
+    
+        pass
+    
+    else:
+    
+        print("%s: Failed - an out array overlapping collections was "
+              "accepted." % test_name)
+        exit(1)
+    
+    # float32 inputs are calculated in single precision, as are other inputs
+    # given dtype = float32, and should agree closely with double precision.
+    
+    dists_single = pywise.distances(points.astype(numpy.float32), n_threads)
+    rmsds_single = pywise.rmsds(colls.astype(numpy.float32), n_threads)
+    
+    if dists_single.dtype != numpy.float32 \
+    or not numpy.allclose(dists_single, dists_reference, rtol = 1e-5):
+    
+        print("%s: Failed - float32 points gave wrong distances." % test_name)
+        exit(1)
+    
+    if rmsds_single.dtype != numpy.float32 \
+    or not numpy.allclose(rmsds_single, rmsds_reference, rtol = 1e-5):
+    
+        print("%s: Failed - float32 collections gave wrong RMSDs." % test_name)
+        exit(1)
+    
+    if not numpy.array_equal(pywise.distances(points.astype(numpy.float32)
+                                              .tolist(),
+                                              n_threads,
+                                              dtype = numpy.float32),
+                             dists_single):
+    
+        print("%s: Failed - dtype = float32 gave different distances to "
+              "float32 points." % test_name)
+        exit(1)
+    
+    if pywise.distances(points.astype(numpy.float32), n_threads,
+                        dtype = "float64").dtype != numpy.float64:
+    
+        print("%s: Failed - dtype = float64 didn't give float64 distances."
+              % test_name)
+        exit(1)
+    
+    out = numpy.empty(n_pairs, dtype = numpy.float32)
+    
+    if pywise.distances(points, n_threads, out = out,
+                        dtype = numpy.float32) is not out \
+    or not numpy.array_equal(out, dists_single):
+    
+        print("%s: Failed - float32 distances written to out were wrong."
+              % test_name)
+        exit(1)
+    
+    try:
+    
+        pywise.distances(points, n_threads, dtype = numpy.int32)
+    
+    except TypeError:
+    
+        pass
+    
+    else:
+    
+        print("%s: Failed - dtype = int32 was accepted." % test_name)
+        exit(1)
+    
+    print("%s: Passed!" % test_name)
@@ -0,0 +1,136 @@
+#!/usr/bin/env python
+
+# pywise_test_cross.py
+#
+# A unit test for pywise.cross_distances() and pywise.cross_rmsds(), checking
+# that every result between two sets equals the result between the same two
+# members of the single set made by joining them.
+#
+# Usage: python pywise_test_cross.py
+
+import sys
+import os
+
+n_points_a = 300
+n_points_b = 700
+n_colls_a = 40
+n_colls_b = 130
+n_coll_points = 10
+n_coords = 3
+n_threads = 3
+
+test_name = "pywise_test_cross.py"
+
+
+def rectangle(condensed, n_a, n_b):
+
+    # Pick out of the condensed results for a joined set of n_a + n_b members
+    # the n_a by n_b rectangle of results between its two parts.
+    
+    import numpy
+    
+    n = n_a + n_b
+    
+    rows = numpy.repeat(numpy.arange(n_a), n_b)
+    columns = numpy.tile(numpy.arange(n_a, n), n_a)
+    
+    indices = (rows * (2 * n - rows - 1)) // 2 + (columns - rows - 1)
+    
+    return condensed[indices].reshape(n_a, n_b)
+
+
+def check(name, got, expected):
+
+    if got.shape != expected.shape or (got != expected).any():
+    
+        print("%s: Failed - %s gave the wrong results." % (test_name, name))
+        exit(1)
+
+
+if __name__ == "__main__":
+
+    # Add the distribution root to the system path in case pywise has been
+    # built in place, rather than installed permanently.
+    
+    test_directory = os.path.dirname(os.path.realpath(__file__))
+    dist_directory = os.path.join(test_directory, os.path.pardir)
+    
+    sys.path.append(dist_directory)
+    
+    # Try to import the required modules, including pywise.
+    
+    try:
+    
+        import pywise
+    
+    except:
+        
+        print("%s: Failed - couldn't import pywise." % test_name)
+        exit(1)
+    
+    try:
+    
+        import numpy
+    
+    except:
+    
+        print("%s: Failed - couldn't import NumPy." % test_name)
+        exit(1)
+    
+    points_a = numpy.random.rand(n_points_a, n_coords)
+    points_b = numpy.random.rand(n_points_b, n_coords)
+    
+    colls_a = numpy.random.rand(n_colls_a, n_coll_points, n_coords)
+    colls_b = numpy.random.rand(n_colls_b, n_coll_points, n_coords)
+    
+    # Compare against the joined sets, in both precisions and both ways
+    # round.
+    
+    points = numpy.concatenate((points_a, points_b))
+    colls = numpy.concatenate((colls_a, colls_b))
+    
+    check("cross_distances()",
+          pywise.cross_distances(points_a, points_b, n_threads),
+          rectangle(pywise.distances(points, n_threads), n_points_a,
+                    n_points_b))
+                    
+    check("cross_distances() of b and a",
+          pywise.cross_distances(points_b, points_a, n_threads),
+          pywise.cross_distances(points_a, points_b, n_threads).T)
+          
+    check("cross_rmsds()",
+          pywise.cross_rmsds(colls_a, colls_b, n_threads),
+          rectangle(pywise.rmsds(colls, n_threads), n_colls_a, n_colls_b))
+          
+    points_single = points.astype(numpy.float32)
+    
+    results = pywise.cross_distances(points_single[:n_points_a],
+                                     points_single[n_points_a:], n_threads)
+    
+    if results.dtype != numpy.float32:
+    
+        print("%s: Failed - float32 points gave results of dtype %s."
+              % (test_name, results.dtype))
+        exit(1)
+    
+    check("cross_distances() of float32 points", results,
+          rectangle(pywise.distances(points_single, n_threads), n_points_a,
+                    n_points_b))
+    
+    # Sets of different dimensions cannot be compared.
+    
+    try:
+    
+        pywise.cross_distances(points_a, points_b[:, :2], n_threads)
+    
+    except ValueError:
+    
+        pass
+    
+    else:
+    
+        print("%s: Failed - points of different dimensions were accepted."
+              % test_name)
+        exit(1)
+    
+    print("%s: Passed!" % test_name)
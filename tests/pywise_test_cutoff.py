@@ -0,0 +1,145 @@
+#!/usr/bin/env python
+
+# pywise_test_cutoff.py
+#
+# A unit test for the cutoff argument of pywise.distances() and pywise.rmsds(),
+# checking that the CSR arrays returned hold exactly the results of the
+# condensed array which lie within the cutoff.
+#
+# Usage: python pywise_test_cutoff.py
+
+import sys
+import os
+
+n_points = 400
+n_colls = 120
+n_coll_points = 10
+n_coords = 3
+n_threads = 3
+
+test_name = "pywise_test_cutoff.py"
+
+
+def condensed_to_csr(results, n, cutoff):
+
+    # Filter a condensed results array in Python, giving the CSR arrays which
+    # pywise should return for the same cutoff.
+    
+    indptr = [0]
+    indices = []
+    values = []
+    
+    k = 0
+    
+    for i in range(n):
+    
+        for j in range(i + 1, n):
+        
+            if results[k] <= cutoff:
+            
+                indices.append(j)
+                values.append(results[k])
+            
+            k += 1
+        
+        indptr.append(len(indices))
+    
+    return indptr, indices, values
+
+
+def check(name, csr, reference):
+
+    for got, expected, part in zip(csr, reference, ["indptr", "indices",
+                                                    "values"]):
+    
+        if list(got) != list(expected):
+        
+            print("%s: Failed - %s with a cutoff gave the wrong %s."
+                  % (test_name, name, part))
+            exit(1)
+
+
+if __name__ == "__main__":
+
+    # Add the distribution root to the system path in case pywise has been
+    # built in place, rather than installed permanently.
+    
+    test_directory = os.path.dirname(os.path.realpath(__file__))
+    dist_directory = os.path.join(test_directory, os.path.pardir)
+    
+    sys.path.append(dist_directory)
+    
+    # Try to import the required modules, including pywise.
+    
+    try:
+    
+        import pywise
+    
+    except:
+        
+        print("%s: Failed - couldn't import pywise." % test_name)
+        exit(1)
+    
+    try:
+    
+        import numpy
+    
+    except:
+    
+        print("%s: Failed - couldn't import NumPy." % test_name)
+        exit(1)
+    
+    points = numpy.random.rand(n_points, n_coords)
+    colls = numpy.random.rand(n_colls, n_coll_points, n_coords)
+    
+    # Compare the CSR arrays against the condensed results, filtered in
+    # Python, for cutoffs keeping none, some and all of the results.
+    
+    dists = pywise.distances(points, n_threads)
+    rmsds = pywise.rmsds(colls, n_threads)
+    
+    for cutoff in [-1.0, 0.2, 10.0]:
+    
+        check("distances()",
+              pywise.distances(points, n_threads, cutoff = cutoff),
+              condensed_to_csr(dists, n_points, cutoff))
+              
+        check("rmsds()",
+              pywise.rmsds(colls, n_threads, cutoff = cutoff),
+              condensed_to_csr(rmsds, n_colls, cutoff))
+    
+    # Single precision results must also be those of the condensed array.
+    
+    points_single = points.astype(numpy.float32)
+    
+    indptr, indices, values = pywise.distances(points_single, n_threads,
+                                               cutoff = 0.2)
+    
+    if values.dtype != numpy.float32:
+    
+        print("%s: Failed - float32 points gave values of dtype %s."
+              % (test_name, values.dtype))
+        exit(1)
+    
+    check("distances() of float32 points", (indptr, indices, values),
+          condensed_to_csr(pywise.distances(points_single, n_threads),
+                           n_points, numpy.float32(0.2)))
+    
+    # out and cutoff cannot be given together.
+    
+    try:
+    
+        pywise.distances(points, n_threads, out = numpy.empty(len(dists)),
+                         cutoff = 0.2)
+    
+    except ValueError:
+    
+        pass
+    
+    else:
+    
+        print("%s: Failed - out and cutoff were accepted together."
+              % test_name)
+        exit(1)
+    
+    print("%s: Passed!" % test_name)
@@ -0,0 +1,203 @@
+#!/usr/bin/env python
+
+# pywise_test_file.py
+#
+# A unit test for the file argument of pywise.distances() and pywise.rmsds(),
+# and for pywise.load(), checking that results written to a results file
+# match those calculated in memory, and that the file describes itself.
+#
+# Usage: python pywise_test_file.py
+
+import sys
+import os
+import shutil
+import tempfile
+
+n_points = 1000
+n_colls = 120
+n_coll_points = 10
+n_coords = 3
+n_threads = 3
+
+test_name = "pywise_test_file.py"
+
+
+def check(name, got, expected):
+
+    if got.shape != expected.shape or got.dtype != expected.dtype or \
+       (got != expected).any():
+    
+        print("%s: Failed - %s gave the wrong results." % (test_name, name))
+        exit(1)
+
+
+def check_header(name, path, n, dtype, metric):
+
+    # Read the header as a process without pywise would.
+    
+    import numpy
+    
+    header = open(path, "rb").read(64)
+    
+    version, count = numpy.frombuffer(header[8:24], "<u8")
+    offset = numpy.frombuffer(header[48:56], "<u8")[0]
+    
+    if header[:8] != b"PAIRWISE" or version != 1 or count != n or \
+       header[24:32].rstrip(b"\0") != numpy.dtype(dtype).str.encode() or \
+       header[32:48].rstrip(b"\0") != metric.encode() or offset != 64:
+       
+        print("%s: Failed - %s wrote the wrong header." % (test_name, name))
+        exit(1)
+    
+    return numpy.memmap(path, dtype, "r", offset)
+
+
+if __name__ == "__main__":
+
+    # Add the distribution root to the system path in case pywise has been
+    # built in place, rather than installed permanently.
+    
+    test_directory = os.path.dirname(os.path.realpath(__file__))
+    dist_directory = os.path.join(test_directory, os.path.pardir)
+    
+    sys.path.append(dist_directory)
+    
+    # Try to import the required modules, including pywise.
+    
+    try:
+    
+        import pywise
+    
+    except:
+        
+        print("%s: Failed - couldn't import pywise." % test_name)
+        exit(1)
+    
+    try:
+    
+        import numpy
+    
+    except:
+    
+        print("%s: Failed - couldn't import NumPy." % test_name)
+        exit(1)
+    
+    points = numpy.random.rand(n_points, n_coords)
+    colls = numpy.random.rand(n_colls, n_coll_points, n_coords)
+    
+    directory = tempfile.mkdtemp()
+    
+    try:
+    
+        # Results written to a file must be those calculated in memory,
+        # whether read back through the returned array, through load(), or
+        # straight from the file.
+        
+        path = os.path.join(directory, "distances.pw")
+        
+        expected = pywise.distances(points, n_threads)
+        
+        check("distances() to a file",
+              pywise.distances(points, n_threads, file = path), expected)
+        
+        check("load() of distances", pywise.load(path), expected)
+        
+        check("reading distances without pywise",
+              check_header("distances()", path, n_points, numpy.float64,
+                           "euclidean"), expected)
+        
+        path = os.path.join(directory, "rmsds.pw")
+        
+        expected = pywise.rmsds(colls, n_threads, dtype = numpy.float32)
+        
+        check("rmsds() of float32 to a file",
+              pywise.rmsds(colls, n_threads, dtype = numpy.float32,
+                           file = path), expected)
+        
+        check_header("rmsds()", path, n_colls, numpy.float32, "rmsd")
+        
+        path = os.path.join(directory, "superposed.pw")
+        
+        expected = pywise.rmsds(colls, n_threads, superpose = True)
+        
+        check("superposed rmsds() to a file",
+              pywise.rmsds(colls, n_threads, superpose = True, file = path),
+              expected)
+        
+        check_header("superposed rmsds()", path, n_colls, numpy.float64,
+                     "rmsd_superposed")
+        
+        # A single point has no results, but still gives a valid file.
+        
+        path = os.path.join(directory, "single.pw")
+        
+        check("distances() of one point to a file",
+              pywise.distances(points[:1], n_threads, file = path),
+              numpy.zeros(0))
+        
+        # Writing results over the very file the points are mapped from
+        # replaces it, leaving the points being read intact.
+        
+        path = os.path.join(directory, "points.bin")
+        
+        mapped = numpy.memmap(path, numpy.float64, "w+", shape = points.shape)
+        mapped[:] = points
+        mapped.flush()
+        
+        check("distances() to the file of their input",
+              pywise.distances(mapped, n_threads, file = path),
+              pywise.distances(points, n_threads))
+        
+        check("points mapped from a replaced file", numpy.array(mapped),
+              points)
+        
+        del mapped
+        
+        # A file cannot be combined with out or cutoff, and only results
+        # files can be loaded.
+        
+        for keywords in ({"out": numpy.zeros(n_points * (n_points - 1) // 2)},
+                         {"cutoff": 0.5}):
+            
+            keywords["file"] = path
+            
+            try:
+            
+                pywise.distances(points, n_threads, **keywords)
+            
+            except ValueError:
+            
+                pass
+            
+            else:
+            
+                print("%s: Failed - file was accepted with %s."
+                      % (test_name, list(keywords)))
+                exit(1)
+        
+        path = os.path.join(directory, "other.pw")
+        
+        open(path, "wb").write(b"NOTPAIRWISE" * 10)
+        
+        for path, error in ((path, ValueError),
+                            (os.path.join(directory, "missing.pw"), IOError)):
+            
+            try:
+            
+                pywise.load(path)
+            
+            except error:
+            
+                pass
+            
+            else:
+            
+                print("%s: Failed - load() did not raise %s."
+                      % (test_name, error.__name__))
+                exit(1)
+    
+    finally:
+    
+        shutil.rmtree(directory)
+    
+    print("%s: Passed!" % test_name)
@@ -0,0 +1,191 @@
+#!/usr/bin/env python
+
+# pywise_test_futures.py
+#
+# A unit test for pywise.submit_distances() and pywise.submit_rmsds(), checking
+# that their futures give the results of pywise.distances() and
+# pywise.rmsds(), report progress, time out, can be cancelled, and complete
+# even while a stream is open.
+#
+# Usage: python pywise_test_futures.py
+
+import sys
+import os
+
+n_points = 1100
+n_colls = 150
+n_coll_points = 10
+n_coords = 3
+n_threads = 3
+n_tile = 64
+n_queue = 2
+
+n_colls_slow = 3000
+n_coll_points_slow = 100
+
+test_name = "pywise_test_futures.py"
+
+
+def check(name, future, expected):
+
+    # Wait for future, then check its results, that it reports itself done
+    # and complete, and that asking again gives the same array.
+    
+    got = future.result()
+    
+    if got.shape != expected.shape or got.dtype != expected.dtype \
+    or (got != expected).any():
+    
+        print("%s: Failed - %s gave the wrong results." % (test_name, name))
+        exit(1)
+        
+    if not future.done() or future.progress() != (len(got), len(got)):
+    
+        print("%s: Failed - %s was not complete once its result was returned."
+              % (test_name, name))
+        exit(1)
+        
+    if future.result(0) is not got:
+    
+        print("%s: Failed - %s gave a new result when asked again."
+              % (test_name, name))
+        exit(1)
+
+
+def refused(name, exception, call, *arguments):
+
+    try:
+    
+        call(*arguments)
+        
+    except exception:
+    
+        pass
+        
+    else:
+    
+        print("%s: Failed - %s was not refused." % (test_name, name))
+        exit(1)
+
+
+if __name__ == "__main__":
+
+    # Add the distribution root to the system path in case pywise has been
+    # built in place, rather than installed permanently.
+    
+    test_directory = os.path.dirname(os.path.realpath(__file__))
+    dist_directory = os.path.join(test_directory, os.path.pardir)
+    
+    sys.path.append(dist_directory)
+    
+    # Try to import the required modules, including pywise.
+    
+    try:
+    
+        import pywise
+        
+    except:
+    
+        print("%s: Failed - couldn't import pywise." % test_name)
+        exit(1)
+        
+    try:
+    
+        import numpy
+        
+    except:
+    
+        print("%s: Failed - couldn't import NumPy." % test_name)
+        exit(1)
+        
+    points = numpy.random.rand(n_points, n_coords)
+    colls = numpy.random.rand(n_colls, n_coll_points, n_coords)
+    
+    # Compare the results of futures against those calculated at once, in
+    # both precisions and for both metrics.
+    
+    check("submit_distances()",
+          pywise.submit_distances(points, n_threads),
+          pywise.distances(points, n_threads))
+          
+    points_single = points.astype(numpy.float32)
+    
+    check("submit_distances() of float32 points",
+          pywise.submit_distances(points_single, n_threads),
+          pywise.distances(points_single, n_threads))
+          
+    check("submit_rmsds()",
+          pywise.submit_rmsds(colls, n_threads),
+          pywise.rmsds(colls, n_threads))
+          
+    check("submit_rmsds() with dtype float32",
+          pywise.submit_rmsds(colls, n_threads, numpy.float32),
+          pywise.rmsds(colls, n_threads, dtype = numpy.float32))
+          
+    # A future with nothing to calculate is complete from the start.
+    
+    check("submit_distances() of one point",
+          pywise.submit_distances(points[:1], n_threads),
+          pywise.distances(points[:1], n_threads))
+          
+    # A long calculation times out when not waited for long enough, and once
+    # cancelled stops short of complete.
+    
+    colls_slow = numpy.random.rand(n_colls_slow, n_coll_points_slow, n_coords)
+    
+    future = pywise.submit_rmsds(colls_slow, n_threads)
+    
+    refused("result(0) of a running future", RuntimeError, future.result, 0)
+    
+    future.cancel()
+    
+    refused("result() of a cancelled future", RuntimeError, future.result)
+    
+    n_done, n_total = future.progress()
+    
+    if not future.done() or n_done >= n_total:
+    
+        print("%s: Failed - cancel() did not stop the calculation short."
+              % test_name)
+        exit(1)
+        
+    # Dropping a running future stops it, and must leave nothing behind.
+    
+    future = pywise.submit_rmsds(colls_slow, n_threads)
+    
+    del future
+    
+    # A future submitted while a stream's threads wait for its reader to take
+    # tiles must still complete, rather than wait behind them.
+    
+    tiles = pywise.tiles(points, n_tile, n_queue, n_threads)
+    
+    next(tiles)
+    
+    try:
+    
+        got = pywise.submit_distances(points, n_threads).result(60)
+        
+    except RuntimeError:
+    
+        print("%s: Failed - a future did not complete while a stream was "
+              "open." % test_name)
+        exit(1)
+        
+    if (got != pywise.distances(points, n_threads)).any():
+    
+        print("%s: Failed - a future submitted while a stream was open gave "
+              "the wrong results." % test_name)
+        exit(1)
+        
+    del tiles
+    
+    # Negative threads and timeouts are refused.
+    
+    refused("submit_distances(points, -1)", ValueError,
+            pywise.submit_distances, points, -1)
+            
+    refused("result(-1)", ValueError,
+            pywise.submit_rmsds(colls, n_threads).result, -1)
+            
+    print("%s: Passed!" % test_name)
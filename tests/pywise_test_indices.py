@@ -0,0 +1,182 @@
+#!/usr/bin/env python
+
+# pywise_test_indices.py
+#
+# A unit test for pywise.indices() and pywise.indices_inverse(), checking that
+# they agree with pywise.index() element by element, invert one another, and
+# gather whole rows of the results of pywise.distances().
+#
+# Usage: python pywise_test_indices.py
+
+import sys
+import os
+
+n_points = 400
+n_coords = 3
+n_lookups = 200000
+n_threads = 3
+
+test_name = "pywise_test_indices.py"
+
+
+def check(name, got, expected):
+
+    if got.shape != expected.shape or (got != expected).any():
+    
+        print("%s: Failed - %s gave the wrong indices." % (test_name, name))
+        exit(1)
+
+
+def refused(name, exception, function, *arguments):
+
+    try:
+    
+        function(*arguments)
+        
+    except exception:
+    
+        return
+        
+    print("%s: Failed - %s was accepted." % (test_name, name))
+    exit(1)
+
+
+if __name__ == "__main__":
+
+    # Add the distribution root to the system path in case pywise has been
+    # built in place, rather than installed permanently.
+    
+    test_directory = os.path.dirname(os.path.realpath(__file__))
+    dist_directory = os.path.join(test_directory, os.path.pardir)
+    
+    sys.path.append(dist_directory)
+    
+    # Try to import the required modules, including pywise.
+    
+    try:
+    
+        import pywise
+        
+    except:
+    
+        print("%s: Failed - couldn't import pywise." % test_name)
+        exit(1)
+        
+    try:
+    
+        import numpy
+        
+    except:
+    
+        print("%s: Failed - couldn't import NumPy." % test_name)
+        exit(1)
+        
+    # Every pair, in the order of the condensed results, maps to 0, 1, 2, ...
+    # and back again.
+    
+    rows, columns = numpy.triu_indices(n_points, 1)
+    every = numpy.arange(len(rows))
+    
+    check("indices()", pywise.indices(n_points, rows, columns, n_threads),
+          every)
+    check("indices() with swapped pairs",
+          pywise.indices(n_points, columns, rows, n_threads), every)
+          
+    inverse = pywise.indices_inverse(n_points, every, n_threads)
+    
+    check("indices_inverse()", inverse[0], rows)
+    check("indices_inverse()", inverse[1], columns)
+    
+    # Random pairs, some negative, agree with index() one by one, whatever
+    # the number of threads.
+    
+    pairs_a = numpy.random.randint(-n_points, n_points, n_lookups)
+    pairs_b = numpy.random.randint(-n_points, n_points, n_lookups)
+    
+    same = (pairs_a % n_points) == (pairs_b % n_points)
+    pairs_b[same] = (pairs_a[same] + 1) % n_points
+    
+    expected = numpy.array([pywise.index(n_points, a, b)
+                            for a, b in zip(pairs_a[:1000], pairs_b[:1000])])
+                            
+    for threads in (1, n_threads, 0):
+    
+        found = pywise.indices(n_points, pairs_a, pairs_b, threads)
+        
+        check("indices() of random pairs", found[:1000], expected)
+        
+        lesser, greater = pywise.indices_inverse(n_points, found, threads)
+        
+        check("indices_inverse() of random pairs", lesser,
+              numpy.minimum(pairs_a % n_points, pairs_b % n_points))
+        check("indices_inverse() of random pairs", greater,
+              numpy.maximum(pairs_a % n_points, pairs_b % n_points))
+              
+    # Shapes broadcast, so a row of the full matrix can be gathered at once.
+    
+    points = numpy.random.rand(n_points, n_coords)
+    results = pywise.distances(points, n_threads)
+    
+    square = numpy.zeros((n_points, n_points))
+    square[rows, columns] = results
+    square[columns, rows] = results
+    
+    for i in (0, 17, n_points - 1):
+    
+        others = numpy.delete(numpy.arange(n_points), i)
+        
+        row = results[pywise.indices(n_points, i, others)]
+        
+        if (row != square[i, others]).any():
+        
+            print("%s: Failed - indices() didn't gather row %d."
+                  % (test_name, i))
+            exit(1)
+            
+    grid = pywise.indices(n_points, numpy.arange(3)[:, None],
+                          numpy.arange(3, 7)[None, :])
+                          
+    check("indices() of a grid", grid,
+          numpy.array([[pywise.index(n_points, a, b) for b in range(3, 7)]
+                       for a in range(3)]))
+                       
+    lesser, greater = pywise.indices_inverse(n_points, -1)
+    
+    if lesser.shape != () or lesser != n_points - 2 or greater != n_points - 1:
+    
+        print("%s: Failed - indices_inverse() of -1 was wrong." % test_name)
+        exit(1)
+        
+    # Sizes far beyond 2 ** 53 results still invert exactly.
+    
+    n_huge = 4000000000
+    huge_a = numpy.array([0, 1, n_huge // 2, n_huge - 3, n_huge - 2])
+    huge_b = numpy.array([1, n_huge - 1, n_huge // 2 + 1, n_huge - 1,
+                          n_huge - 1])
+                          
+    lesser, greater = pywise.indices_inverse(
+        n_huge, pywise.indices(n_huge, huge_a, huge_b))
+        
+    check("indices_inverse() of many collections", lesser, huge_a)
+    check("indices_inverse() of many collections", greater, huge_b)
+    
+    # Invalid pairs and indices raise what index() raises.
+    
+    n_results = n_points * (n_points - 1) // 2
+    
+    refused("indices() of an out-of-bounds pair", IndexError,
+            pywise.indices, n_points, [0, n_points], [1, 2])
+    refused("indices() of a pair of one collection", IndexError,
+            pywise.indices, n_points, [0, 3], [1, 3])
+    refused("indices() of unbroadcastable shapes", ValueError,
+            pywise.indices, n_points, [0, 1], [2, 3, 4])
+    refused("indices() of one collection", ValueError,
+            pywise.indices, 1, [0], [0])
+    refused("indices_inverse() of an out-of-bounds index", IndexError,
+            pywise.indices_inverse, n_points, [0, n_results])
+    refused("indices_inverse() of a negative out-of-bounds index", IndexError,
+            pywise.indices_inverse, n_points, [-n_results - 1])
+    refused("negative threads", ValueError,
+            pywise.indices_inverse, n_points, [0], -1)
+            
+    print("%s: Passed!" % test_name)
@@ -0,0 +1,139 @@
+#!/usr/bin/env python
+
+# pywise_test_knn.py
+#
+# A unit test for pywise.knn(), checking that the neighbours it returns are
+# exactly the nearest found by sorting each row of the full matrix of results
+# from pywise.distances() and pywise.rmsds().
+#
+# Usage: python pywise_test_knn.py
+
+import sys
+import os
+
+n_points = 500
+n_colls = 150
+n_coll_points = 10
+n_coords = 3
+n_threads = 3
+
+test_name = "pywise_test_knn.py"
+
+
+def nearest(condensed, n, k):
+
+    # Expand a condensed results array to a full square matrix, and return the
+    # indices and results of the k nearest neighbours of each row, ordering
+    # equal results by index as pywise.knn() does.
+    
+    import numpy
+    
+    full = numpy.empty((n, n), dtype = condensed.dtype)
+    
+    rows, columns = numpy.triu_indices(n, 1)
+    
+    full[rows, columns] = condensed
+    full[columns, rows] = condensed
+    
+    indices = numpy.empty((n, k), dtype = numpy.intp)
+    
+    for i in range(n):
+    
+        others = numpy.delete(numpy.arange(n), i)
+        order = numpy.lexsort((others, full[i, others]))
+        
+        indices[i] = others[order[:k]]
+    
+    return indices, full[numpy.arange(n)[:, None], indices]
+
+
+def check(name, got, expected):
+
+    for got_array, expected_array, part in zip(got, expected,
+                                               ["indices", "values"]):
+    
+        if got_array.shape != expected_array.shape \
+        or (got_array != expected_array).any():
+        
+            print("%s: Failed - %s gave the wrong %s." % (test_name, name, part))
+            exit(1)
+
+
+if __name__ == "__main__":
+
+    # Add the distribution root to the system path in case pywise has been
+    # built in place, rather than installed permanently.
+    
+    test_directory = os.path.dirname(os.path.realpath(__file__))
+    dist_directory = os.path.join(test_directory, os.path.pardir)
+    
+    sys.path.append(dist_directory)
+    
+    # Try to import the required modules, including pywise.
+    
+    try:
+    
+        import pywise
+    
+    except:
+        
+        print("%s: Failed - couldn't import pywise." % test_name)
+        exit(1)
+    
+    try:
+    
+        import numpy
+    
+    except:
+    
+        print("%s: Failed - couldn't import NumPy." % test_name)
+        exit(1)
+    
+    points = numpy.random.rand(n_points, n_coords)
+    colls = numpy.random.rand(n_colls, n_coll_points, n_coords)
+    
+    # Compare against the full matrices for several k, in both metrics and
+    # in both precisions.
+    
+    dists = pywise.distances(points, n_threads)
+    rmsds = pywise.rmsds(colls, n_threads)
+    
+    points_single = points.astype(numpy.float32)
+    dists_single = pywise.distances(points_single, n_threads)
+    
+    for k in [0, 1, 7]:
+    
+        check("knn() of points", pywise.knn(points, k, n_threads),
+              nearest(dists, n_points, k))
+              
+        check("knn() of collections",
+              pywise.knn(colls, k, n_threads, metric = "rmsd"),
+              nearest(rmsds, n_colls, k))
+              
+        check("knn() of float32 points",
+              pywise.knn(points_single, k, n_threads),
+              nearest(dists_single, n_points, k))
+    
+    # The results must not depend on the number of threads.
+    
+    check("knn() on one thread", pywise.knn(points, 7, 1),
+          pywise.knn(points, 7, 5))
+    
+    # k must be less than the number of points, and metric recognised.
+    
+    for k, metric in [(n_points, "euclidean"), (-1, "euclidean"),
+                      (3, "manhattan")]:
+    
+        try:
+        
+            pywise.knn(points, k, n_threads, metric = metric)
+        
+        except ValueError:
+        
+            continue
+        
+        print("%s: Failed - knn() accepted k = %d with metric %s."
+              % (test_name, k, metric))
+        exit(1)
+    
+    print("%s: Passed!" % test_name)
@@ -0,0 +1,168 @@
+#!/usr/bin/env python
+
+# pywise_test_linkage.py
+#
+# A unit test for pywise.single_linkage(), checking that its linkage matches
+# single linkage of the full results of pywise.distances() and pywise.rmsds()
+# as SciPy would give it, whatever the number of threads.
+#
+# Usage: python pywise_test_linkage.py
+
+import sys
+import os
+
+n_points = 700
+n_colls = 120
+n_coll_points = 10
+n_coords = 3
+n_threads = 3
+
+test_name = "pywise_test_linkage.py"
+
+
+def single_linkage(condensed, n):
+
+    # Cluster n members by single linkage from their condensed results, by
+    # Prim's algorithm over the full matrix, labelling merges as SciPy does.
+    
+    import numpy
+    
+    matrix = numpy.zeros((n, n))
+    
+    rows, columns = numpy.triu_indices(n, 1)
+    
+    matrix[rows, columns] = condensed
+    matrix[columns, rows] = condensed
+    
+    nearest = matrix[0].copy()
+    source = numpy.zeros(n, numpy.int64)
+    remaining = numpy.ones(n, bool)
+    remaining[0] = False
+    
+    edges = []
+    
+    for i_edge in range(n - 1):
+    
+        candidates = numpy.flatnonzero(remaining)
+        added = candidates[nearest[candidates].argmin()]
+        
+        edges.append((nearest[added], i_edge, source[added], added))
+        
+        remaining[added] = False
+        
+        closer = remaining & (matrix[added] < nearest)
+        
+        nearest[closer] = matrix[added][closer]
+        source[closer] = added
+        
+    parent = list(range(2 * n - 1))
+    sizes = [1] * n
+    
+    def find(label):
+    
+        while parent[label] != label:
+        
+            label = parent[label]
+            
+        return label
+        
+    linkage = []
+    
+    for i_merge, (result, _, a, b) in enumerate(sorted(edges)):
+    
+        a, b = sorted((find(a), find(b)))
+        
+        sizes.append(sizes[a] + sizes[b])
+        
+        parent[a] = parent[b] = n + i_merge
+        
+        linkage.append((a, b, result, sizes[-1]))
+        
+    return numpy.array(linkage).reshape(-1, 4)
+
+
+def check(name, got, expected, tolerance):
+
+    import numpy
+    
+    if (got.shape != expected.shape
+    or  (got[:, [0, 1, 3]] != expected[:, [0, 1, 3]]).any()
+    or  not numpy.allclose(got[:, 2], expected[:, 2], tolerance, tolerance)):
+    
+        print("%s: Failed - %s gave the wrong linkage." % (test_name, name))
+        exit(1)
+
+
+if __name__ == "__main__":
+
+    # Add the distribution root to the system path in case pywise has been
+    # built in place, rather than installed permanently.
+    
+    test_directory = os.path.dirname(os.path.realpath(__file__))
+    dist_directory = os.path.join(test_directory, os.path.pardir)
+    
+    sys.path.append(dist_directory)
+    
+    # Try to import the required modules, including pywise.
+    
+    try:
+    
+        import pywise
+        
+    except:
+    
+        print("%s: Failed - couldn't import pywise." % test_name)
+        exit(1)
+        
+    try:
+    
+        import numpy
+        
+    except:
+    
+        print("%s: Failed - couldn't import NumPy." % test_name)
+        exit(1)
+        
+    points = numpy.random.rand(n_points, n_coords)
+    colls = numpy.random.rand(n_colls, n_coll_points, n_coords)
+    
+    expected = single_linkage(pywise.distances(points), n_points)
+    
+    for threads in (1, n_threads):
+    
+        check("single_linkage() on %d threads" % threads,
+              pywise.single_linkage(points, threads), expected, 1e-12)
+              
+    check("single_linkage() of float32 points",
+          pywise.single_linkage(points, n_threads, dtype = numpy.float32),
+          expected, 1e-5)
+          
+    check("single_linkage() of collections",
+          pywise.single_linkage(colls, n_threads, "rmsd"),
+          single_linkage(pywise.rmsds(colls), n_colls), 1e-12)
+          
+    # Fewer than two points give an empty linkage.
+    
+    if pywise.single_linkage(points[:1]).shape != (0, 4):
+    
+        print("%s: Failed - single_linkage() of one point was not empty."
+              % test_name)
+        exit(1)
+        
+    # Unknown metrics are refused.
+    
+    try:
+    
+        pywise.single_linkage(points, n_threads, "manhattan")
+        
+    except ValueError:
+    
+        pass
+        
+    else:
+    
+        print("%s: Failed - single_linkage() accepted metric manhattan."
+              % test_name)
+        exit(1)
+        
+    print("%s: Passed!" % test_name)
@@ -0,0 +1,172 @@
+#!/usr/bin/env python
+
+# pywise_test_reduce.py
+#
+# A unit test for pywise.pair_stats(), pywise.histogram() and
+# pywise.row_sums(), checking that they agree with the same reductions by
+# NumPy over the full results of pywise.distances() and pywise.rmsds().
+#
+# Usage: python pywise_test_reduce.py
+
+import sys
+import os
+
+n_points = 900
+n_colls = 120
+n_coll_points = 10
+n_coords = 3
+n_bins = 16
+n_threads = 3
+
+test_name = "pywise_test_reduce.py"
+
+
+def square(condensed, n):
+
+    # Expand condensed results for n members into the full symmetric n by n
+    # matrix, with zero on its diagonal.
+    
+    import numpy
+    
+    matrix = numpy.zeros((n, n), numpy.float64)
+    
+    rows, columns = numpy.triu_indices(n, 1)
+    
+    matrix[rows, columns] = condensed
+    matrix[columns, rows] = condensed
+    
+    return matrix
+
+
+def check(name, source, condensed, n, **arguments):
+
+    # Compare every reduction of source against NumPy's reduction of its
+    # condensed results.
+    
+    import numpy
+    
+    import pywise
+    
+    condensed = condensed.astype(numpy.float64)
+    
+    tolerance = 1e-4 if arguments.get("dtype") == numpy.float32 else 1e-9
+    
+    got = numpy.array(pywise.pair_stats(source, n_threads, **arguments))
+    expected = numpy.array([condensed.min(), condensed.max(),
+                            condensed.mean(), condensed.var()])
+                            
+    if not numpy.allclose(got, expected, tolerance, tolerance):
+    
+        print("%s: Failed - pair_stats() of %s gave the wrong statistics."
+              % (test_name, name))
+        exit(1)
+        
+    # Bin edges may round differently, so allow a result which falls on an
+    # edge to be counted either side of it.
+    
+    for bounds in (None, (0.25, 0.75)):
+    
+        counts, edges = pywise.histogram(source, n_bins, bounds, n_threads,
+                                         **arguments)
+                                         
+        counts_numpy, edges_numpy = numpy.histogram(condensed, n_bins, bounds)
+        
+        if (counts.shape != counts_numpy.shape
+        or  not numpy.allclose(edges, edges_numpy, tolerance, tolerance)
+        or  abs(counts - counts_numpy).max() > 2
+        or  abs(counts.sum() - counts_numpy.sum()) > 2):
+        
+            print("%s: Failed - histogram() of %s over %s gave the wrong "
+                  "counts." % (test_name, name, str(bounds)))
+            exit(1)
+            
+    sums = pywise.row_sums(source, n_threads, **arguments)
+    
+    if (sums.shape != (n,)
+    or  not numpy.allclose(sums, square(condensed, n).sum(1),
+                           tolerance, tolerance)):
+                           
+        print("%s: Failed - row_sums() of %s gave the wrong sums."
+              % (test_name, name))
+        exit(1)
+
+
+if __name__ == "__main__":
+
+    # Add the distribution root to the system path in case pywise has been
+    # built in place, rather than installed permanently.
+    
+    test_directory = os.path.dirname(os.path.realpath(__file__))
+    dist_directory = os.path.join(test_directory, os.path.pardir)
+    
+    sys.path.append(dist_directory)
+    
+    # Try to import the required modules, including pywise.
+    
+    try:
+    
+        import pywise
+        
+    except:
+    
+        print("%s: Failed - couldn't import pywise." % test_name)
+        exit(1)
+        
+    try:
+    
+        import numpy
+        
+    except:
+    
+        print("%s: Failed - couldn't import NumPy." % test_name)
+        exit(1)
+        
+    # Offset the points far from the origin, so that a variance found from
+    # unshifted sums of squares would lose most of its precision.
+    
+    points = numpy.random.rand(n_points, n_coords) + 1000
+    colls = numpy.random.rand(n_colls, n_coll_points, n_coords)
+    
+    check("points", points, pywise.distances(points, n_threads), n_points)
+    
+    check("float32 points", points, pywise.distances(points, n_threads,
+          dtype = numpy.float32), n_points, dtype = numpy.float32)
+          
+    check("collections", colls, pywise.rmsds(colls, n_threads), n_colls,
+          metric = "rmsd")
+          
+    # Fewer than two points give no results.
+    
+    if not numpy.isnan(pywise.pair_stats(points[:1])).all():
+    
+        print("%s: Failed - pair_stats() of one point was not NaN."
+              % test_name)
+        exit(1)
+        
+    if pywise.row_sums(points[:1]).tolist() != [0]:
+    
+        print("%s: Failed - row_sums() of one point was not zero."
+              % test_name)
+        exit(1)
+        
+    # Empty bins and ranges, and unknown metrics, are refused.
+    
+    for arguments in ((points, 0), (points, n_bins, (1, 1)),
+                      (points, n_bins, (1, 0)), (points, n_bins, "range"),
+                      (points, n_bins, None, n_threads, "manhattan")):
+                      
+        try:
+        
+            pywise.histogram(*arguments)
+            
+        except ValueError:
+        
+            pass
+            
+        else:
+        
+            print("%s: Failed - histogram%s was accepted."
+                  % (test_name, str(arguments[1:])))
+            exit(1)
+            
+    print("%s: Passed!" % test_name)
@@ -0,0 +1,143 @@
+#!/usr/bin/env python
+
+# pywise_test_stats.py
+#
+# A unit test for pywise.last_stats(), checking that it describes the last
+# call to pywise.distances() or pywise.rmsds() to succeed, with phase timings,
+# per-thread counts which add up, and sensible rates.
+#
+# Usage: python pywise_test_stats.py
+
+import sys
+import os
+
+n_points = 1100
+n_colls = 150
+n_coll_points = 10
+n_coords = 3
+n_threads = 3
+
+test_name = "pywise_test_stats.py"
+
+phases = ["convert", "allocate", "prepare", "spawn", "compute", "wrap"]
+
+
+def check(name, stats, method, n_pairs):
+
+    # Check that stats describes a call to method which carried out n_pairs
+    # pairwise calculations, and that its timings and rates are consistent.
+    
+    if stats is None or stats["method"] != method:
+    
+        print("%s: Failed - %s was not recorded." % (test_name, name))
+        exit(1)
+        
+    if sorted(stats["phases"]) != sorted(phases) \
+    or min(stats["phases"].values()) < 0:
+    
+        print("%s: Failed - %s recorded the wrong phases." % (test_name, name))
+        exit(1)
+        
+    if stats["seconds"] < stats["phases"]["convert"] \
+                        + stats["phases"]["allocate"] \
+                        + stats["phases"]["wrap"]:
+    
+        print("%s: Failed - %s took less time than its phases."
+              % (test_name, name))
+        exit(1)
+        
+    if stats["pairs"] != n_pairs or sum(stats["thread_pairs"]) != n_pairs \
+    or len(stats["thread_pairs"]) != stats["threads"] \
+    or len(stats["thread_seconds"]) != stats["threads"] \
+    or stats["threads"] > n_threads:
+    
+        print("%s: Failed - %s recorded the wrong counts." % (test_name, name))
+        exit(1)
+        
+    if stats["imbalance"] < 1 - 1e-9 \
+    or stats["pairs_per_second"] < 0 or stats["gb_per_second"] < 0 \
+    or (n_pairs and stats["phases"]["compute"] > 0
+                and not stats["pairs_per_second"] > 0):
+    
+        print("%s: Failed - %s recorded the wrong rates." % (test_name, name))
+        exit(1)
+
+
+if __name__ == "__main__":
+
+    # Add the distribution root to the system path in case pywise has been
+    # built in place, rather than installed permanently.
+    
+    test_directory = os.path.dirname(os.path.realpath(__file__))
+    dist_directory = os.path.join(test_directory, os.path.pardir)
+    
+    sys.path.append(dist_directory)
+    
+    # Try to import the required modules, including pywise.
+    
+    try:
+    
+        import pywise
+        
+    except:
+    
+        print("%s: Failed - couldn't import pywise." % test_name)
+        exit(1)
+        
+    try:
+    
+        import numpy
+        
+    except:
+    
+        print("%s: Failed - couldn't import NumPy." % test_name)
+        exit(1)
+        
+    points = numpy.random.rand(n_points, n_coords)
+    colls = numpy.random.rand(n_colls, n_coll_points, n_coords)
+    
+    # Nothing has been recorded before the first call.
+    
+    if pywise.last_stats() is not None:
+    
+        print("%s: Failed - stats were recorded before any call." % test_name)
+        exit(1)
+        
+    pywise.distances(points, n_threads)
+    
+    check("distances()", pywise.last_stats(), "distances",
+          n_points * (n_points - 1) // 2)
+          
+    pywise.rmsds(colls, n_threads, dtype = numpy.float32)
+    
+    check("rmsds()", pywise.last_stats(), "rmsds",
+          n_colls * (n_colls - 1) // 2)
+          
+    # A call which fails leaves the last stats as they were.
+    
+    try:
+    
+        pywise.distances(points, -1)
+        
+    except ValueError:
+    
+        pass
+        
+    check("distances() after a failed call", pywise.last_stats(), "rmsds",
+          n_colls * (n_colls - 1) // 2)
+          
+    # A call with nothing to calculate records no pairs, at no rate.
+    
+    pywise.distances(points[:1], n_threads)
+    
+    stats = pywise.last_stats()
+    
+    check("distances() of one point", stats, "distances", 0)
+    
+    if stats["pairs_per_second"] or stats["gb_per_second"]:
+    
+        print("%s: Failed - a call with nothing to calculate had a rate."
+              % test_name)
+        exit(1)
+        
+    print("%s: Passed!" % test_name)
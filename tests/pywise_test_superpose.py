@@ -0,0 +1,201 @@
+#!/usr/bin/env python
+
+# pywise_test_superpose.py
+#
+# A unit test for pywise.rmsds(..., superpose = True), checking its results
+# against superposition by the Kabsch method, and that a collection rotated
+# and translated onto another gives an RMSD of zero, including for collections
+# of one point, of coincident points and of collinear points.
+#
+# Usage: python pywise_test_superpose.py
+
+import sys
+import os
+
+n_colls = 60
+n_coll_points = 25
+n_coords = 3
+n_threads = 3
+
+tolerance_double = 1e-9
+tolerance_single = 1e-3
+tolerance_collinear = 1e-5
+
+test_name = "pywise_test_superpose.py"
+
+
+def kabsch_rmsd(a, b):
+
+    # Find the RMSD between collections a and b after optimal superposition,
+    # by the singular value decomposition of their covariance matrix.
+    
+    import numpy
+    
+    a = a - a.mean(axis = 0)
+    b = b - b.mean(axis = 0)
+    
+    u, s, vt = numpy.linalg.svd(numpy.dot(a.T, b))
+    
+    if numpy.linalg.det(u) * numpy.linalg.det(vt) < 0:
+    
+        s[-1] = -s[-1]
+    
+    e = (a * a).sum() + (b * b).sum() - 2 * s.sum()
+    
+    return numpy.sqrt(max(e, 0) / len(a))
+
+
+def check(name, got, expected, tolerance):
+
+    # Written so that any NaN in got fails.
+    
+    if got.shape != expected.shape or \
+       not (numpy.abs(got - expected) <= tolerance).all():
+    
+        print("%s: Failed - %s gave the wrong results." % (test_name, name))
+        exit(1)
+
+
+if __name__ == "__main__":
+
+    # Add the distribution root to the system path in case pywise has been
+    # built in place, rather than installed permanently.
+    
+    test_directory = os.path.dirname(os.path.realpath(__file__))
+    dist_directory = os.path.join(test_directory, os.path.pardir)
+    
+    sys.path.append(dist_directory)
+    
+    # Try to import the required modules, including pywise.
+    
+    try:
+    
+        import pywise
+    
+    except:
+        
+        print("%s: Failed - couldn't import pywise." % test_name)
+        exit(1)
+    
+    try:
+    
+        import numpy
+    
+    except:
+    
+        print("%s: Failed - couldn't import NumPy." % test_name)
+        exit(1)
+    
+    colls = numpy.random.rand(n_colls, n_coll_points, n_coords)
+    
+    # Make the second collection a rotated and translated copy of the first.
+    
+    angle = 0.7
+    
+    rotation = numpy.array([[numpy.cos(angle), -numpy.sin(angle), 0],
+                            [numpy.sin(angle), numpy.cos(angle), 0],
+                            [0, 0, 1]])
+    
+    colls[1] = numpy.dot(colls[0], rotation.T) + numpy.array([1.5, -2, 0.25])
+    
+    expected = numpy.array([kabsch_rmsd(colls[i], colls[j])
+                            for i in range(n_colls)
+                            for j in range(i + 1, n_colls)])
+    
+    results = pywise.rmsds(colls, n_threads, superpose = True)
+    
+    check("rmsds() with superpose", results, expected, tolerance_double)
+    
+    if results[0] > tolerance_double:
+    
+        print("%s: Failed - a rotated copy gave an RMSD of %g."
+              % (test_name, results[0]))
+        exit(1)
+    
+    # Superposition can only bring collections closer.
+    
+    if (results > pywise.rmsds(colls, n_threads) + tolerance_double).any():
+    
+        print("%s: Failed - superposition increased an RMSD." % test_name)
+        exit(1)
+    
+    results = pywise.rmsds(colls.astype(numpy.float32), n_threads,
+                           superpose = True)
+    
+    if results.dtype != numpy.float32:
+    
+        print("%s: Failed - float32 collections gave results of dtype %s."
+              % (test_name, results.dtype))
+        exit(1)
+    
+    check("rmsds() with superpose of float32 collections", results, expected,
+          tolerance_single)
+    
+    # Collections of a single point, or of coincident points, have nothing to
+    # rotate and superpose exactly, up to the rounding of their centroids.
+    
+    for name, degenerate in [
+        
+        ("single points", numpy.random.rand(n_colls, 1, n_coords)),
+        ("coincident points",
+         numpy.repeat(numpy.random.rand(n_colls, 1, n_coords), n_coll_points,
+                      axis = 1))
+    
+    ]:
+    
+        for dtype, tolerance in ((numpy.float64, tolerance_double),
+                                 (numpy.float32, tolerance_single)):
+        
+            check("rmsds() with superpose of %s of %s"
+                  % (name, numpy.dtype(dtype).name),
+                  pywise.rmsds(degenerate.astype(dtype), n_threads,
+                               superpose = True),
+                  numpy.zeros(n_colls * (n_colls - 1) // 2), tolerance)
+    
+    # Between collinear collections the optimal rotation is not unique, so
+    # the QCP polynomial has a repeated root. Rotated copies of one line must
+    # still give zero, and lines of other spacings and coincident points the
+    # RMSDs of Kabsch, within what a repeated root allows.
+    
+    line = numpy.outer(numpy.random.rand(n_coll_points), [1, 2, -0.5])
+    
+    lines = numpy.array([line, numpy.dot(line, rotation.T) + 3,
+                         numpy.outer(numpy.random.rand(n_coll_points),
+                                     [0, 1, 1]),
+                         numpy.repeat(line[:1], n_coll_points, axis = 0)])
+    
+    expected = numpy.array([kabsch_rmsd(lines[i], lines[j])
+                            for i in range(len(lines))
+                            for j in range(i + 1, len(lines))])
+    
+    expected[0] = 0
+    
+    check("rmsds() with superpose of collinear collections",
+          pywise.rmsds(lines, n_threads, superpose = True), expected,
+          tolerance_collinear)
+    
+    check("rmsds() with superpose of float32 collinear collections",
+          pywise.rmsds(lines.astype(numpy.float32), n_threads,
+                       superpose = True), expected, tolerance_single)
+    
+    # Only points in three-dimensional space can be superposed, and
+    # superposition cannot be combined with a cutoff.
+    
+    for kwargs in [{"collections": colls[:, :, :2], "superpose": True},
+                   {"collections": colls, "superpose": True, "cutoff": 0.5}]:
+    
+        try:
+        
+            pywise.rmsds(**kwargs)
+        
+        except ValueError:
+        
+            pass
+        
+        else:
+        
+            print("%s: Failed - rmsds() accepted %s."
+                  % (test_name, sorted(kwargs.keys())))
+            exit(1)
+    
+    print("%s: Passed!" % test_name)
@@ -0,0 +1,112 @@
+#!/usr/bin/env python
+
+# pywise_test_threads.py
+#
+# A unit test for concurrent calls to pywise.distances() and pywise.rmsds()
+# from several Python threads, which pywise allows by releasing the GIL.
+#
+# Usage: python pywise_test_threads.py
+
+import sys
+import os
+import threading
+
+n_points = 2000
+n_colls = 200
+n_coll_points = 20
+n_coords = 3
+n_threads = 4
+n_python_threads = 6
+
+test_name = "pywise_test_threads.py"
+
+
+if __name__ == "__main__":
+
+    # Add the distribution root to the system path in case pywise has been
+    # built in place, rather than installed permanently.
+    
+    test_directory = os.path.dirname(os.path.realpath(__file__))
+    dist_directory = os.path.join(test_directory, os.path.pardir)
+    
+    sys.path.append(dist_directory)
+    
+    # Try to import the required modules, including pywise.
+    
+    try:
+    
+        import pywise
+    
+    except:
+        
+        print("%s: Failed - couldn't import pywise." % test_name)
+        exit(1)
+    
+    try:
+    
+        import numpy
+    
+    except:
+    
+        print("%s: Failed - couldn't import NumPy." % test_name)
+        exit(1)
+    
+    # Calculate reference results once on the main thread, and then calculate
+    # the same results again from several Python threads at once, each
+    # alternating between pywise.distances() and pywise.rmsds().
+    
+    points = numpy.random.rand(n_points, n_coords)
+    colls = numpy.random.rand(n_colls, n_coll_points, n_coords)
+    
+    dists_reference = pywise.distances(points, n_threads)
+    rmsds_reference = pywise.rmsds(colls, n_threads)
+    
+    # Automatically chosen numbers of threads, given by zero or by default,
+    # must give the same results as an explicit number.
+    
+    if not numpy.array_equal(pywise.distances(points, 0), dists_reference) \
+    or not numpy.array_equal(pywise.distances(points), dists_reference) \
+    or not numpy.array_equal(pywise.rmsds(colls, 0), rmsds_reference) \
+    or not numpy.array_equal(pywise.rmsds(colls), rmsds_reference):
+    
+        print("%s: Failed - an automatically chosen number of threads gave "
+              "different results to %d threads." % (test_name, n_threads))
+        exit(1)
+    
+    failures = list()
+    
+    def worker(i_worker):
+    
+        for i_round in range(4):
+        
+            if (i_worker + i_round) % 2:
+            
+                result = pywise.distances(points, n_threads)
+                
+                if not numpy.array_equal(result, dists_reference):
+                    failures.append("distances")
+            
+            else:
+            
+                result = pywise.rmsds(colls, n_threads)
+                
+                if not numpy.array_equal(result, rmsds_reference):
+                    failures.append("rmsds")
+    
+    workers = [threading.Thread(target = worker, args = (i,))
+               for i in range(n_python_threads)]
+    
+    for thread in workers:
+        thread.start()
+    
+    for thread in workers:
+        thread.join()
+    
+    if failures:
+    
+        print("%s: Failed - concurrent calls to pywise.%s() gave different "
+              "results to a lone call." % (test_name, failures[0]))
+        exit(1)
+    
+    print("%s: Passed!" % test_name)
+    
@@ -0,0 +1,174 @@
+#!/usr/bin/env python
+
+# pywise_test_tiles.py
+#
+# A unit test for pywise.tiles(), checking that its tiles cover the upper
+# triangle of the matrix of results exactly once, and agree with the results
+# of pywise.distances() and pywise.rmsds().
+#
+# Usage: python pywise_test_tiles.py
+
+import sys
+import os
+
+n_points = 1100
+n_colls = 150
+n_coll_points = 10
+n_coords = 3
+n_tile = 64
+n_queue = 3
+n_threads = 3
+
+test_name = "pywise_test_tiles.py"
+
+
+def square(condensed, n):
+
+    # Expand condensed results for n members into the full symmetric n by n
+    # matrix, with zero on its diagonal.
+    
+    import numpy
+    
+    matrix = numpy.zeros((n, n), condensed.dtype)
+    
+    rows, columns = numpy.triu_indices(n, 1)
+    
+    matrix[rows, columns] = condensed
+    matrix[columns, rows] = condensed
+    
+    return matrix
+
+
+def assemble(name, tiles, n, dtype):
+
+    # Place every tile in a full matrix, checking that each element of the
+    # upper triangle, diagonal included, is covered exactly once.
+    
+    import numpy
+    
+    matrix = numpy.zeros((n, n), dtype)
+    covered = numpy.zeros((n, n), numpy.int64)
+    
+    for (r0, r1), (c0, c1), block in tiles:
+    
+        if block.shape != (r1 - r0, c1 - c0) or block.dtype != dtype:
+        
+            print("%s: Failed - %s gave a malformed tile." % (test_name, name))
+            exit(1)
+            
+        if r0 == c0 and (block != block.T).any():
+        
+            print("%s: Failed - %s gave an asymmetric diagonal tile."
+                  % (test_name, name))
+            exit(1)
+            
+        matrix[r0:r1, c0:c1] = block
+        covered[r0:r1, c0:c1] += 1
+        
+    expected = numpy.triu(numpy.ones((n, n), numpy.int64))
+    
+    if (numpy.triu(covered) != expected).any() or numpy.tril(covered, -1).any():
+    
+        print("%s: Failed - %s did not cover every pair once."
+              % (test_name, name))
+        exit(1)
+        
+    return numpy.triu(matrix) + numpy.triu(matrix, 1).T
+
+
+def check(name, got, expected):
+
+    if got.shape != expected.shape or (got != expected).any():
+    
+        print("%s: Failed - %s gave the wrong results." % (test_name, name))
+        exit(1)
+
+
+if __name__ == "__main__":
+
+    # Add the distribution root to the system path in case pywise has been
+    # built in place, rather than installed permanently.
+    
+    test_directory = os.path.dirname(os.path.realpath(__file__))
+    dist_directory = os.path.join(test_directory, os.path.pardir)
+    
+    sys.path.append(dist_directory)
+    
+    # Try to import the required modules, including pywise.
+    
+    try:
+    
+        import pywise
+        
+    except:
+    
+        print("%s: Failed - couldn't import pywise." % test_name)
+        exit(1)
+        
+    try:
+    
+        import numpy
+        
+    except:
+    
+        print("%s: Failed - couldn't import NumPy." % test_name)
+        exit(1)
+        
+    points = numpy.random.rand(n_points, n_coords)
+    colls = numpy.random.rand(n_colls, n_coll_points, n_coords)
+    
+    # Compare the reassembled tiles against the full matrices, in both
+    # precisions and for both metrics.
+    
+    check("tiles()",
+          assemble("tiles()",
+                   pywise.tiles(points, n_tile, n_queue, n_threads),
+                   n_points, numpy.float64),
+          square(pywise.distances(points, n_threads), n_points))
+          
+    points_single = points.astype(numpy.float32)
+    
+    check("tiles() of float32 points",
+          assemble("tiles() of float32 points",
+                   pywise.tiles(points_single, n_tile, n_queue, n_threads),
+                   n_points, numpy.float32),
+          square(pywise.distances(points_single, n_threads), n_points))
+          
+    check("tiles() of collections",
+          assemble("tiles() of collections",
+                   pywise.tiles(colls, n_tile, n_queue, n_threads, "rmsd"),
+                   n_colls, numpy.float64),
+          square(pywise.rmsds(colls, n_threads), n_colls))
+          
+    # Stopping early, or never starting, must leave nothing behind.
+    
+    for i_tile, tile in enumerate(pywise.tiles(points, n_tile, 1, n_threads)):
+    
+        if i_tile == 2:
+        
+            break
+            
+    del tile
+    
+    pywise.tiles(points, n_tile, n_queue, n_threads)
+    
+    # Negative sizes and unknown metrics are refused.
+    
+    for arguments in ((points, -1), (points, n_tile, -1),
+                      (points, n_tile, n_queue, n_threads, "manhattan")):
+                      
+        try:
+        
+            pywise.tiles(*arguments)
+            
+        except ValueError:
+        
+            pass
+            
+        else:
+        
+            print("%s: Failed - tiles%s was accepted."
+                  % (test_name, str(arguments[1:])))
+            exit(1)
+            
+    print("%s: Passed!" % test_name)
@@ -0,0 +1,124 @@
+#!/usr/bin/env python
+
+# pywise_test_wide.py
+#
+# A unit test for pywise.distances() and pywise.rmsds() between points and
+# collections of 64 or more coordinates in all, which libpairwise calculates
+# by norm expansion, checking that they keep their precision far from the
+# origin and between near-identical members.
+#
+# Usage: python pywise_test_wide.py
+
+import sys
+import os
+
+n_colls = 200
+n_coll_points = 300
+n_points = 300
+n_coords = 128
+n_threads = 3
+
+test_name = "pywise_test_wide.py"
+
+
+def reference(members):
+
+    # Return the condensed RMSDs between every pair of members, each an array
+    # of coordinates, calculated directly in double precision.
+    
+    import numpy
+    
+    flat = members.reshape(len(members), -1).astype(numpy.float64)
+    n_per_member = members[0].size / members[0].shape[-1]
+    
+    return numpy.concatenate([
+        numpy.sqrt(((flat[i + 1:] - flat[i]) ** 2).sum(axis = 1) / n_per_member)
+        for i in xrange(len(flat) - 1)
+    ])
+
+
+def check(name, got, expected, tolerance):
+
+    # Members which are exactly the same must give exactly zero, and every
+    # other pair must agree with the reference to within tolerance.
+    
+    same = expected == 0
+    error = (abs(got[~same] - expected[~same]) / expected[~same]).max()
+    
+    if got[same].any() or not error <= tolerance:
+    
+        print("%s: Failed - %s had a relative error of %g."
+              % (test_name, name, error))
+        exit(1)
+
+
+if __name__ == "__main__":
+
+    # Add the distribution root to the system path in case pywise has been
+    # built in place, rather than installed permanently.
+    
+    test_directory = os.path.dirname(os.path.realpath(__file__))
+    dist_directory = os.path.join(test_directory, os.path.pardir)
+    
+    sys.path.append(dist_directory)
+    
+    # Try to import the required modules, including pywise.
+    
+    try:
+    
+        import pywise
+        
+    except:
+    
+        print("%s: Failed - couldn't import pywise." % test_name)
+        exit(1)
+        
+    try:
+    
+        import numpy
+        
+    except:
+    
+        print("%s: Failed - couldn't import NumPy." % test_name)
+        exit(1)
+        
+    # Frames of one molecule, its atoms tens of angstroms from the origin and
+    # jittered by a tenth of an angstrom, so that RMSDs are thousands of times
+    # smaller than the coordinates.
+    
+    molecule = numpy.random.uniform(-40, 40, (n_coll_points, 3))
+    colls = molecule + numpy.random.normal(0, 0.1, (n_colls, n_coll_points, 3))
+    colls_single = colls.astype(numpy.float32)
+    
+    check("rmsds() far from the origin",
+          pywise.rmsds(colls, n_threads), reference(colls), 1e-12)
+          
+    check("rmsds() of float32 far from the origin",
+          pywise.rmsds(colls_single, n_threads), reference(colls_single), 1e-6)
+          
+    # Points of many features around one hundred, near-identical in pairs and
+    # otherwise spread, whose distances must neither be lost to cancellation
+    # nor rounded to zero.
+    
+    points = 100 + numpy.random.rand(n_points, n_coords)
+    points[1::2] = points[::2] + numpy.random.normal(0, 1e-6, points[::2].shape)
+    points_single = points.astype(numpy.float32)
+    
+    check("distances() of near-identical points",
+          pywise.distances(points, n_threads), reference(points), 1e-12)
+          
+    check("distances() of near-identical float32 points",
+          pywise.distances(points_single, n_threads),
+          reference(points_single), 1e-6)
+          
+    # Identical points are still exactly zero apart.
+    
+    points[1] = points[0]
+    
+    if pywise.distances(points, n_threads)[0] != 0:
+    
+        print("%s: Failed - distances() between identical points was not "
+              "zero." % test_name)
+        exit(1)
+        
+    print("%s: Passed!" % test_name)